@@ -279,7 +279,7 @@ namespace backend {
                 core::configManager.acquire();
                 core::configManager.conf["windowSize"]["w"] = winWidth;
                 core::configManager.conf["windowSize"]["h"] = winHeight;
-                core::configManager.release(true);
+                core::configManager.releaseKey("windowSize");
             }
 
             if (winWidth > 0 && winHeight > 0) {
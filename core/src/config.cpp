@@ -1,6 +1,7 @@
 #include <config.h>
 #include <utils/flog.h>
 #include <fstream>
+#include <algorithm>
 
 #include <filesystem>
 
@@ -35,6 +36,7 @@ void ConfigManager::load(json def, bool lock) {
         std::ifstream file(path.c_str());
         file >> conf;
         file.close();
+        allDirty = true;
     }
     catch (const std::exception& e) {
         flog::error("Config file '{}' is corrupted, resetting it: {}", path, e.what());
@@ -45,11 +47,12 @@ void ConfigManager::load(json def, bool lock) {
 }
 
 void ConfigManager::save(bool lock) {
+    // Only copying what changed is done with the lock held, serializing and writing happen after
     if (lock) { mtx.lock(); }
-    std::ofstream file(path.c_str());
-    file << conf.dump(4);
-    file.close();
+    allDirty = true;
+    takeSnapshot();
     if (lock) { mtx.unlock(); }
+    flush();
 }
 
 void ConfigManager::enableAutoSave() {
@@ -75,7 +78,16 @@ void ConfigManager::acquire() {
 }
 
 void ConfigManager::release(bool modified) {
-    changed |= modified;
+    if (modified) {
+        allDirty = true;
+        changed = true;
+    }
+    mtx.unlock();
+}
+
+void ConfigManager::releaseKey(const std::string& key) {
+    dirtyKeys.insert(key);
+    changed = true;
     mtx.unlock();
 }
 
@@ -86,11 +98,13 @@ void ConfigManager::autoSaveWorker() {
             std::this_thread::sleep_for(std::chrono::milliseconds(1000));
             continue;
         }
-        if (changed) {
+        bool modified = changed;
+        if (modified) {
             changed = false;
-            save(false);
+            takeSnapshot();
         }
         mtx.unlock();
+        if (modified) { flush(); }
 
         // Sleep but listen for wakeup call
         {
@@ -98,4 +112,99 @@ void ConfigManager::autoSaveWorker() {
             termCond.wait_for(lock, std::chrono::milliseconds(1000), [this]() { return termFlag; });
         }
     }
-}
\ No newline at end of file
+}
+
+void ConfigManager::takeSnapshot() {
+    Snapshot snap;
+    snap.isObject = conf.is_object();
+    if (!snap.isObject) {
+        snapshotKeys.clear();
+        snap.whole = conf;
+    }
+    else {
+        // Copy the keys that were marked as modified and those that were never written, everything if unknown
+        for (auto& [key, val] : conf.items()) {
+            snap.keys.push_back(key);
+            bool added = snapshotKeys.insert(key).second;
+            if (!allDirty && !added && !dirtyKeys.count(key)) { continue; }
+            snap.changed.push_back({ key, val });
+        }
+
+        // Forget the keys that were removed
+        if (snapshotKeys.size() != snap.keys.size()) {
+            for (auto it = snapshotKeys.begin(); it != snapshotKeys.end();) {
+                it = conf.contains(*it) ? std::next(it) : snapshotKeys.erase(it);
+            }
+        }
+    }
+    allDirty = false;
+    dirtyKeys.clear();
+
+    std::lock_guard<std::mutex> lck(pendingMtx);
+    pending.push_back(std::move(snap));
+}
+
+void ConfigManager::flush() {
+    std::lock_guard<std::mutex> lck(writeMtx);
+    std::vector<Snapshot> snaps;
+    {
+        std::lock_guard<std::mutex> lck2(pendingMtx);
+        snaps.swap(pending);
+    }
+    if (snaps.empty()) { return; }
+
+    // Re-serialize only the keys that changed, in the same layout as dump(4)
+    for (auto& snap : snaps) {
+        if (!snap.isObject) { continue; }
+        for (auto& [key, val] : snap.changed) {
+            std::string text = val.dump(4);
+            std::string indented = "    " + json(key).dump() + ": ";
+            indented.reserve(indented.size() + text.size());
+            for (char c : text) {
+                indented += c;
+                if (c == '\n') { indented += "    "; }
+            }
+            serialized[key] = std::move(indented);
+        }
+    }
+
+    // Assemble the file from the latest snapshot
+    const Snapshot& last = snaps.back();
+    std::string out;
+    if (!last.isObject) {
+        serialized.clear();
+        out = last.whole.dump(4);
+    }
+    else if (last.keys.empty()) {
+        serialized.clear();
+        out = "{}";
+    }
+    else {
+        for (auto it = serialized.begin(); it != serialized.end();) {
+            it = std::binary_search(last.keys.begin(), last.keys.end(), it->first) ? std::next(it) : serialized.erase(it);
+        }
+        out = "{\n";
+        for (int i = 0; i < last.keys.size(); i++) {
+            out += serialized[last.keys[i]];
+            out += (i < last.keys.size() - 1) ? ",\n" : "\n";
+        }
+        out += "}";
+    }
+
+    // Write to a temporary file and swap it in so that the config is never left half written
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        file << out;
+        file.close();
+        if (file.fail()) {
+            flog::error("Failed to write config file '{0}'", tempPath);
+            return;
+        }
+    }
+    std::error_code err;
+    std::filesystem::rename(tempPath, path, err);
+    if (err) {
+        flog::error("Failed to replace config file '{0}': {1}", path, err.message());
+    }
+}
@@ -4,6 +4,9 @@
 #include <string>
 #include <mutex>
 #include <condition_variable>
+#include <vector>
+#include <map>
+#include <set>
 
 using nlohmann::json;
 
@@ -18,11 +21,21 @@ public:
     void disableAutoSave();
     void acquire();
     void release(bool modified = false);
+    void releaseKey(const std::string& key);
 
     json conf;
 
 private:
+    struct Snapshot {
+        bool isObject;
+        std::vector<std::string> keys;
+        std::vector<std::pair<std::string, json>> changed;
+        json whole;
+    };
+
     void autoSaveWorker();
+    void takeSnapshot();
+    void flush();
 
     std::string path = "";
     volatile bool changed = false;
@@ -30,6 +43,19 @@ private:
     std::thread autoSaveThread;
     std::mutex mtx;
 
+    // Top-level keys modified since the last snapshot and the keys that were ever snapshotted, only accessed with mtx held
+    bool allDirty = true;
+    std::set<std::string> dirtyKeys;
+    std::set<std::string> snapshotKeys;
+
+    // Snapshots waiting to be written, in order
+    std::vector<Snapshot> pending;
+    std::mutex pendingMtx;
+
+    // Serialized text of each top-level key, only accessed with writeMtx held
+    std::map<std::string, std::string> serialized;
+    std::mutex writeMtx;
+
     std::mutex termMtx;
     std::condition_variable termCond;
     volatile bool termFlag = false;
@@ -128,6 +128,8 @@ int sdrpp_main(int argc, char* argv[]) {
     defConfig["fftWindow"] = 2;
     defConfig["frequency"] = 100000000.0;
     defConfig["fullWaterfallUpdate"] = false;
+    defConfig["waterfallHighPrecision"] = false;
+    defConfig["waterfallMemory"] = 256;
     defConfig["max"] = 0.0;
     defConfig["maximized"] = false;
     defConfig["fullscreen"] = false;
@@ -248,6 +250,7 @@ int sdrpp_main(int argc, char* argv[]) {
     defConfig["showMenu"] = true;
     defConfig["showWaterfall"] = true;
     defConfig["source"] = "";
+    defConfig["instanceSources"] = json::object();
     defConfig["decimation"] = 1;
     defConfig["iqCorrection"] = false;
     defConfig["invertIQ"] = false;
@@ -390,6 +393,9 @@ int sdrpp_main(int argc, char* argv[]) {
     LoadingScreen::show("Loading band plans");
     flog::info("Loading band plans");
     bandplan::loadFromDir(resDir + "/bandplans");
+    if (std::filesystem::is_directory(root + "/bandplans")) {
+        bandplan::loadFromDir(root + "/bandplans");
+    }
 
     LoadingScreen::show("Loading band plan colors");
     flog::info("Loading band plans color table");
@@ -0,0 +1,115 @@
+#pragma once
+#include <atomic>
+#include <algorithm>
+#include "buffer.h"
+
+namespace dsp::buffer {
+    // Lock-free ring buffer for exactly one writer thread and one reader thread. Neither side ever
+    // blocks, which makes it usable from audio callbacks: the writer drops what doesn't fit and the
+    // reader gets what's available.
+    template <class T>
+    class SPSCRing {
+    public:
+        SPSCRing() {}
+
+        SPSCRing(int capacity) { init(capacity); }
+
+        ~SPSCRing() {
+            if (!_buffer) { return; }
+            buffer::free(_buffer);
+        }
+
+        void init(int capacity) {
+            if (_buffer) { buffer::free(_buffer); }
+            size = capacity + 1;
+            _buffer = buffer::alloc<T>(size);
+            buffer::clear(_buffer, size);
+            readPos = 0;
+            writePos = 0;
+        }
+
+        int getCapacity() { return size - 1; }
+
+        int readable() {
+            int w = writePos.load(std::memory_order_acquire);
+            int r = readPos.load(std::memory_order_relaxed);
+            return (w >= r) ? (w - r) : (w + size - r);
+        }
+
+        int writable() {
+            int w = writePos.load(std::memory_order_relaxed);
+            int r = readPos.load(std::memory_order_acquire);
+            return (r > w) ? (r - w - 1) : (r + size - w - 1);
+        }
+
+        /**
+         * Write samples, called from the writer thread only.
+         * @param data Samples to write.
+         * @param count Number of samples.
+         * @return Number of samples written, the ones that didn't fit are dropped.
+        */
+        int write(const T* data, int count) {
+            count = std::min<int>(count, writable());
+            int w = writePos.load(std::memory_order_relaxed);
+            int first = std::min<int>(count, size - w);
+            memcpy(&_buffer[w], data, first * sizeof(T));
+            memcpy(_buffer, &data[first], (count - first) * sizeof(T));
+            writePos.store((w + count) % size, std::memory_order_release);
+            return count;
+        }
+
+        /**
+         * Read samples, called from the reader thread only.
+         * @param data Buffer to read into.
+         * @param count Maximum number of samples.
+         * @return Number of samples read.
+        */
+        int read(T* data, int count) {
+            count = peek(data, count);
+            int r = readPos.load(std::memory_order_relaxed);
+            readPos.store((r + count) % size, std::memory_order_release);
+            return count;
+        }
+
+        /**
+         * Copy samples without consuming them, called from the reader thread only.
+         * @param data Buffer to copy into.
+         * @param count Maximum number of samples.
+         * @return Number of samples copied.
+        */
+        int peek(T* data, int count) {
+            count = std::min<int>(count, readable());
+            int r = readPos.load(std::memory_order_relaxed);
+            int first = std::min<int>(count, size - r);
+            memcpy(data, &_buffer[r], first * sizeof(T));
+            memcpy(&data[first], _buffer, (count - first) * sizeof(T));
+            return count;
+        }
+
+        /**
+         * Drop samples without reading them, called from the reader thread only.
+         * @param count Maximum number of samples.
+         * @return Number of samples dropped.
+        */
+        int skip(int count) {
+            count = std::min<int>(count, readable());
+            int r = readPos.load(std::memory_order_relaxed);
+            readPos.store((r + count) % size, std::memory_order_release);
+            return count;
+        }
+
+        /**
+         * Empty the ring, only valid while neither the reader nor the writer is running.
+        */
+        void clear() {
+            readPos = 0;
+            writePos = 0;
+        }
+
+    private:
+        T* _buffer = NULL;
+        int size = 1;
+        std::atomic<int> readPos = 0;
+        std::atomic<int> writePos = 0;
+    };
+}
@@ -0,0 +1,214 @@
+#pragma once
+#include "frequency_xlator.h"
+#include "../multirate/rational_resampler.h"
+#include "../filter/fir.h"
+#include "../taps/windowed_sinc.h"
+#include "../taps/estimate_tap_count.h"
+
+namespace dsp::channel {
+    // Digital downconverter for real samples, such as those of a direct sampling ADC. The input is shifted down by a
+    // quarter of its rate and decimated by two with a half-band filter, giving complex samples of the whole first
+    // Nyquist zone. The quarter rate shift only multiplies by 1, -j, -1 and j, so even input samples end up in the real
+    // part and odd ones in the imaginary part. Every other half-band tap being zero, the real part is a filter with
+    // half of the taps over the even samples, and the imaginary part is a delayed odd sample scaled by the center tap.
+    // The band is then brought to baseband and resampled at half the input rate.
+    class RealDDC : public Processor<float, complex_t> {
+        using base_type = Processor<float, complex_t>;
+    public:
+        RealDDC() {}
+
+        RealDDC(stream<float>* in, double inSamplerate, double outSamplerate, double bandwidth, double offset) { init(in, inSamplerate, outSamplerate, bandwidth, offset); }
+
+        ~RealDDC() {
+            if (!base_type::_block_init) { return; }
+            base_type::stop();
+            buffer::free(evenBuf);
+            buffer::free(oddBuf);
+            taps::free(htaps);
+            taps::free(ftaps);
+        }
+
+        void init(stream<float>* in, double inSamplerate, double outSamplerate, double bandwidth, double offset) {
+            _inSamplerate = inSamplerate;
+            _outSamplerate = outSamplerate;
+            _bandwidth = bandwidth;
+            _offset = offset;
+            filterNeeded = (_bandwidth != _outSamplerate);
+            htaps.taps = NULL;
+            ftaps.taps = NULL;
+
+            generateHalfBandTaps();
+            evenBuf = buffer::alloc<float>((STREAM_BUFFER_SIZE / 2) + 1 + htaps.size);
+            oddBuf = buffer::alloc<float>((STREAM_BUFFER_SIZE / 2) + 1 + oddHistory);
+            clearHistory();
+            xlator.init(NULL, getShift(), _inSamplerate / 2.0);
+            resamp.init(NULL, _inSamplerate / 2.0, _outSamplerate);
+            generateTaps();
+            filter.init(NULL, ftaps);
+
+            base_type::init(in);
+        }
+
+        void setInSamplerate(double inSamplerate) {
+            assert(base_type::_block_init);
+            std::lock_guard<std::recursive_mutex> lck(base_type::ctrlMtx);
+            base_type::tempStop();
+            _inSamplerate = inSamplerate;
+            xlator.setOffset(getShift(), _inSamplerate / 2.0);
+            resamp.setInSamplerate(_inSamplerate / 2.0);
+            base_type::tempStart();
+        }
+
+        void setOutSamplerate(double outSamplerate, double bandwidth) {
+            assert(base_type::_block_init);
+            std::lock_guard<std::recursive_mutex> lck(base_type::ctrlMtx);
+            base_type::tempStop();
+            _outSamplerate = outSamplerate;
+            _bandwidth = bandwidth;
+            filterNeeded = (_bandwidth != _outSamplerate);
+            resamp.setOutSamplerate(_outSamplerate);
+            if (filterNeeded) {
+                generateTaps();
+                filter.setTaps(ftaps);
+            }
+            base_type::tempStart();
+        }
+
+        void setBandwidth(double bandwidth) {
+            assert(base_type::_block_init);
+            std::lock_guard<std::recursive_mutex> lck(base_type::ctrlMtx);
+            std::lock_guard<std::mutex> lck2(filterMtx);
+            _bandwidth = bandwidth;
+            filterNeeded = (_bandwidth != _outSamplerate);
+            if (filterNeeded) {
+                generateTaps();
+                filter.setTaps(ftaps);
+            }
+        }
+
+        void setOffset(double offset) {
+            assert(base_type::_block_init);
+            std::lock_guard<std::recursive_mutex> lck(base_type::ctrlMtx);
+            _offset = offset;
+            xlator.setOffset(getShift(), _inSamplerate / 2.0);
+        }
+
+        void reset() {
+            assert(base_type::_block_init);
+            std::lock_guard<std::recursive_mutex> lck(base_type::ctrlMtx);
+            base_type::tempStop();
+            clearHistory();
+            xlator.reset();
+            resamp.reset();
+            filter.reset();
+            base_type::tempStart();
+        }
+
+        inline int process(int count, const float* in, complex_t* out) {
+            // Split the input into its even and odd samples, applying the sign of the quarter rate shift
+            float* evenStart = &evenBuf[htaps.size - 1];
+            float* oddStart = &oddBuf[oddHistory];
+            int oddLead = phase & 1;
+            int evenCount = 0;
+            int oddCount = 0;
+            for (int i = 0; i < count; i++) {
+                float val = (phase & 2) ? -in[i] : in[i];
+                if (phase & 1) {
+                    oddStart[oddCount++] = val;
+                }
+                else {
+                    evenStart[evenCount++] = val;
+                }
+                phase = (phase + 1) & 3;
+            }
+
+            // One output per even sample, the odd sample at the center of the filter gives the imaginary part
+            const float* oddCenter = &oddBuf[oddLead + 1];
+            for (int i = 0; i < evenCount; i++) {
+                volk_32f_x2_dot_prod_32f(&out[i].re, &evenBuf[i], htaps.taps, htaps.size);
+                out[i].im = -centerTap * oddCenter[i];
+            }
+
+            // Keep the history for the next block
+            memmove(evenBuf, &evenBuf[evenCount], (htaps.size - 1) * sizeof(float));
+            memmove(oddBuf, &oddBuf[oddCount], oddHistory * sizeof(float));
+
+            // Bring the band down to baseband and resample to the output rate
+            xlator.process(evenCount, out, out);
+            int outCount = resamp.process(evenCount, out, out);
+            if (!filterNeeded) { return outCount; }
+            {
+                std::lock_guard<std::mutex> lck(filterMtx);
+                filter.process(outCount, out, out);
+            }
+            return outCount;
+        }
+
+        int run() {
+            int count = base_type::_in->read();
+            if (count < 0) { return -1; }
+
+            int outCount = process(count, base_type::_in->readBuf, base_type::out.writeBuf);
+
+            // Swap if some data was generated
+            base_type::_in->flush();
+            if (outCount) {
+                if (!base_type::out.swap(outCount)) { return -1; }
+            }
+            return outCount;
+        }
+
+    protected:
+        // After the quarter rate shift, the offset sits this far from the center of the decimated band
+        double getShift() {
+            return -(_offset - (_inSamplerate / 4.0));
+        }
+
+        void generateHalfBandTaps() {
+            // With 4K-1 taps, the center tap is odd and all other odd taps are zero. Only the even taps are kept,
+            // the transition is a tenth of the decimated rate
+            int k = (taps::estimateTapCount(0.05, 1.0) + 4) / 4;
+            tap<float> hb = taps::windowedSinc<float>((4 * k) - 1, DB_M_PI / 2.0, window::nuttall);
+            taps::free(htaps);
+            htaps = taps::alloc<float>(2 * k);
+            for (int i = 0; i < 2 * k; i++) { htaps.taps[i] = hb.taps[2 * i]; }
+            centerTap = hb.taps[(2 * k) - 1];
+            oddHistory = k + 1;
+            taps::free(hb);
+        }
+
+        void generateTaps() {
+            taps::free(ftaps);
+            double filterWidth = _bandwidth / 2.0;
+            ftaps = taps::lowPass(filterWidth, filterWidth * 0.1, _outSamplerate);
+        }
+
+        void clearHistory() {
+            buffer::clear(evenBuf, htaps.size - 1);
+            buffer::clear(oddBuf, oddHistory);
+            phase = 0;
+        }
+
+        FrequencyXlator xlator;
+        multirate::RationalResampler<complex_t> resamp;
+        filter::FIR<complex_t, float> filter;
+        tap<float> htaps;
+        tap<float> ftaps;
+        float centerTap;
+        bool filterNeeded;
+
+        float* evenBuf;
+        float* oddBuf;
+        int oddHistory;
+
+        // Index of the next input sample, modulo 4
+        int phase = 0;
+
+        double _inSamplerate;
+        double _outSamplerate;
+        double _bandwidth;
+        double _offset;
+
+        std::mutex filterMtx;
+    };
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include "frequency_xlator.h"
 #include "../multirate/rational_resampler.h"
 
@@ -86,6 +87,13 @@ namespace dsp::channel {
             base_type::tempStart();
         }
 
+        // Duration of the last input block plus the group delay of the resampler and filter, in seconds
+        double getDelay() {
+            double delay = (double)lastBlockSize / _inSamplerate + resamp.getGroupDelay();
+            if (filterNeeded) { delay += (double)(ftaps.size - 1) / 2.0 / _outSamplerate; }
+            return delay;
+        }
+
         inline int process(int count, const complex_t* in, complex_t* out) {
             xlator.process(count, in, out);
             if (!filterNeeded) {
@@ -102,6 +110,7 @@ namespace dsp::channel {
         int run() {
             int count = base_type::_in->read();
             if (count < 0) { return -1; }
+            lastBlockSize = count;
 
             int outCount = process(count, base_type::_in->readBuf, out.writeBuf);
 
@@ -130,6 +139,7 @@ namespace dsp::channel {
         double _outSamplerate;
         double _bandwidth;
         double _offset;
+        std::atomic<int> lastBlockSize = 0;
 
         std::mutex filterMtx;
     };
@@ -0,0 +1,35 @@
+#pragma once
+#include <math.h>
+
+namespace dsp::clock_recovery {
+    // Averaged state of a timing recovery loop, for display and tuning purposes
+    struct TimingDiagnostics {
+        inline void update(float error) {
+            errorMean += (error - errorMean) * ALPHA;
+            errorPower += ((error * error) - errorPower) * ALPHA;
+        }
+
+        void reset() {
+            errorMean = 0.0f;
+            errorPower = 0.0f;
+        }
+
+        /**
+         * Get the RMS value of the timing error. Close to zero when locked, grows with noise and jitter.
+         * @return RMS timing error.
+        */
+        float getErrorRMS() const { return sqrtf(errorPower); }
+
+        // Averaging constant, about a thousand symbols
+        static constexpr float ALPHA = 1e-3f;
+
+        // Average timing error
+        float errorMean = 0.0f;
+
+        // Average squared timing error
+        float errorPower = 0.0f;
+
+        // Current estimate of the number of samples per symbol
+        float omega = 0.0f;
+    };
+}
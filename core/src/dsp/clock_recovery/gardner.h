@@ -0,0 +1,275 @@
+#pragma once
+#include "../processor.h"
+#include "../loop/phase_control_loop.h"
+#include "../taps/windowed_sinc.h"
+#include "../multirate/polyphase_bank.h"
+#include "diagnostics.h"
+
+namespace dsp::clock_recovery {
+    // Gardner timing recovery. Unlike Mueller & Muller, the error doesn't depend on symbol decisions, so it
+    // works before the carrier is locked and with any constellation. Needs at least two samples per symbol.
+    template<class T>
+    class Gardner : public Processor<T, T> {
+        using base_type = Processor<T, T>;
+    public:
+        // Most symbols that can be interpolated in one pass
+        static constexpr int MAX_BATCH_SIZE = 64;
+
+        Gardner() {}
+
+        Gardner(stream<T>* in, double omega, double omegaGain, double muGain, double omegaRelLimit, int interpPhaseCount = 128, int interpTapCount = 8) { init(in, omega, omegaGain, muGain, omegaRelLimit, interpPhaseCount, interpTapCount); }
+
+        ~Gardner() {
+            if (!base_type::_block_init) { return; }
+            base_type::stop();
+            dsp::multirate::freePolyphaseBank(interpBank);
+            buffer::free(buffer);
+        }
+
+        void init(stream<T>* in, double omega, double omegaGain, double muGain, double omegaRelLimit, int interpPhaseCount = 128, int interpTapCount = 8) {
+            _omega = omega;
+            _omegaGain = omegaGain;
+            _muGain = muGain;
+            _omegaRelLimit = omegaRelLimit;
+            _interpPhaseCount = interpPhaseCount;
+            _interpTapCount = interpTapCount;
+
+            pcl.init(_muGain, _omegaGain, 0.0, 0.0, 1.0, _omega, _omega * (1.0 - omegaRelLimit), _omega * (1.0 + omegaRelLimit));
+            generateInterpTaps();
+            allocBuffer();
+            diag.omega = _omega;
+            published = diag;
+
+            base_type::init(in);
+        }
+
+        void setOmega(double omega) {
+            assert(base_type::_block_init);
+            std::lock_guard<std::recursive_mutex> lck(base_type::ctrlMtx);
+            base_type::tempStop();
+            _omega = omega;
+            offset = 0;
+            pcl.phase = 0.0f;
+            pcl.freq = _omega;
+            pcl.setFreqLimits(_omega * (1.0 - _omegaRelLimit), _omega * (1.0 + _omegaRelLimit));
+            buffer::free(buffer);
+            allocBuffer();
+            base_type::tempStart();
+        }
+
+        void setOmegaGain(double omegaGain) {
+            assert(base_type::_block_init);
+            std::lock_guard<std::recursive_mutex> lck(base_type::ctrlMtx);
+            _omegaGain = omegaGain;
+            pcl.setCoefficients(_muGain, _omegaGain);
+        }
+
+        void setMuGain(double muGain) {
+            assert(base_type::_block_init);
+            std::lock_guard<std::recursive_mutex> lck(base_type::ctrlMtx);
+            _muGain = muGain;
+            pcl.setCoefficients(_muGain, _omegaGain);
+        }
+
+        void setOmegaRelLimit(double omegaRelLimit) {
+            assert(base_type::_block_init);
+            std::lock_guard<std::recursive_mutex> lck(base_type::ctrlMtx);
+            base_type::tempStop();
+            _omegaRelLimit = omegaRelLimit;
+            pcl.setFreqLimits(_omega * (1.0 - _omegaRelLimit), _omega * (1.0 + _omegaRelLimit));
+            buffer::free(buffer);
+            allocBuffer();
+            base_type::tempStart();
+        }
+
+        void setInterpParams(int interpPhaseCount, int interpTapCount) {
+            assert(base_type::_block_init);
+            std::lock_guard<std::recursive_mutex> lck(base_type::ctrlMtx);
+            base_type::tempStop();
+            _interpPhaseCount = interpPhaseCount;
+            _interpTapCount = interpTapCount;
+            dsp::multirate::freePolyphaseBank(interpBank);
+            buffer::free(buffer);
+            generateInterpTaps();
+            allocBuffer();
+            base_type::tempStart();
+        }
+
+        /**
+         * Set how many symbols are placed and interpolated at once. The timing loop is still updated for every symbol,
+         * but the corrections only move the symbols of the next batch. A size of 1 gives a per-symbol loop.
+         * @param batchSize Number of symbols per batch, up to MAX_BATCH_SIZE.
+        */
+        void setBatchSize(int batchSize) {
+            assert(base_type::_block_init);
+            assert(batchSize >= 1 && batchSize <= MAX_BATCH_SIZE);
+            std::lock_guard<std::recursive_mutex> lck(base_type::ctrlMtx);
+            _batchSize = batchSize;
+        }
+
+        void reset() {
+            assert(base_type::_block_init);
+            std::lock_guard<std::recursive_mutex> lck(base_type::ctrlMtx);
+            base_type::tempStop();
+            offset = 0;
+            pcl.phase = 0.0f;
+            pcl.freq = _omega;
+            lastOut = {};
+            buffer::clear(buffer, historySize);
+            diag.reset();
+            {
+                std::lock_guard<std::mutex> lck(diagMtx);
+                published = diag;
+            }
+            base_type::tempStart();
+        }
+
+        /**
+         * Get the state of the timing loop. Values are updated once per processed block.
+         * @return Timing diagnostics.
+        */
+        TimingDiagnostics getDiagnostics() {
+            std::lock_guard<std::mutex> lck(diagMtx);
+            return published;
+        }
+
+        inline int process(int count, const T* in, T* out) {
+            // Copy data to work buffer, after the history
+            memcpy(&buffer[historySize], in, count * sizeof(T));
+
+            // Process all samples
+            int outCount = 0;
+            while (offset < count) {
+                // Place the symbols of the batch and the points halfway to the previous ones, assuming the timing doesn't change in between
+                int n = 0;
+                float pos = pcl.phase;
+                while (n < _batchSize) {
+                    if (offset + (int)floorf(pos) >= count) { break; }
+                    place(n, pos);
+                    place(_batchSize + n, pos - (pcl.freq * 0.5f));
+                    pos += pcl.freq;
+                    n++;
+                }
+
+                // Interpolate the whole batch at once
+                interpolate(n, 0, &out[outCount]);
+                interpolate(n, _batchSize, midVals);
+
+                for (int i = 0; i < n; i++) {
+                    T outVal = out[outCount + i];
+                    T midVal = midVals[i];
+
+                    // Calculate symbol phase error
+                    float error;
+                    if constexpr (std::is_same_v<T, float>) {
+                        error = (lastOut - outVal) * midVal;
+                    }
+                    if constexpr (std::is_same_v<T, complex_t>) {
+                        error = ((lastOut.re - outVal.re) * midVal.re) + ((lastOut.im - outVal.im) * midVal.im);
+                    }
+                    lastOut = outVal;
+
+                    // Clamp symbol phase error
+                    if (error > 1.0f) { error = 1.0f; }
+                    if (error < -1.0f) { error = -1.0f; }
+                    diag.update(error);
+
+                    // Advance symbol offset and phase
+                    pcl.advance(error);
+                    float delta = floorf(pcl.phase);
+                    offset += delta;
+                    pcl.phase -= delta;
+                }
+                outCount += n;
+            }
+            offset -= count;
+            diag.omega = pcl.freq;
+            {
+                std::lock_guard<std::mutex> lck(diagMtx);
+                published = diag;
+            }
+
+            // Update delay buffer
+            memmove(buffer, &buffer[count], historySize * sizeof(T));
+
+            return outCount;
+        }
+
+        int run() {
+            int count = base_type::_in->read();
+            if (count < 0) { return -1; }
+
+            int outCount = process(count, base_type::_in->readBuf, base_type::out.writeBuf);
+
+            // Swap if some data was generated
+            base_type::_in->flush();
+            if (outCount) {
+                if (!base_type::out.swap(outCount)) { return -1; }
+            }
+            return outCount;
+        }
+
+    protected:
+        // Store a position relative to the current offset, which can be up to half a symbol before the start of the block
+        inline void place(int slot, float pos) {
+            float whole = floorf(pos);
+            batchOffsets[slot] = historySize - (_interpTapCount - 1) + offset + (int)whole;
+            batchPhases[slot] = std::clamp<int>(floorf((pos - whole) * (float)_interpPhaseCount), 0, _interpPhaseCount - 1);
+        }
+
+        inline void interpolate(int n, int first, T* out) {
+            for (int i = 0; i < n; i++) {
+                const T* start = &buffer[batchOffsets[first + i]];
+                const float* taps = interpBank.phases[batchPhases[first + i]];
+                if constexpr (std::is_same_v<T, float>) {
+                    volk_32f_x2_dot_prod_32f(&out[i], start, taps, _interpTapCount);
+                }
+                if constexpr (std::is_same_v<T, complex_t>) {
+                    volk_32fc_32f_dot_prod_32fc((lv_32fc_t*)&out[i], (lv_32fc_t*)start, taps, _interpTapCount);
+                }
+            }
+        }
+
+        void generateInterpTaps() {
+            double bw = 0.5 / (double)_interpPhaseCount;
+            dsp::tap<float> lp = dsp::taps::windowedSinc<float>(_interpPhaseCount * _interpTapCount, dsp::math::hzToRads(bw, 1.0), dsp::window::nuttall, _interpPhaseCount);
+            interpBank = dsp::multirate::buildPolyphaseBank<float>(_interpPhaseCount, lp);
+            taps::free(lp);
+        }
+
+        void allocBuffer() {
+            // The history must cover the interpolator and half of the longest possible symbol
+            historySize = (_interpTapCount - 1) + (int)ceil(_omega * (1.0 + _omegaRelLimit) * 0.5) + 1;
+            buffer = buffer::alloc<T>(STREAM_BUFFER_SIZE + historySize);
+            buffer::clear(buffer, historySize);
+        }
+
+        dsp::multirate::PolyphaseBank<float> interpBank;
+        loop::PhaseControlLoop<float, false> pcl;
+
+        // Diagnostics are accumulated by the DSP thread and published once per block for the UI
+        TimingDiagnostics diag;
+        TimingDiagnostics published;
+        std::mutex diagMtx;
+
+        double _omega;
+        double _omegaGain;
+        double _muGain;
+        double _omegaRelLimit;
+        int _interpPhaseCount;
+        int _interpTapCount;
+        int _batchSize = 1;
+
+        // Positions of the current batch, the symbols followed by the midpoints
+        int batchOffsets[2 * MAX_BATCH_SIZE];
+        int batchPhases[2 * MAX_BATCH_SIZE];
+        T midVals[MAX_BATCH_SIZE];
+
+        // Previous output storage
+        T lastOut = {};
+
+        int offset = 0;
+        int historySize;
+        T* buffer;
+    };
+}
@@ -4,12 +4,16 @@
 #include "../taps/windowed_sinc.h"
 #include "../multirate/polyphase_bank.h"
 #include "../math/step.h"
+#include "diagnostics.h"
 
 namespace dsp::clock_recovery {
     template<class T>
     class MM : public Processor<T, T> {
         using base_type = Processor<T, T> ;
     public:
+        // Most symbols that can be interpolated in one pass
+        static constexpr int MAX_BATCH_SIZE = 64;
+
         MM() {}
 
         MM(stream<T>* in, double omega, double omegaGain, double muGain, double omegaRelLimit, int interpPhaseCount = 128, int interpTapCount = 8) { init(in, omega, omegaGain, muGain, omegaRelLimit, interpPhaseCount, interpTapCount); }
@@ -33,6 +37,8 @@ namespace dsp::clock_recovery {
             generateInterpTaps();
             buffer = buffer::alloc<T>(STREAM_BUFFER_SIZE + _interpTapCount);
             bufStart = &buffer[_interpTapCount - 1];
+            diag.omega = _omega;
+            published = diag;
         
             base_type::init(in);
         }
@@ -84,6 +90,18 @@ namespace dsp::clock_recovery {
             base_type::tempStart();
         }
 
+        /**
+         * Set how many symbols are placed and interpolated at once. The timing loop is still updated for every symbol,
+         * but the corrections only move the symbols of the next batch. A size of 1 gives a per-symbol loop.
+         * @param batchSize Number of symbols per batch, up to MAX_BATCH_SIZE.
+        */
+        void setBatchSize(int batchSize) {
+            assert(base_type::_block_init);
+            assert(batchSize >= 1 && batchSize <= MAX_BATCH_SIZE);
+            std::lock_guard<std::recursive_mutex> lck(base_type::ctrlMtx);
+            _batchSize = batchSize;
+        }
+
         void reset() {
             assert(base_type::_block_init);
             std::lock_guard<std::recursive_mutex> lck(base_type::ctrlMtx);
@@ -94,9 +112,23 @@ namespace dsp::clock_recovery {
             lastOut = 0.0f;
             _p_0T = { 0.0f, 0.0f }; _p_1T = { 0.0f, 0.0f }; _p_2T = { 0.0f, 0.0f };
             _c_0T = { 0.0f, 0.0f }; _c_1T = { 0.0f, 0.0f }; _c_2T = { 0.0f, 0.0f };
+            diag.reset();
+            {
+                std::lock_guard<std::mutex> lck(diagMtx);
+                published = diag;
+            }
             base_type::tempStart();
         }
 
+        /**
+         * Get the state of the timing loop. Values are updated once per processed block.
+         * @return Timing diagnostics.
+        */
+        TimingDiagnostics getDiagnostics() {
+            std::lock_guard<std::mutex> lck(diagMtx);
+            return published;
+        }
+
         inline int process(int count, const T* in, T* out) {
             // Copy data to work buffer
             memcpy(bufStart, in, count * sizeof(T));
@@ -104,50 +136,65 @@ namespace dsp::clock_recovery {
             // Process all samples
             int outCount = 0;
             while (offset < count) {
-                float error;
-                T outVal;
-
-                // Calculate new output value
-                int phase = std::clamp<int>(floorf(pcl.phase * (float)_interpPhaseCount), 0, _interpPhaseCount - 1);
-                if constexpr (std::is_same_v<T, float>) {
-                    volk_32f_x2_dot_prod_32f(&outVal, &buffer[offset], interpBank.phases[phase], _interpTapCount);
-                }
-                if constexpr (std::is_same_v<T, complex_t>) {
-                    volk_32fc_32f_dot_prod_32fc((lv_32fc_t*)&outVal, (lv_32fc_t*)&buffer[offset], interpBank.phases[phase], _interpTapCount);
+                // Place the symbols of the batch assuming the timing doesn't change in between
+                int n = 0;
+                float pos = pcl.phase;
+                while (n < _batchSize) {
+                    float whole = floorf(pos);
+                    int symOffset = offset + (int)whole;
+                    if (symOffset >= count) { break; }
+                    batchOffsets[n] = symOffset;
+                    batchPhases[n] = std::clamp<int>(floorf((pos - whole) * (float)_interpPhaseCount), 0, _interpPhaseCount - 1);
+                    pos += pcl.freq;
+                    n++;
                 }
-                out[outCount++] = outVal;
 
-                // Calculate symbol phase error
-                if constexpr (std::is_same_v<T, float>) {
-                    error = (math::step(lastOut) * outVal) - (lastOut * math::step(outVal));
-                    lastOut = outVal;
-                }
-                if constexpr (std::is_same_v<T, complex_t>) {
-                    // Propagate delay
-                    _p_2T = _p_1T;
-                    _p_1T = _p_0T;
-                    _c_2T = _c_1T;
-                    _c_1T = _c_0T;
-
-                    // Update the T0 values
-                    _p_0T = outVal;
-                    _c_0T = math::step(outVal);
-
-                    // Error
-                    error = (((_p_0T - _p_2T) * _c_1T.conj()) - ((_c_0T - _c_2T) * _p_1T.conj())).re;
-                }
+                // Interpolate the whole batch at once
+                interpolate(n, &out[outCount]);
 
-                // Clamp symbol phase error
-                if (error > 1.0f) { error = 1.0f; }
-                if (error < -1.0f) { error = -1.0f; }
+                for (int i = 0; i < n; i++) {
+                    T outVal = out[outCount + i];
+                    float error;
 
-                // Advance symbol offset and phase
-                pcl.advance(error);
-                float delta = floorf(pcl.phase);
-                offset += delta;
-                pcl.phase -= delta;
+                    // Calculate symbol phase error
+                    if constexpr (std::is_same_v<T, float>) {
+                        error = (math::step(lastOut) * outVal) - (lastOut * math::step(outVal));
+                        lastOut = outVal;
+                    }
+                    if constexpr (std::is_same_v<T, complex_t>) {
+                        // Propagate delay
+                        _p_2T = _p_1T;
+                        _p_1T = _p_0T;
+                        _c_2T = _c_1T;
+                        _c_1T = _c_0T;
+
+                        // Update the T0 values
+                        _p_0T = outVal;
+                        _c_0T = math::step(outVal);
+
+                        // Error
+                        error = (((_p_0T - _p_2T) * _c_1T.conj()) - ((_c_0T - _c_2T) * _p_1T.conj())).re;
+                    }
+
+                    // Clamp symbol phase error
+                    if (error > 1.0f) { error = 1.0f; }
+                    if (error < -1.0f) { error = -1.0f; }
+                    diag.update(error);
+
+                    // Advance symbol offset and phase
+                    pcl.advance(error);
+                    float delta = floorf(pcl.phase);
+                    offset += delta;
+                    pcl.phase -= delta;
+                }
+                outCount += n;
             }
             offset -= count;
+            diag.omega = pcl.freq;
+            {
+                std::lock_guard<std::mutex> lck(diagMtx);
+                published = diag;
+            }
 
             // Update delay buffer
             memmove(buffer, &buffer[count], (_interpTapCount - 1) * sizeof(T));
@@ -170,6 +217,17 @@ namespace dsp::clock_recovery {
         }
 
     protected:
+        inline void interpolate(int n, T* out) {
+            for (int i = 0; i < n; i++) {
+                if constexpr (std::is_same_v<T, float>) {
+                    volk_32f_x2_dot_prod_32f(&out[i], &buffer[batchOffsets[i]], interpBank.phases[batchPhases[i]], _interpTapCount);
+                }
+                if constexpr (std::is_same_v<T, complex_t>) {
+                    volk_32fc_32f_dot_prod_32fc((lv_32fc_t*)&out[i], (lv_32fc_t*)&buffer[batchOffsets[i]], interpBank.phases[batchPhases[i]], _interpTapCount);
+                }
+            }
+        }
+
         void generateInterpTaps() {
             double bw = 0.5 / (double)_interpPhaseCount;
             dsp::tap<float> lp = dsp::taps::windowedSinc<float>(_interpPhaseCount * _interpTapCount, dsp::math::hzToRads(bw, 1.0), dsp::window::nuttall, _interpPhaseCount);
@@ -180,12 +238,22 @@ namespace dsp::clock_recovery {
         dsp::multirate::PolyphaseBank<float> interpBank;
         loop::PhaseControlLoop<float, false> pcl;
 
+        // Diagnostics are accumulated by the DSP thread and published once per block for the UI
+        TimingDiagnostics diag;
+        TimingDiagnostics published;
+        std::mutex diagMtx;
+
         double _omega;
         double _omegaGain;
         double _muGain;
         double _omegaRelLimit;
         int _interpPhaseCount;
         int _interpTapCount;
+        int _batchSize = 1;
+
+        // Symbol positions of the current batch
+        int batchOffsets[MAX_BATCH_SIZE];
+        int batchPhases[MAX_BATCH_SIZE];
 
         // Previous output storage
         float lastOut = 0.0f;
@@ -0,0 +1,181 @@
+#pragma once
+#include <stdint.h>
+#include <volk/volk.h>
+#include "../types.h"
+#include "../buffer/buffer.h"
+
+// Conversion of the native IQ formats of devices and network protocols to complex float. All functions take
+// the number of complex samples and scale the output to roughly [-1.0, 1.0].
+namespace dsp::convert {
+    // DC offset and gain correction applied to the converted samples: out = (in - offset) * gain
+    struct IQCorrection {
+        float offsetI = 0.0f;
+        float offsetQ = 0.0f;
+        float gainI = 1.0f;
+        float gainQ = 1.0f;
+
+        bool isIdentity() const {
+            return offsetI == 0.0f && offsetQ == 0.0f && gainI == 1.0f && gainQ == 1.0f;
+        }
+
+        bool operator==(const IQCorrection& b) const {
+            return offsetI == b.offsetI && offsetQ == b.offsetQ && gainI == b.gainI && gainQ == b.gainQ;
+        }
+    };
+
+    /**
+     * Apply a DC offset and gain correction in place.
+     * @param data Samples to correct.
+     * @param count Number of samples.
+     * @param corr Correction to apply.
+    */
+    inline void correct(complex_t* data, int count, const IQCorrection& corr) {
+        if (corr.isIdentity()) { return; }
+        for (int i = 0; i < count; i++) {
+            data[i].re = (data[i].re - corr.offsetI) * corr.gainI;
+            data[i].im = (data[i].im - corr.offsetQ) * corr.gainQ;
+        }
+    }
+
+    /**
+     * Convert interleaved signed 8bit IQ.
+     * @param in Input samples.
+     * @param out Output samples.
+     * @param count Number of IQ pairs.
+     * @param scale Value that maps to 1.0.
+    */
+    inline void s8ToComplex(const int8_t* in, complex_t* out, int count, float scale = 128.0f, const IQCorrection& corr = IQCorrection()) {
+        volk_8i_s32f_convert_32f((float*)out, in, scale, count * 2);
+        correct(out, count, corr);
+    }
+
+    /**
+     * Convert interleaved signed 16bit IQ.
+     * @param in Input samples.
+     * @param out Output samples.
+     * @param count Number of IQ pairs.
+     * @param scale Value that maps to 1.0.
+    */
+    inline void s16ToComplex(const int16_t* in, complex_t* out, int count, float scale = 32768.0f, const IQCorrection& corr = IQCorrection()) {
+        volk_16i_s32f_convert_32f((float*)out, in, scale, count * 2);
+        correct(out, count, corr);
+    }
+
+    /**
+     * Convert interleaved signed 32bit IQ.
+     * @param in Input samples.
+     * @param out Output samples.
+     * @param count Number of IQ pairs.
+     * @param scale Value that maps to 1.0.
+    */
+    inline void s32ToComplex(const int32_t* in, complex_t* out, int count, float scale = 2147483647.0f, const IQCorrection& corr = IQCorrection()) {
+        volk_32i_s32f_convert_32f((float*)out, in, scale, count * 2);
+        correct(out, count, corr);
+    }
+
+    /**
+     * Convert packed signed 12bit IQ, where each pair takes three bytes: the low 8 bits of I, the high 4 bits of I
+     * in the low nibble along with the low 4 bits of Q in the high nibble, then the high 8 bits of Q.
+     * @param in Input bytes.
+     * @param out Output samples.
+     * @param count Number of IQ pairs.
+     * @param scale Value that maps to 1.0.
+    */
+    inline void s12PackedToComplex(const uint8_t* in, complex_t* out, int count, float scale = 2048.0f, const IQCorrection& corr = IQCorrection()) {
+        float mul = 1.0f / scale;
+        for (int i = 0; i < count; i++) {
+            const uint8_t* p = &in[i * 3];
+            // Shift the 12 bits to the top of a 16bit word and back down to sign extend them
+            int16_t re = (int16_t)(((uint16_t)p[0] << 4) | ((uint16_t)(p[1] & 0x0F) << 12)) >> 4;
+            int16_t im = (int16_t)(((uint16_t)(p[1] & 0xF0)) | ((uint16_t)p[2] << 8)) >> 4;
+            out[i].re = (float)re * mul;
+            out[i].im = (float)im * mul;
+        }
+        correct(out, count, corr);
+    }
+
+    /**
+     * Convert interleaved signed 24bit little endian IQ.
+     * @param in Input bytes.
+     * @param out Output samples.
+     * @param count Number of IQ pairs.
+     * @param scale Value that maps to 1.0.
+    */
+    inline void s24ToComplex(const uint8_t* in, complex_t* out, int count, float scale = 8388608.0f, const IQCorrection& corr = IQCorrection()) {
+        float mul = 1.0f / scale;
+        for (int i = 0; i < count; i++) {
+            const uint8_t* p = &in[i * 6];
+            int32_t re = (int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24)) >> 8;
+            int32_t im = (int32_t)(((uint32_t)p[3] << 8) | ((uint32_t)p[4] << 16) | ((uint32_t)p[5] << 24)) >> 8;
+            out[i].re = (float)re * mul;
+            out[i].im = (float)im * mul;
+        }
+        correct(out, count, corr);
+    }
+
+    // Converts 8bit IQ through a table of every possible pair, with the offset, scale and correction folded in.
+    // A conversion is then a single lookup per sample, which beats the arithmetic for offset binary input.
+    class IQTable8 {
+    public:
+        IQTable8() {}
+
+        IQTable8(bool isSigned, float center, float scale, const IQCorrection& corr = IQCorrection()) { init(isSigned, center, scale, corr); }
+
+        ~IQTable8() {
+            if (!table) { return; }
+            buffer::free(table);
+        }
+
+        // Owns its table, can't be copied
+        IQTable8(const IQTable8& b) = delete;
+        IQTable8& operator=(const IQTable8& b) = delete;
+
+        /**
+         * Set the conversion parameters. The table is only rebuilt if they changed.
+         * @param isSigned True for two's complement input, false for offset binary.
+         * @param center Input value that maps to 0.0.
+         * @param scale Distance from the center that maps to 1.0.
+         * @param corr Correction applied after scaling.
+        */
+        void init(bool isSigned, float center, float scale, const IQCorrection& corr = IQCorrection()) {
+            if (table && isSigned == _isSigned && center == _center && scale == _scale && corr == _corr) { return; }
+            _isSigned = isSigned;
+            _center = center;
+            _scale = scale;
+            _corr = corr;
+
+            float values[256];
+            for (int i = 0; i < 256; i++) {
+                float raw = isSigned ? (float)(int8_t)i : (float)i;
+                values[i] = (raw - center) / scale;
+            }
+
+            if (!table) { table = buffer::alloc<complex_t>(65536); }
+            for (int q = 0; q < 256; q++) {
+                float im = (values[q] - corr.offsetQ) * corr.gainQ;
+                for (int i = 0; i < 256; i++) {
+                    table[(q << 8) | i] = { (values[i] - corr.offsetI) * corr.gainI, im };
+                }
+            }
+        }
+
+        /**
+         * Convert interleaved IQ bytes.
+         * @param in Input bytes.
+         * @param out Output samples.
+         * @param count Number of IQ pairs.
+        */
+        inline void convert(const uint8_t* in, complex_t* out, int count) {
+            for (int i = 0; i < count; i++) {
+                out[i] = table[in[2 * i] | (in[(2 * i) + 1] << 8)];
+            }
+        }
+
+    private:
+        complex_t* table = NULL;
+        bool _isSigned = false;
+        float _center = 0.0f;
+        float _scale = 1.0f;
+        IQCorrection _corr;
+    };
+}
@@ -0,0 +1,251 @@
+#pragma once
+#include "../types.h"
+#include <stdint.h>
+#include <math.h>
+#include <bitset>
+#include <vector>
+
+namespace dsp::digital {
+    enum SyncVariants {
+        SYNC_VARIANTS_NONE,     // Only the pattern itself
+        SYNC_VARIANTS_INVERTED, // Pattern and its inverse, for a polarity ambiguity
+        SYNC_VARIANTS_QPSK      // Pattern rotated by 0, 90, 180 and 270 degrees, for the phase ambiguity of QPSK
+    };
+
+    struct SyncMatch {
+        // ID of the matching pattern as returned by addPattern()
+        int pattern;
+
+        // Index of the variant. 1 means inverted for SYNC_VARIANTS_INVERTED, k means rotated by k*90 degrees
+        // counter-clockwise for SYNC_VARIANTS_QPSK
+        int variant;
+
+        // Number of bit errors
+        int errors;
+
+        // Correlation between -1 and 1 of the input with the variant, weighted by the soft bits if available
+        float score;
+    };
+
+    // Searches a bit stream for one or several sync words. Every bit is pushed into a shift register that is
+    // compared against all patterns at once using their hamming distance. The soft correlation is only computed
+    // for candidates, so searching noise costs little more than a popcount per pattern and bit.
+    class SyncSearch {
+    public:
+        static constexpr int MAX_BITS = 128;
+
+        SyncSearch() {}
+
+        /**
+         * Add a pattern to search for.
+         * @param bits Pattern bits, one per byte, in the order they are received.
+         * @param len Number of bits, at most MAX_BITS and even for SYNC_VARIANTS_QPSK.
+         * @param maxErrors Maximum number of bit errors for a match.
+         * @param variants Variants of the pattern to search for as well.
+         * @return ID of the pattern.
+        */
+        int addPattern(const uint8_t* bits, int len, int maxErrors, SyncVariants variants = SYNC_VARIANTS_NONE) {
+            Word word = { 0, 0 };
+            for (int i = 0; i < len; i++) { shiftIn(word, bits[i] & 1); }
+            return addPattern(word, len, maxErrors, variants);
+        }
+
+        /**
+         * Add a pattern to search for.
+         * @param word Pattern bits, the last received one being the least significant.
+         * @param len Number of bits, at most 64 and even for SYNC_VARIANTS_QPSK.
+         * @param maxErrors Maximum number of bit errors for a match.
+         * @param variants Variants of the pattern to search for as well.
+         * @return ID of the pattern.
+        */
+        int addPattern(uint64_t word, int len, int maxErrors, SyncVariants variants = SYNC_VARIANTS_NONE) {
+            return addPattern(Word{ word, 0 }, len, maxErrors, variants);
+        }
+
+        /**
+         * Remove all patterns.
+        */
+        void clear() {
+            entries.clear();
+            patternCount = 0;
+            reset();
+        }
+
+        /**
+         * Forget the previously received bits, for example after reading a frame.
+        */
+        void reset() {
+            shift = { 0, 0 };
+            filled = 0;
+        }
+
+        /**
+         * Search hard bits for a pattern.
+         * @param in Input bits, one per byte.
+         * @param count Number of input bits.
+         * @param match Description of the match if one was found.
+         * @return Index of the last bit of the sync word, or -1 if none was found in the input.
+        */
+        int search(const uint8_t* in, int count, SyncMatch& match) {
+            for (int i = 0; i < count; i++) {
+                push(in[i] & 1);
+                if (check(match, false)) { return i; }
+            }
+            return -1;
+        }
+
+        /**
+         * Search soft bits for a pattern.
+         * @param in Input soft bits, positive meaning a 1.
+         * @param count Number of input bits.
+         * @param match Description of the match if one was found.
+         * @return Index of the last bit of the sync word, or -1 if none was found in the input.
+        */
+        int search(const float* in, int count, SyncMatch& match) {
+            for (int i = 0; i < count; i++) {
+                pushSoft(in[i]);
+                if (check(match, true)) { return i; }
+            }
+            return -1;
+        }
+
+        /**
+         * Search QPSK symbols for a pattern. Each symbol carries two bits, the sign of I then the sign of Q.
+         * @param in Input symbols.
+         * @param count Number of input symbols.
+         * @param match Description of the match if one was found.
+         * @return Index of the last symbol of the sync word, or -1 if none was found in the input.
+        */
+        int search(const complex_t* in, int count, SyncMatch& match) {
+            for (int i = 0; i < count; i++) {
+                pushSoft(in[i].re);
+                pushSoft(in[i].im);
+                if (check(match, true)) { return i; }
+            }
+            return -1;
+        }
+
+    private:
+        struct Word {
+            uint64_t low;
+            uint64_t high;
+        };
+
+        struct Entry {
+            Word word;
+            Word mask;
+            int len;
+            int maxErrors;
+            int pattern;
+            int variant;
+        };
+
+        static inline void shiftIn(Word& w, uint64_t bit) {
+            w.high = (w.high << 1) | (w.low >> 63);
+            w.low = (w.low << 1) | bit;
+        }
+
+        static inline int distance(const Word& a, const Word& b, const Word& mask) {
+            return std::bitset<64>((a.low ^ b.low) & mask.low).count() + std::bitset<64>((a.high ^ b.high) & mask.high).count();
+        }
+
+        static inline int bitAt(const Word& w, int age) {
+            return (age < 64) ? ((w.low >> age) & 1) : ((w.high >> (age - 64)) & 1);
+        }
+
+        int addPattern(Word word, int len, int maxErrors, SyncVariants variants) {
+            if (len <= 0 || len > MAX_BITS) { return -1; }
+            if (variants == SYNC_VARIANTS_QPSK && (len & 1)) { return -1; }
+
+            Entry e;
+            e.mask.low = (len >= 64) ? ~0ull : ((1ull << len) - 1);
+            e.mask.high = (len > 64) ? ((len >= 128) ? ~0ull : ((1ull << (len - 64)) - 1)) : 0;
+            e.len = len;
+            e.maxErrors = maxErrors;
+            e.pattern = patternCount++;
+
+            // Add the pattern and its variants
+            e.word = word;
+            e.variant = 0;
+            entries.push_back(e);
+            if (variants == SYNC_VARIANTS_INVERTED) {
+                e.word = { ~word.low, ~word.high };
+                e.variant = 1;
+                entries.push_back(e);
+            }
+            else if (variants == SYNC_VARIANTS_QPSK) {
+                for (int k = 1; k < 4; k++) {
+                    e.word = rotate(e.word, len);
+                    e.variant = k;
+                    entries.push_back(e);
+                }
+            }
+
+            return e.pattern;
+        }
+
+        // Rotate QPSK symbols by 90 degrees counter-clockwise: 00 -> 10 -> 11 -> 01 -> 00
+        static Word rotate(const Word& w, int len) {
+            static const uint8_t ROT[4] = { 0b10, 0b00, 0b11, 0b01 };
+            Word out = { 0, 0 };
+            for (int age = len - 2; age >= 0; age -= 2) {
+                uint8_t sym = (bitAt(w, age + 1) << 1) | bitAt(w, age);
+                uint8_t rsym = ROT[sym];
+                shiftIn(out, rsym >> 1);
+                shiftIn(out, rsym & 1);
+            }
+            return out;
+        }
+
+        inline void push(uint64_t bit) {
+            shiftIn(shift, bit);
+            if (filled < MAX_BITS) { filled++; }
+        }
+
+        inline void pushSoft(float val) {
+            hist[histPos] = val;
+            histPos = (histPos + 1) % MAX_BITS;
+            push(val > 0.0f);
+        }
+
+        bool check(SyncMatch& match, bool soft) {
+            // Find the variant with the least errors
+            const Entry* best = NULL;
+            int bestErrors = 0;
+            for (const auto& e : entries) {
+                if (filled < e.len) { continue; }
+                int errors = distance(shift, e.word, e.mask);
+                if (errors > e.maxErrors || (best && errors >= bestErrors)) { continue; }
+                best = &e;
+                bestErrors = errors;
+            }
+            if (!best) { return false; }
+
+            match.pattern = best->pattern;
+            match.variant = best->variant;
+            match.errors = bestErrors;
+            match.score = soft ? softScore(*best) : (1.0f - (2.0f * (float)bestErrors / (float)best->len));
+            return true;
+        }
+
+        float softScore(const Entry& e) {
+            float corr = 0.0f;
+            float energy = 0.0f;
+            for (int age = 0; age < e.len; age++) {
+                float val = hist[(histPos + MAX_BITS - 1 - age) % MAX_BITS];
+                corr += bitAt(e.word, age) ? val : -val;
+                energy += fabsf(val);
+            }
+            return (energy > 0.0f) ? (corr / energy) : 0.0f;
+        }
+
+        std::vector<Entry> entries;
+        int patternCount = 0;
+
+        Word shift = { 0, 0 };
+        int filled = 0;
+
+        float hist[MAX_BITS] = { 0 };
+        int histPos = 0;
+    };
+}
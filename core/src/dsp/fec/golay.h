@@ -0,0 +1,83 @@
+#pragma once
+#include <stdint.h>
+
+namespace dsp::fec::golay24 {
+    // Generator polynomial of the Golay(23, 12) code
+    inline const uint16_t POLY = 0xC75;
+
+    // Codewords are laid out as data(12) | check(11) | parity(1), from the most significant bit
+    struct Tables {
+        Tables() {
+            // Check bits of every possible data word
+            for (uint32_t data = 0; data < 4096; data++) {
+                uint32_t reg = data;
+                for (int i = 0; i < 12; i++) {
+                    if (reg & 1) { reg ^= POLY; }
+                    reg >>= 1;
+                }
+                check[data] = reg & 0x7FF;
+            }
+
+            // The code is perfect, every syndrome matches exactly one error pattern of up to 3 bits
+            for (int i = 0; i < 23; i++) {
+                add(1 << i);
+                for (int j = i + 1; j < 23; j++) {
+                    add((1 << i) | (1 << j));
+                    for (int k = j + 1; k < 23; k++) {
+                        add((1 << i) | (1 << j) | (1 << k));
+                    }
+                }
+            }
+        }
+
+        inline uint16_t syndrome(uint32_t codeword23) const {
+            return check[(codeword23 >> 11) & 0xFFF] ^ (codeword23 & 0x7FF);
+        }
+
+        void add(uint32_t pattern) { errors[syndrome(pattern)] = pattern; }
+
+        uint16_t check[4096];
+        uint32_t errors[2048] = { 0 };
+    };
+
+    inline const Tables& tables() {
+        static const Tables t;
+        return t;
+    }
+
+    inline int popcount(uint32_t n) {
+        int count = 0;
+        for (; n; n &= n - 1) { count++; }
+        return count;
+    }
+
+    /**
+     * Encode 12 bits of data.
+     * @param data Data in the 12 least significant bits.
+     * @return Extended Golay(24, 12) codeword.
+    */
+    inline uint32_t encode(uint16_t data) {
+        data &= 0xFFF;
+        uint32_t codeword23 = ((uint32_t)data << 11) | tables().check[data];
+        return (codeword23 << 1) | (popcount(codeword23) & 1);
+    }
+
+    /**
+     * Decode a codeword, correcting up to 3 errors.
+     * @param codeword Extended Golay(24, 12) codeword.
+     * @param data Decoded data in the 12 least significant bits.
+     * @return True on success, false if there were too many errors.
+    */
+    inline bool decode(uint32_t codeword, uint16_t& data) {
+        const Tables& tbl = tables();
+        uint32_t codeword23 = (codeword >> 1) & 0x7FFFFF;
+        uint32_t pattern = tbl.errors[tbl.syndrome(codeword23)];
+        codeword23 ^= pattern;
+
+        // With 3 corrected errors, the parity tells 4 errors apart
+        if (popcount(pattern) == 3 && (popcount(codeword23) & 1) != (codeword & 1)) { return false; }
+
+        data = codeword23 >> 11;
+        return true;
+    }
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <algorithm>
+
+extern "C" {
+#include <correct.h>
+#ifdef HAVE_SSE
+#include <correct-sse.h>
+#endif
+}
+
+namespace dsp::fec {
+    // Convolutional encoder and soft decision Viterbi decoder. Uses the SSE4.1 implementation of libcorrect when
+    // it was built with it, which is several times faster than the generic one for the common K=7 codes.
+    class Viterbi {
+    public:
+        Viterbi() {}
+
+        /**
+         * Create a convolutional codec.
+         * @param rate Inverse of the code rate, number of polynomials.
+         * @param order Constraint length.
+         * @param poly Polynomials, such as correct_conv_r12_7_polynomial.
+        */
+        Viterbi(int rate, int order, const correct_convolutional_polynomial_t* poly) { init(rate, order, poly); }
+
+        ~Viterbi() { free(); }
+
+        // Owns the libcorrect instance, can't be copied
+        Viterbi(const Viterbi& b) = delete;
+        Viterbi& operator=(const Viterbi& b) = delete;
+
+        /**
+         * Configure the codec.
+         * @param rate Inverse of the code rate, number of polynomials.
+         * @param order Constraint length.
+         * @param poly Polynomials, such as correct_conv_r12_7_polynomial.
+        */
+        void init(int rate, int order, const correct_convolutional_polynomial_t* poly) {
+            free();
+#ifdef HAVE_SSE
+            conv = correct_convolutional_sse_create(rate, order, poly);
+#else
+            conv = correct_convolutional_create(rate, order, poly);
+#endif
+        }
+
+        /**
+         * Get the number of encoded bits for a message.
+         * @param len Length of the message in bytes.
+         * @return Number of encoded bits, including the flush bits.
+        */
+        int getEncodedBits(int len) {
+#ifdef HAVE_SSE
+            return correct_convolutional_sse_encode_len(conv, len);
+#else
+            return correct_convolutional_encode_len(conv, len);
+#endif
+        }
+
+        /**
+         * Encode a message.
+         * @param msg Message bytes.
+         * @param len Length of the message in bytes.
+         * @param out Output packed bits, at least (getEncodedBits(len)+7)/8 bytes.
+         * @return Number of output bits.
+        */
+        int encode(const uint8_t* msg, int len, uint8_t* out) {
+#ifdef HAVE_SSE
+            return correct_convolutional_sse_encode(conv, msg, len, out);
+#else
+            return correct_convolutional_encode(conv, msg, len, out);
+#endif
+        }
+
+        /**
+         * Decode hard bits.
+         * @param in Input packed bits.
+         * @param bits Number of input bits.
+         * @param out Output message bytes.
+         * @return Number of output bytes, -1 on error.
+        */
+        int decode(const uint8_t* in, int bits, uint8_t* out) {
+#ifdef HAVE_SSE
+            return correct_convolutional_sse_decode(conv, in, bits, out);
+#else
+            return correct_convolutional_decode(conv, in, bits, out);
+#endif
+        }
+
+        /**
+         * Decode soft bits.
+         * @param in Input soft bits, one per byte, 0 being a certain 0 and 255 a certain 1.
+         * @param bits Number of input bits.
+         * @param out Output message bytes.
+         * @return Number of output bytes, -1 on error.
+        */
+        int decodeSoft(const uint8_t* in, int bits, uint8_t* out) {
+#ifdef HAVE_SSE
+            return correct_convolutional_sse_decode_soft(conv, in, bits, out);
+#else
+            return correct_convolutional_decode_soft(conv, in, bits, out);
+#endif
+        }
+
+        /**
+         * Decode soft symbols.
+         * @param in Input soft bits, -1.0 being a certain 0 and 1.0 a certain 1.
+         * @param bits Number of input bits.
+         * @param out Output message bytes.
+         * @return Number of output bytes, -1 on error.
+        */
+        int decodeSoft(const float* in, int bits, uint8_t* out) {
+            if (soft.size() < bits) { soft.resize(bits); }
+            for (int i = 0; i < bits; i++) {
+                soft[i] = std::clamp<int>((in[i] * 127.0f) + 128.0f, 0, 255);
+            }
+            return decodeSoft(soft.data(), bits, out);
+        }
+
+    private:
+        void free() {
+            if (!conv) { return; }
+#ifdef HAVE_SSE
+            correct_convolutional_sse_destroy(conv);
+#else
+            correct_convolutional_destroy(conv);
+#endif
+            conv = NULL;
+        }
+
+#ifdef HAVE_SSE
+        correct_convolutional_sse* conv = NULL;
+#else
+        correct_convolutional* conv = NULL;
+#endif
+        std::vector<uint8_t> soft;
+    };
+}
@@ -29,6 +29,9 @@ namespace dsp::multirate {
             return 1 << decim::plans_len;
         }
 
+        // Group delay of all stages, in input samples
+        inline double getGroupDelay() { return groupDelay; }
+
         void setRatio(unsigned int ratio) {
             assert(base_type::_block_init);
             std::lock_guard<std::recursive_mutex> lck(base_type::ctrlMtx);
@@ -93,16 +96,20 @@ namespace dsp::multirate {
             freeFirs();
 
             // Generate filters based on DDC plan
+            groupDelay = 0.0;
             if (_ratio > 1) {
                 int planId = log2(_ratio) - 1;
                 decim::plan plan = decim::plans[planId];
                 stageCount = plan.stageCount;
+                int step = 1;
                 for (int i = 0; i < stageCount; i++) {
                     tap<float> taps = taps::fromArray<float>(plan.stages[i].tapcount, plan.stages[i].taps);
                     auto fir = new filter::DecimatingFIR<T, float>(NULL, taps, plan.stages[i].decimation);
                     fir->out.free();
                     decimTaps.push_back(taps);
                     decimFirs.push_back(fir);
+                    groupDelay += (double)(plan.stages[i].tapcount - 1) / 2.0 * (double)step;
+                    step *= plan.stages[i].decimation;
                 }
             }
         }
@@ -116,5 +123,6 @@ namespace dsp::multirate {
         std::vector<tap<float>> decimTaps;
         unsigned int _ratio;
         int stageCount;
+        double groupDelay = 0.0;
     };
 }
\ No newline at end of file
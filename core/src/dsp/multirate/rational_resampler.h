@@ -79,6 +79,9 @@ namespace dsp::multirate {
             base_type::tempStart();
         }
 
+        // Group delay of the decimator and resampler filters, in seconds
+        inline double getGroupDelay() { return groupDelay; }
+
         inline int process(int count, const T* in, T* out) {
             switch(mode) {
                 case Mode::BOTH:
@@ -125,9 +128,11 @@ namespace dsp::multirate {
 
             // Configure the DDC
             bool useDecim = (_inSamplerate > _outSamplerate && predecPower > 0);
+            groupDelay = 0.0;
             if (useDecim) {
                 intSamplerate = _inSamplerate / (double)predecRatio;
                 decim.setRatio(predecRatio);
+                groupDelay = decim.getGroupDelay() / _inSamplerate;
             }
 
             // Calculate interpolation and decimation for polyphase resampler
@@ -158,6 +163,7 @@ namespace dsp::multirate {
             rtaps = taps::lowPass(tapBandwidth, tapTransWidth, tapSamplerate);
             for (int i = 0; i < rtaps.size; i++) { rtaps.taps[i] *= (float)interp; }
             resamp.setRatio(interp, decim, rtaps);
+            groupDelay += (double)(rtaps.size - 1) / 2.0 / tapSamplerate;
 
             printf("[Resamp] predec: %d, interp: %d, decim: %d, inacc: %lf%%, taps: %d\n", predecRatio, interp, decim, error, rtaps.size);
 
@@ -169,6 +175,7 @@ namespace dsp::multirate {
         tap<float> rtaps;
         double _inSamplerate;
         double _outSamplerate;
+        double groupDelay = 0.0;
         Mode mode;
     };
 }
\ No newline at end of file
@@ -22,6 +22,7 @@
 #include <gui/menus/theme.h>
 #include <gui/dialogs/credits.h>
 #include <filesystem>
+#include <algorithm>
 #include <signal_path/source.h>
 #include <gui/dialogs/loading_screen.h>
 #include <gui/colormaps.h>
@@ -132,15 +133,50 @@ void MainWindow::init() {
 #endif
     }
 
-    // Create module instances
+    // Create module instances. Disabled ones are only created once enabled, a placeholder menu entry lets the user do so.
+    // Enabled sources other than the selected one are only created once selected, using the source names they registered last time.
+    instanceDeleteHandlerObj.handler = instanceDeleteHandler;
+    instanceDeleteHandlerObj.ctx = this;
+    core::moduleManager.onInstanceDelete.bindHandler(&instanceDeleteHandlerObj);
+    instanceRealizedHandlerObj.handler = instanceRealizedHandler;
+    instanceRealizedHandlerObj.ctx = this;
+    core::moduleManager.onInstanceRealized.bindHandler(&instanceRealizedHandlerObj);
+    core::configManager.acquire();
+    std::string selectedSource = core::configManager.conf["source"];
+    json lastSources = core::configManager.conf["instanceSources"];
+    core::configManager.release();
+    json instanceSources = json::object();
     for (auto const& [name, _module] : modList) {
         std::string mod = _module["module"];
         bool enabled = _module["enabled"];
+        if (lastSources.contains(name)) { instanceSources[name] = lastSources[name]; }
+        if (!enabled) {
+            flog::info("Deferring {0} ({1}) until enabled", name, mod);
+            if (core::moduleManager.createInstance(name, mod, true)) { continue; }
+            gui::menu.registerEntry(name, deferredMenuHandler, NULL, core::moduleManager.instances[name].instance);
+            continue;
+        }
+
+        std::vector<std::string> srcNames;
+        if (lastSources.contains(name)) { srcNames = lastSources[name].get<std::vector<std::string>>(); }
+        if (!srcNames.empty() && std::find(srcNames.begin(), srcNames.end(), selectedSource) == srcNames.end()) {
+            flog::info("Deferring {0} ({1}) until one of its sources is selected", name, mod);
+            if (core::moduleManager.createInstance(name, mod, true, true)) { continue; }
+            for (auto const& srcName : srcNames) {
+                deferredSourceInstances[srcName] = name;
+                sigpath::sourceManager.registerDeferredSource(srcName, deferredSourceHandler, this);
+            }
+            continue;
+        }
+
         flog::info("Initializing {0} ({1})", name, mod);
         LoadingScreen::show("Initializing " + name + " (" + mod + ")");
-        core::moduleManager.createInstance(name, mod);
-        if (!enabled) { core::moduleManager.disableInstance(name); }
+        instanceSources[name] = createSourceInstance(name, mod);
+        if (instanceSources[name].empty()) { instanceSources.erase(name); }
     }
+    core::configManager.acquire();
+    core::configManager.conf["instanceSources"] = instanceSources;
+    core::configManager.releaseKey("instanceSources");
 
     // Load color maps
     LoadingScreen::show("Loading color maps");
@@ -225,6 +261,65 @@ void MainWindow::init() {
     initComplete = true;
 
     core::moduleManager.doPostInitAll();
+    core::moduleManager.printStartupReport();
+}
+
+std::vector<std::string> MainWindow::createSourceInstance(std::string name, std::string module) {
+    // Note the sources registered by the new instance
+    std::vector<std::string> before = sigpath::sourceManager.getSourceNames();
+    std::vector<std::string> srcNames;
+    if (core::moduleManager.createInstance(name, module)) { return srcNames; }
+    for (auto const& srcName : sigpath::sourceManager.getSourceNames()) {
+        if (std::find(before.begin(), before.end(), srcName) == before.end()) { srcNames.push_back(srcName); }
+    }
+    return srcNames;
+}
+
+void MainWindow::instanceDeleteHandler(std::string name, void* ctx) {
+    MainWindow* _this = (MainWindow*)ctx;
+
+    // Remove the placeholder entry of deferred instances, real instances remove their own
+    gui::menu.removeEntry(name);
+
+    // Same for the sources listed for a deferred instance
+    for (auto it = _this->deferredSourceInstances.begin(); it != _this->deferredSourceInstances.end();) {
+        if (it->second != name) {
+            it++;
+            continue;
+        }
+        sigpath::sourceManager.unregisterDeferredSource(it->first);
+        it = _this->deferredSourceInstances.erase(it);
+    }
+}
+
+void MainWindow::instanceRealizedHandler(std::string name, void* ctx) {
+    MainWindow* _this = (MainWindow*)ctx;
+
+    // Modules without a menu of their own leave the placeholder entry in place, it must not keep the freed placeholder
+    gui::menu.setEntryInstance(name, core::moduleManager.instances[name].instance);
+
+    // The real instance registered its sources, drop the listed ones it no longer provides
+    for (auto it = _this->deferredSourceInstances.begin(); it != _this->deferredSourceInstances.end();) {
+        if (it->second != name) {
+            it++;
+            continue;
+        }
+        auto srcNames = sigpath::sourceManager.getSourceNames();
+        bool registered = std::find(srcNames.begin(), srcNames.end(), it->first) != srcNames.end();
+        if (!registered) { sigpath::sourceManager.unregisterDeferredSource(it->first); }
+        it = _this->deferredSourceInstances.erase(it);
+    }
+}
+
+void MainWindow::deferredSourceHandler(std::string name, void* ctx) {
+    MainWindow* _this = (MainWindow*)ctx;
+    auto it = _this->deferredSourceInstances.find(name);
+    if (it == _this->deferredSourceInstances.end()) { return; }
+    core::moduleManager.enableInstance(it->second);
+}
+
+void MainWindow::deferredMenuHandler(void* ctx) {
+    ImGui::TextDisabled("Enable to load this module");
 }
 
 float* MainWindow::acquireFFTBuffer(void* ctx) {
@@ -276,7 +371,7 @@ void MainWindow::draw() {
             gui::freqSelect.frequencyChanged = false;
             core::configManager.acquire();
             core::configManager.conf["vfoOffsets"][gui::waterfall.selectedVFO] = vfo->generalOffset;
-            core::configManager.release(true);
+            core::configManager.releaseKey("vfoOffsets");
         }
     }
 
@@ -318,7 +413,7 @@ void MainWindow::draw() {
         }
         core::configManager.acquire();
         core::configManager.conf["frequency"] = gui::waterfall.getCenterFrequency();
-        core::configManager.release(true);
+        core::configManager.releaseKey("frequency");
     }
 
     int _fftHeight = gui::waterfall.getFFTHeight();
@@ -326,7 +421,7 @@ void MainWindow::draw() {
         fftHeight = _fftHeight;
         core::configManager.acquire();
         core::configManager.conf["fftHeight"] = fftHeight;
-        core::configManager.release(true);
+        core::configManager.releaseKey("fftHeight");
     }
 
     // To Bar
@@ -337,7 +432,7 @@ void MainWindow::draw() {
         showMenu = !showMenu;
         core::configManager.acquire();
         core::configManager.conf["showMenu"] = showMenu;
-        core::configManager.release(true);
+        core::configManager.releaseKey("showMenu");
     }
     ImGui::PopID();
 
@@ -387,7 +482,7 @@ void MainWindow::draw() {
             gui::waterfall.VFOMoveSingleClick = false;
             core::configManager.acquire();
             core::configManager.conf["centerTuning"] = false;
-            core::configManager.release(true);
+            core::configManager.releaseKey("centerTuning");
         }
         ImGui::PopID();
     }
@@ -399,7 +494,7 @@ void MainWindow::draw() {
             tuner::tune(tuner::TUNER_MODE_CENTER, gui::waterfall.selectedVFO, gui::freqSelect.frequency);
             core::configManager.acquire();
             core::configManager.conf["centerTuning"] = true;
-            core::configManager.release(true);
+            core::configManager.releaseKey("centerTuning");
         }
         ImGui::PopID();
     }
@@ -462,7 +557,7 @@ void MainWindow::draw() {
             menuWidth = newWidth;
             core::configManager.acquire();
             core::configManager.conf["menuWidth"] = menuWidth;
-            core::configManager.release(true);
+            core::configManager.releaseKey("menuWidth");
         }
     }
 
@@ -639,7 +734,7 @@ void MainWindow::draw() {
         fftMax = std::max<float>(fftMax, fftMin + 10);
         core::configManager.acquire();
         core::configManager.conf["max"] = fftMax;
-        core::configManager.release(true);
+        core::configManager.releaseKey("max");
     }
 
     ImGui::NewLine();
@@ -652,7 +747,7 @@ void MainWindow::draw() {
         fftMin = std::min<float>(fftMax - 10, fftMin);
         core::configManager.acquire();
         core::configManager.conf["min"] = fftMin;
-        core::configManager.release(true);
+        core::configManager.releaseKey("min");
     }
 
     ImGui::EndChild();
@@ -5,6 +5,8 @@
 #include <dsp/stream.h>
 #include <signal_path/vfo_manager.h>
 #include <string>
+#include <vector>
+#include <map>
 #include <utils/event.h>
 #include <mutex>
 #include <gui/tuner.h>
@@ -35,6 +37,11 @@ public:
 
 private:
     static void vfoAddedHandler(VFOManager::VFO* vfo, void* ctx);
+    static void instanceDeleteHandler(std::string name, void* ctx);
+    static void instanceRealizedHandler(std::string name, void* ctx);
+    static void deferredMenuHandler(void* ctx);
+    static void deferredSourceHandler(std::string name, void* ctx);
+    static std::vector<std::string> createSourceInstance(std::string name, std::string module);
 
     // FFT Variables
     int fftSize = 8192 * 8;
@@ -66,4 +73,9 @@ private:
     bool autostart = false;
 
     EventHandler<VFOManager::VFO*> vfoCreatedHandler;
+    EventHandler<std::string> instanceDeleteHandlerObj;
+    EventHandler<std::string> instanceRealizedHandlerObj;
+
+    // Instance behind each source that is listed before its instance gets created
+    std::map<std::string, std::string> deferredSourceInstances;
 };
\ No newline at end of file
@@ -3,6 +3,9 @@
 #include <gui/gui.h>
 #include <core.h>
 #include <gui/style.h>
+#include <gui/file_dialogs.h>
+#include <utils/flog.h>
+#include <filesystem>
 
 namespace bandplanmenu {
     int bandplanId;
@@ -11,6 +14,42 @@ namespace bandplanmenu {
 
     const char* bandPlanPosTxt = "Bottom\0Top\0";
 
+    bool importOpen = false;
+    pfd::open_file* importDialog = NULL;
+
+    void importBandPlan(std::string path) {
+        // Imported band plans are converted to the binary format and kept in the root directory
+        std::string dir = (std::string)core::args["root"] + "/bandplans";
+        if (!std::filesystem::is_directory(dir) && !std::filesystem::create_directories(dir)) {
+            flog::error("Could not create band plan directory {0}", dir);
+            return;
+        }
+
+        // Find a file name that isn't taken so that no loaded band plan gets overwritten
+        std::string stem = std::filesystem::path(path).stem().string();
+        std::string dst = dir + "/" + stem + ".fdb";
+        for (int i = 1; std::filesystem::exists(dst); i++) {
+            dst = dir + "/" + stem + " (" + std::to_string(i) + ").fdb";
+        }
+        if (!bandplan::importBandPlan(path, dst)) { return; }
+
+        // Don't leave the file behind if the band plan couldn't be loaded, for instance because of a duplicate name
+        int count = bandplan::bandplanNames.size();
+        bandplan::loadBinaryBandPlan(dst);
+        if (bandplan::bandplanNames.size() == count) {
+            std::error_code err;
+            std::filesystem::remove(dst, err);
+            return;
+        }
+
+        // Select the new band plan
+        bandplanId = count;
+        gui::waterfall.bandplan = &bandplan::bandplans[bandplan::bandplanNames[bandplanId]];
+        core::configManager.acquire();
+        core::configManager.conf["bandPlan"] = bandplan::bandplanNames[bandplanId];
+        core::configManager.releaseKey("bandPlan");
+    }
+
     void init() {
         // todo: check if the bandplan wasn't removed
         if (bandplan::bandplanNames.size() == 0) {
@@ -41,7 +80,7 @@ namespace bandplanmenu {
             gui::waterfall.bandplan = &bandplan::bandplans[bandplan::bandplanNames[bandplanId]];
             core::configManager.acquire();
             core::configManager.conf["bandPlan"] = bandplan::bandplanNames[bandplanId];
-            core::configManager.release(true);
+            core::configManager.releaseKey("bandPlan");
         }
         ImGui::PopItemWidth();
 
@@ -51,17 +90,30 @@ namespace bandplanmenu {
             gui::waterfall.setBandPlanPos(bandPlanPos);
             core::configManager.acquire();
             core::configManager.conf["bandPlanPos"] = bandPlanPos;
-            core::configManager.release(true);
+            core::configManager.releaseKey("bandPlanPos");
         }
 
         if (ImGui::Checkbox("Enabled", &bandPlanEnabled)) {
             bandPlanEnabled ? gui::waterfall.showBandplan() : gui::waterfall.hideBandplan();
             core::configManager.acquire();
             core::configManager.conf["bandPlanEnabled"] = bandPlanEnabled;
-            core::configManager.release(true);
+            core::configManager.releaseKey("bandPlanEnabled");
+        }
+        if (!bandplan::bandplanNames.empty()) {
+            bandplan::BandPlan_t& plan = bandplan::bandplans[bandplan::bandplanNames[bandplanId]];
+            ImGui::Text("Country: %s (%s)", plan.countryName.c_str(), plan.countryCode.c_str());
+            ImGui::Text("Author: %s", plan.authorName.c_str());
+        }
+
+        if (ImGui::Button("Import##_bandplan_import_", ImVec2(menuColumnWidth, 0)) && !importOpen) {
+            importOpen = true;
+            importDialog = new pfd::open_file("Import band plan", "", { "Band Plans (*.json *.csv)", "*.json *.csv", "All Files", "*" });
+        }
+        if (importOpen && importDialog->ready()) {
+            importOpen = false;
+            std::vector<std::string> paths = importDialog->result();
+            if (!paths.empty()) { importBandPlan(paths[0]); }
+            delete importDialog;
         }
-        bandplan::BandPlan_t plan = bandplan::bandplans[bandplan::bandplanNames[bandplanId]];
-        ImGui::Text("Country: %s (%s)", plan.countryName.c_str(), plan.countryCode.c_str());
-        ImGui::Text("Author: %s", plan.authorName.c_str());
     }
 };
\ No newline at end of file
@@ -28,6 +28,8 @@ namespace displaymenu {
     int fftSmoothingSpeed = 100;
     bool snrSmoothing = false;
     int snrSmoothingSpeed = 20;
+    int waterfallMemory = 256;
+    bool waterfallHighPrecision = false;
 
     OptionList<int, int> fftSizes;
     OptionList<float, float> uiScales;
@@ -44,8 +46,13 @@ namespace displaymenu {
         gui::waterfall.setSNRSmoothingSpeed(std::min<float>((float)snrSmoothingSpeed / (float)(fftRate * 10.0f), 1.0f));
     }
 
+    void updateWaterfallStorage() {
+        gui::waterfall.setHistoryStorage((size_t)waterfallMemory * 1024 * 1024, waterfallHighPrecision);
+    }
+
     void init() {
         // Define FFT sizes
+        fftSizes.define(1048576, "1048576", 1048576);
         fftSizes.define(524288, "524288", 524288);
         fftSizes.define(262144, "262144", 262144);
         fftSizes.define(131072, "131072", 131072);
@@ -78,6 +85,10 @@ namespace displaymenu {
         fullWaterfallUpdate = core::configManager.conf["fullWaterfallUpdate"];
         gui::waterfall.setFullWaterfallUpdate(fullWaterfallUpdate);
 
+        waterfallMemory = std::clamp<int>(core::configManager.conf["waterfallMemory"], 16, 16384);
+        waterfallHighPrecision = core::configManager.conf["waterfallHighPrecision"];
+        updateWaterfallStorage();
+
         fftSizeId = fftSizes.valueId(65536);
         int size = core::configManager.conf["fftSize"];
         if (fftSizes.keyExists(size)) {
@@ -117,7 +128,7 @@ namespace displaymenu {
         showWaterfall ? gui::waterfall.showWaterfall() : gui::waterfall.hideWaterfall();
         core::configManager.acquire();
         core::configManager.conf["showWaterfall"] = showWaterfall;
-        core::configManager.release(true);
+        core::configManager.releaseKey("showWaterfall");
     }
 
     void checkKeybinds() {
@@ -136,20 +147,27 @@ namespace displaymenu {
             gui::waterfall.setFullWaterfallUpdate(fullWaterfallUpdate);
             core::configManager.acquire();
             core::configManager.conf["fullWaterfallUpdate"] = fullWaterfallUpdate;
-            core::configManager.release(true);
+            core::configManager.releaseKey("fullWaterfallUpdate");
+        }
+
+        if (ImGui::Checkbox("High Precision Waterfall##_sdrpp", &waterfallHighPrecision)) {
+            updateWaterfallStorage();
+            core::configManager.acquire();
+            core::configManager.conf["waterfallHighPrecision"] = waterfallHighPrecision;
+            core::configManager.releaseKey("waterfallHighPrecision");
         }
 
         if (ImGui::Checkbox("Lock Menu Order##_sdrpp", &gui::menu.locked)) {
             core::configManager.acquire();
             core::configManager.conf["lockMenuOrder"] = gui::menu.locked;
-            core::configManager.release(true);
+            core::configManager.releaseKey("lockMenuOrder");
         }
 
         if (ImGui::Checkbox("FFT Hold##_sdrpp", &fftHold)) {
             gui::waterfall.setFFTHold(fftHold);
             core::configManager.acquire();
             core::configManager.conf["fftHold"] = fftHold;
-            core::configManager.release(true);
+            core::configManager.releaseKey("fftHold");
         }
         ImGui::SameLine();
         ImGui::FillWidth();
@@ -157,14 +175,14 @@ namespace displaymenu {
             updateFFTSpeeds();
             core::configManager.acquire();
             core::configManager.conf["fftHoldSpeed"] = fftHoldSpeed;
-            core::configManager.release(true);
+            core::configManager.releaseKey("fftHoldSpeed");
         }
 
         if (ImGui::Checkbox("FFT Smoothing##_sdrpp", &fftSmoothing)) {
             gui::waterfall.setFFTSmoothing(fftSmoothing);
             core::configManager.acquire();
             core::configManager.conf["fftSmoothing"] = fftSmoothing;
-            core::configManager.release(true);
+            core::configManager.releaseKey("fftSmoothing");
         }
         ImGui::SameLine();
         ImGui::FillWidth();
@@ -173,14 +191,14 @@ namespace displaymenu {
             updateFFTSpeeds();
             core::configManager.acquire();
             core::configManager.conf["fftSmoothingSpeed"] = fftSmoothingSpeed;
-            core::configManager.release(true);
+            core::configManager.releaseKey("fftSmoothingSpeed");
         }
 
         if (ImGui::Checkbox("SNR Smoothing##_sdrpp", &snrSmoothing)) {
             gui::waterfall.setSNRSmoothing(snrSmoothing);
             core::configManager.acquire();
             core::configManager.conf["snrSmoothing"] = snrSmoothing;
-            core::configManager.release(true);
+            core::configManager.releaseKey("snrSmoothing");
         }
         ImGui::SameLine();
         ImGui::FillWidth();
@@ -189,7 +207,7 @@ namespace displaymenu {
             updateFFTSpeeds();
             core::configManager.acquire();
             core::configManager.conf["snrSmoothingSpeed"] = snrSmoothingSpeed;
-            core::configManager.release(true);
+            core::configManager.releaseKey("snrSmoothingSpeed");
         }
 
         ImGui::LeftLabel("High-DPI Scaling");
@@ -197,7 +215,7 @@ namespace displaymenu {
         if (ImGui::Combo("##sdrpp_ui_scale", &uiScaleId, uiScales.txt)) {
             core::configManager.acquire();
             core::configManager.conf["uiScale"] = uiScales[uiScaleId];
-            core::configManager.release(true);
+            core::configManager.releaseKey("uiScale");
             restartRequired = true;
         }
 
@@ -209,7 +227,7 @@ namespace displaymenu {
             updateFFTSpeeds();
             core::configManager.acquire();
             core::configManager.conf["fftRate"] = fftRate;
-            core::configManager.release(true);
+            core::configManager.releaseKey("fftRate");
         }
 
         ImGui::LeftLabel("FFT Size");
@@ -218,7 +236,21 @@ namespace displaymenu {
             sigpath::iqFrontEnd.setFFTSize(fftSizes.value(fftSizeId));
             core::configManager.acquire();
             core::configManager.conf["fftSize"] = fftSizes.key(fftSizeId);
-            core::configManager.release(true);
+            core::configManager.releaseKey("fftSize");
+        }
+
+        ImGui::LeftLabel("Waterfall Memory (MB)");
+        ImGui::SetNextItemWidth(menuWidth - ImGui::GetCursorPosX());
+        if (ImGui::InputInt("##sdrpp_wf_memory", &waterfallMemory, 16, 256)) {
+            waterfallMemory = std::clamp<int>(waterfallMemory, 16, 16384);
+        }
+
+        // Resizing clears the history, only do it once done editing
+        if (ImGui::IsItemDeactivatedAfterEdit()) {
+            updateWaterfallStorage();
+            core::configManager.acquire();
+            core::configManager.conf["waterfallMemory"] = waterfallMemory;
+            core::configManager.releaseKey("waterfallMemory");
         }
 
         ImGui::LeftLabel("FFT Window");
@@ -227,7 +259,7 @@ namespace displaymenu {
             sigpath::iqFrontEnd.setFFTWindow(fftWindowList[selectedWindow]);
             core::configManager.acquire();
             core::configManager.conf["fftWindow"] = selectedWindow;
-            core::configManager.release(true);
+            core::configManager.releaseKey("fftWindow");
         }
 
         if (colorMapNames.size() > 0) {
@@ -238,7 +270,7 @@ namespace displaymenu {
                 gui::waterfall.updatePalletteFromArray(map.map, map.entryCount);
                 core::configManager.acquire();
                 core::configManager.conf["colorMap"] = colorMapNames[colorMapId];
-                core::configManager.release(true);
+                core::configManager.releaseKey("colorMap");
                 colorMapAuthor = map.author;
             }
             ImGui::Text("Color map Author: %s", colorMapAuthor.c_str());
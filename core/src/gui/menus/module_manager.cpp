@@ -120,7 +120,7 @@ namespace module_manager_menu {
                 instances[_name]["enabled"] = inst.instance->isEnabled();
             }
             core::configManager.conf["moduleInstances"] = instances;
-            core::configManager.release(true);
+            core::configManager.releaseKey("moduleInstances");
         }
     }
 }
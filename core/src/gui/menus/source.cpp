@@ -210,7 +210,7 @@ namespace sourcemenu {
         core::configManager.conf["offsets"][name] = offset;
 
         // Acquire the config file
-        core::configManager.release(true);
+        core::configManager.releaseKey("offsets");
 
         // Reload the offsets
         reloadOffsets();
@@ -227,7 +227,7 @@ namespace sourcemenu {
         core::configManager.conf["offsets"].erase(name);
 
         // Acquire the config file
-        core::configManager.release(true);
+        core::configManager.releaseKey("offsets");
 
         // Reload the offsets
         reloadOffsets();
@@ -294,7 +294,7 @@ namespace sourcemenu {
             selectSource(newSource);
             core::configManager.acquire();
             core::configManager.conf["source"] = newSource;
-            core::configManager.release(true);
+            core::configManager.releaseKey("source");
         }
 
         if (running) { style::endDisabled(); }
@@ -305,14 +305,14 @@ namespace sourcemenu {
             sigpath::iqFrontEnd.setDCBlocking(iqCorrection);
             core::configManager.acquire();
             core::configManager.conf["iqCorrection"] = iqCorrection;
-            core::configManager.release(true);
+            core::configManager.releaseKey("iqCorrection");
         }
 
         if (ImGui::Checkbox("Invert IQ##_sdrpp_inv_iq", &invertIQ)) {
             sigpath::iqFrontEnd.setInvertIQ(invertIQ);
             core::configManager.acquire();
             core::configManager.conf["invertIQ"] = invertIQ;
-            core::configManager.release(true);
+            core::configManager.releaseKey("invertIQ");
         }
 
         ImGui::LeftLabel("Offset mode");
@@ -321,7 +321,7 @@ namespace sourcemenu {
             selectOffsetById(offsetId);
             core::configManager.acquire();
             core::configManager.conf["selectedOffset"] = offsets.key(offsetId);
-            core::configManager.release(true);
+            core::configManager.releaseKey("selectedOffset");
         }
         ImGui::SameLine();
         ImGui::SetCursorPosX(ImGui::GetCursorPosX() - spacing);
@@ -355,7 +355,7 @@ namespace sourcemenu {
                 updateOffset();
                 core::configManager.acquire();
                 core::configManager.conf["manualOffset"] = manualOffset;
-                core::configManager.release(true);
+                core::configManager.releaseKey("manualOffset");
             }
         }
         else {
@@ -371,7 +371,7 @@ namespace sourcemenu {
             sigpath::iqFrontEnd.setDecimation(decimations.value(decimId));
             core::configManager.acquire();
             core::configManager.conf["decimation"] = decimations.key(decimId);
-            core::configManager.release(true);
+            core::configManager.releaseKey("decimation");
         }
         if (running) { style::endDisabled(); }
     }
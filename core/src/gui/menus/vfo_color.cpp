@@ -94,7 +94,7 @@ namespace vfo_color_menu {
                 char buf[16];
                 sprintf(buf, "#%02X%02X%02X", (int)roundf(r * 255), (int)roundf(g * 255), (int)roundf(b * 255));
                 core::configManager.conf["vfoColors"][name] = buf;
-                core::configManager.release(true);
+                core::configManager.releaseKey("vfoColors");
             }
         }
 
@@ -105,7 +105,7 @@ namespace vfo_color_menu {
                 vfo->color = IM_COL32(255, 255, 255, 50);
                 core::configManager.acquire();
                 core::configManager.conf["vfoColors"][name] = "#FFFFFF";
-                core::configManager.release(true);
+                core::configManager.releaseKey("vfoColors");
             }
         }
 
@@ -126,7 +126,7 @@ namespace vfo_color_menu {
                 char buf[16];
                 sprintf(buf, "#%02X%02X%02X", (int)roundf(col.x * 255), (int)roundf(col.y * 255), (int)roundf(col.z * 255));
                 core::configManager.conf["vfoColors"][name] = buf;
-                core::configManager.release(true);
+                core::configManager.releaseKey("vfoColors");
             }
             ImGui::SameLine();
             ImGui::TextUnformatted(name.c_str());
@@ -73,6 +73,19 @@ namespace bandplan {
         ct.transColorValue = IM_COL32(r, g, b, 100);
     }
 
+    std::vector<freqdb::Record> toRecords(const std::vector<Band_t>& bands) {
+        std::vector<freqdb::Record> records;
+        for (auto const& band : bands) {
+            freqdb::Record r;
+            r.start = band.start;
+            r.end = band.end;
+            r.name = band.name;
+            r.type = band.type;
+            records.push_back(r);
+        }
+        return records;
+    }
+
     void loadBandPlan(std::string path) {
         std::ifstream file(path.c_str());
         json data;
@@ -84,11 +97,64 @@ namespace bandplan {
             flog::error("Duplicate band plan name ({0}), not loading.", plan.name);
             return;
         }
+
+        // Draw from the same sorted representation as binary band plans
+        plan.db = std::make_shared<freqdb::Database>();
+        plan.db->open(freqdb::build(toRecords(plan.bands), {}));
+
         bandplans[plan.name] = plan;
         bandplanNames.push_back(plan.name);
         generateTxt();
     }
 
+    void loadBinaryBandPlan(std::string path) {
+        BandPlan_t plan;
+        plan.db = std::make_shared<freqdb::Database>();
+        if (!plan.db->open(path)) { return; }
+        plan.name = plan.db->getMeta("name");
+        plan.countryName = plan.db->getMeta("country_name");
+        plan.countryCode = plan.db->getMeta("country_code");
+        plan.authorName = plan.db->getMeta("author_name");
+        plan.authorURL = plan.db->getMeta("author_url");
+        if (plan.name.empty()) { plan.name = std::filesystem::path(path).stem().string(); }
+        if (bandplans.find(plan.name) != bandplans.end()) {
+            flog::error("Duplicate band plan name ({0}), not loading.", plan.name);
+            return;
+        }
+        bandplans[plan.name] = plan;
+        bandplanNames.push_back(plan.name);
+        generateTxt();
+    }
+
+    bool importBandPlan(std::string srcPath, std::string dstPath) {
+        std::vector<freqdb::Record> records;
+        std::map<std::string, std::string> meta;
+        if (std::filesystem::path(srcPath).extension().string() == ".csv") {
+            if (!freqdb::readCSV(srcPath, records)) { return false; }
+            meta["name"] = std::filesystem::path(srcPath).stem().string();
+        }
+        else {
+            BandPlan_t plan;
+            try {
+                std::ifstream file(srcPath.c_str());
+                json data;
+                file >> data;
+                plan = data.get<BandPlan_t>();
+            }
+            catch (const std::exception& e) {
+                flog::error("Could not import band plan {0}: {1}", srcPath, e.what());
+                return false;
+            }
+            records = toRecords(plan.bands);
+            meta["name"] = plan.name;
+            meta["country_name"] = plan.countryName;
+            meta["country_code"] = plan.countryCode;
+            meta["author_name"] = plan.authorName;
+            meta["author_url"] = plan.authorURL;
+        }
+        return freqdb::write(dstPath, records, meta);
+    }
+
     void loadFromDir(std::string path) {
         if (!std::filesystem::exists(path)) {
             flog::error("Band Plan directory does not exist");
@@ -98,13 +164,15 @@ namespace bandplan {
             flog::error("Band Plan directory isn't a directory...");
             return;
         }
-        bandplans.clear();
         for (const auto& file : std::filesystem::directory_iterator(path)) {
             std::string path = file.path().generic_string();
-            if (file.path().extension().generic_string() != ".json") {
-                continue;
+            std::string ext = file.path().extension().generic_string();
+            if (ext == ".json") {
+                loadBandPlan(path);
+            }
+            else if (ext == ".fdb") {
+                loadBinaryBandPlan(path);
             }
-            loadBandPlan(path);
         }
     }
 
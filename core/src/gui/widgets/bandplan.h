@@ -2,6 +2,8 @@
 #include <json.hpp>
 #include <imgui/imgui.h>
 #include <stdint.h>
+#include <memory>
+#include <utils/freqdb.h>
 
 using nlohmann::json;
 
@@ -23,6 +25,9 @@ namespace bandplan {
         std::string authorName;
         std::string authorURL;
         std::vector<Band_t> bands;
+
+        // Bands sorted by start frequency, mapped from a binary band plan or built from the JSON one
+        std::shared_ptr<freqdb::Database> db;
     };
 
     void to_json(json& j, const BandPlan_t& b);
@@ -37,7 +42,16 @@ namespace bandplan {
     void from_json(const json& j, BandPlanColor_t& ct);
 
     void loadBandPlan(std::string path);
+    void loadBinaryBandPlan(std::string path);
     void loadFromDir(std::string path);
+
+    /**
+     * Convert a JSON band plan, or a CSV file with start, end, name and type columns, to a binary band plan.
+     * @param srcPath Path of the band plan to convert.
+     * @param dstPath Path of the binary band plan.
+     * @return True on success.
+    */
+    bool importBandPlan(std::string srcPath, std::string dstPath);
     void loadColorTable(json table);
 
     extern std::map<std::string, BandPlan_t> bandplans;
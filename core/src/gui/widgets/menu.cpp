@@ -24,6 +24,11 @@ void Menu::removeEntry(std::string name) {
     items.erase(name);
 }
 
+void Menu::setEntryInstance(std::string name, ModuleManager::Instance* inst) {
+    if (items.find(name) == items.end()) { return; }
+    items[name].inst = inst;
+}
+
 bool Menu::draw(bool updateStates) {
     bool changed = false;
     float menuWidth = ImGui::GetContentRegionAvail().x;
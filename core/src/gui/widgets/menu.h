@@ -23,6 +23,7 @@ public:
 
     void registerEntry(std::string name, void (*drawHandler)(void* ctx), void* ctx = NULL, ModuleManager::Instance* inst = NULL);
     void removeEntry(std::string name);
+    void setEntryInstance(std::string name, ModuleManager::Instance* inst);
     bool draw(bool updateStates);
 
     std::vector<MenuOption_t> order;
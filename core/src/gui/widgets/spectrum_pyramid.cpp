@@ -0,0 +1,77 @@
+#include <gui/widgets/spectrum_pyramid.h>
+#include <volk/volk.h>
+#include <dsp/buffer/buffer.h>
+#include <algorithm>
+#include <math.h>
+
+namespace ImGui {
+    SpectrumPyramid::~SpectrumPyramid() {
+        dsp::buffer::free(levels);
+        dsp::buffer::free(evenBuf);
+        dsp::buffer::free(oddBuf);
+    }
+
+    void SpectrumPyramid::build(const float* line, int size) {
+        if (size != lineSize) { updateLayout(size); }
+        this->line = line;
+
+        // Each level is the pairwise max of the one below, split into even and odd bins so that it vectorizes
+        const float* prev = line;
+        for (int k = 1; k < levelSizes.size(); k++) {
+            int prevSize = levelSizes[k - 1];
+            int half = prevSize / 2;
+            float* next = &levels[levelOffsets[k]];
+            volk_32fc_deinterleave_32f_x2(evenBuf, oddBuf, (const lv_32fc_t*)prev, half);
+            volk_32f_x2_max_32f(next, evenBuf, oddBuf, half);
+            if (prevSize & 1) { next[half] = prev[prevSize - 1]; }
+            prev = next;
+        }
+    }
+
+    void SpectrumPyramid::render(int offset, int width, float* out, int outSize) {
+        if (!line || lineSize <= 0) {
+            for (int i = 0; i < outSize; i++) { out[i] = -INFINITY; }
+            return;
+        }
+        double factor = (double)width / (double)outSize;
+        int span = std::max<int>(ceil(factor), 1);
+        int topLevel = levelSizes.size() - 1;
+
+        for (int i = 0; i < outSize; i++) {
+            int lo = std::clamp<int>(offset + (int)(i * factor), 0, lineSize - 1);
+            int hi = std::clamp<int>(lo + span - 1, 0, lineSize - 1);
+
+            // Cover the range with the largest aligned blocks, climbing one level per step
+            float maxVal = -INFINITY;
+            for (int k = 0; k <= topLevel && lo <= hi; k++) {
+                const float* lvl = getLevel(k);
+                if (lo & 1) { maxVal = std::max<float>(maxVal, lvl[lo++]); }
+                if (!(hi & 1)) { maxVal = std::max<float>(maxVal, lvl[hi--]); }
+                lo >>= 1;
+                hi >>= 1;
+            }
+            out[i] = maxVal;
+        }
+    }
+
+    void SpectrumPyramid::updateLayout(int size) {
+        lineSize = size;
+        levelSizes.clear();
+        levelOffsets.clear();
+        int total = 0;
+        for (int s = size; s > 0; s = (s + 1) / 2) {
+            // Level 0 is the line itself and isn't stored
+            levelOffsets.push_back(levelSizes.empty() ? 0 : total);
+            if (!levelSizes.empty()) { total += s; }
+            levelSizes.push_back(s);
+            if (s == 1) { break; }
+        }
+
+        dsp::buffer::free(levels);
+        dsp::buffer::free(evenBuf);
+        dsp::buffer::free(oddBuf);
+        levels = dsp::buffer::alloc<float>(std::max<int>(total, 1));
+        evenBuf = dsp::buffer::alloc<float>(std::max<int>(size / 2, 1));
+        oddBuf = dsp::buffer::alloc<float>(std::max<int>(size / 2, 1));
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include <stddef.h>
+
+namespace ImGui {
+    // Multi-resolution max reduction of an FFT line. Level k holds the max of each aligned group of
+    // 2^k bins, which lets any span of the line be reduced to any output width in O(width * log(zoom)).
+    class SpectrumPyramid {
+    public:
+        SpectrumPyramid() {}
+        ~SpectrumPyramid();
+
+        /**
+         * Build the pyramid of a line. The line is used as level 0 and must stay valid until the next build.
+         * @param line FFT line in dB.
+         * @param size Number of bins in the line.
+        */
+        void build(const float* line, int size);
+
+        /**
+         * Render a span of the line, taking the max of the bins falling into each output point.
+         * @param offset First bin of the span.
+         * @param width Number of bins in the span.
+         * @param out Output buffer.
+         * @param outSize Number of output points.
+        */
+        void render(int offset, int width, float* out, int outSize);
+
+        int getLevelCount() { return levelSizes.size(); }
+        int getLevelSize(int level) { return levelSizes[level]; }
+        const float* getLevel(int level) { return level ? &levels[levelOffsets[level]] : line; }
+
+    private:
+        void updateLayout(int size);
+
+        const float* line = NULL;
+        int lineSize = 0;
+        std::vector<int> levelSizes;
+        std::vector<int> levelOffsets;
+        float* levels = NULL;
+        float* evenBuf = NULL;
+        float* oddBuf = NULL;
+    };
+}
@@ -62,33 +62,6 @@ inline void printAndScale(double freq, char* buf) {
     }
 }
 
-inline void doZoom(int offset, int width, int inSize, int outSize, float* in, float* out) {
-    // NOTE: REMOVE THAT SHIT, IT'S JUST A HACKY FIX
-    if (offset < 0) {
-        offset = 0;
-    }
-    if (width > 524288) {
-        width = 524288;
-    }
-
-    float factor = (float)width / (float)outSize;
-    float sFactor = ceilf(factor);
-    float uFactor;
-    float id = offset;
-    float maxVal;
-    int sId;
-    for (int i = 0; i < outSize; i++) {
-        maxVal = -INFINITY;
-        sId = (int)id;
-        uFactor = (sId + sFactor > inSize) ? sFactor - ((sId + sFactor) - inSize) : sFactor;
-        for (int j = 0; j < uFactor; j++) {
-            if (in[sId + j] > maxVal) { maxVal = in[sId + j]; }
-        }
-        out[i] = maxVal;
-        id += factor;
-    }
-}
-
 namespace ImGui {
     WaterFall::WaterFall() {
         fftMin = -70.0;
@@ -159,30 +132,17 @@ namespace ImGui {
             window->DrawList->AddText(ImVec2(roundf(xPos - (txtSz.x / 2.0)), fftAreaMax.y + txtSz.y), text, buf);
         }
 
-        // Data
-        if (latestFFT != NULL && fftLines != 0) {
-            for (int i = 1; i < dataWidth; i++) {
-                double aPos = fftAreaMax.y - ((latestFFT[i - 1] - fftMin) * scaleFactor);
-                double bPos = fftAreaMax.y - ((latestFFT[i] - fftMin) * scaleFactor);
-                aPos = std::clamp<double>(aPos, fftAreaMin.y + 1, fftAreaMax.y);
-                bPos = std::clamp<double>(bPos, fftAreaMin.y + 1, fftAreaMax.y);
-                window->DrawList->AddLine(ImVec2(fftAreaMin.x + i - 1, roundf(aPos)),
-                                          ImVec2(fftAreaMin.x + i, roundf(bPos)), trace, 1.0);
-                window->DrawList->AddLine(ImVec2(fftAreaMin.x + i, roundf(bPos)),
-                                          ImVec2(fftAreaMin.x + i, fftAreaMax.y), shadow, 1.0);
-            }
+        // Data, drawn as a single filled strip for the shadow and a single polyline for the trace
+        if (latestFFT != NULL && fftLines != 0 && dataWidth > 1) {
+            buildTrace(latestFFT, scaleFactor);
+            drawTraceShadow(shadow);
+            window->DrawList->AddPolyline(tracePoints.data(), dataWidth, trace, ImDrawFlags_None, 1.0);
         }
 
         // Hold
-        if (fftHold && latestFFT != NULL && latestFFTHold != NULL && fftLines != 0) {
-            for (int i = 1; i < dataWidth; i++) {
-                double aPos = fftAreaMax.y - ((latestFFTHold[i - 1] - fftMin) * scaleFactor);
-                double bPos = fftAreaMax.y - ((latestFFTHold[i] - fftMin) * scaleFactor);
-                aPos = std::clamp<double>(aPos, fftAreaMin.y + 1, fftAreaMax.y);
-                bPos = std::clamp<double>(bPos, fftAreaMin.y + 1, fftAreaMax.y);
-                window->DrawList->AddLine(ImVec2(fftAreaMin.x + i - 1, roundf(aPos)),
-                                          ImVec2(fftAreaMin.x + i, roundf(bPos)), traceHold, 1.0);
-            }
+        if (fftHold && latestFFT != NULL && latestFFTHold != NULL && fftLines != 0 && dataWidth > 1) {
+            buildTrace(latestFFTHold, scaleFactor);
+            window->DrawList->AddPolyline(tracePoints.data(), dataWidth, traceHold, ImDrawFlags_None, 1.0);
         }
 
         FFTRedrawArgs args;
@@ -205,14 +165,62 @@ namespace ImGui {
                                   text, style::uiScale);
     }
 
+    void WaterFall::buildTrace(const float* data, float scaleFactor) {
+        tracePoints.resize(dataWidth);
+        float top = fftAreaMin.y + 1;
+        float bottom = fftAreaMax.y;
+        for (int i = 0; i < dataWidth; i++) {
+            float y = std::clamp<float>(bottom - ((data[i] - fftMin) * scaleFactor), top, bottom);
+            tracePoints[i] = ImVec2(fftAreaMin.x + i, roundf(y));
+        }
+    }
+
+    void WaterFall::drawTraceShadow(ImU32 color) {
+        // One quad per column between the trace and the bottom of the FFT, sharing vertices with its neighbours
+        ImDrawList* dl = window->DrawList;
+        ImVec2 uv = dl->_Data->TexUvWhitePixel;
+        dl->PrimReserve((dataWidth - 1) * 6, dataWidth * 2);
+        unsigned int base = dl->_VtxCurrentIdx;
+        for (int i = 0; i < dataWidth; i++) {
+            dl->PrimWriteVtx(tracePoints[i], uv, color);
+            dl->PrimWriteVtx(ImVec2(tracePoints[i].x, fftAreaMax.y), uv, color);
+        }
+        for (int i = 0; i < dataWidth - 1; i++) {
+            unsigned int id = base + (i * 2);
+            dl->PrimWriteIdx((ImDrawIdx)id);
+            dl->PrimWriteIdx((ImDrawIdx)(id + 1));
+            dl->PrimWriteIdx((ImDrawIdx)(id + 3));
+            dl->PrimWriteIdx((ImDrawIdx)id);
+            dl->PrimWriteIdx((ImDrawIdx)(id + 3));
+            dl->PrimWriteIdx((ImDrawIdx)(id + 2));
+        }
+    }
+
+    void WaterFall::colorizeLine(const float* data, uint32_t* out) {
+        // Scale to palette indices in two vectorized passes, only the clamp and the lookup are left per pixel
+        colorScaleBuf.resize(dataWidth);
+        colorIdBuf.resize(dataWidth);
+        float scale = (float)(WATERFALL_RESOLUTION - 1) / (waterfallMax - waterfallMin);
+        volk_32f_s32f_add_32f(colorScaleBuf.data(), data, -waterfallMin, dataWidth);
+        volk_32f_s32f_convert_32i(colorIdBuf.data(), colorScaleBuf.data(), scale, dataWidth);
+        for (int i = 0; i < dataWidth; i++) {
+            out[i] = waterfallPallet[std::clamp<int32_t>(colorIdBuf[i], 0, WATERFALL_RESOLUTION - 1)];
+        }
+    }
+
     void WaterFall::drawWaterfall() {
-        if (waterfallUpdate) {
-            waterfallUpdate = false;
+        if (waterfallUpdate || waterfallNewLines) {
             updateWaterfallTexture();
         }
         {
+            // Unroll the circular texture, the rows from the head down to the end of the texture first
             std::lock_guard<std::mutex> lck(texMtx);
-            window->DrawList->AddImage((void*)(intptr_t)textureId, wfMin, wfMax);
+            float headRatio = (float)waterfallHead / (float)waterfallHeight;
+            float splitY = wfMin.y + (waterfallHeight - waterfallHead);
+            window->DrawList->AddImage((void*)(intptr_t)textureId, wfMin, ImVec2(wfMax.x, splitY), ImVec2(0, headRatio), ImVec2(1, 1));
+            if (waterfallHead) {
+                window->DrawList->AddImage((void*)(intptr_t)textureId, ImVec2(wfMin.x, splitY), wfMax, ImVec2(0, 0), ImVec2(1, headRatio));
+            }
         }
         
         ImVec2 mPos = ImGui::GetMousePos();
@@ -492,7 +500,7 @@ namespace ImGui {
                         ImGui::Text("Bandwidth Locked: %s", _vfo->bandwidthLocked ? "Yes" : "No");
 
                         float strength, snr;
-                        if (calculateVFOSignalInfo(waterfallVisible ? &rawFFTs[currentFFTLine * rawFFTSize] : rawFFTs, _vfo, strength, snr)) {
+                        if (calculateVFOSignalInfo(rawFFTs, _vfo, strength, snr)) {
                             ImGui::Text("Strength: %0.1fdBFS", strength);
                             ImGui::Text("SNR: %0.1fdB", snr);
                         }
@@ -606,18 +614,13 @@ namespace ImGui {
         int drawDataStart;
         // TODO: Maybe put on the stack for faster alloc?
         float* tempData = new float[dataWidth];
-        float pixel;
-        float dataRange = waterfallMax - waterfallMin;
-        int count = std::min<float>(waterfallHeight, fftLines);
-        if (rawFFTs != NULL && fftLines >= 0) {
+        int count = std::min<int>(waterfallHeight, history.getLineCount());
+        if (rawFFTs != NULL) {
             for (int i = 0; i < count; i++) {
                 drawDataSize = (viewBandwidth / wholeBandwidth) * rawFFTSize;
                 drawDataStart = (((double)rawFFTSize / 2.0) * (offsetRatio + 1)) - (drawDataSize / 2);
-                doZoom(drawDataStart, drawDataSize, rawFFTSize, dataWidth, &rawFFTs[((i + currentFFTLine) % waterfallHeight) * rawFFTSize], tempData);
-                for (int j = 0; j < dataWidth; j++) {
-                    pixel = (std::clamp<float>(tempData[j], waterfallMin, waterfallMax) - waterfallMin) / dataRange;
-                    waterfallFb[(i * dataWidth) + j] = waterfallPallet[(int)(pixel * (WATERFALL_RESOLUTION - 1))];
-                }
+                history.render(i, drawDataStart, drawDataSize, tempData, dataWidth);
+                colorizeLine(tempData, &waterfallFb[i * dataWidth]);
             }
 
             for (int i = count; i < waterfallHeight; i++) {
@@ -627,11 +630,15 @@ namespace ImGui {
             }
         }
         delete[] tempData;
+        waterfallHead = 0;
+        waterfallNewLines = 0;
         waterfallUpdate = true;
     }
 
     void WaterFall::drawBandPlan() {
-        int count = bandplan->bands.size();
+        if (!bandplan->db) { return; }
+        freqdb::Database& db = *bandplan->db;
+        int count = db.getEntryCount();
         double horizScale = (double)dataWidth / viewBandwidth;
         double start, end, center, aPos, bPos, cPos, width;
         ImVec2 txtSz;
@@ -649,15 +656,15 @@ namespace ImGui {
         }
 
 
-        for (int i = 0; i < count; i++) {
-            start = bandplan->bands[i].start;
-            end = bandplan->bands[i].end;
-            if (start < lowerFreq && end < lowerFreq) {
-                continue;
-            }
-            if (start > upperFreq && end > upperFreq) {
-                continue;
-            }
+        // Bands are sorted by start frequency, only walk the ones that can be in view
+        for (int i = db.findFirst(lowerFreq); i < count; i++) {
+            const freqdb::Entry& band = db.getEntry(i);
+            start = band.start;
+            end = band.end;
+            if (start > upperFreq) { break; }
+            if (end < lowerFreq) { continue; }
+            const char* name = db.getString(band.name);
+            const char* type = db.getString(band.type);
             startVis = (start > lowerFreq);
             endVis = (end < upperFreq);
             start = std::clamp<double>(start, lowerFreq, upperFreq);
@@ -667,10 +674,11 @@ namespace ImGui {
             bPos = fftAreaMin.x + ((end - lowerFreq) * horizScale);
             cPos = fftAreaMin.x + ((center - lowerFreq) * horizScale);
             width = bPos - aPos;
-            txtSz = ImGui::CalcTextSize(bandplan->bands[i].name.c_str());
-            if (bandplan::colorTable.find(bandplan->bands[i].type.c_str()) != bandplan::colorTable.end()) {
-                color = bandplan::colorTable[bandplan->bands[i].type].colorValue;
-                colorTrans = bandplan::colorTable[bandplan->bands[i].type].transColorValue;
+            txtSz = ImGui::CalcTextSize(name);
+            auto colorIt = bandplan::colorTable.find(type);
+            if (colorIt != bandplan::colorTable.end()) {
+                color = colorIt->second.colorValue;
+                colorTrans = colorIt->second.transColorValue;
             }
             else {
                 color = IM_COL32(255, 255, 255, 255);
@@ -696,7 +704,7 @@ namespace ImGui {
             }
             if (txtSz.x <= width) {
                 window->DrawList->AddText(ImVec2(cPos - (txtSz.x / 2.0), bpBottom - (height / 2.0f) - (txtSz.y / 2.0f)),
-                                          IM_COL32(255, 255, 255, 255), bandplan->bands[i].name.c_str());
+                                          IM_COL32(255, 255, 255, 255), name);
             }
         }
     }
@@ -706,8 +714,26 @@ namespace ImGui {
         glBindTexture(GL_TEXTURE_2D, textureId);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, dataWidth, waterfallHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, (uint8_t*)waterfallFb);
+
+        // Re-upload everything only when the whole framebuffer was redrawn or resized
+        if (waterfallUpdate || texWidth != dataWidth || texHeight != waterfallHeight) {
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, dataWidth, waterfallHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, (uint8_t*)waterfallFb);
+            texWidth = dataWidth;
+            texHeight = waterfallHeight;
+            waterfallUpdate = false;
+            waterfallNewLines = 0;
+            return;
+        }
+
+        // Otherwise only upload the lines pushed since the last frame, in at most two runs if they wrap around
+        int firstRun = std::min<int>(waterfallNewLines, waterfallHeight - waterfallHead);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, waterfallHead, dataWidth, firstRun, GL_RGBA, GL_UNSIGNED_BYTE, (uint8_t*)&waterfallFb[waterfallHead * dataWidth]);
+        if (waterfallNewLines > firstRun) {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, dataWidth, waterfallNewLines - firstRun, GL_RGBA, GL_UNSIGNED_BYTE, (uint8_t*)waterfallFb);
+        }
+        waterfallNewLines = 0;
     }
 
     void WaterFall::onPositionChange() {
@@ -722,8 +748,6 @@ namespace ImGui {
             return;
         }
 
-        int lastWaterfallHeight = waterfallHeight;
-
         if (waterfallVisible) {
             FFTAreaHeight = std::min<int>(FFTAreaHeight, widgetSize.y - (50.0f * style::uiScale));
             newFFTAreaHeight = FFTAreaHeight;
@@ -736,24 +760,11 @@ namespace ImGui {
         dataWidth = widgetSize.x - (60.0f * style::uiScale);
 
         if (waterfallVisible) {
-            // Raw FFT resize
-            fftLines = std::min<int>(fftLines, waterfallHeight) - 1;
+            // The history keeps the newest lines that still fit
             if (rawFFTs != NULL) {
-                if (currentFFTLine != 0) {
-                    float* tempWF = new float[currentFFTLine * rawFFTSize];
-                    int moveCount = lastWaterfallHeight - currentFFTLine;
-                    memcpy(tempWF, rawFFTs, currentFFTLine * rawFFTSize * sizeof(float));
-                    memmove(rawFFTs, &rawFFTs[currentFFTLine * rawFFTSize], moveCount * rawFFTSize * sizeof(float));
-                    memcpy(&rawFFTs[moveCount * rawFFTSize], tempWF, currentFFTLine * rawFFTSize * sizeof(float));
-                    delete[] tempWF;
-                }
-                currentFFTLine = 0;
-                rawFFTs = (float*)realloc(rawFFTs, waterfallHeight * rawFFTSize * sizeof(float));
+                history.setSize(rawFFTSize, waterfallHeight);
+                fftLines = std::min<int>(fftLines, history.getLineCount());
             }
-            else {
-                rawFFTs = (float*)malloc(waterfallHeight * rawFFTSize * sizeof(float));
-            }
-            // ==============
         }
 
         // Reallocate display FFT
@@ -781,6 +792,8 @@ namespace ImGui {
             delete[] waterfallFb;
             waterfallFb = new uint32_t[dataWidth * waterfallHeight];
             memset(waterfallFb, 0, dataWidth * waterfallHeight * sizeof(uint32_t));
+            waterfallHead = 0;
+            waterfallNewLines = 0;
         }
         for (int i = 0; i < dataWidth; i++) {
             latestFFT[i] = -1000.0f; // Hide everything
@@ -876,13 +889,6 @@ namespace ImGui {
     float* WaterFall::getFFTBuffer() {
         if (rawFFTs == NULL) { return NULL; }
         buf_mtx.lock();
-        if (waterfallVisible) {
-            currentFFTLine--;
-            fftLines++;
-            currentFFTLine = ((currentFFTLine + waterfallHeight) % waterfallHeight);
-            fftLines = std::min<float>(fftLines, waterfallHeight);
-            return &rawFFTs[currentFFTLine * rawFFTSize];
-        }
         return rawFFTs;
     }
 
@@ -894,19 +900,19 @@ namespace ImGui {
         int drawDataStart = (((double)rawFFTSize / 2.0) * (offsetRatio + 1)) - (drawDataSize / 2);
 
         if (waterfallVisible) {
-            doZoom(drawDataStart, drawDataSize, rawFFTSize, dataWidth, &rawFFTs[currentFFTLine * rawFFTSize], latestFFT);
-            memmove(&waterfallFb[dataWidth], waterfallFb, dataWidth * (waterfallHeight - 1) * sizeof(uint32_t));
-            float pixel;
-            float dataRange = waterfallMax - waterfallMin;
-            for (int j = 0; j < dataWidth; j++) {
-                pixel = (std::clamp<float>(latestFFT[j], waterfallMin, waterfallMax) - waterfallMin) / dataRange;
-                int id = (int)(pixel * (WATERFALL_RESOLUTION - 1));
-                waterfallFb[j] = waterfallPallet[id];
-            }
-            waterfallUpdate = true;
+            pyramid.build(rawFFTs, rawFFTSize);
+            pyramid.render(drawDataStart, drawDataSize, latestFFT, dataWidth);
+            history.push(pyramid);
+            fftLines = std::max<int>(history.getLineCount(), 1);
+
+            // Write the new line over the oldest one instead of scrolling the whole framebuffer
+            waterfallHead = (waterfallHead + waterfallHeight - 1) % waterfallHeight;
+            colorizeLine(latestFFT, &waterfallFb[waterfallHead * dataWidth]);
+            waterfallNewLines = std::min<int>(waterfallNewLines + 1, waterfallHeight);
         }
         else {
-            doZoom(drawDataStart, drawDataSize, rawFFTSize, dataWidth, rawFFTs, latestFFT);
+            pyramid.build(rawFFTs, rawFFTSize);
+            pyramid.render(drawDataStart, drawDataSize, latestFFT, dataWidth);
             fftLines = 1;
         }
 
@@ -923,11 +929,11 @@ namespace ImGui {
             float dummy;
             if (snrSmoothing) {
                 float newSNR = 0.0f;
-                calculateVFOSignalInfo(waterfallVisible ? &rawFFTs[currentFFTLine * rawFFTSize] : rawFFTs, vfos[selectedVFO], dummy, newSNR);
+                calculateVFOSignalInfo(rawFFTs, vfos[selectedVFO], dummy, newSNR);
                 selectedVFOSNR = (snrSmoothingBeta*selectedVFOSNR) + (snrSmoothingAlpha*newSNR);
             }
             else {
-                calculateVFOSignalInfo(waterfallVisible ? &rawFFTs[currentFFTLine * rawFFTSize] : rawFFTs, vfos[selectedVFO], dummy, selectedVFOSNR);
+                calculateVFOSignalInfo(rawFFTs, vfos[selectedVFO], dummy, selectedVFOSNR);
             }
         }
 
@@ -1134,15 +1140,22 @@ namespace ImGui {
     void WaterFall::setRawFFTSize(int size) {
         std::lock_guard<std::recursive_mutex> lck(buf_mtx);
         rawFFTSize = size;
-        int wfSize = std::max<int>(1, waterfallHeight);
         if (rawFFTs != NULL) {
-            rawFFTs = (float*)realloc(rawFFTs, rawFFTSize * wfSize * sizeof(float));
+            rawFFTs = (float*)realloc(rawFFTs, rawFFTSize * sizeof(float));
         }
         else {
-            rawFFTs = (float*)malloc(rawFFTSize * wfSize * sizeof(float));
+            rawFFTs = (float*)malloc(rawFFTSize * sizeof(float));
         }
         fftLines = 0;
-        memset(rawFFTs, 0, rawFFTSize * waterfallHeight * sizeof(float));
+        memset(rawFFTs, 0, rawFFTSize * sizeof(float));
+        history.setSize(rawFFTSize, waterfallHeight);
+        history.clear();
+        updateWaterfallFb();
+    }
+
+    void WaterFall::setHistoryStorage(size_t budget, bool highPrecision) {
+        std::lock_guard<std::recursive_mutex> lck(buf_mtx);
+        history.setStorage(budget, highPrecision);
         updateWaterfallFb();
     }
 
@@ -1388,7 +1401,7 @@ namespace ImGui {
         }
         waterfallVisible = true;
         onResize();
-        memset(rawFFTs, 0, waterfallHeight * rawFFTSize * sizeof(float));
+        history.clear();
         updateWaterfallFb();
         buf_mtx.unlock();
     }
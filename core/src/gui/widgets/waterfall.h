@@ -2,6 +2,7 @@
 #include <vector>
 #include <mutex>
 #include <gui/widgets/bandplan.h>
+#include <gui/widgets/waterfall_history.h>
 #include <imgui/imgui.h>
 #include <imgui/imgui_internal.h>
 #include <utils/event.h>
@@ -135,6 +136,13 @@ namespace ImGui {
 
         void setRawFFTSize(int size);
 
+        /**
+         * Configure the memory used by the waterfall history.
+         * @param budget Maximum size of the history in bytes.
+         * @param highPrecision Keep 16bit instead of 8bit values.
+        */
+        void setHistoryStorage(size_t budget, bool highPrecision);
+
         void setFullWaterfallUpdate(bool fullUpdate);
 
         void setBandPlanPos(int pos);
@@ -228,10 +236,14 @@ namespace ImGui {
         void onResize();
         void updateWaterfallFb();
         void updateWaterfallTexture();
+        void buildTrace(const float* data, float scaleFactor);
+        void drawTraceShadow(ImU32 color);
+        void colorizeLine(const float* data, uint32_t* out);
         void updateAllVFOs(bool checkRedrawRequired = false);
         bool calculateVFOSignalInfo(float* fftLine, WaterfallVFO* vfo, float& strength, float& snr);
 
-        bool waterfallUpdate = false;
+        bool waterfallUpdate = false;   // Whole texture must be re-uploaded
+        int waterfallNewLines = 0;      // Lines pushed since the last texture upload
 
         uint32_t waterfallPallet[WATERFALL_RESOLUTION];
 
@@ -281,16 +293,24 @@ namespace ImGui {
         float waterfallMin;
         float waterfallMax;
 
-        //std::vector<std::vector<float>> rawFFTs;
-        int rawFFTSize;
-        float* rawFFTs = NULL;
+        int rawFFTSize = 0;
+        float* rawFFTs = NULL;          // Latest full resolution FFT line
         float* latestFFT = NULL;
         float* latestFFTHold = NULL;
         float* smoothingBuf = NULL;
-        int currentFFTLine = 0;
         int fftLines = 0;
+        std::vector<ImVec2> tracePoints;
+        std::vector<float> colorScaleBuf;
+        std::vector<int32_t> colorIdBuf;
+
+        SpectrumPyramid pyramid;
+        WaterfallHistory history;
 
+        // Circular framebuffer, the newest line is at waterfallHead and older ones follow it
         uint32_t* waterfallFb;
+        int waterfallHead = 0;
+        int texWidth = 0;
+        int texHeight = 0;
 
         bool draggingFW = false;
         int FFTAreaHeight;
@@ -0,0 +1,153 @@
+#include <gui/widgets/waterfall_history.h>
+#include <algorithm>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+// Quantization of the dB values, 8bit covers -160dB to +10dB and 16bit -300dB to +355dB
+#define Q8_MIN      -160.0f
+#define Q8_SCALE    1.5f
+#define Q16_MIN     -300.0f
+#define Q16_SCALE   100.0f
+
+namespace ImGui {
+    WaterfallHistory::~WaterfallHistory() {
+        free(data);
+    }
+
+    void WaterfallHistory::setStorage(size_t budget, bool highPrecision) {
+        if (budget == this->budget && highPrecision == this->highPrecision) { return; }
+        this->budget = budget;
+        this->highPrecision = highPrecision;
+        updateLayout(maxLines, false);
+    }
+
+    void WaterfallHistory::setSize(int lineSize, int maxLines) {
+        if (lineSize == this->lineSize && maxLines == this->maxLines) { return; }
+        bool keep = (lineSize == this->lineSize);
+        int oldMaxLines = this->maxLines;
+        this->lineSize = lineSize;
+        this->maxLines = maxLines;
+        updateLayout(oldMaxLines, keep);
+    }
+
+    void WaterfallHistory::clear() {
+        head = 0;
+        count = 0;
+    }
+
+    void WaterfallHistory::push(SpectrumPyramid& pyramid) {
+        if (!data || pyramid.getLevelCount() != levelSizes.size()) { return; }
+        head = (head + maxLines - 1) % maxLines;
+        count = std::min<int>(count + 1, maxLines);
+        uint8_t* dst = &data[(size_t)head * storedSize * bytesPerValue];
+        if (highPrecision) {
+            store<uint16_t>(pyramid, (uint16_t*)dst);
+        }
+        else {
+            store<uint8_t>(pyramid, dst);
+        }
+    }
+
+    void WaterfallHistory::render(int line, int offset, int width, float* out, int outSize) {
+        if (!data || line >= count) {
+            for (int i = 0; i < outSize; i++) { out[i] = -INFINITY; }
+            return;
+        }
+        uint8_t* src = &data[(size_t)((head + line) % maxLines) * storedSize * bytesPerValue];
+        if (highPrecision) {
+            renderLevels<uint16_t>((uint16_t*)src, offset, width, out, outSize);
+        }
+        else {
+            renderLevels<uint8_t>(src, offset, width, out, outSize);
+        }
+    }
+
+    void WaterfallHistory::updateLayout(int oldMaxLines, bool keep) {
+        // Compute the size of every level of the pyramid
+        levelSizes.clear();
+        if (lineSize > 0) {
+            for (int size = lineSize; ; size = (size + 1) / 2) {
+                levelSizes.push_back(size);
+                if (size == 1) { break; }
+            }
+        }
+        int levels = levelSizes.size();
+
+        // Drop the finest levels until the history fits in the budget
+        int oldStoredSize = storedSize;
+        int oldBytesPerValue = bytesPerValue;
+        bytesPerValue = highPrecision ? sizeof(uint16_t) : sizeof(uint8_t);
+        baseLevel = 0;
+        for (; baseLevel < levels - 1; baseLevel++) {
+            size_t bytes = 0;
+            for (int k = baseLevel; k < levels; k++) { bytes += levelSizes[k]; }
+            if (bytes * bytesPerValue * maxLines <= budget) { break; }
+        }
+        levelOffsets.assign(levels, -1);
+        storedSize = 0;
+        for (int k = baseLevel; k < levels; k++) {
+            levelOffsets[k] = storedSize;
+            storedSize += levelSizes[k];
+        }
+
+        // Keep the newest lines only if their layout didn't change
+        keep &= (storedSize == oldStoredSize && bytesPerValue == oldBytesPerValue && data != NULL);
+        size_t lineBytes = (size_t)storedSize * bytesPerValue;
+        uint8_t* newData = (maxLines > 0 && lineBytes) ? (uint8_t*)malloc(lineBytes * maxLines) : NULL;
+        int newCount = 0;
+        if (keep && newData) {
+            newCount = std::min<int>(count, maxLines);
+            for (int i = 0; i < newCount; i++) {
+                memcpy(&newData[i * lineBytes], &data[((head + i) % oldMaxLines) * lineBytes], lineBytes);
+            }
+        }
+        free(data);
+        data = newData;
+        head = 0;
+        count = newCount;
+    }
+
+    template <class T>
+    void WaterfallHistory::store(SpectrumPyramid& pyramid, T* dst) {
+        // Quantize the levels of the pyramid that are kept
+        float qMin = highPrecision ? Q16_MIN : Q8_MIN;
+        float qScale = highPrecision ? Q16_SCALE : Q8_SCALE;
+        float qMax = (float)((1 << (8 * sizeof(T))) - 1);
+        for (int k = baseLevel; k < levelSizes.size(); k++) {
+            const float* level = pyramid.getLevel(k);
+            T* out = &dst[levelOffsets[k]];
+            for (int i = 0; i < levelSizes[k]; i++) {
+                out[i] = (T)(std::clamp<float>((level[i] - qMin) * qScale, 0.0f, qMax) + 0.5f);
+            }
+        }
+    }
+
+    template <class T>
+    void WaterfallHistory::renderLevels(const T* src, int offset, int width, float* out, int outSize) {
+        double factor = (double)width / (double)outSize;
+        int span = std::max<int>(ceil(factor), 1);
+        float qMin = highPrecision ? Q16_MIN : Q8_MIN;
+        float qStep = 1.0f / (highPrecision ? Q16_SCALE : Q8_SCALE);
+        int topLevel = levelSizes.size() - 1;
+
+        for (int i = 0; i < outSize; i++) {
+            // Bins covered by the output point, at the finest stored level
+            int first = std::clamp<int>(offset + (int)(i * factor), 0, lineSize - 1);
+            int last = std::clamp<int>(first + span - 1, 0, lineSize - 1);
+            int lo = first >> baseLevel;
+            int hi = last >> baseLevel;
+
+            // Cover the range with the largest aligned blocks of the pyramid, climbing one level per step
+            T maxVal = 0;
+            for (int k = baseLevel; k <= topLevel && lo <= hi; k++) {
+                const T* lvl = &src[levelOffsets[k]];
+                if (lo & 1) { maxVal = std::max<T>(maxVal, lvl[lo++]); }
+                if (!(hi & 1)) { maxVal = std::max<T>(maxVal, lvl[hi--]); }
+                lo >>= 1;
+                hi >>= 1;
+            }
+            out[i] = qMin + (float)maxVal * qStep;
+        }
+    }
+}
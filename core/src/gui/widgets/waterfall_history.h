@@ -0,0 +1,82 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <gui/widgets/spectrum_pyramid.h>
+
+#define WATERFALL_HISTORY_DEFAULT_BUDGET    (256 * 1024 * 1024)
+
+namespace ImGui {
+    // Stores past FFT lines for the waterfall as quantized dB, each with a max-reduced resolution
+    // pyramid so that any zoom can be rendered by reading a few values per output pixel. When the
+    // memory budget doesn't allow the full resolution, the finest levels of the pyramid are dropped.
+    class WaterfallHistory {
+    public:
+        WaterfallHistory() {}
+        ~WaterfallHistory();
+
+        /**
+         * Set the memory budget and precision. Clears the history if the layout changes.
+         * @param budget Maximum memory used by the stored lines, in bytes.
+         * @param highPrecision Store lines as 16bit (0.01dB steps) instead of 8bit (~0.7dB steps).
+        */
+        void setStorage(size_t budget, bool highPrecision);
+
+        /**
+         * Set the size of the lines and how many of them to keep. The newest lines are kept if the layout allows it.
+         * @param lineSize Number of bins in an FFT line.
+         * @param maxLines Number of lines to keep.
+        */
+        void setSize(int lineSize, int maxLines);
+
+        void clear();
+
+        /**
+         * Add a new line, evicting the oldest one if full.
+         * @param pyramid Pyramid built from the FFT line in dB, lineSize bins.
+        */
+        void push(SpectrumPyramid& pyramid);
+
+        int getLineCount() { return count; }
+
+        /**
+         * Get the size of a stored line in bytes, pyramid included.
+        */
+        size_t getLineBytes() { return storedSize * bytesPerValue; }
+
+        /**
+         * Render a span of a line at the given output resolution, taking the max of the bins falling into each output point.
+         * @param line Age of the line, 0 being the newest.
+         * @param offset First bin of the span.
+         * @param width Number of bins in the span.
+         * @param out Output buffer in dB.
+         * @param outSize Number of output points.
+        */
+        void render(int line, int offset, int width, float* out, int outSize);
+
+    private:
+        void updateLayout(int oldMaxLines, bool keep);
+
+        template <class T>
+        void store(SpectrumPyramid& pyramid, T* dst);
+
+        template <class T>
+        void renderLevels(const T* src, int offset, int width, float* out, int outSize);
+
+        size_t budget = WATERFALL_HISTORY_DEFAULT_BUDGET;
+        bool highPrecision = false;
+        int lineSize = 0;
+        int maxLines = 0;
+
+        // Layout of a stored line, levels from baseLevel upwards
+        int baseLevel = 0;
+        std::vector<int> levelOffsets;
+        std::vector<int> levelSizes;
+        int storedSize = 0;
+        int bytesPerValue = 1;
+
+        uint8_t* data = NULL;
+        int head = 0;
+        int count = 0;
+    };
+}
@@ -1,9 +1,29 @@
 #include <module.h>
 #include <filesystem>
+#include <chrono>
+#include <algorithm>
 #include <utils/flog.h>
 
+static double msSince(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+static std::string formatMs(double ms) {
+    char buf[32];
+    sprintf(buf, "%.1lfms", ms);
+    return buf;
+}
+
 ModuleManager::Module_t ModuleManager::loadModule(std::string path) {
+    double loadTime;
+    Module_t mod = openModule(path, loadTime);
+    return registerModule(mod, path, loadTime);
+}
+
+ModuleManager::Module_t ModuleManager::openModule(std::string path, double& loadTime) {
     Module_t mod;
+    auto start = std::chrono::high_resolution_clock::now();
+    loadTime = 0.0;
 
     // On android, the path has to be relative, don't make it absolute
 #ifndef __ANDROID__
@@ -68,6 +88,12 @@ ModuleManager::Module_t ModuleManager::loadModule(std::string path) {
         mod.handle = NULL;
         return mod;
     }
+    loadTime = msSince(start);
+    return mod;
+}
+
+ModuleManager::Module_t ModuleManager::registerModule(ModuleManager::Module_t mod, std::string path, double loadTime) {
+    if (mod.handle == NULL) { return mod; }
     if (modules.find(mod.info->name) != modules.end()) {
         flog::error("{0} has the same name as an already loaded module", path);
         mod.handle = NULL;
@@ -78,12 +104,15 @@ ModuleManager::Module_t ModuleManager::loadModule(std::string path) {
             return _mod;
         }
     }
+    auto start = std::chrono::high_resolution_clock::now();
     mod.init();
     modules[mod.info->name] = mod;
+    moduleTimings[mod.info->name].load = loadTime;
+    moduleTimings[mod.info->name].init = msSince(start);
     return mod;
 }
 
-int ModuleManager::createInstance(std::string name, std::string module) {
+int ModuleManager::createInstance(std::string name, std::string module, bool deferred, bool enabled) {
     if (modules.find(module) == modules.end()) {
         flog::error("Module '{0}' doesn't exist", module);
         return -1;
@@ -99,12 +128,47 @@ int ModuleManager::createInstance(std::string name, std::string module) {
     }
     Instance_t inst;
     inst.module = modules[module];
-    inst.instance = inst.module.createInstance(name);
+    if (deferred) {
+        placeholders[name] = new DeferredInstance(this, name);
+        inst.instance = placeholders[name];
+        inst.deferred = true;
+        inst.deferredEnabled = enabled;
+    }
+    else {
+        auto start = std::chrono::high_resolution_clock::now();
+        inst.instance = inst.module.createInstance(name);
+        instanceTimings[name].create = msSince(start);
+    }
     instances[name] = inst;
     onInstanceCreated.emit(name);
     return 0;
 }
 
+void ModuleManager::realizeInstance(std::string name) {
+    Instance_t& inst = instances[name];
+    flog::info("Creating deferred instance {0}", name);
+    auto start = std::chrono::high_resolution_clock::now();
+    Instance* instance = inst.module.createInstance(name);
+    instanceTimings[name].create = msSince(start);
+
+    // The real instance starts in the state the placeholder reported, it's only changed by the caller
+    if (!inst.deferredEnabled) { instance->disable(); }
+    inst.instance = instance;
+    inst.deferred = false;
+    if (postInitDone) { postInit(name); }
+
+    // Let whatever still points to the placeholder switch to the real instance before freeing it
+    onInstanceRealized.emit(name);
+    freePlaceholder(name);
+}
+
+void ModuleManager::freePlaceholder(std::string name) {
+    auto it = placeholders.find(name);
+    if (it == placeholders.end()) { return; }
+    delete it->second;
+    placeholders.erase(it);
+}
+
 int ModuleManager::deleteInstance(std::string name) {
     if (instances.find(name) == instances.end()) {
         flog::error("Tried to remove non-existent instance '{0}'", name);
@@ -112,7 +176,9 @@ int ModuleManager::deleteInstance(std::string name) {
     }
     onInstanceDelete.emit(name);
     Instance_t inst = instances[name];
-    inst.module.deleteInstance(inst.instance);
+    if (!inst.deferred) { inst.module.deleteInstance(inst.instance); }
+    freePlaceholder(name);
+    instanceTimings.erase(name);
     instances.erase(name);
     onInstanceDeleted.emit(name);
     return 0;
@@ -128,6 +194,7 @@ int ModuleManager::enableInstance(std::string name) {
         flog::error("Cannot enable '{0}', instance doesn't exist", name);
         return -1;
     }
+    if (instances[name].deferred) { realizeInstance(name); }
     instances[name].instance->enable();
     return 0;
 }
@@ -137,6 +204,10 @@ int ModuleManager::disableInstance(std::string name) {
         flog::error("Cannot disable '{0}', instance doesn't exist", name);
         return -1;
     }
+    if (instances[name].deferred) {
+        instances[name].deferredEnabled = false;
+        return 0;
+    }
     instances[name].instance->disable();
     return 0;
 }
@@ -146,15 +217,27 @@ bool ModuleManager::instanceEnabled(std::string name) {
         flog::error("Cannot check if '{0}' is enabled, instance doesn't exist", name);
         return false;
     }
+    if (instances[name].deferred) { return instances[name].deferredEnabled; }
     return instances[name].instance->isEnabled();
 }
 
+bool ModuleManager::instanceDeferred(std::string name) {
+    if (instances.find(name) == instances.end()) {
+        flog::error("Cannot check if '{0}' is deferred, instance doesn't exist", name);
+        return false;
+    }
+    return instances[name].deferred;
+}
+
 void ModuleManager::postInit(std::string name) {
     if (instances.find(name) == instances.end()) {
         flog::error("Cannot post-init '{0}', instance doesn't exist", name);
         return;
     }
+    if (instances[name].deferred) { return; }
+    auto start = std::chrono::high_resolution_clock::now();
     instances[name].instance->postInit();
+    instanceTimings[name].postInit = msSince(start);
 }
 
 std::string ModuleManager::getInstanceModuleName(std::string name) {
@@ -180,7 +263,34 @@ int ModuleManager::countModuleInstances(std::string module) {
 
 void ModuleManager::doPostInitAll() {
     for (auto& [name, inst] : instances) {
+        if (inst.deferred) { continue; }
         flog::info("Running post-init for {0}", name);
-        inst.instance->postInit();
+        postInit(name);
+    }
+    postInitDone = true;
+}
+
+void ModuleManager::printStartupReport() {
+    std::vector<std::pair<double, std::string>> lines;
+    double total = 0.0;
+    for (auto const& [name, t] : moduleTimings) {
+        lines.push_back({ t.load + t.init, "Module " + name + ": load " + formatMs(t.load) + ", init " + formatMs(t.init) });
+        total += t.load + t.init;
+    }
+    int deferredCount = 0;
+    for (auto const& [name, inst] : instances) {
+        if (inst.deferred) {
+            deferredCount++;
+            continue;
+        }
+        InstanceTiming_t t = instanceTimings[name];
+        lines.push_back({ t.create + t.postInit, "Instance " + name + " (" + inst.module.info->name + "): create " + formatMs(t.create) + ", post-init " + formatMs(t.postInit) });
+        total += t.create + t.postInit;
+    }
+    std::sort(lines.begin(), lines.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    flog::info("Module startup report ({0} total, {1} deferred instances):", formatMs(total), deferredCount);
+    for (auto const& [time, line] : lines) {
+        flog::info("    {0}", line);
     }
 }
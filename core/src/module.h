@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <map>
+#include <vector>
 #include <json.hpp>
 #include <utils/event.h>
 
@@ -75,17 +76,29 @@ public:
     struct Instance_t {
         ModuleManager::Module_t module;
         ModuleManager::Instance* instance;
+        bool deferred = false;
+        bool deferredEnabled = false;
     };
 
     ModuleManager::Module_t loadModule(std::string path);
 
-    int createInstance(std::string name, std::string module);
+    /**
+     * Create a module instance.
+     * @param name Name of the instance.
+     * @param module Name of the module.
+     * @param deferred Don't create the instance until it gets enabled. Meant for instances that start disabled,
+     * or that aren't needed until something else asks for them.
+     * @param enabled State reported by a deferred instance. Enabling a deferred instance creates it, even if it already reports enabled.
+     * @return 0 on success, -1 otherwise.
+    */
+    int createInstance(std::string name, std::string module, bool deferred = false, bool enabled = false);
     int deleteInstance(std::string name);
     int deleteInstance(ModuleManager::Instance* instance);
 
     int enableInstance(std::string name);
     int disableInstance(std::string name);
     bool instanceEnabled(std::string name);
+    bool instanceDeferred(std::string name);
     void postInit(std::string name);
     std::string getInstanceModuleName(std::string name);
 
@@ -93,12 +106,59 @@ public:
 
     void doPostInitAll();
 
+    /**
+     * Log the time spent loading each module and creating each instance, slowest first.
+    */
+    void printStartupReport();
+
     Event<std::string> onInstanceCreated;
     Event<std::string> onInstanceDelete;
     Event<std::string> onInstanceDeleted;
 
+    // Emitted when a deferred instance gets created, its placeholder is freed right after
+    Event<std::string> onInstanceRealized;
+
     std::map<std::string, ModuleManager::Module_t> modules;
     std::map<std::string, ModuleManager::Instance_t> instances;
+
+private:
+    // Stands in for an instance that hasn't been created yet, creating it once enabled
+    class DeferredInstance : public Instance {
+    public:
+        DeferredInstance(ModuleManager* manager, std::string name) : manager(manager), name(name) {}
+        void postInit() {}
+        // Enabling frees the placeholder, nothing must be accessed after the call
+        void enable() { manager->enableInstance(name); }
+        void disable() { manager->disableInstance(name); }
+        bool isEnabled() { return manager->instanceEnabled(name); }
+
+    private:
+        ModuleManager* manager;
+        std::string name;
+    };
+
+    struct ModuleTiming_t {
+        double load = 0.0;
+        double init = 0.0;
+    };
+
+    struct InstanceTiming_t {
+        double create = 0.0;
+        double postInit = 0.0;
+    };
+
+    ModuleManager::Module_t openModule(std::string path, double& loadTime);
+    ModuleManager::Module_t registerModule(ModuleManager::Module_t mod, std::string path, double loadTime);
+    void realizeInstance(std::string name);
+    void freePlaceholder(std::string name);
+
+    bool postInitDone = false;
+
+    // Placeholders of the instances that are still deferred
+    std::map<std::string, ModuleManager::Instance*> placeholders;
+
+    std::map<std::string, ModuleTiming_t> moduleTimings;
+    std::map<std::string, InstanceTiming_t> instanceTimings;
 };
 
 #define SDRPP_MOD_INFO MOD_EXPORT const ModuleManager::ModuleInfo_t _INFO_
\ No newline at end of file
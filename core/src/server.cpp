@@ -136,6 +136,7 @@ namespace server {
 
         // Do post-init
         core::moduleManager.doPostInitAll();
+        core::moduleManager.printStartupReport();
 
         // Generate source list
         auto list = sigpath::sourceManager.getSourceNames();
@@ -312,7 +313,7 @@ namespace server {
             sigpath::sourceManager.selectSource(sourceList[sourceId]);
             core::configManager.acquire();
             core::configManager.conf["source"] = sourceList.key(sourceId);
-            core::configManager.release(true);
+            core::configManager.releaseKey("source");
         }
         if (running) { SmGui::EndDisabled(); }
 
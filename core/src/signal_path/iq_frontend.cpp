@@ -12,6 +12,7 @@ IQFrontEnd::~IQFrontEnd() {
     fftwf_destroy_plan(fftwPlan);
     fftwf_free(fftInBuf);
     fftwf_free(fftOutBuf);
+    dsp::buffer::free(fftDbOut);
 }
 
 void IQFrontEnd::init(dsp::stream<dsp::complex_t>* in, double sampleRate, bool buffering, int decimRatio, bool dcBlocking, int fftSize, double fftRate, FFTWindow fftWindow, float* (*acquireFFTBuffer)(void* ctx), void (*releaseFFTBuffer)(void* ctx), void* fftCtx) {
@@ -60,6 +61,7 @@ void IQFrontEnd::init(dsp::stream<dsp::complex_t>* in, double sampleRate, bool b
     fftInBuf = (fftwf_complex*)fftwf_malloc(_fftSize * sizeof(fftwf_complex));
     fftOutBuf = (fftwf_complex*)fftwf_malloc(_fftSize * sizeof(fftwf_complex));
     fftwPlan = fftwf_plan_dft_1d(_fftSize, fftInBuf, fftOutBuf, FFTW_FORWARD, FFTW_ESTIMATE);
+    fftDbOut = dsp::buffer::alloc<float>(_fftSize);
 
     // Clear the rest of the FFT input buffer
     dsp::buffer::clear(fftInBuf, _fftSize - _nzFFTSize, _nzFFTSize);
@@ -254,12 +256,26 @@ void IQFrontEnd::handler(dsp::complex_t* data, int count, void* ctx) {
     // Execute FFT
     fftwf_execute(_this->fftwPlan);
 
+    // Without listeners, convert the complex output of the FFT to dB amplitude straight into the waterfall
+    if (_this->onFFT.empty()) {
+        float* fftBuf = _this->_acquireFFTBuffer(_this->_fftCtx);
+        if (fftBuf) {
+            volk_32fc_s32f_power_spectrum_32f(fftBuf, (lv_32fc_t*)_this->fftOutBuf, _this->_fftSize, _this->_fftSize);
+        }
+        _this->_releaseFFTBuffer(_this->_fftCtx);
+        return;
+    }
+
+    // Otherwise convert it once and hand it to the listeners
+    volk_32fc_s32f_power_spectrum_32f(_this->fftDbOut, (lv_32fc_t*)_this->fftOutBuf, _this->_fftSize, _this->_fftSize);
+    _this->onFFT(_this->fftDbOut, _this->_fftSize);
+
     // Aquire buffer
     float* fftBuf = _this->_acquireFFTBuffer(_this->_fftCtx);
 
-    // Convert the complex output of the FFT to dB amplitude
+    // Copy the frame to the waterfall
     if (fftBuf) {
-        volk_32fc_s32f_power_spectrum_32f(fftBuf, (lv_32fc_t*)_this->fftOutBuf, _this->_fftSize, _this->_fftSize);
+        memcpy(fftBuf, _this->fftDbOut, _this->_fftSize * sizeof(float));
     }
 
     // Release buffer
@@ -296,6 +312,8 @@ void IQFrontEnd::updateFFTPath(bool updateWaterfall) {
     fftInBuf = (fftwf_complex*)fftwf_malloc(_fftSize * sizeof(fftwf_complex));
     fftOutBuf = (fftwf_complex*)fftwf_malloc(_fftSize * sizeof(fftwf_complex));
     fftwPlan = fftwf_plan_dft_1d(_fftSize, fftInBuf, fftOutBuf, FFTW_FORWARD, FFTW_ESTIMATE);
+    dsp::buffer::free(fftDbOut);
+    fftDbOut = dsp::buffer::alloc<float>(_fftSize);
 
     // Clear the rest of the FFT input buffer
     dsp::buffer::clear(fftInBuf, _fftSize - _nzFFTSize, _nzFFTSize);
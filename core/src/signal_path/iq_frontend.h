@@ -8,6 +8,7 @@
 #include "../dsp/channel/rx_vfo.h"
 #include "../dsp/sink/handler_sink.h"
 #include "../dsp/math/conjugate.h"
+#include "../utils/new_event.h"
 #include <fftw3.h>
 
 class IQFrontEnd {
@@ -48,6 +49,9 @@ public:
 
     double getEffectiveSamplerate();
 
+    // Emitted from the DSP thread with every full band FFT frame in dB (data, size), whether or not the waterfall is shown
+    NewEvent<const float*, int> onFFT;
+
 protected:
     static void handler(dsp::complex_t* data, int count, void* ctx);
     void updateFFTPath(bool updateWaterfall = false);
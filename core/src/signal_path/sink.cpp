@@ -68,6 +68,18 @@ void SinkManager::Stream::setInput(dsp::stream<dsp::stereo_t>* in) {
     splitter.setInput(_in);
 }
 
+void SinkManager::Stream::setLatencyProvider(double (*provider)(void* ctx), void* ctx) {
+    std::lock_guard<std::mutex> lck(ctrlMtx);
+    latencyProvider = provider;
+    latencyProviderCtx = ctx;
+}
+
+double SinkManager::Stream::getUpstreamLatency() {
+    std::lock_guard<std::mutex> lck(ctrlMtx);
+    if (!latencyProvider) { return 0.0; }
+    return latencyProvider(latencyProviderCtx);
+}
+
 dsp::stream<dsp::stereo_t>* SinkManager::Stream::bindStream() {
     dsp::stream<dsp::stereo_t>* stream = new dsp::stream<dsp::stereo_t>;
     splitter.bindStream(stream);
@@ -273,7 +285,7 @@ void SinkManager::showVolumeSlider(std::string name, std::string prefix, float w
             stream->volumeAjust.setMuted(false);
             core::configManager.acquire();
             saveStreamConfig(name);
-            core::configManager.release(true);
+            core::configManager.releaseKey("streams");
         }
         ImGui::PopID();
     }
@@ -283,7 +295,7 @@ void SinkManager::showVolumeSlider(std::string name, std::string prefix, float w
             stream->volumeAjust.setMuted(true);
             core::configManager.acquire();
             saveStreamConfig(name);
-            core::configManager.release(true);
+            core::configManager.releaseKey("streams");
         }
         ImGui::PopID();
     }
@@ -296,7 +308,7 @@ void SinkManager::showVolumeSlider(std::string name, std::string prefix, float w
         stream->setVolume(stream->guiVolume);
         core::configManager.acquire();
         saveStreamConfig(name);
-        core::configManager.release(true);
+        core::configManager.releaseKey("streams");
     }
     if (sameLine) { ImGui::SetCursorPosY(ypos); }
     //ImGui::SetCursorPosY(ypos);
@@ -361,7 +373,7 @@ void SinkManager::showMenu() {
             setStreamSink(name, providerNames[stream->providerId]);
             core::configManager.acquire();
             saveStreamConfig(name);
-            core::configManager.release(true);
+            core::configManager.releaseKey("streams");
         }
 
         stream->sink->menuHandler();
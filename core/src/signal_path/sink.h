@@ -40,6 +40,10 @@ public:
 
         void setInput(dsp::stream<dsp::stereo_t>* in);
 
+        // Lets the owner of the stream report the delay of its DSP chain, in seconds
+        void setLatencyProvider(double (*provider)(void* ctx), void* ctx);
+        double getUpstreamLatency();
+
         dsp::stream<dsp::stereo_t>* bindStream();
         void unbindStream(dsp::stream<dsp::stereo_t>* stream);
 
@@ -62,6 +66,9 @@ public:
         std::string providerName = "";
         bool running = false;
 
+        double (*latencyProvider)(void* ctx) = NULL;
+        void* latencyProviderCtx = NULL;
+
         float guiVolume = 1.0f;
     };
 
@@ -3,6 +3,7 @@
 #include <utils/flog.h>
 #include <signal_path/signal_path.h>
 #include <core.h>
+#include <algorithm>
 
 SourceManager::SourceManager() {
 }
@@ -12,10 +13,46 @@ void SourceManager::registerSource(std::string name, SourceHandler* handler) {
         flog::error("Tried to register new source with existing name: {0}", name);
         return;
     }
+    deferredSources.erase(name);
     sources[name] = handler;
     onSourceRegistered.emit(name);
 }
 
+void SourceManager::registerDeferredSource(std::string name, void (*createHandler)(std::string name, void* ctx), void* ctx) {
+    if (sources.find(name) != sources.end() || deferredSources.find(name) != deferredSources.end()) {
+        flog::error("Tried to register new deferred source with existing name: {0}", name);
+        return;
+    }
+    deferredSources[name] = { createHandler, ctx };
+    onSourceRegistered.emit(name);
+}
+
+void SourceManager::unregisterDeferredSource(std::string name) {
+    if (deferredSources.find(name) == deferredSources.end()) {
+        flog::error("Tried to unregister non existent deferred source: {0}", name);
+        return;
+    }
+    onSourceUnregister.emit(name);
+    deferredSources.erase(name);
+    onSourceUnregistered.emit(name);
+}
+
+void SourceManager::createDeferredSource(std::string name) {
+    auto it = deferredSources.find(name);
+    if (it == deferredSources.end()) { return; }
+    DeferredSource ds = it->second;
+    deferredSources.erase(it);
+
+    flog::info("Creating the module instance of source {0}", name);
+    ds.createHandler(name, ds.ctx);
+
+    // Take the entry out of the source lists if the instance didn't register it
+    if (sources.find(name) == sources.end()) {
+        flog::error("Creating the instance of source {0} didn't register it", name);
+        onSourceUnregistered.emit(name);
+    }
+}
+
 void SourceManager::unregisterSource(std::string name) {
     if (sources.find(name) == sources.end()) {
         flog::error("Tried to unregister non existent source: {0}", name);
@@ -36,10 +73,23 @@ void SourceManager::unregisterSource(std::string name) {
 std::vector<std::string> SourceManager::getSourceNames() {
     std::vector<std::string> names;
     for (auto const& [name, src] : sources) { names.push_back(name); }
+    for (auto const& [name, ds] : deferredSources) { names.push_back(name); }
+    std::sort(names.begin(), names.end());
     return names;
 }
 
+SourceManager::SourceHandler* SourceManager::getSourceHandler(std::string name) {
+    createDeferredSource(name);
+    auto it = sources.find(name);
+    return (it != sources.end()) ? it->second : NULL;
+}
+
 void SourceManager::selectSource(std::string name) {
+    // Registering the real source already reselects it through the source menu
+    if (deferredSources.find(name) != deferredSources.end()) {
+        createDeferredSource(name);
+        if (selectedHandler != NULL && selectedName == name) { return; }
+    }
     if (sources.find(name) == sources.end()) {
         flog::error("Tried to select non existent source: {0}", name);
         return;
@@ -2,6 +2,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <atomic>
 #include <dsp/stream.h>
 #include <dsp/types.h>
 #include <utils/event.h>
@@ -28,6 +29,16 @@ public:
 
     void registerSource(std::string name, SourceHandler* handler);
     void unregisterSource(std::string name);
+
+    /**
+     * List a source whose module instance hasn't been created yet. The first time the source is selected or its
+     * handler is requested, createHandler is called and must create the instance, which registers the real source.
+     * @param name Name of the source.
+     * @param createHandler Called with the name of the source to create its instance.
+     * @param ctx Context passed to the handler.
+    */
+    void registerDeferredSource(std::string name, void (*createHandler)(std::string name, void* ctx), void* ctx);
+    void unregisterDeferredSource(std::string name);
     void selectSource(std::string name);
     void showSelectedMenu();
     void start();
@@ -36,20 +47,36 @@ public:
     void setTuningOffset(double offset);
     void setTuningMode(TuningMode mode);
     void setPanadapterIF(double freq);
+    double getCenterFrequency() { return currentFreq; }
 
     std::vector<std::string> getSourceNames();
 
+    /**
+     * Get the handler of a source, to drive it from another module.
+     * @param name Name of the source.
+     * @return Handler of the source, NULL if it doesn't exist.
+    */
+    SourceHandler* getSourceHandler(std::string name);
+
     Event<std::string> onSourceRegistered;
     Event<std::string> onSourceUnregister;
     Event<std::string> onSourceUnregistered;
     Event<double> onRetune;
 
 private:
+    struct DeferredSource {
+        void (*createHandler)(std::string name, void* ctx);
+        void* ctx;
+    };
+
+    void createDeferredSource(std::string name);
+
     std::map<std::string, SourceHandler*> sources;
+    std::map<std::string, DeferredSource> deferredSources;
     std::string selectedName;
     SourceHandler* selectedHandler = NULL;
     double tuneOffset;
-    double currentFreq;
+    std::atomic<double> currentFreq = 0.0;
     double ifFreq = 0.0;
     TuningMode tuneMode = TuningMode::NORMAL;
     dsp::stream<dsp::complex_t> nullSource;
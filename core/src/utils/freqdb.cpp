@@ -0,0 +1,344 @@
+#include "freqdb.h"
+#include <utils/flog.h>
+#include <algorithm>
+#include <fstream>
+#include <filesystem>
+#include <sstream>
+#include <string.h>
+#include <math.h>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace freqdb {
+    // The layout is the file format, it must not depend on the platform
+    static_assert(sizeof(Header) == 56, "Unexpected freqdb header size");
+    static_assert(sizeof(Entry) == 40, "Unexpected freqdb entry size");
+
+    Database::~Database() {
+        close();
+    }
+
+    bool Database::open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) {
+            flog::error("Could not open frequency database {0}", path);
+            return false;
+        }
+        LARGE_INTEGER fsize;
+        GetFileSizeEx(file, &fsize);
+        size = fsize.QuadPart;
+        mapping = (size > 0) ? CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+        data = mapping ? (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+        if (!data) {
+            flog::error("Could not map frequency database {0}", path);
+            close();
+            return false;
+        }
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            flog::error("Could not open frequency database {0}", path);
+            return false;
+        }
+        struct stat st;
+        void* ptr = MAP_FAILED;
+        if (!fstat(fd, &st) && st.st_size > 0) {
+            size = st.st_size;
+            ptr = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if (ptr == MAP_FAILED) {
+            flog::error("Could not map frequency database {0}", path);
+            size = 0;
+            return false;
+        }
+        data = (const uint8_t*)ptr;
+        mapped = true;
+#endif
+        if (!validate()) {
+            flog::error("{0} is not a valid frequency database", path);
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    bool Database::open(std::vector<uint8_t>&& data) {
+        close();
+        owned = std::move(data);
+        this->data = owned.data();
+        size = owned.size();
+        if (!validate()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void Database::close() {
+#ifdef _WIN32
+        if (data && mapping) { UnmapViewOfFile(data); }
+        if (mapping) { CloseHandle(mapping); }
+        if (file != INVALID_HANDLE_VALUE) { CloseHandle(file); }
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (mapped) { munmap((void*)data, size); }
+        mapped = false;
+#endif
+        owned.clear();
+        data = NULL;
+        size = 0;
+        header = NULL;
+        entries = NULL;
+        meta = NULL;
+        strings = NULL;
+    }
+
+    std::string Database::getMeta(const std::string& key) {
+        if (!header) { return ""; }
+        for (uint32_t i = 0; i < header->metaCount; i++) {
+            if (key == getString(meta[i].key)) { return getString(meta[i].value); }
+        }
+        return "";
+    }
+
+    int Database::findFirst(double low) {
+        if (!header) { return 0; }
+        // maxEnd never decreases, so the entries before this one all end below the frequency
+        const Entry* it = std::lower_bound(entries, entries + header->entryCount, low, [](const Entry& e, double freq) {
+            return e.maxEnd < freq;
+        });
+        return it - entries;
+    }
+
+    bool Database::validate() {
+        if (size < sizeof(Header)) { return false; }
+        const Header* hdr = (const Header*)data;
+        if (memcmp(hdr->signature, SIGNATURE, sizeof(SIGNATURE)) || hdr->version != VERSION) { return false; }
+
+        // Check that every table lies within the file and that the string table is terminated. String offsets
+        // are checked on access instead, so that opening doesn't have to read the whole file.
+        if (hdr->entriesOffset > size || (size - hdr->entriesOffset) / sizeof(Entry) < hdr->entryCount) { return false; }
+        if (hdr->metaOffset > size || (size - hdr->metaOffset) / sizeof(MetaEntry) < hdr->metaCount) { return false; }
+        if (hdr->stringsOffset > size || hdr->stringsSize > size - hdr->stringsOffset || !hdr->stringsSize) { return false; }
+        if (hdr->entriesOffset % alignof(Entry) || hdr->metaOffset % alignof(MetaEntry)) { return false; }
+        const char* strs = (const char*)&data[hdr->stringsOffset];
+        if (strs[hdr->stringsSize - 1] != 0) { return false; }
+        const Entry* ents = (const Entry*)&data[hdr->entriesOffset];
+        const MetaEntry* mt = (const MetaEntry*)&data[hdr->metaOffset];
+
+        header = hdr;
+        entries = ents;
+        meta = mt;
+        strings = strs;
+        return true;
+    }
+
+    class StringTable {
+    public:
+        StringTable() { data.push_back(0); }
+
+        uint32_t add(const std::string& str) {
+            if (str.empty()) { return 0; }
+            auto it = offsets.find(str);
+            if (it != offsets.end()) { return it->second; }
+            uint32_t off = data.size();
+            data.insert(data.end(), str.begin(), str.end());
+            data.push_back(0);
+            offsets[str] = off;
+            return off;
+        }
+
+        std::vector<char> data;
+
+    private:
+        std::map<std::string, uint32_t> offsets;
+    };
+
+    std::vector<uint8_t> build(std::vector<Record> records, const std::map<std::string, std::string>& meta) {
+        std::stable_sort(records.begin(), records.end(), [](const Record& a, const Record& b) {
+            return a.start < b.start;
+        });
+
+        // Types repeat a lot, the string table keeps a single copy of each string
+        StringTable strs;
+        std::vector<Entry> entries(records.size());
+        double maxEnd = -INFINITY;
+        uint32_t maxNameLength = 0;
+        for (int i = 0; i < records.size(); i++) {
+            const Record& r = records[i];
+            Entry& e = entries[i];
+            e.start = r.start;
+            e.end = std::max<double>(r.start, r.end);
+            maxEnd = std::max<double>(maxEnd, e.end);
+            e.maxEnd = maxEnd;
+            e.bandwidth = r.bandwidth;
+            e.mode = r.mode;
+            e.name = strs.add(r.name);
+            e.type = strs.add(r.type);
+            maxNameLength = std::max<uint32_t>(maxNameLength, r.name.size());
+        }
+        std::vector<MetaEntry> metaEntries;
+        for (auto const& [key, value] : meta) {
+            metaEntries.push_back({ strs.add(key), strs.add(value) });
+        }
+
+        Header hdr;
+        memcpy(hdr.signature, SIGNATURE, sizeof(SIGNATURE));
+        hdr.version = VERSION;
+        hdr.entryCount = entries.size();
+        hdr.entriesOffset = sizeof(Header);
+        hdr.metaCount = metaEntries.size();
+        hdr.maxNameLength = maxNameLength;
+        hdr.metaOffset = hdr.entriesOffset + entries.size() * sizeof(Entry);
+        hdr.stringsOffset = hdr.metaOffset + metaEntries.size() * sizeof(MetaEntry);
+        hdr.stringsSize = strs.data.size();
+
+        std::vector<uint8_t> out(hdr.stringsOffset + hdr.stringsSize);
+        memcpy(&out[0], &hdr, sizeof(Header));
+        if (!entries.empty()) { memcpy(&out[hdr.entriesOffset], entries.data(), entries.size() * sizeof(Entry)); }
+        if (!metaEntries.empty()) { memcpy(&out[hdr.metaOffset], metaEntries.data(), metaEntries.size() * sizeof(MetaEntry)); }
+        memcpy(&out[hdr.stringsOffset], strs.data.data(), strs.data.size());
+        return out;
+    }
+
+    bool write(const std::string& path, const std::vector<Record>& records, const std::map<std::string, std::string>& meta) {
+        std::vector<uint8_t> data = build(records, meta);
+
+        // Write to a temporary file and swap it in, the existing file may still be mapped by a reader
+        std::string tempPath = path + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                flog::error("Could not open {0} for writing", tempPath);
+                return false;
+            }
+            file.write((const char*)data.data(), data.size());
+            file.close();
+            if (file.fail()) {
+                flog::error("Failed to write {0}", tempPath);
+                std::filesystem::remove(tempPath);
+                return false;
+            }
+        }
+        std::error_code err;
+        std::filesystem::rename(tempPath, path, err);
+        if (err) {
+            flog::error("Failed to replace {0}: {1}", path, err.message());
+            std::filesystem::remove(tempPath, err);
+            return false;
+        }
+        return true;
+    }
+
+    static std::vector<std::string> splitCSVLine(const std::string& line) {
+        std::vector<std::string> fields;
+        std::string field;
+        bool quoted = false;
+        for (int i = 0; i < line.size(); i++) {
+            char c = line[i];
+            if (quoted) {
+                if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                    field += '"';
+                    i++;
+                }
+                else if (c == '"') {
+                    quoted = false;
+                }
+                else {
+                    field += c;
+                }
+            }
+            else if (c == '"') {
+                quoted = true;
+            }
+            else if (c == ',') {
+                fields.push_back(field);
+                field.clear();
+            }
+            else if (c != '\r') {
+                field += c;
+            }
+        }
+        fields.push_back(field);
+        return fields;
+    }
+
+    static std::string toLower(std::string str) {
+        std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+        return str;
+    }
+
+    bool readCSV(const std::string& path, std::vector<Record>& records, const std::vector<std::string>& modeNames) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            flog::error("Could not open {0}", path);
+            return false;
+        }
+
+        // Find the recognized columns
+        std::string line;
+        if (!std::getline(file, line)) { return false; }
+        std::vector<std::string> columns = splitCSVLine(line);
+        int nameCol = -1, typeCol = -1, startCol = -1, endCol = -1, freqCol = -1, bwCol = -1, modeCol = -1;
+        for (int i = 0; i < columns.size(); i++) {
+            std::string col = toLower(columns[i]);
+            if (col == "name") { nameCol = i; }
+            else if (col == "type") { typeCol = i; }
+            else if (col == "start") { startCol = i; }
+            else if (col == "end") { endCol = i; }
+            else if (col == "frequency") { freqCol = i; }
+            else if (col == "bandwidth") { bwCol = i; }
+            else if (col == "mode") { modeCol = i; }
+        }
+        if (freqCol < 0 && startCol < 0) {
+            flog::error("{0} has neither a frequency nor a start column", path);
+            return false;
+        }
+
+        int lineNum = 1;
+        while (std::getline(file, line)) {
+            lineNum++;
+            if (line.empty() || line == "\r") { continue; }
+            std::vector<std::string> fields = splitCSVLine(line);
+            fields.resize(std::max<size_t>(fields.size(), columns.size()));
+            Record r;
+            try {
+                if (freqCol >= 0) {
+                    r.start = std::stod(fields[freqCol]);
+                    r.end = r.start;
+                }
+                if (startCol >= 0) { r.start = std::stod(fields[startCol]); }
+                if (endCol >= 0) { r.end = std::stod(fields[endCol]); }
+                else if (freqCol < 0) { r.end = r.start; }
+                if (bwCol >= 0 && !fields[bwCol].empty()) { r.bandwidth = std::stof(fields[bwCol]); }
+            }
+            catch (const std::exception& e) {
+                flog::warn("Invalid frequency on line {0} of {1}, skipping", lineNum, path);
+                continue;
+            }
+            if (nameCol >= 0) { r.name = fields[nameCol]; }
+            if (typeCol >= 0) { r.type = fields[typeCol]; }
+            if (modeCol >= 0) {
+                std::string mode = toLower(fields[modeCol]);
+                auto it = std::find_if(modeNames.begin(), modeNames.end(), [&mode](const std::string& name) { return toLower(name) == mode; });
+                if (it != modeNames.end()) {
+                    r.mode = std::distance(modeNames.begin(), it);
+                }
+                else {
+                    r.mode = atoi(mode.c_str());
+                }
+            }
+            records.push_back(r);
+        }
+        return true;
+    }
+}
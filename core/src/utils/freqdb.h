@@ -0,0 +1,144 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+// Compact frequency database (band plans, bookmark lists) meant to be memory mapped. The file is a
+// header, an array of entries sorted by start frequency, a metadata table and a string table.
+// Nothing is parsed at load time, so opening it doesn't depend on its size.
+namespace freqdb {
+    const char SIGNATURE[8] = { 'S', 'D', 'R', 'P', 'P', 'F', 'D', 'B' };
+    const uint32_t VERSION = 1;
+
+    struct Header {
+        char signature[8];
+        uint32_t version;
+        uint32_t entryCount;
+        uint64_t entriesOffset;
+        uint32_t metaCount;
+        uint32_t maxNameLength;
+        uint64_t metaOffset;
+        uint64_t stringsOffset;
+        uint64_t stringsSize;
+    };
+
+    struct Entry {
+        double start;
+        double end;
+        double maxEnd;      // Highest end of this entry and all the ones before it
+        float bandwidth;
+        int32_t mode;
+        uint32_t name;      // Offsets in the string table
+        uint32_t type;
+    };
+
+    struct MetaEntry {
+        uint32_t key;
+        uint32_t value;
+    };
+
+    // Entry as given to the builder
+    struct Record {
+        double start = 0.0;
+        double end = 0.0;
+        float bandwidth = 0.0f;
+        int mode = 0;
+        std::string name;
+        std::string type;
+    };
+
+    class Database {
+    public:
+        Database() {}
+        ~Database();
+
+        // Owns a mapping, can't be copied
+        Database(const Database& b) = delete;
+        Database& operator=(const Database& b) = delete;
+
+        /**
+         * Map a database file.
+         * @param path Path of the file.
+         * @return True on success.
+        */
+        bool open(const std::string& path);
+
+        /**
+         * Use a database held in memory.
+         * @param data Content of a database file.
+         * @return True on success.
+        */
+        bool open(std::vector<uint8_t>&& data);
+
+        void close();
+        bool isOpen() { return header != NULL; }
+
+        int getEntryCount() { return header ? header->entryCount : 0; }
+        const Entry& getEntry(int id) { return entries[id]; }
+        const char* getString(uint32_t offset) { return (offset < header->stringsSize) ? &strings[offset] : ""; }
+        int getMaxNameLength() { return header ? header->maxNameLength : 0; }
+
+        /**
+         * Get a metadata value.
+         * @param key Name of the value.
+         * @return The value, empty if missing.
+        */
+        std::string getMeta(const std::string& key);
+
+        /**
+         * Find the first entry that can reach a frequency. The entries overlapping a range are then among
+         * the following ones, up to the first starting above the range.
+         * @param low Frequency.
+         * @return Id of the entry, the entry count if there is none.
+        */
+        int findFirst(double low);
+
+    private:
+        bool validate();
+
+        const uint8_t* data = NULL;
+        size_t size = 0;
+        const Header* header = NULL;
+        const Entry* entries = NULL;
+        const MetaEntry* meta = NULL;
+        const char* strings = NULL;
+
+        std::vector<uint8_t> owned;
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = NULL;
+#else
+        bool mapped = false;
+#endif
+    };
+
+    /**
+     * Build a database in memory.
+     * @param records Entries of the database, in any order.
+     * @param meta Metadata values.
+     * @return Content of the database file.
+    */
+    std::vector<uint8_t> build(std::vector<Record> records, const std::map<std::string, std::string>& meta);
+
+    /**
+     * Build a database and write it to a file. The file is replaced atomically so that it can be mapped meanwhile.
+     * @return True on success.
+    */
+    bool write(const std::string& path, const std::vector<Record>& records, const std::map<std::string, std::string>& meta);
+
+    /**
+     * Read records from a CSV file whose first line names the columns. Recognized columns are name, type,
+     * start, end, frequency (sets both start and end), bandwidth and mode. Others are ignored.
+     * @param path Path of the file.
+     * @param records Records read from the file.
+     * @param modeNames Names accepted in the mode column in place of a number, matched to their index.
+     * @return True on success.
+    */
+    bool readCSV(const std::string& path, std::vector<Record>& records, const std::vector<std::string>& modeNames = {});
+}
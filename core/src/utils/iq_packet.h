@@ -0,0 +1,43 @@
+#pragma once
+#include <stdint.h>
+
+// Framing of the sequenced UDP IQ stream sent by the IQ exporter and received by the network source. Each
+// datagram starts with this header, followed by the interleaved IQ samples. All fields are little endian.
+
+#define IQ_PACKET_MAGIC     0x51495050  // "PPIQ" on the wire
+#define IQ_PACKET_VERSION   1
+
+enum IQPacketSampleType {
+    IQ_PACKET_SAMPLE_TYPE_INT8,
+    IQ_PACKET_SAMPLE_TYPE_INT16,
+    IQ_PACKET_SAMPLE_TYPE_INT32,
+    IQ_PACKET_SAMPLE_TYPE_FLOAT32,
+    _IQ_PACKET_SAMPLE_TYPE_COUNT
+};
+
+struct IQPacketHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t sampleType;     // One of IQPacketSampleType
+    uint16_t headerSize;    // Offset of the samples from the start of the datagram
+    uint32_t sequence;      // Incremented by one for every datagram
+    uint32_t sampleCount;   // Number of IQ pairs in the datagram
+    uint64_t timestamp;     // Index of the first sample since the start of the stream
+};
+static_assert(sizeof(IQPacketHeader) == 24, "IQPacketHeader must match the 24 byte wire format");
+
+// Size in bytes of one IQ pair of each sample type
+inline int iqPacketSampleSize(uint8_t sampleType) {
+    switch (sampleType) {
+    case IQ_PACKET_SAMPLE_TYPE_INT8:
+        return 2 * sizeof(int8_t);
+    case IQ_PACKET_SAMPLE_TYPE_INT16:
+        return 2 * sizeof(int16_t);
+    case IQ_PACKET_SAMPLE_TYPE_INT32:
+        return 2 * sizeof(int32_t);
+    case IQ_PACKET_SAMPLE_TYPE_FLOAT32:
+        return 2 * sizeof(float);
+    default:
+        return 0;
+    }
+}
@@ -0,0 +1,636 @@
+#include "iqz.h"
+#include <volk/volk.h>
+#include <dsp/buffer/buffer.h>
+#include <stdexcept>
+#include <algorithm>
+#include <string.h>
+
+namespace iqz {
+    const char* FILE_MAGIC          = "IQZ1";
+    const char* BLOCK_MAGIC         = "IQZB";
+    const char* INDEX_MAGIC         = "IQZI";
+    const uint16_t FILE_VERSION     = 1;
+    const int PARTITION_SIZE        = 1024;
+    const int MAX_ORDER             = 3;
+    const int ORDER_BITS            = 2;
+    const int RICE_PARAM_BITS       = 5;
+    const int RICE_ESCAPE           = 31;
+    const int ESCAPE_BITS           = 20;
+
+    class BitWriter {
+    public:
+        BitWriter(std::vector<uint8_t>& out) : out(out) {}
+
+        // Write the n (<= 32) lowest bits of val, MSB first
+        inline void put(uint32_t val, int n) {
+            acc = (acc << n) | (val & (uint32_t)((1ull << n) - 1));
+            count += n;
+            while (count >= 8) {
+                count -= 8;
+                out.push_back(acc >> count);
+            }
+        }
+
+        inline void putUnary(uint32_t q) {
+            while (q >= 32) {
+                put(0, 32);
+                q -= 32;
+            }
+            put(1, q + 1);
+        }
+
+        void flush() {
+            if (count) { out.push_back(acc << (8 - count)); }
+            count = 0;
+        }
+
+    private:
+        std::vector<uint8_t>& out;
+        uint64_t acc = 0;
+        int count = 0;
+    };
+
+    class BitReader {
+    public:
+        BitReader(const uint8_t* data, size_t len) : ptr(data), end(data + len), remaining((int64_t)len * 8) {}
+
+        inline uint32_t get(int n) {
+            if (!n) { return 0; }
+            refill();
+            uint32_t val = cache >> (64 - n);
+            cache <<= n;
+            avail -= n;
+            remaining -= n;
+            return val;
+        }
+
+        inline uint32_t getUnary() {
+            uint32_t q = 0;
+            while (true) {
+                refill();
+                if (!cache) {
+                    // Ran out of data in the middle of a code
+                    if (remaining <= avail) {
+                        remaining = -1;
+                        return 0;
+                    }
+                    q += avail;
+                    remaining -= avail;
+                    avail = 0;
+                    continue;
+                }
+                int lz = countLeadingZeros(cache);
+                q += lz;
+                cache <<= lz + 1;
+                avail -= lz + 1;
+                remaining -= lz + 1;
+                return q;
+            }
+        }
+
+        // True if more bits were consumed than available
+        bool overrun() { return remaining < 0; }
+
+    private:
+        inline void refill() {
+            if (avail > 56) { return; }
+
+            // Fast path, load as many whole bytes as fit in the cache at once
+            int bytes = (64 - avail) >> 3;
+            if (end - ptr >= 8) {
+                uint64_t word = 0;
+                for (int i = 0; i < 8; i++) { word = (word << 8) | ptr[i]; }
+                word &= ~0ull << (64 - (bytes << 3));
+                cache |= word >> avail;
+                ptr += bytes;
+                avail += bytes << 3;
+                return;
+            }
+
+            // Past the end, zeros are shifted in and the overrun is caught by the bit count
+            while (avail <= 56) {
+                if (ptr < end) { cache |= (uint64_t)*(ptr++) << (56 - avail); }
+                avail += 8;
+            }
+        }
+
+        static inline int countLeadingZeros(uint64_t val) {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_clzll(val);
+#else
+            int n = 0;
+            while (!(val & 0xFF00000000000000ull)) {
+                val <<= 8;
+                n += 8;
+            }
+            while (!(val & 0x8000000000000000ull)) {
+                val <<= 1;
+                n++;
+            }
+            return n;
+#endif
+        }
+
+        const uint8_t* ptr;
+        const uint8_t* end;
+        int64_t remaining;
+        uint64_t cache = 0;
+        int avail = 0;
+    };
+
+    inline uint32_t zigzag(int32_t val) {
+        return ((uint32_t)val << 1) ^ (uint32_t)(val >> 31);
+    }
+
+    inline int32_t unzigzag(uint32_t val) {
+        return (int32_t)(val >> 1) ^ -(int32_t)(val & 1);
+    }
+
+    inline int32_t predict(const int32_t* x, int i, int order) {
+        switch (order) {
+        case 1: return x[i - 1];
+        case 2: return 2 * x[i - 1] - x[i - 2];
+        case 3: return 3 * x[i - 1] - 3 * x[i - 2] + x[i - 3];
+        default: return 0;
+        }
+    }
+
+    int bestOrder(const int32_t* x, int n) {
+        // Sum of absolute residuals of every fixed predictor, as done by FLAC
+        uint64_t err[MAX_ORDER + 1] = { 0, 0, 0, 0 };
+        for (int i = MAX_ORDER; i < n; i++) {
+            int32_t e0 = x[i];
+            int32_t e1 = e0 - x[i - 1];
+            int32_t e2 = e1 - (x[i - 1] - x[i - 2]);
+            int32_t e3 = e2 - (x[i - 1] - 2 * x[i - 2] + x[i - 3]);
+            err[0] += abs(e0);
+            err[1] += abs(e1);
+            err[2] += abs(e2);
+            err[3] += abs(e3);
+        }
+        int best = 0;
+        for (int i = 1; i <= MAX_ORDER; i++) {
+            if (err[i] < err[best]) { best = i; }
+        }
+        return std::min<int>(best, n);
+    }
+
+    int bestRiceParam(const uint32_t* vals, int n) {
+        // Estimate the cost of each parameter from the sum of the values
+        uint64_t sum = 0;
+        for (int i = 0; i < n; i++) { sum += vals[i]; }
+        int best = 0;
+        uint64_t bestCost = UINT64_MAX;
+        for (int k = 0; k < RICE_ESCAPE; k++) {
+            uint64_t cost = (uint64_t)n * (k + 1) + (sum >> k);
+            if (cost < bestCost) {
+                bestCost = cost;
+                best = k;
+            }
+        }
+        return (bestCost > (uint64_t)n * ESCAPE_BITS) ? RICE_ESCAPE : best;
+    }
+
+    void encodeBlock(const int16_t* in, int frames, int channels, std::vector<uint8_t>& out) {
+        std::vector<int32_t> x(frames);
+        std::vector<uint32_t> res(frames);
+        out.clear();
+        BitWriter bw(out);
+
+        for (int c = 0; c < channels; c++) {
+            // Deinterleave the channel
+            for (int i = 0; i < frames; i++) { x[i] = in[i * channels + c]; }
+
+            // Write the predictor order and warm-up samples
+            int order = bestOrder(x.data(), frames);
+            bw.put(order, ORDER_BITS);
+            for (int i = 0; i < order; i++) { bw.put((uint16_t)x[i], 16); }
+
+            // Compute the residuals
+            for (int i = order; i < frames; i++) { res[i] = zigzag(x[i] - predict(x.data(), i, order)); }
+
+            // Rice code the residuals, one parameter per partition
+            for (int p = order; p < frames; p += PARTITION_SIZE) {
+                int n = std::min<int>(PARTITION_SIZE, frames - p);
+                const uint32_t* vals = &res[p];
+                int k = bestRiceParam(vals, n);
+                bw.put(k, RICE_PARAM_BITS);
+                if (k == RICE_ESCAPE) {
+                    for (int i = 0; i < n; i++) { bw.put(vals[i], ESCAPE_BITS); }
+                    continue;
+                }
+                for (int i = 0; i < n; i++) {
+                    bw.putUnary(vals[i] >> k);
+                    bw.put(vals[i], k);
+                }
+            }
+        }
+
+        bw.flush();
+    }
+
+    bool decodeBlock(const uint8_t* in, size_t len, int frames, int channels, int16_t* out) {
+        std::vector<int32_t> x(frames);
+        BitReader br(in, len);
+
+        for (int c = 0; c < channels; c++) {
+            // Read the predictor order and warm-up samples
+            int order = br.get(ORDER_BITS);
+            if (order > frames) { return false; }
+            for (int i = 0; i < order; i++) { x[i] = (int16_t)br.get(16); }
+
+            // Decode the residuals
+            for (int p = order; p < frames; p += PARTITION_SIZE) {
+                int n = std::min<int>(PARTITION_SIZE, frames - p);
+                int k = br.get(RICE_PARAM_BITS);
+                if (k == RICE_ESCAPE) {
+                    for (int i = p; i < p + n; i++) { x[i] = unzigzag(br.get(ESCAPE_BITS)); }
+                }
+                else {
+                    for (int i = p; i < p + n; i++) {
+                        uint32_t q = br.getUnary();
+                        if (q >= (1u << ESCAPE_BITS)) { return false; }
+                        x[i] = unzigzag((q << k) | br.get(k));
+                    }
+                }
+                if (br.overrun()) { return false; }
+            }
+
+            // Undo the prediction, one loop per order to keep the inner loop simple
+            switch (order) {
+            case 1:
+                for (int i = 1; i < frames; i++) { x[i] += x[i - 1]; }
+                break;
+            case 2:
+                for (int i = 2; i < frames; i++) { x[i] += 2 * x[i - 1] - x[i - 2]; }
+                break;
+            case 3:
+                for (int i = 3; i < frames; i++) { x[i] += 3 * x[i - 1] - 3 * x[i - 2] + x[i - 3]; }
+                break;
+            default:
+                break;
+            }
+
+            // Interleave the channel back
+            for (int i = 0; i < frames; i++) { out[i * channels + c] = x[i]; }
+        }
+
+        return !br.overrun();
+    }
+
+    Writer::Writer(int channels, uint64_t samplerate, int threads) {
+        // Validate channels and samplerate
+        if (channels < 1 || channels > IQZ_MAX_CHANNELS) { throw std::runtime_error("Invalid channel count"); }
+        if (!samplerate) { throw std::runtime_error("Samplerate must be non-zero"); }
+
+        // Initialize variables
+        _channels = channels;
+        _samplerate = samplerate;
+
+        // By default, leave one core for the rest of the DSP
+        threadCount = threads;
+        if (threadCount <= 0) {
+            threadCount = std::clamp<int>((int)std::thread::hardware_concurrency() - 1, 1, 4);
+        }
+    }
+
+    Writer::~Writer() { close(); }
+
+    bool Writer::open(std::string path) {
+        std::lock_guard<std::recursive_mutex> lck(mtx);
+        // Close previous file
+        if (file.is_open()) { close(); }
+
+        // Open file
+        file = std::ofstream(path, std::ios::out | std::ios::binary);
+        if (!file.is_open()) { return false; }
+
+        // Write the file header
+        FileHeader hdr = {};
+        memcpy(hdr.magic, FILE_MAGIC, 4);
+        hdr.version = FILE_VERSION;
+        hdr.channels = _channels;
+        hdr.samplerate = _samplerate;
+        hdr.blockSize = IQZ_DEFAULT_BLOCK_SIZE;
+        file.write((char*)&hdr, sizeof(FileHeader));
+
+        // Reset work values
+        samplesWritten = 0;
+        index.clear();
+
+        // Allocate enough blocks to keep every worker busy while the next ones are filled
+        jobPool.resize(threadCount * 2);
+        jobs.clear();
+        pending.clear();
+        freeJobs.clear();
+        for (auto& job : jobPool) {
+            job.samples = dsp::buffer::alloc<int16_t>(IQZ_DEFAULT_BLOCK_SIZE * _channels);
+            job.frames = 0;
+            freeJobs.push_back(&job);
+        }
+        current = freeJobs.back();
+        freeJobs.pop_back();
+
+        // Start the compression workers
+        stopWorkers = false;
+        for (int i = 0; i < threadCount; i++) {
+            workers.push_back(std::thread(&Writer::worker, this));
+        }
+
+        return true;
+    }
+
+    bool Writer::isOpen() {
+        std::lock_guard<std::recursive_mutex> lck(mtx);
+        return file.is_open();
+    }
+
+    void Writer::close() {
+        std::lock_guard<std::recursive_mutex> lck(mtx);
+        // Do nothing if the file is not open
+        if (!file.is_open()) { return; }
+
+        // Send the last partial block and wait for all blocks to be written
+        submit();
+        {
+            std::unique_lock<std::mutex> jlck(jobMtx);
+            doneCnd.wait(jlck, [this]() { return jobs.empty(); });
+            stopWorkers = true;
+        }
+        jobCnd.notify_all();
+        for (auto& th : workers) { th.join(); }
+        workers.clear();
+
+        // Write the index and trailer
+        Trailer trailer;
+        trailer.indexOffset = file.tellp();
+        trailer.sampleCount = samplesWritten;
+        trailer.blockCount = index.size();
+        memcpy(trailer.magic, INDEX_MAGIC, 4);
+        file.write((char*)index.data(), index.size() * sizeof(IndexEntry));
+        file.write((char*)&trailer, sizeof(Trailer));
+
+        // Close the file
+        file.close();
+
+        // Free buffers
+        for (auto& job : jobPool) { dsp::buffer::free(job.samples); }
+        jobPool.clear();
+        freeJobs.clear();
+        current = NULL;
+    }
+
+    void Writer::setChannels(int channels) {
+        std::lock_guard<std::recursive_mutex> lck(mtx);
+        // Do not allow settings to change while open
+        if (file.is_open()) { throw std::runtime_error("Cannot change parameters while file is open"); }
+
+        // Validate channel count
+        if (channels < 1 || channels > IQZ_MAX_CHANNELS) { throw std::runtime_error("Invalid channel count"); }
+        _channels = channels;
+    }
+
+    void Writer::setSamplerate(uint64_t samplerate) {
+        std::lock_guard<std::recursive_mutex> lck(mtx);
+        // Do not allow settings to change while open
+        if (file.is_open()) { throw std::runtime_error("Cannot change parameters while file is open"); }
+
+        // Validate samplerate
+        if (!samplerate) { throw std::runtime_error("Samplerate must be non-zero"); }
+        _samplerate = samplerate;
+    }
+
+    void Writer::write(float* samples, int count) {
+        std::lock_guard<std::recursive_mutex> lck(mtx);
+        if (!file.is_open()) { return; }
+
+        while (count > 0) {
+            // Quantize as much as fits in the current block
+            int toCopy = std::min<int>(count, IQZ_DEFAULT_BLOCK_SIZE - current->frames);
+            volk_32f_s32f_convert_16i(&current->samples[current->frames * _channels], samples, 32767.0f, toCopy * _channels);
+            current->frames += toCopy;
+            samples += toCopy * _channels;
+            count -= toCopy;
+            samplesWritten += toCopy;
+
+            // Send the block off to the workers once full
+            if (current->frames >= IQZ_DEFAULT_BLOCK_SIZE) { submit(); }
+        }
+    }
+
+    void Writer::submit() {
+        if (!current->frames) { return; }
+
+        // Queue the block for compression
+        {
+            std::lock_guard<std::mutex> jlck(jobMtx);
+            current->firstSample = samplesWritten - current->frames;
+            current->done = false;
+            jobs.push_back(current);
+            pending.push_back(current);
+        }
+        jobCnd.notify_one();
+
+        // Get a free block, waiting for the workers if they're all busy
+        std::unique_lock<std::mutex> jlck(jobMtx);
+        doneCnd.wait(jlck, [this]() { return !freeJobs.empty(); });
+        current = freeJobs.back();
+        freeJobs.pop_back();
+        current->frames = 0;
+    }
+
+    void Writer::worker() {
+        while (true) {
+            // Wait for a block to compress
+            Job* job;
+            {
+                std::unique_lock<std::mutex> jlck(jobMtx);
+                jobCnd.wait(jlck, [this]() { return !pending.empty() || stopWorkers; });
+                if (pending.empty()) { return; }
+                job = pending.front();
+                pending.pop_front();
+            }
+
+            // Compress it
+            encodeBlock(job->samples, job->frames, _channels, job->data);
+            {
+                std::lock_guard<std::mutex> jlck(jobMtx);
+                job->done = true;
+            }
+
+            // Write out all blocks that are ready, in order
+            flushDone();
+        }
+    }
+
+    void Writer::flushDone() {
+        std::lock_guard<std::mutex> flck(fileMtx);
+        while (true) {
+            // Stop at the first block still being compressed
+            Job* job;
+            {
+                std::lock_guard<std::mutex> jlck(jobMtx);
+                if (jobs.empty() || !jobs.front()->done) { return; }
+                job = jobs.front();
+            }
+
+            // Write the block and add it to the index
+            IndexEntry ent;
+            ent.offset = file.tellp();
+            ent.firstSample = job->firstSample;
+            index.push_back(ent);
+            BlockHeader bhdr = {};
+            memcpy(bhdr.magic, BLOCK_MAGIC, 4);
+            bhdr.frames = job->frames;
+            bhdr.size = job->data.size();
+            bhdr.firstSample = job->firstSample;
+            file.write((char*)&bhdr, sizeof(BlockHeader));
+            file.write((char*)job->data.data(), job->data.size());
+
+            // Give the block back
+            {
+                std::lock_guard<std::mutex> jlck(jobMtx);
+                jobs.pop_front();
+                freeJobs.push_back(job);
+            }
+            doneCnd.notify_all();
+        }
+    }
+
+    Reader::~Reader() { close(); }
+
+    bool Reader::open(std::string path) {
+        std::lock_guard<std::recursive_mutex> lck(mtx);
+        close();
+
+        // Open the file and check the header
+        file = std::ifstream(path, std::ios::in | std::ios::binary);
+        if (!file.is_open()) { return false; }
+        file.read((char*)&hdr, sizeof(FileHeader));
+        if (!file || memcmp(hdr.magic, FILE_MAGIC, 4) || hdr.channels < 1 || hdr.channels > IQZ_MAX_CHANNELS || !hdr.samplerate) {
+            file.close();
+            return false;
+        }
+
+        // Load the index from the trailer
+        file.seekg(0, std::ios::end);
+        uint64_t end = file.tellg();
+        if (end >= sizeof(FileHeader) + sizeof(Trailer)) {
+            Trailer trailer;
+            file.seekg(end - sizeof(Trailer));
+            file.read((char*)&trailer, sizeof(Trailer));
+            uint64_t indexSize = (uint64_t)trailer.blockCount * sizeof(IndexEntry);
+            if (file && !memcmp(trailer.magic, INDEX_MAGIC, 4) && trailer.indexOffset + indexSize + sizeof(Trailer) == end) {
+                index.resize(trailer.blockCount);
+                file.seekg(trailer.indexOffset);
+                file.read((char*)index.data(), indexSize);
+                sampleCount = trailer.sampleCount;
+            }
+        }
+
+        // If the recording wasn't closed properly, rebuild the index from the blocks
+        if (index.empty() && !scanBlocks()) {
+            file.close();
+            return false;
+        }
+
+        file.clear();
+        position = 0;
+        blockId = -1;
+        blockFrames = 0;
+        blockOffset = 0;
+        return true;
+    }
+
+    bool Reader::isOpen() {
+        std::lock_guard<std::recursive_mutex> lck(mtx);
+        return file.is_open();
+    }
+
+    void Reader::close() {
+        std::lock_guard<std::recursive_mutex> lck(mtx);
+        if (!file.is_open()) { return; }
+        file.close();
+        index.clear();
+        sampleCount = 0;
+        blockId = -1;
+    }
+
+    bool Reader::seek(uint64_t sample) {
+        std::lock_guard<std::recursive_mutex> lck(mtx);
+        if (!file.is_open() || sample >= sampleCount) { return false; }
+
+        // Find the last block starting at or before the sample
+        auto it = std::upper_bound(index.begin(), index.end(), sample, [](uint64_t s, const IndexEntry& ent) { return s < ent.firstSample; });
+        if (it == index.begin()) { return false; }
+        int id = std::distance(index.begin(), it) - 1;
+
+        // Decode it and skip to the sample
+        if (id != blockId && !loadBlock(id)) { return false; }
+        blockOffset = std::min<int>(sample - index[id].firstSample, blockFrames);
+        position = sample;
+        return true;
+    }
+
+    int Reader::read(float* samples, int count) {
+        std::lock_guard<std::recursive_mutex> lck(mtx);
+        if (!file.is_open()) { return 0; }
+
+        int read = 0;
+        while (read < count) {
+            // Move on to the next block once this one is used up
+            if (blockId < 0 || blockOffset >= blockFrames) {
+                if (blockId + 1 >= (int)index.size() || !loadBlock(blockId + 1)) { break; }
+            }
+
+            int toRead = std::min<int>(count - read, blockFrames - blockOffset);
+            volk_16i_s32f_convert_32f(&samples[read * hdr.channels], &decoded[blockOffset * hdr.channels], 32767.0f, toRead * hdr.channels);
+            blockOffset += toRead;
+            read += toRead;
+        }
+
+        position += read;
+        return read;
+    }
+
+    bool Reader::loadBlock(int id) {
+        // Read the block
+        BlockHeader bhdr;
+        file.clear();
+        file.seekg(index[id].offset);
+        file.read((char*)&bhdr, sizeof(BlockHeader));
+        if (!file || memcmp(bhdr.magic, BLOCK_MAGIC, 4)) { return false; }
+        encoded.resize(bhdr.size);
+        file.read((char*)encoded.data(), bhdr.size);
+        if (!file) { return false; }
+
+        // Decode it
+        decoded.resize((size_t)bhdr.frames * hdr.channels);
+        if (!decodeBlock(encoded.data(), encoded.size(), bhdr.frames, hdr.channels, decoded.data())) { return false; }
+        blockId = id;
+        blockFrames = bhdr.frames;
+        blockOffset = 0;
+        return true;
+    }
+
+    bool Reader::scanBlocks() {
+        // Walk the block headers, stopping at the first incomplete block
+        file.clear();
+        file.seekg(0, std::ios::end);
+        uint64_t end = file.tellg();
+        uint64_t pos = sizeof(FileHeader);
+        index.clear();
+        sampleCount = 0;
+        while (pos + sizeof(BlockHeader) <= end) {
+            BlockHeader bhdr;
+            file.seekg(pos);
+            file.read((char*)&bhdr, sizeof(BlockHeader));
+            if (!file || memcmp(bhdr.magic, BLOCK_MAGIC, 4)) { break; }
+            if (pos + sizeof(BlockHeader) + bhdr.size > end) { break; }
+            index.push_back({ pos, bhdr.firstSample });
+            sampleCount = bhdr.firstSample + bhdr.frames;
+            pos += sizeof(BlockHeader) + bhdr.size;
+        }
+        return !index.empty();
+    }
+}
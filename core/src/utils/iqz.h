@@ -0,0 +1,170 @@
+#pragma once
+#include <string>
+#include <fstream>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdint.h>
+#include "sample_writer.h"
+
+// Compressed sample container. Samples are quantized to int16 and each block of frames is
+// encoded independently (fixed linear predictor + Rice coded residuals) so that blocks can be
+// compressed in parallel and decoded starting from any block listed in the index.
+
+#define IQZ_DEFAULT_BLOCK_SIZE  65536
+#define IQZ_MAX_CHANNELS        8
+
+namespace iqz {
+    #pragma pack(push, 1)
+    struct FileHeader {
+        char magic[4];
+        uint16_t version;
+        uint16_t channels;
+        uint64_t samplerate;
+        uint32_t blockSize;
+        uint32_t reserved;
+    };
+
+    struct BlockHeader {
+        char magic[4];
+        uint32_t frames;
+        uint32_t size;
+        uint32_t reserved;
+        uint64_t firstSample;
+    };
+
+    struct IndexEntry {
+        uint64_t offset;
+        uint64_t firstSample;
+    };
+
+    struct Trailer {
+        uint64_t indexOffset;
+        uint64_t sampleCount;
+        uint32_t blockCount;
+        char magic[4];
+    };
+    #pragma pack(pop)
+
+    /**
+     * Encode a block of interleaved int16 frames.
+     * @param in Interleaved samples.
+     * @param frames Number of frames.
+     * @param channels Number of channels.
+     * @param out Buffer receiving the encoded block (without its header).
+    */
+    void encodeBlock(const int16_t* in, int frames, int channels, std::vector<uint8_t>& out);
+
+    /**
+     * Decode a block of interleaved int16 frames.
+     * @param in Encoded block (without its header).
+     * @param len Length of the encoded block in bytes.
+     * @param frames Number of frames.
+     * @param channels Number of channels.
+     * @param out Interleaved output samples, must hold frames * channels samples.
+     * @return True on success, false if the block is corrupted.
+    */
+    bool decodeBlock(const uint8_t* in, size_t len, int frames, int channels, int16_t* out);
+
+    class Writer : public SampleWriter {
+    public:
+        Writer(int channels = 2, uint64_t samplerate = 48000, int threads = 0);
+        ~Writer();
+
+        bool open(std::string path);
+        bool isOpen();
+        void close();
+
+        void setChannels(int channels);
+        void setSamplerate(uint64_t samplerate);
+
+        size_t getSamplesWritten() { return samplesWritten; }
+        size_t getBytesPerSample() { return _channels * sizeof(int16_t); }
+
+        void write(float* samples, int count);
+
+    private:
+        struct Job {
+            int16_t* samples;
+            int frames;
+            uint64_t firstSample;
+            std::vector<uint8_t> data;
+            bool done;
+        };
+
+        void submit();
+        void worker();
+        void flushDone();
+
+        std::recursive_mutex mtx;
+        std::ofstream file;
+        int _channels;
+        uint64_t _samplerate;
+        int threadCount;
+        size_t samplesWritten = 0;
+
+        // Blocks in file order, blocks waiting for a worker and unused blocks
+        std::vector<Job> jobPool;
+        std::deque<Job*> jobs;
+        std::deque<Job*> pending;
+        std::vector<Job*> freeJobs;
+        Job* current = NULL;
+        std::mutex jobMtx;
+        std::condition_variable jobCnd;
+        std::condition_variable doneCnd;
+        std::mutex fileMtx;
+        bool stopWorkers = false;
+        std::vector<std::thread> workers;
+
+        std::vector<IndexEntry> index;
+    };
+
+    class Reader {
+    public:
+        Reader() {}
+        ~Reader();
+
+        bool open(std::string path);
+        bool isOpen();
+        void close();
+
+        int getChannels() { return hdr.channels; }
+        uint64_t getSamplerate() { return hdr.samplerate; }
+        uint64_t getSampleCount() { return sampleCount; }
+        uint64_t tell() { return position; }
+
+        /**
+         * Seek to a given frame.
+         * @param sample Index of the frame.
+         * @return True on success, false if out of range or if the block couldn't be decoded.
+        */
+        bool seek(uint64_t sample);
+
+        /**
+         * Read frames, converted to float.
+         * @param samples Interleaved output samples.
+         * @param count Number of frames to read.
+         * @return Number of frames read, less than count at the end of the file.
+        */
+        int read(float* samples, int count);
+
+    private:
+        bool loadBlock(int id);
+        bool scanBlocks();
+
+        std::recursive_mutex mtx;
+        std::ifstream file;
+        FileHeader hdr = {};
+        std::vector<IndexEntry> index;
+        uint64_t sampleCount = 0;
+        uint64_t position = 0;
+
+        int blockId = -1;
+        int blockFrames = 0;
+        int blockOffset = 0;
+        std::vector<int16_t> decoded;
+        std::vector<uint8_t> encoded;
+    };
+}
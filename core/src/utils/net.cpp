@@ -2,6 +2,7 @@
 #include <string.h>
 #include <codecvt>
 #include <stdexcept>
+#include <algorithm>
 
 #ifdef _WIN32
 #define WOULD_BLOCK (WSAGetLastError() == WSAEWOULDBLOCK)
@@ -207,6 +208,59 @@ namespace net {
         return read;
     }
 
+    int Socket::recvmulti(uint8_t* data, size_t maxLen, int maxCount, int* lens, int timeout) {
+        maxCount = std::clamp<int>(maxCount, 1, NET_MAX_RECV_BATCH);
+
+        // Wait for the first datagram
+        if (timeout != NONBLOCKING) {
+            fd_set set;
+            FD_ZERO(&set);
+            FD_SET(sock, &set);
+
+            timeval tv;
+            tv.tv_sec = timeout / 1000;
+            tv.tv_usec = (timeout - tv.tv_sec*1000) * 1000;
+
+            int err = select(sock+1, &set, NULL, &set, (timeout > 0) ? &tv : NULL);
+            if (err <= 0) { return err; }
+        }
+
+#ifdef __linux__
+        // Take everything already queued, up to the batch size, in one go
+        mmsghdr msgs[NET_MAX_RECV_BATCH];
+        iovec iovs[NET_MAX_RECV_BATCH];
+        memset(msgs, 0, maxCount * sizeof(mmsghdr));
+        for (int i = 0; i < maxCount; i++) {
+            iovs[i].iov_base = &data[i * maxLen];
+            iovs[i].iov_len = maxLen;
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        int count = recvmmsg(sock, msgs, maxCount, MSG_DONTWAIT, NULL);
+        if (count <= 0) {
+            if (!WOULD_BLOCK) { close(); }
+            return count;
+        }
+        for (int i = 0; i < count; i++) {
+            lens[i] = msgs[i].msg_len;
+        }
+        return count;
+#else
+        int err = ::recvfrom(sock, (char*)data, maxLen, 0, NULL, NULL);
+        if (err <= 0 && !WOULD_BLOCK) {
+            close();
+            return err;
+        }
+        if (err < 0) { return -1; }
+        lens[0] = err;
+        return 1;
+#endif
+    }
+
+    bool Socket::setRecvBufferSize(int size) {
+        return !setsockopt(sock, SOL_SOCKET, SO_RCVBUF, (const char*)&size, sizeof(int));
+    }
+
     // === Listener functions ===
 
     Listener::Listener(SockHandle_t sock) {
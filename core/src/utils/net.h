@@ -96,6 +96,9 @@ namespace net {
         struct sockaddr_in addr;
     };
 
+    // Maximum number of datagrams received at once by Socket::recvmulti()
+    #define NET_MAX_RECV_BATCH  64
+
     enum {
         NO_TIMEOUT  = -1,
         NONBLOCKING = 0
@@ -169,6 +172,25 @@ namespace net {
          */
         int recvline(std::string& str, int maxLen = 0, int timeout = NO_TIMEOUT, Address* dest = NULL);
 
+        /**
+         * Receive several datagrams with a single system call where supported (recvmmsg), one at a time otherwise.
+         * Meant for high packet rate UDP streams.
+         * @param data Buffer of maxCount consecutive slots of maxLen bytes, each receiving one datagram.
+         * @param maxLen Size of a slot in bytes.
+         * @param maxCount Maximum number of datagrams to receive, at most NET_MAX_RECV_BATCH.
+         * @param lens Array of maxCount integers receiving the length of each datagram.
+         * @param timeout Timeout in milliseconds for the first datagram. Use NO_TIMEOUT or NONBLOCKING here if needed.
+         * @return Number of datagrams read. 0 means timed out or closed. -1 means would block or error.
+         */
+        int recvmulti(uint8_t* data, size_t maxLen, int maxCount, int* lens, int timeout = NO_TIMEOUT);
+
+        /**
+         * Set the size of the kernel receive buffer. The OS may cap it to a lower value.
+         * @param size Size in bytes.
+         * @return True on success, false otherwise.
+         */
+        bool setRecvBufferSize(int size);
+
     private:
         Address* raddr = NULL;
         SockHandle_t sock;
@@ -33,6 +33,11 @@ public:
         handlers.erase(id);
     }
 
+    bool empty() {
+        std::lock_guard<std::mutex> lck(mtx);
+        return handlers.empty();
+    }
+
     void operator()(Args... args) {
         std::lock_guard<std::mutex> lck(mtx);
         for (const auto& [desc, handler] : handlers) {
@@ -1,11 +1,18 @@
 #include "riff.h"
 #include <string.h>
 #include <stdexcept>
+#include <algorithm>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace riff {
     const char* RIFF_SIGNATURE      = "RIFF";
     const char* LIST_SIGNATURE      = "LIST";
     const size_t RIFF_LABEL_SIZE    = 4;
+    const uint64_t RIFF_MAX_SIZE    = 0xFFFFFFFF;
 
     // Writer::Writer(const Writer&& b) {
     //     //file = std::move(b.file);
@@ -21,6 +28,8 @@ namespace riff {
         // Open file
         file = std::ofstream(path, std::ios::out | std::ios::binary);
         if (!file.is_open()) { return false; }
+        _path = path;
+        preallocEnd = 0;
 
         // Begin RIFF chunk
         beginRIFF(form);
@@ -42,7 +51,17 @@ namespace riff {
         endRIFF();
 
         // Close file
+        uint64_t end = file.tellp();
         file.close();
+
+#ifdef __linux__
+        // Release the space that was preallocated but never written
+        if (preallocFd >= 0) {
+            if (ftruncate(preallocFd, end)) {}
+            ::close(preallocFd);
+            preallocFd = -1;
+        }
+#endif
     }
 
     void Writer::beginList(const char id[4]) {
@@ -74,6 +93,7 @@ namespace riff {
         desc.pos = file.tellp();
         memcpy(desc.hdr.id, id, sizeof(desc.hdr.id));
         desc.hdr.size = 0;
+        desc.size = 0;
         file.write((char*)&desc.hdr, sizeof(ChunkHeader));
 
         // Save descriptor
@@ -91,7 +111,8 @@ namespace riff {
         ChunkDesc desc = chunks.top();
         chunks.pop();
 
-        // Write size
+        // Write size, saturated to 0xFFFFFFFF as expected by RF64 when it doesn't fit
+        desc.hdr.size = (uint32_t)std::min<uint64_t>(desc.size, RIFF_MAX_SIZE);
         auto pos = file.tellp();
         auto npos = desc.pos;
         npos += 4;
@@ -101,7 +122,7 @@ namespace riff {
 
         // If parent chunk, increment its size by the size of the sub-chunk plus the size of its header)
         if (!chunks.empty()) {
-            chunks.top().hdr.size += desc.hdr.size + sizeof(ChunkHeader);
+            chunks.top().size += desc.size + sizeof(ChunkHeader);
         }
     }
 
@@ -111,8 +132,28 @@ namespace riff {
         if (chunks.empty()) {
             throw std::runtime_error("No chunk to write into");
         }
+        if (preallocStep) { preallocate((uint64_t)file.tellp() + len); }
+        file.write((char*)data, len);
+        chunks.top().size += len;
+    }
+
+    void Writer::patch(uint64_t pos, const uint8_t* data, size_t len) {
+        std::lock_guard<std::recursive_mutex> lck(mtx);
+
+        auto end = file.tellp();
+        file.seekp(pos);
         file.write((char*)data, len);
-        chunks.top().hdr.size += len;
+        file.seekp(end);
+    }
+
+    uint64_t Writer::tell() {
+        std::lock_guard<std::recursive_mutex> lck(mtx);
+        return file.tellp();
+    }
+
+    void Writer::setPreallocation(uint64_t step) {
+        std::lock_guard<std::recursive_mutex> lck(mtx);
+        preallocStep = step;
     }
 
     void Writer::beginRIFF(const char form[4]) {
@@ -139,4 +180,21 @@ namespace riff {
 
         endChunk();
     }
+
+    void Writer::preallocate(uint64_t end) {
+        // Only extend the reservation once the write position gets past it
+        if (end <= preallocEnd) { return; }
+        preallocEnd = ((end / preallocStep) + 1) * preallocStep;
+
+#ifdef __linux__
+        // Keep a second descriptor around since ofstream doesn't expose its own
+        if (preallocFd < 0) {
+            preallocFd = ::open(_path.c_str(), O_WRONLY);
+            if (preallocFd < 0) { return; }
+        }
+
+        // Reserve the blocks without changing the apparent file size
+        fallocate(preallocFd, FALLOC_FL_KEEP_SIZE, 0, preallocEnd);
+#endif
+    }
 }
\ No newline at end of file
@@ -16,6 +16,7 @@ namespace riff {
     struct ChunkDesc {
         ChunkHeader hdr;
         std::streampos pos;
+        uint64_t size;
     };
 
     class Writer {
@@ -36,13 +37,26 @@ namespace riff {
 
         void write(const uint8_t* data, size_t len);
 
+        // Overwrite already written bytes without affecting chunk sizes
+        void patch(uint64_t pos, const uint8_t* data, size_t len);
+        uint64_t tell();
+
+        // Reserve disk space ahead of the write position in steps of the given size (0 to disable)
+        void setPreallocation(uint64_t step);
+
     private:
         void beginRIFF(const char form[4]);
         void endRIFF();
+        void preallocate(uint64_t end);
 
         std::recursive_mutex mtx;
         std::ofstream file;
         std::stack<ChunkDesc> chunks;
+
+        std::string _path;
+        uint64_t preallocStep = 0;
+        uint64_t preallocEnd = 0;
+        int preallocFd = -1;
     };
 
     // class Reader {
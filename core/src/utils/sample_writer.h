@@ -0,0 +1,21 @@
+#pragma once
+#include <string>
+#include <stddef.h>
+
+// Common interface of the sample file writers so that recorders can switch container at runtime
+class SampleWriter {
+public:
+    virtual ~SampleWriter() {}
+
+    virtual bool open(std::string path) = 0;
+    virtual bool isOpen() = 0;
+    virtual void close() = 0;
+
+    virtual void write(float* samples, int count) = 0;
+
+    // Number of frames written to the current file
+    virtual size_t getSamplesWritten() = 0;
+
+    // Number of bytes a frame takes before any compression
+    virtual size_t getBytesPerSample() = 0;
+};
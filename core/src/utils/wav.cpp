@@ -4,11 +4,15 @@
 #include <dsp/buffer/buffer.h>
 #include <dsp/stream.h>
 #include <map>
+#include <string.h>
 
 namespace wav {
     const char* WAVE_FILE_TYPE          = "WAVE";
     const char* FORMAT_MARKER           = "fmt ";
     const char* DATA_MARKER             = "data";
+    const char* JUNK_MARKER             = "JUNK";
+    const char* DS64_MARKER             = "ds64";
+    const char* RF64_SIGNATURE          = "RF64";
     const uint32_t FORMAT_HEADER_LEN    = 16;
     const uint16_t SAMPLE_TYPE_PCM      = 1;
 
@@ -71,6 +75,15 @@ namespace wav {
         // Open file
         if (!rw.open(path, WAVE_FILE_TYPE)) { return false; }
 
+        // Reserve room for a ds64 chunk in case the file ends up too large for plain WAV
+        if (_format == FORMAT_RF64) {
+            DS64Header ds64 = {};
+            ds64Pos = rw.tell();
+            rw.beginChunk(JUNK_MARKER);
+            rw.write((uint8_t*)&ds64, sizeof(DS64Header));
+            rw.endChunk();
+        }
+
         // Write format chunk
         rw.beginChunk(FORMAT_MARKER);
         rw.write((uint8_t*)&hdr, sizeof(FormatHeader));
@@ -95,6 +108,22 @@ namespace wav {
         // Finish data chunk
         rw.endChunk();
 
+        // If the file doesn't fit the 32bit sizes, turn it into an RF64 file
+        uint64_t riffSize = rw.tell() - sizeof(riff::ChunkHeader);
+        if (_format == FORMAT_RF64 && riffSize > 0xFFFFFFFF) {
+            riff::ChunkHeader ds64Hdr;
+            memcpy(ds64Hdr.id, DS64_MARKER, 4);
+            ds64Hdr.size = sizeof(DS64Header);
+            DS64Header ds64;
+            ds64.riffSize = riffSize;
+            ds64.dataSize = (uint64_t)samplesWritten * bytesPerSamp;
+            ds64.sampleCount = samplesWritten;
+            ds64.tableLength = 0;
+            rw.patch(0, (uint8_t*)RF64_SIGNATURE, 4);
+            rw.patch(ds64Pos, (uint8_t*)&ds64Hdr, sizeof(riff::ChunkHeader));
+            rw.patch(ds64Pos + sizeof(riff::ChunkHeader), (uint8_t*)&ds64, sizeof(DS64Header));
+        }
+
         // Close the file
         rw.close();
 
@@ -147,6 +176,11 @@ namespace wav {
         _type = type;
     }
 
+    void Writer::setPreallocation(uint64_t step) {
+        std::lock_guard<std::recursive_mutex> lck(mtx);
+        rw.setPreallocation(step);
+    }
+
     void Writer::write(float* samples, int count) {
         std::lock_guard<std::recursive_mutex> lck(mtx);
         if (!rw.isOpen()) { return; }
@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <mutex>
 #include "riff.h"
+#include "sample_writer.h"
 
 namespace wav {    
     #pragma pack(push, 1)
@@ -15,6 +16,13 @@ namespace wav {
         uint16_t bytesPerSample;
         uint16_t bitDepth;
     };
+
+    struct DS64Header {
+        uint64_t riffSize;
+        uint64_t dataSize;
+        uint64_t sampleCount;
+        uint32_t tableLength;
+    };
     #pragma pack(pop)
 
     enum Format {
@@ -34,7 +42,7 @@ namespace wav {
         CODEC_FLOAT = 3
     };
 
-    class Writer {
+    class Writer : public SampleWriter {
     public:
         Writer(int channels = 2, uint64_t samplerate = 48000, Format format = FORMAT_WAV, SampleType type = SAMP_TYPE_INT16);
         ~Writer();
@@ -47,8 +55,10 @@ namespace wav {
         void setSamplerate(uint64_t samplerate);
         void setFormat(Format format);
         void setSampleType(SampleType type);
+        void setPreallocation(uint64_t step);
 
         size_t getSamplesWritten() { return samplesWritten; }
+        size_t getBytesPerSample() { return bytesPerSamp; }
 
         void write(float* samples, int count);
 
@@ -62,6 +72,7 @@ namespace wav {
         Format _format;
         SampleType _type;
         size_t bytesPerSamp;
+        uint64_t ds64Pos;
 
         uint8_t* bufU8 = NULL;
         int16_t* bufI16 = NULL;
@@ -0,0 +1,24 @@
+#pragma once
+
+// DAB transmission mode I parameters at 2.048 MHz
+#define DAB_FFT_SIZE            2048
+#define DAB_GUARD_SAMPS         504
+#define DAB_CARRIERS            1536
+#define DAB_FRAME_SYMS          76
+#define DAB_SYM_BITS            (2 * DAB_CARRIERS)
+
+// Soft bits of a frame, excluding the phase reference symbol
+#define DAB_FRAME_BITS          ((DAB_FRAME_SYMS - 1) * DAB_SYM_BITS)
+
+// Fast Information Channel, carried by the three symbols after the phase reference
+#define DAB_FIC_SYMS            3
+#define DAB_FIC_BLOCKS          4
+#define DAB_FIC_BLOCK_BITS      2304
+#define DAB_FIBS_PER_BLOCK      3
+#define DAB_FIB_SIZE            32
+
+// Main Service Channel, carried by the rest of the frame as four Common Interleaved Frames
+#define DAB_CIF_COUNT           4
+#define DAB_CIF_BITS            55296
+#define DAB_CU_BITS             64
+#define DAB_CIF_CUS             (DAB_CIF_BITS / DAB_CU_BITS)
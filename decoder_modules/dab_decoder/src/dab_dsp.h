@@ -3,6 +3,7 @@
 #include <utils/flog.h>
 #include <fftw3.h>
 #include "dab_phase_sym.h"
+#include "dab_consts.h"
 
 namespace dab {
     class CyclicSync : public dsp::Processor<dsp::complex_t, dsp::complex_t> {
@@ -139,6 +140,8 @@ namespace dab {
         float agcRateInv;
     };
 
+    // Locates the null symbol and corrects the frequency offset using the phase reference symbol.
+    // Outputs whole frames of DAB_FRAME_SYMS symbols, starting with the phase reference.
     class FrameFreqSync : public dsp::Processor<dsp::complex_t, dsp::complex_t> {
         using base_type = dsp::Processor<dsp::complex_t, dsp::complex_t>;
     public:
@@ -178,8 +181,7 @@ namespace dab {
             int count = base_type::_in->read();
             if (count < 0) { return -1; }
 
-            // Apply frequency shift
-            lv_32fc_t phase = lv_cmake(1.0f, 0.0f);
+            // Apply frequency shift, keeping the phase continuous from one symbol to the next
             lv_32fc_t phaseDelta = lv_cmake(cos(offset), sin(offset));
 #if VOLK_VERSION >= 030100
             volk_32fc_s32fc_x2_rotator2_32fc((lv_32fc_t*)_in->readBuf, (lv_32fc_t*)_in->readBuf, phaseDelta, &phase, count);
@@ -187,12 +189,17 @@ namespace dab {
             volk_32fc_s32fc_x2_rotator_32fc((lv_32fc_t*)_in->readBuf, (lv_32fc_t*)_in->readBuf, phaseDelta, &phase, count);
 #endif
 
+            // Account for the cyclic prefix that was skipped by the symbol sync
+            float guardPhase = offset * (float)DAB_GUARD_SAMPS;
+            phase *= lv_cmake(cos(guardPhase), sin(guardPhase));
+            phase /= std::abs(phase);
+
             // Compute the amplitude amplitude of all samples
-            volk_32fc_magnitude_32f(amps, (lv_32fc_t*)_in->readBuf, 2048);
+            volk_32fc_magnitude_32f(amps, (lv_32fc_t*)_in->readBuf, DAB_FFT_SIZE);
 
             // Compute the average signal level by adding up all values
             float level = 0.0f;
-            volk_32f_accumulator_s32f(&level, amps, 2048);
+            volk_32f_accumulator_s32f(&level, amps, DAB_FFT_SIZE);
 
             // Detect a frame sync condition
             if (level < avgLvl * 0.5f) {
@@ -210,22 +217,13 @@ namespace dab {
             // Update the average level
             avgLvl = agcRate*level + agcRateInv*avgLvl;
 
+            // Add the symbol to the frame, dropping anything not preceded by a null symbol
+            if (sym >= 1 && sym <= DAB_FRAME_SYMS) {
+                memcpy(&out.writeBuf[(sym - 1) * DAB_FFT_SIZE], _in->readBuf, DAB_FFT_SIZE * sizeof(dsp::complex_t));
+            }
+
             // Handle phase reference
             if (sym == 1) {
-                // Output the symbols (DEBUG ONLY)
-                memcpy(corrIn, _in->readBuf, 2048 * sizeof(dsp::complex_t));
-                fftwf_execute(plan);
-                volk_32fc_magnitude_32f(amps, (lv_32fc_t*)corrOut, 2048);
-                int outCount = 0;
-                dsp::complex_t pi4 = { cos(3.1415926535*0.25), sin(3.1415926535*0.25) };
-                for (int i = -767; i < 768; i++) {
-                    if (!i) { continue; }
-                    int cid0 = ((i-1) >= 0) ? (i-1) : 2048+(i-1);
-                    int cid1 = (i >= 0) ? i : 2048+i;;
-                    out.writeBuf[outCount++] = pi4 * (corrOut[cid1] * corrOut[cid0].conj()) * (1.0f/(amps[cid0]*amps[cid0]));
-                }
-                out.swap(outCount);
-
                 // Multiply the samples with the conjugated phase reference signal
                 volk_32fc_x2_multiply_32fc((lv_32fc_t*)corrIn, (lv_32fc_t*)_in->readBuf, (lv_32fc_t*)conjRef, 2048);
             
@@ -254,8 +252,16 @@ namespace dab {
                 flog::debug("Offset: {} Hz, Error: {} Hz, Avg Level: {}", offset * (0.5f/3.1415926535f)*2.048e6, off * (0.5f/3.1415926535f)*2.048e6, avgLvl);
             }
 
+            // Send off the frame once complete
+            if (sym == DAB_FRAME_SYMS) {
+                base_type::_in->flush();
+                if (!out.swap(DAB_FRAME_SYMS * DAB_FFT_SIZE)) { return -1; }
+                sym = 0;
+                return count;
+            }
+
             // Increment the symbol counter
-            sym++;
+            if (sym) { sym++; }
 
             // Flush the input stream and return
             base_type::_in->flush();
@@ -270,8 +276,9 @@ namespace dab {
         dsp::complex_t* corrIn;
         dsp::complex_t* corrOut;
 
-        int sym;
+        int sym = 0;
         float offset = 0.0f;
+        lv_32fc_t phase = lv_cmake(1.0f, 0.0f);
 
         float avgLvl = 0.0f;
         float agcRate;
@@ -0,0 +1,187 @@
+#include "fic.h"
+#include "dab_consts.h"
+
+#define FIB_DATA_SIZE   30
+#define LABEL_SIZE      16
+
+namespace dab {
+    // Number of CUs per 8 kbit/s for EEP-A and per 32 kbit/s for EEP-B, for each protection level
+    const int EEP_A_CUS[4] = { 12, 8, 6, 4 };
+    const int EEP_B_CUS[4] = { 27, 21, 18, 15 };
+
+    int Subchannel::getBitrate() const {
+        switch (protection) {
+        case PROTECTION_EEP_A:
+            return (size / EEP_A_CUS[level - 1]) * 8;
+        case PROTECTION_EEP_B:
+            return (size / EEP_B_CUS[level - 1]) * 32;
+        default:
+            return 0;
+        }
+    }
+
+    void FICParser::parseFIB(const uint8_t* fib) {
+        int offset = 0;
+        while (offset < FIB_DATA_SIZE) {
+            // An end marker means the rest of the FIB is padding
+            uint8_t header = fib[offset++];
+            if (header == 0xFF) { break; }
+            int type = header >> 5;
+            int len = header & 0x1F;
+
+            // Discard the rest of the FIB if the FIG doesn't fit in it
+            if (!len || offset + len > FIB_DATA_SIZE) { break; }
+
+            switch (type) {
+            case 0:
+                parseFIG0(&fib[offset], len);
+                break;
+            case 1:
+                parseFIG1(&fib[offset], len);
+                break;
+            default:
+                break;
+            }
+            offset += len;
+        }
+    }
+
+    void FICParser::reset() {
+        ensemble = Ensemble();
+    }
+
+    void FICParser::parseFIG0(const uint8_t* data, int len) {
+        // Ignore information about other ensembles
+        bool oe = (data[0] >> 6) & 1;
+        if (oe) { return; }
+        bool pd = (data[0] >> 5) & 1;
+        int ext = data[0] & 0x1F;
+
+        switch (ext) {
+        case 0:
+            // Ensemble information
+            if (len < 5) { return; }
+            ensemble.id = (data[1] << 8) | data[2];
+            break;
+        case 1:
+            parseSubchannels(&data[1], len - 1);
+            break;
+        case 2:
+            parseServices(&data[1], len - 1, pd);
+            break;
+        default:
+            break;
+        }
+    }
+
+    void FICParser::parseFIG1(const uint8_t* data, int len) {
+        // Ignore information about other ensembles
+        bool oe = (data[0] >> 3) & 1;
+        if (oe) { return; }
+        int ext = data[0] & 0x07;
+
+        switch (ext) {
+        case 0:
+            // Ensemble label
+            if (len < 1 + 2 + LABEL_SIZE) { return; }
+            ensemble.id = (data[1] << 8) | data[2];
+            ensemble.label = parseLabel(&data[3]);
+            break;
+        case 1:
+            // Programme service label
+            if (len < 1 + 2 + LABEL_SIZE) { return; }
+            {
+                uint32_t sid = (data[1] << 8) | data[2];
+                Service& svc = ensemble.services[sid];
+                svc.id = sid;
+                svc.label = parseLabel(&data[3]);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    void FICParser::parseSubchannels(const uint8_t* data, int len) {
+        int offset = 0;
+        while (offset + 3 <= len) {
+            Subchannel sc;
+            sc.id = data[offset] >> 2;
+            sc.startAddr = ((data[offset] & 0x03) << 8) | data[offset + 1];
+            bool longForm = data[offset + 2] >> 7;
+
+            if (longForm) {
+                // Equal error protection, the size is given explicitly
+                if (offset + 4 > len) { break; }
+                int option = (data[offset + 2] >> 4) & 0x07;
+                sc.level = ((data[offset + 2] >> 2) & 0x03) + 1;
+                sc.size = ((data[offset + 2] & 0x03) << 8) | data[offset + 3];
+                offset += 4;
+
+                // Only options A and B are defined
+                if (option > 1) { continue; }
+                sc.protection = option ? PROTECTION_EEP_B : PROTECTION_EEP_A;
+            }
+            else {
+                // Unequal error protection, the size is given by the UEP table, which isn't supported
+                sc.level = data[offset + 2] & 0x3F;
+                sc.size = 0;
+                sc.protection = PROTECTION_UEP;
+                offset += 3;
+            }
+
+            // Discard subchannels that don't fit in the CIF
+            if (sc.startAddr + sc.size > DAB_CIF_CUS) { continue; }
+
+            ensemble.subchannels[sc.id] = sc;
+        }
+    }
+
+    void FICParser::parseServices(const uint8_t* data, int len, bool longId) {
+        int idSize = longId ? 4 : 2;
+        int offset = 0;
+        while (offset + idSize + 1 <= len) {
+            // Parse the service ID
+            uint32_t sid = 0;
+            for (int i = 0; i < idSize; i++) {
+                sid = (sid << 8) | data[offset++];
+            }
+
+            // Parse the number of components and make sure they're all there
+            int compCount = data[offset++] & 0x0F;
+            if (offset + (compCount * 2) > len) { break; }
+
+            // Parse the components
+            std::vector<ServiceComponent> comps;
+            for (int i = 0; i < compCount; i++) {
+                ServiceComponent comp;
+                comp.tmId = data[offset] >> 6;
+                comp.type = data[offset] & 0x3F;
+                comp.subchannel = data[offset + 1] >> 2;
+                comp.primary = (data[offset + 1] >> 1) & 1;
+                offset += 2;
+
+                // Only stream components have a subchannel
+                if (comp.tmId == 3) { continue; }
+                comps.push_back(comp);
+            }
+
+            Service& svc = ensemble.services[sid];
+            svc.id = sid;
+            svc.components = comps;
+        }
+    }
+
+    std::string FICParser::parseLabel(const uint8_t* data) {
+        // Keep only the printable characters common to ASCII and the EBU Latin charset
+        std::string label;
+        for (int i = 0; i < LABEL_SIZE; i++) {
+            char c = data[i];
+            label += (c >= 0x20 && c < 0x7F) ? c : '?';
+        }
+
+        // Remove the padding
+        size_t end = label.find_last_not_of(' ');
+        return (end == std::string::npos) ? "" : label.substr(0, end + 1);
+    }
+}
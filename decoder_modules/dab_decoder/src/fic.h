@@ -0,0 +1,79 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace dab {
+    enum ProtectionType {
+        PROTECTION_UEP,
+        PROTECTION_EEP_A,
+        PROTECTION_EEP_B
+    };
+
+    struct Subchannel {
+        /**
+         * Get the bitrate of the subchannel.
+         * @return Bitrate in kbit/s, 0 if unknown.
+        */
+        int getBitrate() const;
+
+        int id;
+        int startAddr;
+        int size;
+        ProtectionType protection;
+
+        // Protection level from 1 to 4 for EEP, UEP table index for UEP
+        int level;
+    };
+
+    struct ServiceComponent {
+        // Transport mechanism, 0 for an MSC audio stream
+        int tmId;
+
+        // Audio or data service component type
+        int type;
+        int subchannel;
+        bool primary;
+    };
+
+    struct Service {
+        uint32_t id;
+        std::string label;
+        std::vector<ServiceComponent> components;
+    };
+
+    struct Ensemble {
+        uint16_t id = 0;
+        std::string label;
+        std::map<uint32_t, Service> services;
+        std::map<int, Subchannel> subchannels;
+    };
+
+    /**
+     * Parses the Fast Information Groups of the FIC into a description of the ensemble. Only the FIGs needed to
+     * build the service list are handled: 0/0, 0/1, 0/2, 1/0 and 1/1.
+    */
+    class FICParser {
+    public:
+        /**
+         * Parse a Fast Information Block.
+         * @param fib FIB of DAB_FIB_SIZE bytes, with a valid CRC.
+        */
+        void parseFIB(const uint8_t* fib);
+
+        /**
+         * Forget everything that was learned about the ensemble.
+        */
+        void reset();
+
+        Ensemble ensemble;
+
+    private:
+        void parseFIG0(const uint8_t* data, int len);
+        void parseFIG1(const uint8_t* data, int len);
+        void parseSubchannels(const uint8_t* data, int len);
+        void parseServices(const uint8_t* data, int len, bool longId);
+        static std::string parseLabel(const uint8_t* data);
+    };
+}
@@ -0,0 +1,280 @@
+#include "frame_decoder.h"
+#include "dab_consts.h"
+#include <utils/flog.h>
+
+// Largest possible subchannel, in bits per CIF before and after decoding
+#define MAX_SUBCH_BITS      DAB_CIF_BITS
+#define MAX_SUBCH_BYTES     (MAX_SUBCH_BITS / 8)
+
+// Every bit of the mother code is made of 4 encoded bits and the code is terminated by 6 tail bits
+#define MOTHER_CODE_RATE    4
+#define TAIL_BITS           6
+
+// Depth of the time interleaver in CIFs
+#define TI_DEPTH            16
+
+namespace dab {
+    // Rate 1/4 K=7 mother code (ETSI EN 300 401 11.1.1), bit reversed for libcorrect
+    const correct_convolutional_polynomial_t DAB_CONV_POLYS[MOTHER_CODE_RATE] = { 0155, 0117, 0123, 0155 };
+
+    // Order in which each group of 4 encoded bits gains a bit as the puncturing index goes up
+    const int PUNCT_GROUP_ORDER[8] = { 0, 4, 2, 6, 1, 5, 3, 7 };
+
+    // Delay of each bit of a CIF in the time interleaver, by index modulo 16
+    const int TI_MAP[TI_DEPTH] = { 0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15 };
+
+    FrameDecoder::FrameDecoder(dsp::stream<uint8_t>* in) {
+        // Configure the convolutional decoder
+        conv.init(MOTHER_CODE_RATE, 7, DAB_CONV_POLYS);
+
+        // Generate the energy dispersal sequence, PRBS x^9 + x^5 + 1 initialized with all ones
+        prbs.resize(MAX_SUBCH_BYTES);
+        uint16_t reg = 0x1FF;
+        for (int i = 0; i < MAX_SUBCH_BYTES; i++) {
+            uint8_t byte = 0;
+            for (int j = 0; j < 8; j++) {
+                uint8_t bit = ((reg >> 8) ^ (reg >> 4)) & 1;
+                reg = ((reg << 1) | bit) & 0x1FF;
+                byte = (byte << 1) | bit;
+            }
+            prbs[i] = byte;
+        }
+
+        // The FIC uses PI_16 for the first 21 blocks and PI_15 for the last 3 (ETSI EN 300 401 11.2)
+        appendPuncturing(ficMask, 21, 16);
+        appendPuncturing(ficMask, 3, 15);
+        appendTail(ficMask);
+
+        // Allocate the decoding buffers for the largest possible subchannel
+        mother.resize((MAX_SUBCH_BITS + TAIL_BITS) * MOTHER_CODE_RATE);
+        decoded.resize(MAX_SUBCH_BYTES + 1);
+        deinterleaved.resize(MAX_SUBCH_BITS);
+
+        // Init the base class
+        base_type::init(in);
+    }
+
+    FrameDecoder::~FrameDecoder() {}
+
+    void FrameDecoder::selectSubchannel(int id) {
+        std::lock_guard<std::mutex> lck(ensMtx);
+        selectedId = id;
+        scConfigured = false;
+    }
+
+    void FrameDecoder::reset() {
+        assert(base_type::_block_init);
+        std::lock_guard<std::recursive_mutex> lck(base_type::ctrlMtx);
+        base_type::tempStop();
+        {
+            std::lock_guard<std::mutex> lck2(ensMtx);
+            parser.reset();
+            scConfigured = false;
+        }
+        ficQuality = 0.0f;
+        base_type::tempStart();
+    }
+
+    Ensemble FrameDecoder::getEnsemble() {
+        std::lock_guard<std::mutex> lck(ensMtx);
+        return parser.ensemble;
+    }
+
+    int FrameDecoder::run() {
+        int count = base_type::_in->read();
+        if (count < 0) { return -1; }
+
+        // Only complete frames are expected
+        if (count != DAB_FRAME_BITS) {
+            base_type::_in->flush();
+            return count;
+        }
+
+        // Decode the FIC first since it describes the MSC
+        const uint8_t* fic = base_type::_in->readBuf;
+        int validFIBs = 0;
+        for (int i = 0; i < DAB_FIC_BLOCKS; i++) {
+            validFIBs += decodeFIC(&fic[i * DAB_FIC_BLOCK_BITS]);
+        }
+        ficQuality = (float)validFIBs / (float)(DAB_FIC_BLOCKS * DAB_FIBS_PER_BLOCK);
+
+        // Decode the selected subchannel in each CIF
+        outCount = 0;
+        const uint8_t* msc = &fic[DAB_FIC_SYMS * DAB_SYM_BITS];
+        for (int i = 0; i < DAB_CIF_COUNT; i++) {
+            decodeCIF(&msc[i * DAB_CIF_BITS]);
+        }
+
+        base_type::_in->flush();
+        if (outCount) {
+            if (!out.swap(outCount)) { return -1; }
+        }
+        return count;
+    }
+
+    int FrameDecoder::decodeFIC(const uint8_t* soft) {
+        // Depuncture and decode the FIC block
+        int bits = depuncture(soft, ficMask, mother.data());
+        conv.decodeSoft(mother.data(), bits, decoded.data());
+        energyDispersal(decoded.data(), DAB_FIBS_PER_BLOCK * DAB_FIB_SIZE);
+
+        // Parse the FIBs that are valid
+        int valid = 0;
+        std::lock_guard<std::mutex> lck(ensMtx);
+        for (int i = 0; i < DAB_FIBS_PER_BLOCK; i++) {
+            const uint8_t* fib = &decoded[i * DAB_FIB_SIZE];
+            if (!checkCRC(fib)) { continue; }
+            parser.parseFIB(fib);
+            valid++;
+        }
+        return valid;
+    }
+
+    void FrameDecoder::decodeCIF(const uint8_t* soft) {
+        // Set up the subchannel once the FIC has described it
+        {
+            std::lock_guard<std::mutex> lck(ensMtx);
+            if (selectedId < 0) { return; }
+            if (!scConfigured) {
+                auto it = parser.ensemble.subchannels.find(selectedId);
+                if (it == parser.ensemble.subchannels.end()) { return; }
+                if (!configureSubchannel(it->second)) {
+                    selectedId = -1;
+                    return;
+                }
+                scConfigured = true;
+            }
+        }
+
+        // Write the subchannel into the time interleaver
+        int bits = sc.size * DAB_CU_BITS;
+        memcpy(&tiBuf[tiIndex * bits], &soft[sc.startAddr * DAB_CU_BITS], bits);
+
+        // Each bit is delayed so that its total delay through the interleaver and deinterleaver is 15 CIFs
+        for (int i = 0; i < bits; i++) {
+            int delay = (TI_DEPTH - 1) - TI_MAP[i % TI_DEPTH];
+            int slot = (tiIndex - delay + TI_DEPTH) % TI_DEPTH;
+            deinterleaved[i] = tiBuf[slot * bits + i];
+        }
+        tiIndex = (tiIndex + 1) % TI_DEPTH;
+
+        // Wait until the deinterleaver is full
+        if (tiFilled < TI_DEPTH - 1) {
+            tiFilled++;
+            return;
+        }
+
+        // Depuncture and decode
+        int motherBits = depuncture(deinterleaved.data(), mscMask, mother.data());
+        int len = (motherBits / MOTHER_CODE_RATE - TAIL_BITS) / 8;
+        conv.decodeSoft(mother.data(), motherBits, decoded.data());
+        energyDispersal(decoded.data(), len);
+
+        // Append to the output
+        memcpy(&out.writeBuf[outCount], decoded.data(), len);
+        outCount += len;
+    }
+
+    bool FrameDecoder::configureSubchannel(const Subchannel& sc) {
+        // Find the protection profile (ETSI EN 300 401 11.3.2)
+        int l1, l2, pi1, pi2;
+        if (sc.protection == PROTECTION_EEP_A) {
+            int n = sc.getBitrate() / 8;
+            switch (sc.level) {
+            case 1: l1 = 6*n - 3; l2 = 3; pi1 = 24; pi2 = 23; break;
+            case 2:
+                if (n > 1) { l1 = 2*n - 3; l2 = 4*n + 3; pi1 = 14; pi2 = 13; }
+                else { l1 = 5; l2 = 1; pi1 = 13; pi2 = 12; }
+                break;
+            case 3: l1 = 6*n - 3; l2 = 3; pi1 = 8; pi2 = 7; break;
+            default: l1 = 4*n - 3; l2 = 2*n + 3; pi1 = 3; pi2 = 2; break;
+            }
+        }
+        else if (sc.protection == PROTECTION_EEP_B) {
+            const int PI_B[4] = { 10, 6, 4, 2 };
+            int n = sc.getBitrate() / 32;
+            l1 = 24*n - 3;
+            l2 = 3;
+            pi1 = PI_B[sc.level - 1];
+            pi2 = pi1 - 1;
+        }
+        else {
+            flog::warn("DAB subchannel {} uses unequal error protection, which is not supported", sc.id);
+            return false;
+        }
+
+        // Build the puncturing mask and check that it matches the size of the subchannel
+        mscMask.clear();
+        appendPuncturing(mscMask, l1, pi1);
+        appendPuncturing(mscMask, l2, pi2);
+        appendTail(mscMask);
+        int kept = 0;
+        for (uint8_t b : mscMask) { kept += b; }
+        if (l1 < 0 || kept != sc.size * DAB_CU_BITS) {
+            flog::warn("DAB subchannel {} has an invalid size for its protection profile", sc.id);
+            return false;
+        }
+
+        // Reset the time deinterleaver
+        this->sc = sc;
+        tiBuf.assign(TI_DEPTH * sc.size * DAB_CU_BITS, 128);
+        tiIndex = 0;
+        tiFilled = 0;
+        return true;
+    }
+
+    int FrameDecoder::depuncture(const uint8_t* in, const std::vector<uint8_t>& mask, uint8_t* out) {
+        // Punctured bits are replaced by erasures
+        int count = mask.size();
+        for (int i = 0; i < count; i++) {
+            out[i] = mask[i] ? *(in++) : 128;
+        }
+        return count;
+    }
+
+    void FrameDecoder::energyDispersal(uint8_t* data, int len) {
+        for (int i = 0; i < len; i++) {
+            data[i] ^= prbs[i];
+        }
+    }
+
+    bool FrameDecoder::checkCRC(const uint8_t* fib) {
+        // CRC-16 CCITT over the FIB data, transmitted inverted
+        uint16_t crc = 0xFFFF;
+        for (int i = 0; i < DAB_FIB_SIZE - 2; i++) {
+            crc ^= fib[i] << 8;
+            for (int j = 0; j < 8; j++) {
+                crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+            }
+        }
+        uint16_t expected = (fib[DAB_FIB_SIZE - 2] << 8) | fib[DAB_FIB_SIZE - 1];
+        return (uint16_t)~crc == expected;
+    }
+
+    void FrameDecoder::appendPuncturing(std::vector<uint8_t>& mask, int blocks, int pi) {
+        // Build the puncturing vector PI_pi, each group of 4 bits keeps at least its first bit
+        // and one more for every time it comes up in the order as the index goes up
+        uint8_t vec[32];
+        for (int g = 0; g < 8; g++) {
+            int keep = 1;
+            for (int m = 0; m < pi; m++) {
+                if (PUNCT_GROUP_ORDER[m % 8] == g) { keep++; }
+            }
+            for (int b = 0; b < 4; b++) {
+                vec[g*4 + b] = (b < keep);
+            }
+        }
+
+        // The vector is applied 4 times per block of 128 bits
+        for (int i = 0; i < blocks * 4; i++) {
+            mask.insert(mask.end(), vec, vec + 32);
+        }
+    }
+
+    void FrameDecoder::appendTail(std::vector<uint8_t>& mask) {
+        // The 24 tail bits are punctured by PI_X = 1100 1100 1100 1100 1100 1100
+        for (int i = 0; i < TAIL_BITS; i++) {
+            mask.insert(mask.end(), { 1, 1, 0, 0 });
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <dsp/processor.h>
+#include <dsp/fec/viterbi.h>
+#include "fic.h"
+
+namespace dab {
+    /**
+     * Decodes the soft bits of the frames from OFDMDemod. The FIC is decoded to keep track of the ensemble and the
+     * selected MSC subchannel is time deinterleaved and decoded. Outputs the bytes of the subchannel.
+    */
+    class FrameDecoder : public dsp::Processor<uint8_t, uint8_t> {
+        using base_type = dsp::Processor<uint8_t, uint8_t>;
+    public:
+        /**
+         * Create a frame decoder specifying an input stream.
+         * @param in Input stream.
+        */
+        FrameDecoder(dsp::stream<uint8_t>* in = NULL);
+
+        // Destructor
+        ~FrameDecoder();
+
+        /**
+         * Select the subchannel to decode. It is set up once it appears in the FIC.
+         * @param id ID of the subchannel, -1 to decode none.
+        */
+        void selectSubchannel(int id);
+
+        /**
+         * Forget the ensemble and the state of the subchannel decoder, for instance after a retune.
+        */
+        void reset();
+
+        /**
+         * Get what is currently known of the ensemble.
+         * @return Copy of the ensemble.
+        */
+        Ensemble getEnsemble();
+
+        /**
+         * Get the ratio of FIBs of the last frame that passed the CRC.
+         * @return Ratio between 0 and 1.
+        */
+        float getFICQuality() { return ficQuality; }
+
+    private:
+        int run();
+        int decodeFIC(const uint8_t* soft);
+        void decodeCIF(const uint8_t* soft);
+        bool configureSubchannel(const Subchannel& sc);
+        int depuncture(const uint8_t* in, const std::vector<uint8_t>& mask, uint8_t* out);
+        void energyDispersal(uint8_t* data, int len);
+        static bool checkCRC(const uint8_t* fib);
+        static void appendPuncturing(std::vector<uint8_t>& mask, int blocks, int pi);
+        static void appendTail(std::vector<uint8_t>& mask);
+
+        dsp::fec::Viterbi conv;
+        std::vector<uint8_t> prbs;
+        std::vector<uint8_t> mother;
+        std::vector<uint8_t> decoded;
+
+        // FIC
+        std::vector<uint8_t> ficMask;
+        FICParser parser;
+        std::atomic<float> ficQuality = 0.0f;
+
+        // MSC
+        int selectedId = -1;
+        bool scConfigured = false;
+        Subchannel sc;
+        std::vector<uint8_t> mscMask;
+        std::vector<uint8_t> tiBuf;
+        std::vector<uint8_t> deinterleaved;
+        int tiIndex = 0;
+        int tiFilled = 0;
+        int outCount = 0;
+
+        std::mutex ensMtx;
+    };
+}
@@ -10,9 +10,10 @@
 #include <dsp/buffer/reshaper.h>
 #include <dsp/multirate/rational_resampler.h>
 #include <dsp/sink/handler_sink.h>
-#include <fstream>
-#include <chrono>
+#include <atomic>
 #include "dab_dsp.h"
+#include "ofdm_demod.h"
+#include "frame_decoder.h"
 #include <gui/widgets/constellation_diagram.h>
 
 #define CONCAT(a, b) ((std::string(a) + b).c_str())
@@ -30,13 +31,11 @@ ConfigManager config;
 #define INPUT_SAMPLE_RATE   2.048e6
 #define VFO_BANDWIDTH       1.6e6
 
-class M17DecoderModule : public ModuleManager::Instance {
+class DABDecoderModule : public ModuleManager::Instance {
 public:
-    M17DecoderModule(std::string name)  {
+    DABDecoderModule(std::string name)  {
         this->name = name;
 
-        file = std::ofstream("sync4.f32", std::ios::out | std::ios::binary);
-
         // Load config
         config.acquire();
         
@@ -49,23 +48,29 @@ public:
         // Initialize DSP here
         csync.init(vfo->output, 1e-3, 246e-6, INPUT_SAMPLE_RATE);
         ffsync.init(&csync.out);
-        ns.init(&ffsync.out, handler, this);
+        ofdm.init(&ffsync.out);
+        decoder.setInput(&ofdm.out);
+        mscSink.init(&decoder.out, mscHandler, this);
 
         // Start DSO Here
         csync.start();
         ffsync.start();
-        ns.start();
+        ofdm.start();
+        decoder.start();
+        mscSink.start();
 
         gui::menu.registerEntry(name, menuHandler, this, this);
     }
 
-    ~M17DecoderModule() {
+    ~DABDecoderModule() {
         gui::menu.removeEntry(name);
         // Stop DSP Here
         if (enabled) {
             csync.stop();
             ffsync.stop();
-            ns.stop();
+            ofdm.stop();
+            decoder.stop();
+            mscSink.stop();
             sigpath::vfoManager.deleteVFO(vfo);
         }
 
@@ -82,10 +87,17 @@ public:
         // Set Input of demod here
         csync.setInput(vfo->output);
 
+        // Forget the previous ensemble
+        decoder.reset();
+        decoder.selectSubchannel(-1);
+        selectedService = 0;
+
         // Start DSP here
         csync.start();
         ffsync.start();
-        ns.start();
+        ofdm.start();
+        decoder.start();
+        mscSink.start();
 
         enabled = true;
     }
@@ -94,7 +106,9 @@ public:
         // Stop DSP here
         csync.stop();
         ffsync.stop();
-        ns.stop();
+        ofdm.stop();
+        decoder.stop();
+        mscSink.stop();
 
         sigpath::vfoManager.deleteVFO(vfo);
         enabled = false;
@@ -106,26 +120,72 @@ public:
 
 private:
     static void menuHandler(void* ctx) {
-        M17DecoderModule* _this = (M17DecoderModule*)ctx;
+        DABDecoderModule* _this = (DABDecoderModule*)ctx;
 
         float menuWidth = ImGui::GetContentRegionAvail().x;
 
         if (!_this->enabled) { style::beginDisabled(); }
 
+        // Update the constellation from the latest frame
+        dsp::complex_t* buf = _this->constDiagram.acquireBuffer();
+        _this->ofdm.getConstellation(buf, 1024);
+        _this->constDiagram.releaseBuffer();
         _this->constDiagram.draw();
 
-        if (!_this->enabled) { style::endDisabled(); }
-    }
+        dab::Ensemble ens = _this->decoder.getEnsemble();
+        ImGui::Text("FIC Quality: %d%%", (int)roundf(_this->decoder.getFICQuality() * 100.0f));
+        ImGui::Text("Ensemble: %s (0x%04X)", ens.label.empty() ? "Unknown" : ens.label.c_str(), ens.id);
+
+        // Service list
+        if (ImGui::BeginTable(("dab_decoder_service_table" + _this->name).c_str(), 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, ImVec2(0, 200.0f * style::uiScale))) {
+            ImGui::TableSetupColumn("Service");
+            ImGui::TableSetupColumn("SId");
+            ImGui::TableSetupColumn("Bitrate");
+            ImGui::TableSetupScrollFreeze(3, 1);
+            ImGui::TableHeadersRow();
+
+            for (auto& [sid, svc] : ens.services) {
+                // Find the subchannel of the primary component
+                const dab::Subchannel* sc = NULL;
+                for (auto& comp : svc.components) {
+                    if (!comp.primary) { continue; }
+                    auto it = ens.subchannels.find(comp.subchannel);
+                    if (it != ens.subchannels.end()) { sc = &it->second; }
+                }
+
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                std::string label = svc.label.empty() ? "Unknown" : svc.label;
+                if (ImGui::Selectable((label + "##dab_decoder_svc_" + std::to_string(sid) + _this->name).c_str(), sid == _this->selectedService, ImGuiSelectableFlags_SpanAllColumns) && sc) {
+                    _this->selectedService = sid;
+                    _this->decoder.selectSubchannel(sc->id);
+                }
+
+                ImGui::TableSetColumnIndex(1);
+                ImGui::Text("0x%04X", sid);
+
+                ImGui::TableSetColumnIndex(2);
+                if (!sc) {
+                    ImGui::TextUnformatted("-");
+                }
+                else if (sc->protection == dab::PROTECTION_UEP) {
+                    ImGui::TextUnformatted("UEP");
+                }
+                else {
+                    ImGui::Text("%d kbit/s", sc->getBitrate());
+                }
+            }
+            ImGui::EndTable();
+        }
 
-    std::ofstream file;
+        ImGui::Text("Subchannel Data: %d KB", (int)(_this->mscBytes / 1000));
 
-    static void handler(dsp::complex_t* data, int count, void* ctx) {
-        M17DecoderModule* _this = (M17DecoderModule*)ctx;
-        //_this->file.write((char*)data, count * sizeof(dsp::complex_t));
+        if (!_this->enabled) { style::endDisabled(); }
+    }
 
-        dsp::complex_t* buf = _this->constDiagram.acquireBuffer();
-        memcpy(buf, data, 1024 * sizeof(dsp::complex_t));
-        _this->constDiagram.releaseBuffer();
+    static void mscHandler(uint8_t* data, int count, void* ctx) {
+        DABDecoderModule* _this = (DABDecoderModule*)ctx;
+        _this->mscBytes += count;
     }
 
     std::string name;
@@ -133,7 +193,12 @@ private:
 
     dab::CyclicSync csync;
     dab::FrameFreqSync ffsync;
-    dsp::sink::Handler<dsp::complex_t> ns;
+    dab::OFDMDemod ofdm;
+    dab::FrameDecoder decoder;
+    dsp::sink::Handler<uint8_t> mscSink;
+
+    uint32_t selectedService = 0;
+    std::atomic<uint64_t> mscBytes = 0;
 
     ImGui::ConstellationDiagram constDiagram;
 
@@ -150,11 +215,11 @@ MOD_EXPORT void _INIT_() {
 }
 
 MOD_EXPORT ModuleManager::Instance* _CREATE_INSTANCE_(std::string name) {
-    return new M17DecoderModule(name);
+    return new DABDecoderModule(name);
 }
 
 MOD_EXPORT void _DELETE_INSTANCE_(void* instance) {
-    delete (M17DecoderModule*)instance;
+    delete (DABDecoderModule*)instance;
 }
 
 MOD_EXPORT void _END_() {
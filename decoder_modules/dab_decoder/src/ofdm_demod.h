@@ -0,0 +1,129 @@
+#pragma once
+#include <dsp/processor.h>
+#include <dsp/buffer/buffer.h>
+#include <fftw3.h>
+#include <mutex>
+#include <algorithm>
+#include "dab_consts.h"
+
+namespace dab {
+    // Demodulates frames from FrameFreqSync into soft bits. Every symbol is FFT'd, each carrier is differentially
+    // demodulated against the same carrier of the previous symbol and the carriers are frequency deinterleaved.
+    // Outputs DAB_FRAME_BITS soft bits per frame, 0 being a certain 0 and 255 a certain 1.
+    class OFDMDemod : public dsp::Processor<dsp::complex_t, uint8_t> {
+        using base_type = dsp::Processor<dsp::complex_t, uint8_t>;
+    public:
+        OFDMDemod() {}
+
+        OFDMDemod(dsp::stream<dsp::complex_t>* in) { init(in); }
+
+        ~OFDMDemod() {
+            if (!base_type::_block_init) { return; }
+            base_type::stop();
+            fftwf_destroy_plan(plan);
+            fftwf_free(fftIn);
+            fftwf_free(fftOut);
+            dsp::buffer::free(prevBins);
+            dsp::buffer::free(diff);
+        }
+
+        void init(dsp::stream<dsp::complex_t>* in) {
+            // Allocate buffers
+            fftIn = (dsp::complex_t*)fftwf_alloc_complex(DAB_FFT_SIZE);
+            fftOut = (dsp::complex_t*)fftwf_alloc_complex(DAB_FFT_SIZE);
+            prevBins = dsp::buffer::alloc<dsp::complex_t>(DAB_FFT_SIZE);
+            diff = dsp::buffer::alloc<dsp::complex_t>(DAB_CARRIERS);
+
+            // Plan the FFT computation
+            plan = fftwf_plan_dft_1d(DAB_FFT_SIZE, (fftwf_complex*)fftIn, (fftwf_complex*)fftOut, FFTW_FORWARD, FFTW_ESTIMATE);
+
+            // Generate the frequency interleaving table (ETSI EN 300 401 14.6.1). The QPSK symbol n goes on the
+            // carrier k = PI(i) - 1024 where PI is the i-th value of the sequence that falls in [256, 1792] except 1024.
+            int pi = 0;
+            int n = 0;
+            while (n < DAB_CARRIERS) {
+                pi = (13 * pi + 511) % DAB_FFT_SIZE;
+                if (pi < 256 || pi > 1792 || pi == 1024) { continue; }
+                int k = pi - 1024;
+                carrierBins[n++] = (k >= 0) ? k : (DAB_FFT_SIZE + k);
+            }
+
+            base_type::init(in);
+        }
+
+        /**
+         * Get the differentially demodulated carriers of the last symbol of the MSC, for display purposes.
+         * @param out Output buffer.
+         * @param count Number of carriers to get, at most DAB_CARRIERS.
+        */
+        void getConstellation(dsp::complex_t* out, int count) {
+            std::lock_guard<std::mutex> lck(constMtx);
+            memcpy(out, constellation, std::min<int>(count, DAB_CARRIERS) * sizeof(dsp::complex_t));
+        }
+
+        int run() {
+            int count = base_type::_in->read();
+            if (count < 0) { return -1; }
+
+            // Only complete frames are expected
+            if (count != DAB_FRAME_SYMS * DAB_FFT_SIZE) {
+                base_type::_in->flush();
+                return count;
+            }
+
+            for (int i = 0; i < DAB_FRAME_SYMS; i++) {
+                // Compute the spectrum of the symbol
+                memcpy(fftIn, &_in->readBuf[i * DAB_FFT_SIZE], DAB_FFT_SIZE * sizeof(dsp::complex_t));
+                fftwf_execute(plan);
+
+                // The phase reference is only used as a reference for the next symbol
+                if (i) { demodSymbol(&out.writeBuf[(i - 1) * DAB_SYM_BITS]); }
+
+                // Save the carriers for the next symbol
+                memcpy(prevBins, fftOut, DAB_FFT_SIZE * sizeof(dsp::complex_t));
+            }
+
+            // Save the constellation of the last symbol
+            {
+                std::lock_guard<std::mutex> lck(constMtx);
+                memcpy(constellation, diff, DAB_CARRIERS * sizeof(dsp::complex_t));
+            }
+
+            base_type::_in->flush();
+            if (!out.swap(DAB_FRAME_BITS)) { return -1; }
+            return count;
+        }
+
+    protected:
+        void demodSymbol(uint8_t* bits) {
+            // Differentially demodulate each QPSK symbol in deinterleaved order
+            float avgAmp = 0.0f;
+            for (int n = 0; n < DAB_CARRIERS; n++) {
+                int bin = carrierBins[n];
+                diff[n] = fftOut[bin] * prevBins[bin].conj();
+                avgAmp += diff[n].amplitude();
+            }
+
+            // Normalize so that a clean symbol lands on (+-1, +-1)
+            float scale = (avgAmp > 0.0f) ? ((float)DAB_CARRIERS * 1.41421356f / avgAmp) : 0.0f;
+
+            // The real part carries the bit n and the imaginary part the bit n + K, a negative value being a 1
+            for (int n = 0; n < DAB_CARRIERS; n++) {
+                diff[n] = diff[n] * scale;
+                bits[n] = std::clamp<int>(128.0f - (diff[n].re * 100.0f), 0, 255);
+                bits[n + DAB_CARRIERS] = std::clamp<int>(128.0f - (diff[n].im * 100.0f), 0, 255);
+            }
+        }
+
+        fftwf_plan plan;
+        dsp::complex_t* fftIn;
+        dsp::complex_t* fftOut;
+        dsp::complex_t* prevBins;
+        dsp::complex_t* diff;
+
+        int carrierBins[DAB_CARRIERS];
+
+        std::mutex constMtx;
+        dsp::complex_t constellation[DAB_CARRIERS] = {};
+    };
+}
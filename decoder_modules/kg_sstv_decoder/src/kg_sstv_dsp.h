@@ -7,9 +7,8 @@
 #include <dsp/sink.h>
 #include <utils/flog.h>
 
-extern "C" {
-#include <correct.h>
-}
+#include <dsp/fec/viterbi.h>
+#include <dsp/digital/sync_search.h>
 
 #define KGSSTV_DEVIATION        300
 #define KGSSTV_BAUDRATE         1200
@@ -119,8 +118,9 @@ namespace kgsstv {
         void init(dsp::stream<float>* in) {
             _in = in;
 
-            // TODO: Destroy
-            conv = correct_convolutional_create(2, 7, kgsstv_polynomial);
+            conv.init(2, 7, kgsstv_polynomial);
+            sync.clear();
+            sync.addPattern(KGSSTV_SYNC_WORD, KGSSTV_SYNC_WORD_SIZE, 4);
             memset(convTmp, 0x00, 1024);
 
             dsp::generic_block<Deframer>::registerInput(_in);
@@ -144,23 +144,16 @@ namespace kgsstv {
 
             for (int i = 0; i < count; i++) {
                 if (syncing) {
-                    // If sync broken, reset sync
-                    if ((_in->readBuf[i] > 0.0f) && !KGSSTV_SYNC_WORD[match]) {
-                        if (++err > 4) {
-                            i -= match - 1;
-                            match = 0;
-                            err = 0;
-                            continue;
-                        }
-                    }
-
-                    // If full syncword was detected, switch to read mode
-                    if (++match == KGSSTV_SYNC_WORD_SIZE) {
-                        flog::warn("Frame detected");
-                        syncing = false;
-                        readCount = 0;
-                        writeCount = 0;
-                    }
+                    // Search for the syncword, switch to read mode once detected
+                    dsp::digital::SyncMatch match;
+                    int syncEnd = sync.search(&_in->readBuf[i], count - i, match);
+                    if (syncEnd < 0) { break; }
+                    i += syncEnd;
+
+                    flog::warn("Frame detected");
+                    syncing = false;
+                    readCount = 0;
+                    writeCount = 0;
                 }
                 else {
                     // // Process symbol
@@ -177,8 +170,7 @@ namespace kgsstv {
                     
                     // When info was read, write data and get back to
                     if (++readCount == 108) {
-                        match = 0;
-                        err = 0;
+                        sync.reset();
                         syncing = true;
 
                         // Descramble
@@ -191,7 +183,7 @@ namespace kgsstv {
                         }
 
                         // Decode convolutional code
-                        int convOutCount = correct_convolutional_decode_soft(conv, convTmp, 124, out.writeBuf);
+                        int convOutCount = conv.decodeSoft(convTmp, 124, out.writeBuf);
 
                         flog::warn("Frames written: {0}, frameBytes: {1}", ++framesWritten, convOutCount);
                         if (!out.swap(7)) {
@@ -211,11 +203,10 @@ namespace kgsstv {
 
     private:
         dsp::stream<float>* _in;
-        correct_convolutional* conv = NULL;
+        dsp::fec::Viterbi conv;
         uint8_t convTmp[1024];
 
-        int match = 0;
-        int err = 0;
+        dsp::digital::SyncSearch sync;
         int readCount = 0;
         int writeCount = 0;
         bool syncing = true;
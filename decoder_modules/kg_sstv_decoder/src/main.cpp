@@ -142,7 +142,7 @@ private:
             }
             config.acquire();
             config.conf[_this->name]["showLines"] = _this->showLines;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
 
         if (!_this->enabled) { style::endDisabled(); }
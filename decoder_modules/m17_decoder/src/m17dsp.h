@@ -4,15 +4,13 @@
 #include <dsp/sink/null_sink.h>
 #include <dsp/demod/gfsk.h>
 #include <dsp/routing/doubler.h>
+#include <dsp/digital/sync_search.h>
 #include <volk/volk.h>
 #include <codec2.h>
-#include <golay24.h>
+#include <dsp/fec/golay.h>
+#include <dsp/fec/viterbi.h>
 #include <lsf_decode.h>
 
-extern "C" {
-#include <correct.h>
-}
-
 #define M17_DEVIATION     2400.0f
 #define M17_BAUDRATE      4800.0f
 #define M17_RRC_ALPHA     0.5f
@@ -148,13 +146,16 @@ namespace dsp {
         ~M17FrameDemux() {
             if (!block::_block_init) { return; }
             block::stop();
-            delete[] delay;
         }
 
         void init(stream<uint8_t>* in) {
             _in = in;
 
-            delay = new uint8_t[STREAM_BUFFER_SIZE];
+            // The pattern IDs are the frame types
+            sync.clear();
+            sync.addPattern(M17_LSF_SYNC, M17_SYNC_SIZE, 0);
+            sync.addPattern(M17_STF_SYNC, M17_SYNC_SIZE, 0);
+            sync.addPattern(M17_PKF_SYNC, M17_SYNC_SIZE, 0);
 
             block::registerInput(_in);
             block::registerOutput(&linkSetupOut);
@@ -178,35 +179,30 @@ namespace dsp {
             int count = _in->read();
             if (count < 0) { return -1; }
 
-            memcpy(&delay[M17_SYNC_SIZE], _in->readBuf, count);
+            uint8_t* in = _in->readBuf;
 
             for (int i = 0; i < count;) {
                 if (detect) {
-                    if (outCount < M17_SYNC_SIZE) {
-                        outCount++;
-                        i++;
-                    }
-                    else {
-                        int id = M17_INTERLEAVER[outCount - M17_SYNC_SIZE];
+                    int id = M17_INTERLEAVER[outCount - M17_SYNC_SIZE];
 
-                        if (type == 0) {
-                            linkSetupOut.writeBuf[id] = delay[i++] ^ M17_SCRAMBLER[outCount - M17_SYNC_SIZE];
-                        }
-                        else if ((type == 1 || type == 2) && id < M17_LICH_SIZE) {
-                            lichOut.writeBuf[id] = delay[i++] ^ M17_SCRAMBLER[outCount - M17_SYNC_SIZE];
-                        }
-                        else if (type == 1) {
-                            streamOut.writeBuf[id - M17_LICH_SIZE] = (delay[i++] ^ M17_SCRAMBLER[outCount - M17_SYNC_SIZE]);
-                        }
-                        else if (type == 2) {
-                            packetOut.writeBuf[id - M17_LICH_SIZE] = (delay[i++] ^ M17_SCRAMBLER[outCount - M17_SYNC_SIZE]);
-                        }
-
-                        outCount++;
+                    if (type == 0) {
+                        linkSetupOut.writeBuf[id] = in[i++] ^ M17_SCRAMBLER[outCount - M17_SYNC_SIZE];
+                    }
+                    else if ((type == 1 || type == 2) && id < M17_LICH_SIZE) {
+                        lichOut.writeBuf[id] = in[i++] ^ M17_SCRAMBLER[outCount - M17_SYNC_SIZE];
+                    }
+                    else if (type == 1) {
+                        streamOut.writeBuf[id - M17_LICH_SIZE] = (in[i++] ^ M17_SCRAMBLER[outCount - M17_SYNC_SIZE]);
                     }
+                    else if (type == 2) {
+                        packetOut.writeBuf[id - M17_LICH_SIZE] = (in[i++] ^ M17_SCRAMBLER[outCount - M17_SYNC_SIZE]);
+                    }
+
+                    outCount++;
 
                     if (outCount >= M17_RAW_FRAME_SIZE) {
                         detect = false;
+                        sync.reset();
                         if (type == 0) {
                             if (!linkSetupOut.swap(M17_CUT_FRAME_SIZE)) { return -1; }
                         }
@@ -222,38 +218,16 @@ namespace dsp {
                     continue;
                 }
 
-                // Check for link setup syncword
-                if (!memcmp(&delay[i], M17_LSF_SYNC, M17_SYNC_SIZE)) {
-                    detect = true;
-                    outCount = 0;
-                    type = 0;
-                    //flog::warn("Found sync frame");
-                    continue;
-                }
-
-                // Check for stream syncword
-                if (!memcmp(&delay[i], M17_STF_SYNC, M17_SYNC_SIZE)) {
-                    detect = true;
-                    outCount = 0;
-                    type = 1;
-                    //flog::warn("Found stream frame");
-                    continue;
-                }
-
-                // Check for packet syncword
-                if (!memcmp(&delay[i], M17_PKF_SYNC, M17_SYNC_SIZE)) {
-                    detect = true;
-                    outCount = 0;
-                    type = 2;
-                    //flog::warn("Found packet frame");
-                    continue;
-                }
-
-                i++;
+                // Search for any of the syncwords, the frame starts right after it
+                digital::SyncMatch match;
+                int syncEnd = sync.search(&in[i], count - i, match);
+                if (syncEnd < 0) { break; }
+                i += syncEnd + 1;
+                detect = true;
+                outCount = M17_SYNC_SIZE;
+                type = match.pattern;
             }
 
-            memmove(delay, &delay[count], 16);
-
             _in->flush();
 
             return count;
@@ -267,7 +241,7 @@ namespace dsp {
     private:
         stream<uint8_t>* _in;
 
-        uint8_t* delay;
+        digital::SyncSearch sync;
 
         bool detect = false;
         int type;
@@ -284,7 +258,6 @@ namespace dsp {
         ~M17LSFDecoder() {
             if (!block::_block_init) { return; }
             block::stop();
-            correct_convolutional_destroy(conv);
         }
 
         void init(stream<uint8_t>* in, void (*handler)(M17LSF& lsf, void* ctx), void* ctx) {
@@ -292,7 +265,7 @@ namespace dsp {
             _handler = handler;
             _ctx = ctx;
 
-            conv = correct_convolutional_create(2, 5, correct_conv_m17_polynomial);
+            conv.init(2, 5, correct_conv_m17_polynomial);
 
             block::registerInput(_in);
             block::_block_init = true;
@@ -312,26 +285,20 @@ namespace dsp {
             int count = _in->read();
             if (count < 0) { return -1; }
 
-            // Depuncture the data
+            // Depuncture the data into soft bits, the punctured ones being erasures
             int inOffset = 0;
             for (int i = 0; i < M17_ENCODED_LSF_SIZE; i++) {
                 if (!M17_PUNCTURING_P1[i % 61]) {
-                    depunctured[i] = 0;
+                    depunctured[i] = 128;
                     continue;
                 }
-                depunctured[i] = _in->readBuf[inOffset++];
+                depunctured[i] = _in->readBuf[inOffset++] ? 255 : 0;
             }
 
             _in->flush();
 
-            // Pack into bytes
-            memset(packed, 0, 61);
-            for (int i = 0; i < M17_ENCODED_LSF_SIZE; i++) {
-                packed[i / 8] |= depunctured[i] << (7 - (i % 8));
-            }
-
             // Run through convolutional decoder
-            correct_convolutional_decode(conv, packed, M17_ENCODED_LSF_SIZE, lsf);
+            conv.decodeSoft(depunctured, M17_ENCODED_LSF_SIZE, lsf);
 
             // Decode it and call the handler
             M17LSF decLsf = M17DecodeLSF(lsf);
@@ -347,10 +314,9 @@ namespace dsp {
         void* _ctx;
 
         uint8_t depunctured[488];
-        uint8_t packed[61];
         uint8_t lsf[30];
 
-        correct_convolutional* conv;
+        dsp::fec::Viterbi conv;
     };
 
     class M17PayloadFEC : public block {
@@ -362,13 +328,12 @@ namespace dsp {
         ~M17PayloadFEC() {
             if (!block::_block_init) { return; }
             block::stop();
-            correct_convolutional_destroy(conv);
         }
 
         void init(stream<uint8_t>* in) {
             _in = in;
 
-            conv = correct_convolutional_create(2, 5, correct_conv_m17_polynomial);
+            conv.init(2, 5, correct_conv_m17_polynomial);
 
             block::registerInput(_in);
             block::registerOutput(&out);
@@ -389,25 +354,18 @@ namespace dsp {
             int count = _in->read();
             if (count < 0) { return -1; }
 
-            // Depuncture the data
+            // Depuncture the data into soft bits, the punctured ones being erasures
             int inOffset = 0;
             for (int i = 0; i < M17_ENCODED_PAYLOAD_SIZE; i++) {
                 if (!M17_PUNCTURING_P2[i % 12]) {
-                    depunctured[i] = 0;
+                    depunctured[i] = 128;
                     continue;
                 }
-                depunctured[i] = _in->readBuf[inOffset++];
-            }
-
-            // Pack into bytes
-            memset(packed, 0, 37);
-            for (int i = 0; i < M17_ENCODED_PAYLOAD_SIZE; i++) {
-                if (!(i % 8)) { packed[i / 8] = 0; }
-                packed[i / 8] |= depunctured[i] << (7 - (i % 8));
+                depunctured[i] = _in->readBuf[inOffset++] ? 255 : 0;
             }
 
             // Run through convolutional decoder
-            correct_convolutional_decode(conv, packed, M17_ENCODED_PAYLOAD_SIZE, out.writeBuf);
+            conv.decodeSoft(depunctured, M17_ENCODED_PAYLOAD_SIZE, out.writeBuf);
 
             _in->flush();
 
@@ -421,9 +379,8 @@ namespace dsp {
         stream<uint8_t>* _in;
 
         uint8_t depunctured[296];
-        uint8_t packed[37];
 
-        correct_convolutional* conv;
+        dsp::fec::Viterbi conv;
     };
 
     class M17Codec2Decode : public block {
@@ -572,25 +529,23 @@ namespace dsp {
 
             // Decode the 4 Golay(24, 12) blocks
             uint32_t encodedBlock;
-            uint32_t decodedBlock;
+            uint16_t decodedBlock;
             for (int b = 0; b < 4; b++) {
                 // Pack the 24bit block into a byte
                 encodedBlock = 0;
-                decodedBlock = 0;
                 for (int i = 0; i < 24; i++) { encodedBlock |= _in->readBuf[(b * 24) + i] << (23 - i); }
 
                 // Decode
-                if (!mobilinkd::Golay24::decode(encodedBlock, decodedBlock)) {
+                if (!dsp::fec::golay24::decode(encodedBlock, decodedBlock)) {
                     _in->flush();
                     return count;
                 }
 
                 // Pack the decoded bits into the output
                 int id = 0;
-                uint8_t temp;
                 for (int i = 0; i < 12; i++) {
                     id = (b * 12) + i;
-                    chunk[id / 8] |= ((decodedBlock >> (23 - i)) & 1) << (7 - (id % 8));
+                    chunk[id / 8] |= ((decodedBlock >> (11 - i)) & 1) << (7 - (id % 8));
                 }
             }
 
@@ -224,7 +224,7 @@ private:
             }
             config.acquire();
             config.conf[_this->name]["showLines"] = _this->showLines;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
 
         ImGui::TextUnformatted("Status:");
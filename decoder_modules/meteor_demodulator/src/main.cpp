@@ -144,7 +144,7 @@ private:
             if (_this->folderSelect.pathIsValid()) {
                 config.acquire();
                 config.conf[_this->name]["recPath"] = _this->folderSelect.path;
-                config.release(true);
+                config.releaseKey(_this->name);
             }
         }
 
@@ -152,16 +152,21 @@ private:
             _this->demod.setBrokenModulation(_this->brokenModulation);
             config.acquire();
             config.conf[_this->name]["brokenModulation"] = _this->brokenModulation;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
 
         if (ImGui::Checkbox(CONCAT("OQPSK##oqpsk", _this->name), &_this->oqpsk)) {
             _this->demod.setOQPSK(_this->oqpsk);
             config.acquire();
             config.conf[_this->name]["oqpsk"] = _this->oqpsk;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
 
+        // Show the state of the symbol timing recovery
+        auto timing = _this->demod.getTimingDiagnostics();
+        ImGui::Text("Symbol rate: %.1f sym/s", INPUT_SAMPLE_RATE / timing.omega);
+        ImGui::Text("Timing error: %.3f RMS", timing.getErrorRMS());
+
         if (!_this->folderSelect.pathIsValid() && _this->enabled) { style::beginDisabled(); }
 
         if (_this->recording) {
@@ -33,6 +33,7 @@ namespace dsp::demod {
             agc.init(NULL, 1.0, 10e6, agcRate);
             costas.init(NULL, costasBandwidth, brokenModulation);
             recov.init(NULL, _samplerate / _symbolrate,  omegaGain, muGain, omegaRelLimit);
+            recov.setBatchSize(16);
 
             rrc.out.free();
             agc.out.free();
@@ -136,6 +137,10 @@ namespace dsp::demod {
             _oqpsk = enabled;
         }
 
+        clock_recovery::TimingDiagnostics getTimingDiagnostics() {
+            return recov.getDiagnostics();
+        }
+
         void reset() {
             assert(base_type::_block_init);
             std::lock_guard<std::recursive_mutex> lck(base_type::ctrlMtx);
@@ -0,0 +1,165 @@
+#include "engine.h"
+#include <dsp/digital/binary_slicer.h>
+#include <dsp/buffer/buffer.h>
+#include <math.h>
+
+#define POCSAG_DEVIATION    4500.0
+
+namespace pocsag {
+    Engine::~Engine() {
+        stopWorkers();
+    }
+
+    void Engine::init(double samplerate, const std::vector<double>& offsets, int workerCount) {
+        stopWorkers();
+        channels.clear();
+
+        // Create the channels
+        for (int i = 0; i < offsets.size(); i++) {
+            auto ch = std::make_unique<Channel>();
+            ch->offset = offsets[i];
+
+            // Channelization and demodulation
+            ch->xlator.init(NULL, -offsets[i], samplerate);
+            ch->resamp.init(NULL, samplerate, ENGINE_CHANNEL_SAMPLERATE);
+            ch->demod.init(NULL, -POCSAG_DEVIATION, ENGINE_CHANNEL_SAMPLERATE);
+
+            // One decoder for every baudrate
+            for (int j = 0; j < ENGINE_BAUDRATE_COUNT; j++) {
+                RateDecoder& rd = ch->rates[j];
+                rd.baudrate = ENGINE_BAUDRATES[j];
+                double sps = ENGINE_CHANNEL_SAMPLERATE / (double)rd.baudrate;
+                rd.shape.init(round(sps));
+                rd.recov.init(NULL, sps, 1e-4, 1.0, 0.05);
+                rd.recov.out.free();
+                int baudrate = rd.baudrate;
+                rd.decoder.onMessage.bind([this, i, baudrate](Address addr, MessageType type, const std::string& msg) {
+                    onMessage(i, baudrate, addr, type, msg);
+                });
+            }
+
+            // Free useless buffers and allocate the intermediate ones
+            ch->xlator.out.free();
+            ch->resamp.out.free();
+            ch->demod.out.free();
+            int resampledSize = ceil((double)STREAM_BUFFER_SIZE * ENGINE_CHANNEL_SAMPLERATE / samplerate) + 16;
+            ch->xlated = dsp::buffer::alloc<dsp::complex_t>(STREAM_BUFFER_SIZE);
+            ch->resampled = dsp::buffer::alloc<dsp::complex_t>(resampledSize);
+            ch->demodulated = dsp::buffer::alloc<float>(resampledSize);
+            ch->filtered = dsp::buffer::alloc<float>(resampledSize);
+            ch->soft = dsp::buffer::alloc<float>(resampledSize);
+            ch->bits = dsp::buffer::alloc<uint8_t>(resampledSize);
+
+            channels.push_back(std::move(ch));
+        }
+
+        startWorkers(workerCount);
+    }
+
+    void Engine::process(int count, const dsp::complex_t* in) {
+        // Without workers, process everything in the calling thread
+        if (workers.empty()) {
+            for (auto& ch : channels) { processChannel(*ch, count, in); }
+            return;
+        }
+
+        // Hand the samples to the workers and wait for all of them to be done
+        std::unique_lock<std::mutex> lck(workMtx);
+        workIn = in;
+        workCount = count;
+        pending = workers.size();
+        generation++;
+        workCnd.notify_all();
+        doneCnd.wait(lck, [this]() { return !pending; });
+    }
+
+    void Engine::MovingAverage::init(int len) {
+        hist.assign(len, 0.0f);
+        sum = 0.0f;
+        pos = 0;
+    }
+
+    void Engine::MovingAverage::process(int count, const float* in, float* out) {
+        int len = hist.size();
+        float scale = 1.0f / (float)len;
+        for (int i = 0; i < count; i++) {
+            sum += in[i] - hist[pos];
+            hist[pos] = in[i];
+            if (++pos >= len) { pos = 0; }
+            out[i] = sum * scale;
+        }
+    }
+
+    Engine::Channel::~Channel() {
+        dsp::buffer::free(xlated);
+        dsp::buffer::free(resampled);
+        dsp::buffer::free(demodulated);
+        dsp::buffer::free(filtered);
+        dsp::buffer::free(soft);
+        dsp::buffer::free(bits);
+    }
+
+    void Engine::startWorkers(int workerCount) {
+        stopping = false;
+        generation = 0;
+        for (int i = 0; i < workerCount; i++) {
+            workers.push_back(std::thread(&Engine::worker, this, i));
+        }
+    }
+
+    void Engine::stopWorkers() {
+        {
+            std::lock_guard<std::mutex> lck(workMtx);
+            stopping = true;
+        }
+        workCnd.notify_all();
+        for (auto& w : workers) {
+            if (w.joinable()) { w.join(); }
+        }
+        workers.clear();
+    }
+
+    void Engine::worker(int id) {
+        uint64_t lastGen = 0;
+        while (true) {
+            // Wait for new samples
+            const dsp::complex_t* in;
+            int count;
+            {
+                std::unique_lock<std::mutex> lck(workMtx);
+                workCnd.wait(lck, [&]() { return generation != lastGen || stopping; });
+                if (stopping) { return; }
+                lastGen = generation;
+                in = workIn;
+                count = workCount;
+            }
+
+            // Process the channels assigned to this worker
+            int workerCount = workers.size();
+            for (int i = id; i < channels.size(); i += workerCount) {
+                processChannel(*channels[i], count, in);
+            }
+
+            // Notify the caller once all workers are done
+            {
+                std::lock_guard<std::mutex> lck(workMtx);
+                if (!--pending) { doneCnd.notify_one(); }
+            }
+        }
+    }
+
+    void Engine::processChannel(Channel& ch, int count, const dsp::complex_t* in) {
+        // Bring the channel to baseband and demodulate it
+        ch.xlator.process(count, in, ch.xlated);
+        count = ch.resamp.process(count, ch.xlated, ch.resampled);
+        count = ch.demod.process(count, ch.resampled, ch.demodulated);
+
+        // Decode it at every baudrate
+        for (auto& rd : ch.rates) {
+            rd.shape.process(count, ch.demodulated, ch.filtered);
+            int symCount = rd.recov.process(count, ch.filtered, ch.soft);
+            dsp::digital::BinarySlicer::process(symCount, ch.soft, ch.bits);
+            rd.decoder.process(ch.bits, symCount);
+        }
+    }
+}
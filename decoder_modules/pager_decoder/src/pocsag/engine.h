@@ -0,0 +1,109 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <dsp/types.h>
+#include <dsp/channel/frequency_xlator.h>
+#include <dsp/multirate/rational_resampler.h>
+#include <dsp/demod/quadrature.h>
+#include <dsp/clock_recovery/mm.h>
+#include <utils/new_event.h>
+#include "pocsag.h"
+
+namespace pocsag {
+    // Baudrates that are all searched for on every channel
+    inline const int ENGINE_BAUDRATES[] = { 512, 1200, 2400 };
+    inline const int ENGINE_BAUDRATE_COUNT = sizeof(ENGINE_BAUDRATES) / sizeof(int);
+
+    // Samplerate of each channel after channelization
+    inline const double ENGINE_CHANNEL_SAMPLERATE = 24000.0;
+
+    /**
+     * Multi-channel POCSAG decoding engine. The input is split into channels, each of which is demodulated and
+     * decoded at every baudrate at once. The channels are spread across a pool of worker threads.
+    */
+    class Engine {
+    public:
+        Engine() {}
+        ~Engine();
+
+        /**
+         * Configure the engine. Must not be called while processing.
+         * @param samplerate Samplerate of the input.
+         * @param offsets Frequency offset of each channel from the center of the input in Hz.
+         * @param workerCount Number of worker threads, 0 to process all channels in the calling thread.
+        */
+        void init(double samplerate, const std::vector<double>& offsets, int workerCount);
+
+        /**
+         * Process a block of samples, returns once all channels are done with it.
+         * @param count Number of input samples.
+         * @param in Input samples.
+        */
+        void process(int count, const dsp::complex_t* in);
+
+        /**
+         * Get the number of channels.
+         * @return Number of channels.
+        */
+        int getChannelCount() { return channels.size(); }
+
+        // Channel ID, baudrate, address, type and content of the message
+        NewEvent<int, int, Address, MessageType, const std::string&> onMessage;
+
+    private:
+        // Symbol long boxcar matched filter
+        struct MovingAverage {
+            void init(int len);
+            void process(int count, const float* in, float* out);
+
+            std::vector<float> hist;
+            float sum = 0.0f;
+            int pos = 0;
+        };
+
+        struct RateDecoder {
+            int baudrate;
+            MovingAverage shape;
+            dsp::clock_recovery::MM<float> recov;
+            Decoder decoder;
+        };
+
+        struct Channel {
+            ~Channel();
+
+            double offset;
+            dsp::channel::FrequencyXlator xlator;
+            dsp::multirate::RationalResampler<dsp::complex_t> resamp;
+            dsp::demod::Quadrature demod;
+            RateDecoder rates[ENGINE_BAUDRATE_COUNT];
+
+            dsp::complex_t* xlated = NULL;
+            dsp::complex_t* resampled = NULL;
+            float* demodulated = NULL;
+            float* filtered = NULL;
+            float* soft = NULL;
+            uint8_t* bits = NULL;
+        };
+
+        void startWorkers(int workerCount);
+        void stopWorkers();
+        void worker(int id);
+        void processChannel(Channel& ch, int count, const dsp::complex_t* in);
+
+        std::vector<std::unique_ptr<Channel>> channels;
+
+        // Worker pool
+        std::vector<std::thread> workers;
+        std::mutex workMtx;
+        std::condition_variable workCnd;
+        std::condition_variable doneCnd;
+        uint64_t generation = 0;
+        int pending = 0;
+        bool stopping = false;
+        const dsp::complex_t* workIn = NULL;
+        int workCount = 0;
+    };
+}
@@ -0,0 +1,147 @@
+#pragma once
+#include "../decoder.h"
+#include <signal_path/vfo_manager.h>
+#include <utils/optionlist.h>
+#include <utils/flog.h>
+#include <gui/style.h>
+#include <dsp/sink/handler_sink.h>
+#include <thread>
+#include "engine.h"
+
+#define MULTI_MAX_CHANNELS  32
+
+class POCSAGMultiDecoder : public Decoder {
+public:
+    POCSAGMultiDecoder(const std::string& name, VFOManager::VFO* vfo) {
+        this->name = name;
+        this->vfo = vfo;
+
+        // Define channel spacing options
+        spacings.define(6250, "6.25 KHz", 6250.0);
+        spacings.define(12500, "12.5 KHz", 12500.0);
+        spacings.define(25000, "25 KHz", 25000.0);
+        spacingId = spacings.keyId(12500);
+
+        // Leave a core for the rest of the DSP
+        workerCount = std::clamp<int>((int)std::thread::hardware_concurrency() - 1, 0, 8);
+
+        // Init DSP
+        engine.onMessage.bind(&POCSAGMultiDecoder::messageHandler, this);
+        configure();
+        handler.init(vfo->output, _handler, this);
+    }
+
+    ~POCSAGMultiDecoder() {
+        stop();
+    }
+
+    void showMenu() {
+        ImGui::LeftLabel("Channels");
+        ImGui::FillWidth();
+        if (ImGui::InputInt(("##pager_decoder_multi_chans_" + name).c_str(), &channelCount)) {
+            channelCount = std::clamp<int>(channelCount, 1, MULTI_MAX_CHANNELS);
+            reconfigure();
+        }
+
+        ImGui::LeftLabel("Spacing");
+        ImGui::FillWidth();
+        if (ImGui::Combo(("##pager_decoder_multi_spacing_" + name).c_str(), &spacingId, spacings.txt)) {
+            reconfigure();
+        }
+
+        ImGui::LeftLabel("Worker Threads");
+        ImGui::FillWidth();
+        if (ImGui::InputInt(("##pager_decoder_multi_workers_" + name).c_str(), &workerCount)) {
+            workerCount = std::clamp<int>(workerCount, 0, MULTI_MAX_CHANNELS);
+            reconfigure();
+        }
+
+        // Show the message count of every channel
+        std::lock_guard<std::mutex> lck(statsMtx);
+        double spacing = spacings.value(spacingId);
+        for (int i = 0; i < msgCounts.size(); i++) {
+            ImGui::Text("%+.2f KHz: %d messages", getChannelOffset(i, spacing) / 1000.0, msgCounts[i]);
+        }
+    }
+
+    void setVFO(VFOManager::VFO* vfo) {
+        this->vfo = vfo;
+        configureVFO();
+        handler.setInput(vfo->output);
+    }
+
+    void start() {
+        handler.start();
+        running = true;
+    }
+
+    void stop() {
+        handler.stop();
+        running = false;
+    }
+
+private:
+    static void _handler(dsp::complex_t* data, int count, void* ctx) {
+        POCSAGMultiDecoder* _this = (POCSAGMultiDecoder*)ctx;
+        _this->engine.process(count, data);
+    }
+
+    double getChannelOffset(int id, double spacing) {
+        return ((double)id - (double)(channelCount - 1) / 2.0) * spacing;
+    }
+
+    void configureVFO() {
+        // Round the samplerate up to a multiple of the channel samplerate, leaving room for the filter transitions
+        double bandwidth = channelCount * spacings.value(spacingId);
+        samplerate = ceil(bandwidth * 1.25 / pocsag::ENGINE_CHANNEL_SAMPLERATE) * pocsag::ENGINE_CHANNEL_SAMPLERATE;
+        vfo->setBandwidthLimits(bandwidth, bandwidth, true);
+        vfo->setSampleRate(samplerate, bandwidth);
+    }
+
+    void configure() {
+        configureVFO();
+
+        // Place the channels symmetrically around the center of the VFO
+        double spacing = spacings.value(spacingId);
+        std::vector<double> offsets;
+        for (int i = 0; i < channelCount; i++) {
+            offsets.push_back(getChannelOffset(i, spacing));
+        }
+        engine.init(samplerate, offsets, std::min<int>(workerCount, channelCount));
+
+        std::lock_guard<std::mutex> lck(statsMtx);
+        msgCounts.assign(channelCount, 0);
+    }
+
+    void reconfigure() {
+        bool wasRunning = running;
+        if (wasRunning) { stop(); }
+        configure();
+        if (wasRunning) { start(); }
+    }
+
+    void messageHandler(int chanId, int baudrate, pocsag::Address addr, pocsag::MessageType type, const std::string& msg) {
+        {
+            std::lock_guard<std::mutex> lck(statsMtx);
+            if (chanId < msgCounts.size()) { msgCounts[chanId]++; }
+        }
+        flog::debug("[CH{} {}Bd][{}]: '{}'", chanId, baudrate, (uint32_t)addr, msg);
+    }
+
+    std::string name;
+    VFOManager::VFO* vfo;
+
+    pocsag::Engine engine;
+    dsp::sink::Handler<dsp::complex_t> handler;
+
+    int channelCount = 8;
+    int spacingId = 0;
+    int workerCount = 0;
+    double samplerate;
+    bool running = false;
+
+    std::mutex statsMtx;
+    std::vector<int> msgCounts;
+
+    OptionList<int, double> spacings;
+};
@@ -1,5 +1,6 @@
 #include "pocsag.h"
 #include <string.h>
+#include <bitset>
 #include <utils/flog.h>
 
 #define POCSAG_FRAME_SYNC_CODEWORD  ((uint32_t)(0b01111100110100100001010111011000))
@@ -8,6 +9,7 @@
 #define POCSAG_DATA_BITS_PER_CW     20
 
 #define POCSAG_GEN_POLY             ((uint32_t)(0b11101101001))
+#define POCSAG_BCH_UNCORRECTABLE    ((uint32_t)0xFFFFFFFF)
 
 namespace pocsag {
     const char NUMERIC_CHARSET[] = {
@@ -29,28 +31,67 @@ namespace pocsag {
         '['
     };
 
+    // BCH(31, 21) syndromes and error patterns, the syndrome being linear it's computed in three chunks
+    struct BCHTables {
+        BCHTables() {
+            for (uint32_t i = 0; i < 2048; i++) { synLow[i] = syndrome(i); }
+            for (uint32_t i = 0; i < 1024; i++) {
+                synMid[i] = syndrome(i << 11);
+                synHigh[i] = syndrome(i << 21);
+            }
+
+            // Every syndrome of up to two errors is unique, the rest is uncorrectable
+            for (auto& e : errors) { e = POCSAG_BCH_UNCORRECTABLE; }
+            for (int i = 0; i < 31; i++) {
+                errors[syndrome(1u << i)] = 1u << i;
+                for (int j = i + 1; j < 31; j++) {
+                    errors[syndrome((1u << i) | (1u << j))] = (1u << i) | (1u << j);
+                }
+            }
+            errors[0] = 0;
+        }
+
+        static uint16_t syndrome(uint32_t cw) {
+            for (int i = 30; i >= 10; i--) {
+                if ((cw >> i) & 1) { cw ^= POCSAG_GEN_POLY << (i - 10); }
+            }
+            return cw;
+        }
+
+        uint16_t synLow[2048];
+        uint16_t synMid[1024];
+        uint16_t synHigh[1024];
+        uint32_t errors[1024];
+    };
+
+    const BCHTables BCH_TABLES;
+
     Decoder::Decoder() {
         // Zero out batch
         memset(batch, 0, sizeof(batch));
+
+        // Search for the frame sync codeword in both polarities
+        sync.addPattern(POCSAG_FRAME_SYNC_CODEWORD, 32, POCSAG_SYNC_DIST, dsp::digital::SYNC_VARIANTS_INVERTED);
     }
 
     void Decoder::process(uint8_t* symbols, int count) {
         for (int i = 0; i < count; i++) {
-            // Get symbol
-            uint32_t s = symbols[i];
-
             // If not sync, try to acquire sync (TODO: sync confidence)
             if (!synced) {
-                // Append new symbol to sync shift register
-                syncSR = (syncSR << 1) | s;
-
-                // Test for sync
-                synced = (distance(syncSR, POCSAG_FRAME_SYNC_CODEWORD) <= POCSAG_SYNC_DIST);
-
-                // Go to next symbol
+                dsp::digital::SyncMatch match;
+                int syncEnd = sync.search(&symbols[i], count - i, match);
+                if (syncEnd < 0) { break; }
+                i += syncEnd;
+
+                // The batch starts right after the sync codeword
+                synced = true;
+                polarity = match.variant;
                 continue;
             }
 
+            // Get symbol
+            uint32_t s = symbols[i] ^ polarity;
+
             // TODO: Flush message on desync
 
             // Append bit to batch
@@ -62,24 +103,26 @@ namespace pocsag {
                 decodeBatch();
                 batchOffset = 0;
                 synced = false;
+                sync.reset();
                 memset(batch, 0, sizeof(batch));
             }
         }
     }
 
-    int Decoder::distance(uint32_t a, uint32_t b) {
-        uint32_t diff = a ^ b;
-        int dist = 0;
-        for (int i = 0; i < 32; i++) {
-            dist += (diff >> i ) & 1;
-        }
-        return dist;
-    }
-
     bool Decoder::correctCodeword(Codeword in, Codeword& out) {
-
-
-        return true; // TODO
+        // Look up the error pattern of the BCH part of the codeword
+        uint32_t cw = in >> 1;
+        uint16_t syn = BCH_TABLES.synLow[cw & 0x7FF] ^ BCH_TABLES.synMid[(cw >> 11) & 0x3FF] ^ BCH_TABLES.synHigh[cw >> 21];
+        uint32_t pattern = BCH_TABLES.errors[syn];
+        if (pattern == POCSAG_BCH_UNCORRECTABLE) { return false; }
+        out = in ^ (pattern << 1);
+
+        // Fix the even parity bit, unless that would make more than two errors
+        if (std::bitset<32>(out).count() & 1) {
+            if (std::bitset<32>(pattern).count() >= 2) { return false; }
+            out ^= 1;
+        }
+        return true;
     }
 
     void Decoder::flushMessage() {
@@ -108,12 +151,16 @@ namespace pocsag {
     }
 
     void Decoder::decodeBatch() {
+        // Correct errors in the whole batch first
+        bool valid[POCSAG_BATCH_CODEWORD_COUNT];
         for (int i = 0; i < POCSAG_BATCH_CODEWORD_COUNT; i++) {
-            // Get codeword
-            Codeword cw = batch[i];
+            valid[i] = correctCodeword(batch[i], batch[i]);
+        }
 
-            // Correct errors. If corrupted, skip
-            if (!correctCodeword(cw, cw)) { continue; }
+        for (int i = 0; i < POCSAG_BATCH_CODEWORD_COUNT; i++) {
+            // Get codeword, if corrupted, skip
+            if (!valid[i]) { continue; }
+            Codeword cw = batch[i];
             // TODO: End message if two consecutive are corrupt
 
             // Get codeword type
@@ -2,6 +2,7 @@
 #include <string>
 #include <stdint.h>
 #include <utils/new_event.h>
+#include <dsp/digital/sync_search.h>
 
 #define POCSAG_SYNC_DIST            4
 #define POCSAG_BATCH_CODEWORD_COUNT 16
@@ -27,16 +28,23 @@ namespace pocsag {
 
         void process(uint8_t* symbols, int count);
 
+        /**
+         * Correct up to two bit errors in a codeword.
+         * @param in Received codeword.
+         * @param out Corrected codeword.
+         * @return True if the codeword could be corrected, false otherwise.
+        */
+        static bool correctCodeword(Codeword in, Codeword& out);
+
         NewEvent<Address, MessageType, const std::string&> onMessage;
 
     private:
-        static int distance(uint32_t a, uint32_t b);
-        bool correctCodeword(Codeword in, Codeword& out);
         void flushMessage();
         void decodeBatch();
 
-        uint32_t syncSR = 0;
+        dsp::digital::SyncSearch sync;
         bool synced = false;
+        uint8_t polarity = 0;
         int batchOffset = 0;
 
         Codeword batch[POCSAG_BATCH_CODEWORD_COUNT];
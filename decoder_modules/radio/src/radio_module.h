@@ -113,6 +113,7 @@ public:
         srChangeHandler.ctx = this;
         srChangeHandler.handler = sampleRateChangeHandler;
         stream.init(afChain.out, &srChangeHandler, audioSampleRate);
+        stream.setLatencyProvider(latencyProvider, this);
         sigpath::sinkManager.registerStream(name, &stream);
 
         // Select the demodulator
@@ -243,7 +244,7 @@ private:
             _this->vfo->setSnapInterval(_this->snapInterval);
             config.acquire();
             config.conf[_this->name][_this->selectedDemod->getName()]["snapInterval"] = _this->snapInterval;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
 
         // Deemphasis mode
@@ -385,7 +386,7 @@ private:
             config.conf[name][demod->getName()]["snapInterval"] = demod->getDefaultSnapInterval();
             config.conf[name][demod->getName()]["squelchLevel"] = MIN_SQUELCH;
             config.conf[name][demod->getName()]["squelchEnabled"] = false;
-            config.release(true);
+            config.releaseKey(name);
         }
         else {
             config.release();
@@ -411,7 +412,7 @@ private:
         // Save config
         config.acquire();
         config.conf[name]["selectedDemodId"] = id;
-        config.release(true);
+        config.releaseKey(name);
         auto endTime = std::chrono::high_resolution_clock::now();
         flog::warn("Demod switch took {0} us", (int64_t)((std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime)).count()));
     }
@@ -571,7 +572,7 @@ private:
 
         config.acquire();
         config.conf[name][selectedDemod->getName()]["bandwidth"] = bandwidth;
-        config.release(true);
+        config.releaseKey(name);
     }
 
     void setAudioSampleRate(double sr) {
@@ -616,7 +617,7 @@ private:
         // Save config
         config.acquire();
         config.conf[name][selectedDemod->getName()]["highPass"] = enabled;
-        config.release(true);
+        config.releaseKey(name);
     }
 
     void setDeemphasisMode(DeemphasisMode mode) {
@@ -629,7 +630,7 @@ private:
         // Save config
         config.acquire();
         config.conf[name][selectedDemod->getName()]["deempMode"] = deempModes.key(deempId);
-        config.release(true);
+        config.releaseKey(name);
     }
 
     void setNBEnabled(bool enable) {
@@ -640,7 +641,7 @@ private:
         // Save config
         config.acquire();
         config.conf[name][selectedDemod->getName()]["noiseBlankerEnabled"] = nbEnabled;
-        config.release(true);
+        config.releaseKey(name);
     }
 
     void setNBLevel(float level) {
@@ -651,7 +652,7 @@ private:
         // Save config
         config.acquire();
         config.conf[name][selectedDemod->getName()]["noiseBlankerLevel"] = nbLevel;
-        config.release(true);
+        config.releaseKey(name);
     }
 
     void setSquelchMode(SquelchMode mode) {
@@ -700,7 +701,7 @@ private:
         // Save config
         config.acquire();
         config.conf[name][selectedDemod->getName()]["squelchMode"] = squelchModes.key(squelchModeId);
-        config.release(true);
+        config.releaseKey(name);
     }
 
     void setSquelchLevel(float level) {
@@ -711,7 +712,7 @@ private:
         // Save config
         config.acquire();
         config.conf[name][selectedDemod->getName()]["squelchLevel"] = squelchLevel;
-        config.release(true);
+        config.releaseKey(name);
     }
 
     void setCTCSSTone(dsp::noise_reduction::CTCSSTone tone) {
@@ -729,7 +730,7 @@ private:
         // Save config
         config.acquire();
         config.conf[name][selectedDemod->getName()]["ctcssTone"] = ctcssTones.key(ctcssToneId);
-        config.release(true);
+        config.releaseKey(name);
     }
 
     void setFMIFNREnabled(bool enabled) {
@@ -740,7 +741,7 @@ private:
         // Save config
         config.acquire();
         config.conf[name][selectedDemod->getName()]["FMIFNREnabled"] = FMIFNREnabled;
-        config.release(true);
+        config.releaseKey(name);
     }
 
     void setIFNRPreset(IFNRPreset preset) {
@@ -758,7 +759,7 @@ private:
         // Save config
         config.acquire();
         config.conf[name][selectedDemod->getName()]["fmifnrPreset"] = ifnrPresets.key(fmIFPresetId);
-        config.release(true);
+        config.releaseKey(name);
     }
 
     static void vfoUserChangedBandwidthHandler(double newBw, void* ctx) {
@@ -771,6 +772,14 @@ private:
         _this->setAudioSampleRate(sampleRate);
     }
 
+    static double latencyProvider(void* ctx) {
+        RadioModule* _this = (RadioModule*)ctx;
+        if (!_this->vfo || !_this->selectedDemod) { return 0.0; }
+        double latency = _this->vfo->dspVFO->getDelay();
+        if (_this->postProcEnabled) { latency += _this->resamp.getGroupDelay(); }
+        return latency;
+    }
+
     static void ifChainOutputChangeHandler(dsp::stream<dsp::complex_t>* output, void* ctx) {
         RadioModule* _this = (RadioModule*)ctx;
         if (!_this->selectedDemod) { return; }
@@ -6,20 +6,21 @@
 #include <utils/flog.h>
 
 namespace rds {
-    std::map<uint16_t, BlockType> SYNDROMES = {
-        { 0b1111011000, BLOCK_TYPE_A  },
-        { 0b1111010100, BLOCK_TYPE_B  },
-        { 0b1001011100, BLOCK_TYPE_C  },
-        { 0b1111001100, BLOCK_TYPE_CP },
-        { 0b1001011000, BLOCK_TYPE_D  }
+    // Syndrome of an error free block of each type
+    const uint16_t SYNDROMES[_BLOCK_TYPE_COUNT] = {
+        0b1111011000, // BLOCK_TYPE_A
+        0b1111010100, // BLOCK_TYPE_B
+        0b1001011100, // BLOCK_TYPE_C
+        0b1111001100, // BLOCK_TYPE_CP
+        0b1001011000  // BLOCK_TYPE_D
     };
 
-    std::map<BlockType, uint16_t> OFFSETS = {
-        { BLOCK_TYPE_A,  0b0011111100 },
-        { BLOCK_TYPE_B,  0b0110011000 },
-        { BLOCK_TYPE_C,  0b0101101000 },
-        { BLOCK_TYPE_CP, 0b1101010000 },
-        { BLOCK_TYPE_D,  0b0110110100 }
+    const uint16_t OFFSETS[_BLOCK_TYPE_COUNT] = {
+        0b0011111100, // BLOCK_TYPE_A
+        0b0110011000, // BLOCK_TYPE_B
+        0b0101101000, // BLOCK_TYPE_C
+        0b1101010000, // BLOCK_TYPE_CP
+        0b0110110100  // BLOCK_TYPE_D
     };
 
     const BlockType nextType[_BLOCK_TYPE_COUNT] = {
@@ -130,7 +131,55 @@ namespace rds {
     const int DATA_LEN = 16;
     const int POLY_LEN = 10;
 
+    // Longest error burst corrected, the most the code can reliably do
+    const int MAX_BURST_LEN = 5;
+
+    // Lookup tables replacing the bit-serial syndrome computation and the error search
+    struct Tables {
+        Tables() {
+            // The syndrome is linear, so it's the XOR of the syndromes of the high and low halves of the block
+            for (uint32_t i = 0; i < 8192; i++) {
+                synLow[i] = Decoder::calcSyndrome(i);
+                synHigh[i] = Decoder::calcSyndrome(i << 13);
+            }
+
+            // Syndrome to block type
+            for (int i = 0; i < 1024; i++) { synType[i] = -1; }
+            for (int i = 0; i < _BLOCK_TYPE_COUNT; i++) { synType[SYNDROMES[i]] = i; }
+
+            // Error pattern of every burst, from the shortest so that the most likely one wins
+            for (int i = 0; i < 1024; i++) { errors[i] = 0; }
+            for (int len = 1; len <= MAX_BURST_LEN; len++) {
+                // Bursts start and end with an error, anything can be in between
+                int innerCount = (len > 2) ? (1 << (len - 2)) : 1;
+                for (int inner = 0; inner < innerCount; inner++) {
+                    uint32_t burst = (len > 1) ? ((1 << (len - 1)) | (inner << 1) | 1) : 1;
+                    for (int pos = 0; pos <= BLOCK_LEN - len; pos++) {
+                        uint32_t pattern = burst << pos;
+                        uint16_t syn = syndrome(pattern);
+                        if (!errors[syn]) { errors[syn] = pattern; }
+                    }
+                }
+            }
+        }
+
+        inline uint16_t syndrome(uint32_t block) const {
+            return synHigh[(block >> 13) & 0x1FFF] ^ synLow[block & 0x1FFF];
+        }
+
+        uint16_t synLow[8192];
+        uint16_t synHigh[8192];
+        int8_t synType[1024];
+        uint32_t errors[1024];
+    };
+
+    const Tables& tables() {
+        static const Tables t;
+        return t;
+    }
+
     void Decoder::process(uint8_t* symbols, int count) {
+        const Tables& tbl = tables();
         for (int i = 0; i < count; i++) {
             // Shift in the bit
             shiftReg = ((shiftReg << 1) & 0x3FFFFFF) | (symbols[i] & 1);
@@ -138,27 +187,37 @@ namespace rds {
             // Skip if we need to shift in new data
             if (--skip > 0) { continue; }
 
-            // Calculate the syndrome and update sync status
-            uint16_t syn = calcSyndrome(shiftReg);
-            auto synIt = SYNDROMES.find(syn);
-            bool knownSyndrome = synIt != SYNDROMES.end();
-            sync = std::clamp<int>(knownSyndrome ? ++sync : --sync, 0, 4);
-            
-            // If we're still no longer in sync, try to resync
-            if (!sync) { continue; }
+            // Calculate the syndrome and check if it's the one of an error free block
+            uint16_t syn = tbl.syndrome(shiftReg);
+            int knownType = tbl.synType[syn];
+            bool knownSyndrome = (knownType >= 0);
+
+            // Out of sync, only an error free block can be trusted to find the block boundary again
+            if (!sync && !knownSyndrome) { continue; }
 
             // Figure out which block we've got
             BlockType type;
             if (knownSyndrome) {
-                type = SYNDROMES[syn];
+                type = (BlockType)knownType;
+            }
+            else if (lastType == BLOCK_TYPE_B && blockAvail[BLOCK_TYPE_B] && ((blocks[BLOCK_TYPE_B] >> 21) & 1)) {
+                // Version B groups have a C' block after block B
+                type = BLOCK_TYPE_CP;
             }
             else {
                 // Assume the type is the one following the previous block
                 type = nextType[lastType];
             }
 
-            // Save block while correcting errors (NOT YET) <- idk why the "not yet is here", TODO: find why
-            blocks[type] = correctErrors(shiftReg, type, blockAvail[type]);
+            // Save block while correcting errors
+            blocks[type] = correctErrors(shiftReg, syn, type, blockAvail[type]);
+
+            // Update sync status, a corrected block keeps the sync where it is
+            if (knownSyndrome) { sync = std::min<int>(sync + 1, 4); }
+            else if (!blockAvail[type]) { sync--; }
+
+            // If we're no longer in sync, try to resync
+            if (!sync) { continue; }
 
             // If block type is A, decode it directly, otherwise, update continous count
             if (type == BLOCK_TYPE_A) {
@@ -206,33 +265,21 @@ namespace rds {
         return syn;
     }
 
-    uint32_t Decoder::correctErrors(uint32_t block, BlockType type, bool& recovered) {        
+    uint32_t Decoder::correctErrors(uint32_t block, uint16_t syn, BlockType type, bool& recovered) {
         // Subtract the offset from block
         block ^= (uint32_t)OFFSETS[type];
-        uint32_t out = block;
-
-        // Calculate syndrome of corrected block
-        uint16_t syn = calcSyndrome(block);
-
-        // Use the syndrome register to do error correction if errors are present
-        uint8_t errorFound = 0;
-        if (syn) {
-            for (int i = DATA_LEN - 1; i >= 0; i--) {
-                // Check if the 5 leftmost bits are all zero
-                errorFound |= !(syn & 0b11111);
 
-                // Write output
-                uint8_t outBit = (syn >> (POLY_LEN - 1)) & 1;
-                out ^= (errorFound & outBit) << (i + POLY_LEN);
-
-                // Shift syndrome
-                syn = (syn << 1) & 0b1111111111;
-                syn ^= LFSR_POLY * outBit * !errorFound;
-            }
+        // Remove the syndrome of the offset to get the one of the errors
+        syn ^= SYNDROMES[type];
+        if (!syn) {
+            recovered = true;
+            return block;
         }
-        recovered = !(syn & 0b11111);
 
-        return out;
+        // Look up the error burst matching the syndrome, if any
+        uint32_t pattern = tables().errors[syn];
+        recovered = (pattern != 0);
+        return block ^ pattern;
     }
 
     void Decoder::decodeBlockA() {
@@ -236,9 +236,11 @@ namespace rds {
         bool programTypeNameValid() { std::lock_guard<std::mutex> lck(group10Mtx); return group10Valid(); }
         std::string getProgramTypeName() { std::lock_guard<std::mutex> lck(group10Mtx); return programTypeName; }
 
-    private:
+        // Bit-serial syndrome computation, only used to build the lookup tables
         static uint16_t calcSyndrome(uint32_t block);
-        static uint32_t correctErrors(uint32_t block, BlockType type, bool& recovered);
+
+    private:
+        static uint32_t correctErrors(uint32_t block, uint16_t syn, BlockType type, bool& recovered);
         void decodeBlockA();
         void decodeBlockB();
         void decodeGroup0();
@@ -2,21 +2,18 @@
 
 namespace ryfi {
     ConvEncoder::ConvEncoder(dsp::stream<uint8_t>* in) {
-        // Create the convolutional encoder instance
-        conv = correct_convolutional_create(2, 7, correct_conv_r12_7_polynomial);
+        // Configure the convolutional encoder
+        conv.init(2, 7, correct_conv_r12_7_polynomial);
         
         // Init the base class
         base_type::init(in);
     }
 
-    ConvEncoder::~ConvEncoder() {
-        // Destroy the convolutional encoder instance
-        correct_convolutional_destroy(conv);
-    }
+    ConvEncoder::~ConvEncoder() {}
 
     int ConvEncoder::encode(const uint8_t* in, uint8_t* out, int count) {
         // Run convolutional encoder on the data
-        return correct_convolutional_encode(conv, in, count, out);
+        return conv.encode(in, count, out);
     }
 
     int ConvEncoder::run() {
@@ -31,34 +28,18 @@ namespace ryfi {
     }
 
     ConvDecoder::ConvDecoder(dsp::stream<dsp::complex_t>* in) {
-        // Create the convolutional encoder instance
-        conv = correct_convolutional_create(2, 7, correct_conv_r12_7_polynomial);
-
-        // Allocate the soft symbol buffer
-        soft = dsp::buffer::alloc<uint8_t>(STREAM_BUFFER_SIZE);
+        // Configure the convolutional decoder
+        conv.init(2, 7, correct_conv_r12_7_polynomial);
         
         // Init the base class
         base_type::init(in);
     }
 
-    ConvDecoder::~ConvDecoder() {
-        // Destroy the convolutional encoder instance
-        correct_convolutional_destroy(conv);
-
-        // Free the soft symbol buffer
-        dsp::buffer::free(soft);
-    }
+    ConvDecoder::~ConvDecoder() {}
 
     int ConvDecoder::decode(const dsp::complex_t* in, uint8_t* out, int count) {
-        // Convert to uint8
-        const float* _in = (const float*)in;
-        count *= 2;
-        for (int i = 0; i < count; i++) {
-            soft[i] = std::clamp<int>((_in[i] * 127.0f) + 128.0f, 0, 255);
-        }
-        
-        // Run convolutional decoder on the data
-        return correct_convolutional_decode_soft(conv, soft, count, out);
+        // Run convolutional decoder on the soft symbols, each carrying two bits
+        return conv.decodeSoft((const float*)in, count * 2, out);
     }
 
     int ConvDecoder::run() {
@@ -2,10 +2,7 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "dsp/processor.h"
-
-extern "C" {
-    #include "correct.h"
-}
+#include "dsp/fec/viterbi.h"
 
 namespace ryfi {
     /**
@@ -35,7 +32,7 @@ namespace ryfi {
     private:
         int run();
 
-        correct_convolutional* conv;
+        dsp::fec::Viterbi conv;
     };
 
     /**
@@ -65,7 +62,6 @@ namespace ryfi {
     private:
         int run();
 
-        correct_convolutional* conv;
-        uint8_t* soft = NULL;
+        dsp::fec::Viterbi conv;
     };
 }
\ No newline at end of file
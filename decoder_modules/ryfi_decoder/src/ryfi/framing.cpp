@@ -48,36 +48,8 @@ namespace ryfi {
     }
 
     Deframer::Deframer(dsp::stream<dsp::complex_t> *in) {
-        // Compute sync word rotations
-        //   0: 00 01 11 10
-        //  90: 10 00 01 11
-        // 180: 11 10 00 01
-        // 270: 01 11 10 00
-
-        // For 0 and 180 it's the sync and its complement
-        syncRots[ROT_0_DEG] = SYNC_WORD;
-        syncRots[ROT_180_DEG] = ~SYNC_WORD;
-        
-        // For 90 and 270 its the quadrature and its complement
-        uint64_t quad;
-        for (int i = 62; i >= 0; i -= 2) {
-            // Get the symbol
-            uint8_t sym = (SYNC_WORD >> i) & 0b11;
-
-            // Rotate it 90 degrees
-            uint8_t rsym;
-            switch (sym) {
-                case 0b00:  rsym = 0b10; break;
-                case 0b01:  rsym = 0b00; break;
-                case 0b11:  rsym = 0b01; break;
-                case 0b10:  rsym = 0b11; break;
-            }
-
-            // Push it into the quadrature
-            quad = (quad << 2) | rsym;
-        }
-        syncRots[ROT_90_DEG] = quad;
-        syncRots[ROT_270_DEG] = ~quad;
+        // Search for the sync word in all four rotations of the constellation
+        sync.addPattern(SYNC_WORD, SYNC_BITS, 5, dsp::digital::SYNC_VARIANTS_QPSK);
 
         base_type::init(in);
     }
@@ -102,32 +74,17 @@ namespace ryfi {
                 }
             }
             else {
-                // Get the raw symbol
-                dsp::complex_t fsym = in[i];
-
-                // Decode the symbol
-                uint8_t sym = ((fsym.re > 0) ? 0b10 : 0b00) | ((fsym.im > 0) ? 0b01 : 0b00);
-
-                // Push it to the shift register
-                shift = (shift << 2) | sym;
-
-                // Find the rotation starting with the last known one
-                for (int i = 0; i < 4; i++) {
-                    // Get the test rotation
-                    int testRot = (knownRot+i) & 0b11;
-
-                    // Check if the hamming distance is close enough
-                    int dist;
-                    if (distance(shift, syncRots[testRot]) < 6) {
-                        // Save the new rotation
-                        knownRot = testRot;
-
-                        // Start reading in symbols for the frame
-                        symRot = symRots[knownRot];
-                        recv = 8168; // TODO: Don't hardcode!
-                        outCount = 0;
-                    }
-                }
+                // Search for the sync word
+                dsp::digital::SyncMatch match;
+                int syncEnd = sync.search(&in[i], count - i, match);
+                if (syncEnd < 0) { break; }
+                i += syncEnd;
+
+                // Start reading in symbols for the frame, undoing the rotation
+                symRot = symRots[match.variant];
+                recv = 8168; // TODO: Don't hardcode!
+                outCount = 0;
+                sync.reset();
             }
         }
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "dsp/processor.h"
+#include "dsp/digital/sync_search.h"
 #include <stdint.h>
 #include <stddef.h>
 
@@ -56,23 +57,12 @@ namespace ryfi {
     private:
         int run();
 
-        inline static constexpr int distance(uint64_t a, uint64_t b) {
-            int dist = 0;
-            for (int i = 0; i < 64; i++) {
-                dist += ((a & 1) != (b & 1));
-                a >>= 1;
-                b >>= 1;
-            }
-            return dist;
-        }
-
         // Frame reading counters
         int recv = 0;
         int outCount = 0;
 
-        // Rotation handling
-        int knownRot = 0;
-        uint64_t syncRots[4];
+        // Sync word search, the variant is the rotation
+        dsp::digital::SyncSearch sync;
         dsp::complex_t symRot;
         const dsp::complex_t symRots[4] = {
             {  1.0f,  0.0f }, //   0 deg
@@ -80,8 +70,5 @@ namespace ryfi {
             { -1.0f,  0.0f }, // 180 deg
             {  0.0f,  1.0f }, // 270 deg
         };
-
-        // Shift register
-        uint64_t shift;
     };
 }
\ No newline at end of file
@@ -2,34 +2,21 @@
 
 namespace ryfi {
     RSEncoder::RSEncoder(dsp::stream<uint8_t>* in) {
-        // Create the convolutional encoder instance
-        rs = correct_reed_solomon_create(correct_rs_primitive_polynomial_ccsds, 1, 1, 32);
+        // Configure the reed-solomon encoder
+        rs.init(correct_rs_primitive_polynomial_ccsds, 1, 1, 32);
         
         // Init the base class
         base_type::init(in);
     }
 
-    RSEncoder::~RSEncoder() {
-        // Destroy the convolutional encoder instance
-        correct_reed_solomon_destroy(rs);
-    }
+    RSEncoder::~RSEncoder() {}
 
     int RSEncoder::encode(const uint8_t* in, uint8_t* out, int count) {
         // Check the size
         assert(count == RS_BLOCK_COUNT*RS_BLOCK_DEC_SIZE);
 
-        // Go through each block
-        uint8_t block[RS_BLOCK_ENC_SIZE];
-        for (int i = 0; i < RS_BLOCK_COUNT; i++) {
-            // Encode block
-            correct_reed_solomon_encode(rs, &in[i*RS_BLOCK_DEC_SIZE], RS_BLOCK_DEC_SIZE, block);
-
-            // Interleave into the frame
-            int k = 0;
-            for (int j = i; j < RS_BLOCK_ENC_SIZE*RS_BLOCK_COUNT; j += RS_BLOCK_COUNT) {
-                out[j] = block[k++];
-            }
-        }
+        // Encode all blocks, interleaved into the frame
+        rs.encodeInterleaved(in, RS_BLOCK_DEC_SIZE, RS_BLOCK_COUNT, out);
 
         // Scramble
         for (int i = 0; i < RS_BLOCK_COUNT*RS_BLOCK_ENC_SIZE; i++) {
@@ -51,17 +38,14 @@ namespace ryfi {
     }
 
     RSDecoder::RSDecoder(dsp::stream<uint8_t>* in) {
-        // Create the convolutional encoder instance
-        rs = correct_reed_solomon_create(correct_rs_primitive_polynomial_ccsds, 1, 1, 32);
+        // Configure the reed-solomon decoder
+        rs.init(correct_rs_primitive_polynomial_ccsds, 1, 1, 32);
         
         // Init the base class
         base_type::init(in);
     }
 
-    RSDecoder::~RSDecoder() {
-        // Destroy the convolutional encoder instance
-        correct_reed_solomon_destroy(rs);
-    }
+    RSDecoder::~RSDecoder() {}
 
     int RSDecoder::decode(uint8_t* in, uint8_t* out, int count) {
         // Check the size
@@ -72,19 +56,8 @@ namespace ryfi {
             in[i] ^= RS_SCRAMBLER_SEQ[i];
         }
 
-        // Go through each block
-        uint8_t block[RS_BLOCK_ENC_SIZE];
-        for (int i = 0; i < RS_BLOCK_COUNT; i++) {
-            // Deinterleave out of the frame
-            int k = 0;
-            for (int j = i; j < count; j += RS_BLOCK_COUNT) {
-                block[k++] = in[j];
-            }
-
-            // Decode block and return if decoding fails
-            int res = correct_reed_solomon_decode(rs, block, RS_BLOCK_ENC_SIZE, &out[i*RS_BLOCK_DEC_SIZE]);
-            if (res < 0) { return 0; }
-        }
+        // Decode all blocks out of the frame and return if decoding fails
+        if (rs.decodeInterleaved(in, RS_BLOCK_ENC_SIZE, RS_BLOCK_COUNT, out)) { return 0; }
 
         return RS_BLOCK_COUNT*RS_BLOCK_DEC_SIZE;
     }
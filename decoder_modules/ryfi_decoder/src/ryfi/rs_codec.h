@@ -2,10 +2,7 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "dsp/processor.h"
-
-extern "C" {
-    #include "correct.h"
-}
+#include "dsp/fec/reed_solomon.h"
 
 namespace ryfi {
     // Size of an encoded reed-solomon block.
@@ -47,7 +44,7 @@ namespace ryfi {
     private:
         int run();
 
-        correct_reed_solomon* rs;
+        dsp::fec::ReedSolomon rs;
     };
 
     /**
@@ -77,6 +74,6 @@ namespace ryfi {
     private:
         int run();
 
-        correct_reed_solomon* rs;
+        dsp::fec::ReedSolomon rs;
     };
 }
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "bookmark_index.h"
+#include <imgui.h>
+#include <algorithm>
+
+// Space between the name and the edges of the label, plus a pixel for the rounding of its position
+#define LABEL_PADDING   6.0f
+
+void BookmarkIndex::clear() {
+    lists.clear();
+}
+
+void BookmarkIndex::setList(const std::string& listName, const std::map<std::string, FrequencyBookmark>& bookmarks, bool visible) {
+    removeList(listName);
+    List& list = lists[listName];
+    list.visible = visible;
+    for (auto const& [bmName, bm] : bookmarks) {
+        add(listName, bmName, bm);
+    }
+}
+
+void BookmarkIndex::removeList(const std::string& listName) {
+    lists.erase(listName);
+}
+
+void BookmarkIndex::renameList(const std::string& oldName, const std::string& newName) {
+    auto node = lists.extract(oldName);
+    if (node.empty()) { return; }
+    node.key() = newName;
+    for (auto& e : node.mapped().entries) {
+        e.wbm.listName = newName;
+    }
+    lists.insert(std::move(node));
+}
+
+void BookmarkIndex::setListVisible(const std::string& listName, bool visible) {
+    auto lit = lists.find(listName);
+    if (lit == lists.end()) { return; }
+    lit->second.visible = visible;
+}
+
+void BookmarkIndex::add(const std::string& listName, const std::string& bookmarkName, const FrequencyBookmark& bookmark) {
+    List& list = lists[listName];
+    int old = find(list, bookmarkName);
+    if (old >= 0) { list.entries.erase(list.entries.begin() + old); }
+
+    Entry e;
+    e.wbm.listName = listName;
+    e.wbm.bookmarkName = bookmarkName;
+    e.wbm.bookmark = bookmark;
+    e.wbm.bookmark.selected = false;
+    e.halfWidth = -1.0f;
+    e.maxHalfWidth = 0.0f;
+    auto pos = std::upper_bound(list.entries.begin(), list.entries.end(), bookmark.frequency, [](double freq, const Entry& e) {
+        return freq < e.wbm.bookmark.frequency;
+    });
+    list.entries.insert(pos, e);
+    list.byName[bookmarkName] = bookmark.frequency;
+    list.measured = false;
+}
+
+void BookmarkIndex::remove(const std::string& listName, const std::string& bookmarkName) {
+    auto lit = lists.find(listName);
+    if (lit == lists.end()) { return; }
+    int id = find(lit->second, bookmarkName);
+    if (id < 0) { return; }
+    lit->second.entries.erase(lit->second.entries.begin() + id);
+    lit->second.byName.erase(bookmarkName);
+    lit->second.measured = false;
+}
+
+void BookmarkIndex::query(double low, double high, double freqToPixelRatio, std::vector<const WaterfallBookmark*>& out) {
+    out.clear();
+    for (auto& [listName, list] : lists) {
+        if (!list.visible || list.entries.empty()) { continue; }
+        if (!list.measured) { measure(list); }
+
+        // The frequency and the widest label so far never decrease, so the labels of the entries before this one
+        // all end below the range
+        auto it = std::lower_bound(list.entries.begin(), list.entries.end(), low, [freqToPixelRatio](const Entry& e, double freq) {
+            return e.wbm.bookmark.frequency + (e.maxHalfWidth / freqToPixelRatio) < freq;
+        });
+
+        // No label starts in the range past the widest one
+        double maxReach = list.entries.back().maxHalfWidth / freqToPixelRatio;
+        for (; it != list.entries.end() && it->wbm.bookmark.frequency - maxReach <= high; it++) {
+            double reach = it->halfWidth / freqToPixelRatio;
+            if (it->wbm.bookmark.frequency + reach < low || it->wbm.bookmark.frequency - reach > high) { continue; }
+            out.push_back(&it->wbm);
+        }
+    }
+}
+
+float BookmarkIndex::getLabelHalfWidth(const std::string& name) {
+    return (ImGui::CalcTextSize(name.c_str()).x / 2.0f) + LABEL_PADDING;
+}
+
+int BookmarkIndex::find(List& list, const std::string& bookmarkName) {
+    auto nit = list.byName.find(bookmarkName);
+    if (nit == list.byName.end()) { return -1; }
+    double freq = nit->second;
+    auto it = std::lower_bound(list.entries.begin(), list.entries.end(), freq, [](const Entry& e, double f) {
+        return e.wbm.bookmark.frequency < f;
+    });
+    for (; it != list.entries.end() && it->wbm.bookmark.frequency == freq; it++) {
+        if (it->wbm.bookmarkName == bookmarkName) { return it - list.entries.begin(); }
+    }
+    return -1;
+}
+
+void BookmarkIndex::measure(List& list) {
+    // Only the new labels are measured, the running maximum is redone since any entry may have moved
+    float maxHalfWidth = 0.0f;
+    for (auto& e : list.entries) {
+        if (e.halfWidth < 0.0f) { e.halfWidth = getLabelHalfWidth(e.wbm.bookmarkName); }
+        maxHalfWidth = std::max<float>(maxHalfWidth, e.halfWidth);
+        e.maxHalfWidth = maxHalfWidth;
+    }
+    list.measured = true;
+}
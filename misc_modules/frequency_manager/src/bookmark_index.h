@@ -0,0 +1,80 @@
+#pragma once
+#include <string>
+#include <map>
+#include <vector>
+
+struct FrequencyBookmark {
+    double frequency;
+    double bandwidth;
+    int mode;
+    bool selected;
+};
+
+struct WaterfallBookmark {
+    std::string listName;
+    std::string bookmarkName;
+    FrequencyBookmark bookmark;
+};
+
+// Bookmarks of all lists sorted by frequency along with the extent of their label, so that only the ones whose
+// label is in view have to be looked at when drawing the waterfall. Kept up to date by the edits instead of being
+// rebuilt from the config.
+class BookmarkIndex {
+public:
+    void clear();
+
+    /**
+     * Replace all bookmarks of a list, creating it if needed.
+     * @param listName Name of the list.
+     * @param bookmarks Bookmarks of the list by name.
+     * @param visible Whether the list is shown on the waterfall.
+    */
+    void setList(const std::string& listName, const std::map<std::string, FrequencyBookmark>& bookmarks, bool visible);
+
+    void removeList(const std::string& listName);
+    void renameList(const std::string& oldName, const std::string& newName);
+    void setListVisible(const std::string& listName, bool visible);
+
+    /**
+     * Add a bookmark to a list, replacing the one with the same name if any.
+    */
+    void add(const std::string& listName, const std::string& bookmarkName, const FrequencyBookmark& bookmark);
+
+    void remove(const std::string& listName, const std::string& bookmarkName);
+
+    /**
+     * Find the bookmarks of the visible lists whose label reaches into a frequency range, list by list and by
+     * increasing frequency. Must be called from the UI thread since labels are measured with the current font.
+     * @param low Lowest frequency.
+     * @param high Highest frequency.
+     * @param freqToPixelRatio Number of pixels per Hz on the waterfall.
+     * @param out Found bookmarks, valid until the index is modified.
+    */
+    void query(double low, double high, double freqToPixelRatio, std::vector<const WaterfallBookmark*>& out);
+
+    /**
+     * Get the half width of the label drawn for a bookmark, padding included.
+     * @param name Name of the bookmark.
+     * @return Half width in pixels.
+    */
+    static float getLabelHalfWidth(const std::string& name);
+
+private:
+    struct Entry {
+        WaterfallBookmark wbm;
+        float halfWidth;        // Half width of the label in pixels, negative until measured
+        float maxHalfWidth;     // Widest half width of this entry and all the ones before it
+    };
+
+    struct List {
+        bool visible = true;
+        bool measured = true;
+        std::vector<Entry> entries;
+        std::map<std::string, double> byName;
+    };
+
+    int find(List& list, const std::string& bookmarkName);
+    void measure(List& list);
+
+    std::map<std::string, List> lists;
+};
@@ -13,6 +13,9 @@
 #include <utils/freq_formatting.h>
 #include <gui/dialogs/dialog_box.h>
 #include <fstream>
+#include <filesystem>
+#include <utils/freqdb.h>
+#include "bookmark_index.h"
 
 SDRPP_MOD_INFO{
     /* Name:            */ "frequency_manager",
@@ -22,19 +25,6 @@ SDRPP_MOD_INFO{
     /* Max instances    */ 1
 };
 
-struct FrequencyBookmark {
-    double frequency;
-    double bandwidth;
-    int mode;
-    bool selected;
-};
-
-struct WaterfallBookmark {
-    std::string listName;
-    std::string bookmarkName;
-    FrequencyBookmark bookmark;
-};
-
 ConfigManager config;
 
 const char* demodModeList[] = {
@@ -49,6 +39,7 @@ const char* demodModeList[] = {
 };
 
 const char* demodModeListTxt = "NFM\0WFM\0AM\0DSB\0USB\0CW\0LSB\0RAW\0";
+const int demodModeCount = sizeof(demodModeList) / sizeof(demodModeList[0]);
 
 enum {
     BOOKMARK_DISP_MODE_OFF,
@@ -175,12 +166,16 @@ private:
                 open = false;
 
                 // If editing, delete the original one
+                config.acquire();
                 if (editOpen) {
                     bookmarks.erase(firstEditedBookmarkName);
+                    config.conf["lists"][selectedListName]["bookmarks"].erase(firstEditedBookmarkName);
+                    bookmarkIndex.remove(selectedListName, firstEditedBookmarkName);
                 }
                 bookmarks[editedBookmarkName] = editedBookmark;
-
-                saveByName(selectedListName);
+                storeBookmark(selectedListName, editedBookmarkName, editedBookmark);
+                bookmarkIndex.add(selectedListName, editedBookmarkName, editedBookmark);
+                config.releaseKey("lists");
             }
             if (applyDisabled) { style::endDisabled(); }
             ImGui::SameLine();
@@ -221,13 +216,19 @@ private:
                 if (renameListOpen) {
                     config.conf["lists"][editedListName] = config.conf["lists"][firstEditedListName];
                     config.conf["lists"].erase(firstEditedListName);
+                    bookmarkIndex.renameList(firstEditedListName, editedListName);
+                    auto dbNode = databases.extract(firstEditedListName);
+                    if (!dbNode.empty()) {
+                        dbNode.key() = editedListName;
+                        databases.insert(std::move(dbNode));
+                    }
                 }
                 else {
                     config.conf["lists"][editedListName]["showOnWaterfall"] = true;
                     config.conf["lists"][editedListName]["bookmarks"] = json::object();
+                    bookmarkIndex.setList(editedListName, {}, true);
                 }
-                refreshWaterfallBookmarks(false);
-                config.release(true);
+                config.releaseKey("lists");
                 refreshLists();
                 loadByName(editedListName);
             }
@@ -258,8 +259,9 @@ private:
                 if (ImGui::Checkbox((listName + "##freq_manager_sel_list_").c_str(), &shown)) {
                     config.acquire();
                     config.conf["lists"][listName]["showOnWaterfall"] = shown;
-                    refreshWaterfallBookmarks(false);
-                    config.release(true);
+                    config.releaseKey("lists");
+                    bookmarkIndex.setListVisible(listName, shown);
+                    if (databases.find(listName) != databases.end()) { databases[listName].visible = shown; }
                 }
             }
 
@@ -286,23 +288,148 @@ private:
 
     void refreshWaterfallBookmarks(bool lockConfig = true) {
         if (lockConfig) { config.acquire(); }
-        waterfallBookmarks.clear();
-        for (auto [listName, list] : config.conf["lists"].items()) {
-            if (!((bool)list["showOnWaterfall"])) { continue; }
-            WaterfallBookmark wbm;
-            wbm.listName = listName;
-            for (auto [bookmarkName, bm] : config.conf["lists"][listName]["bookmarks"].items()) {
-                wbm.bookmarkName = bookmarkName;
-                wbm.bookmark.frequency = config.conf["lists"][listName]["bookmarks"][bookmarkName]["frequency"];
-                wbm.bookmark.bandwidth = config.conf["lists"][listName]["bookmarks"][bookmarkName]["bandwidth"];
-                wbm.bookmark.mode = config.conf["lists"][listName]["bookmarks"][bookmarkName]["mode"];
-                wbm.bookmark.selected = false;
-                waterfallBookmarks.push_back(wbm);
+        bookmarkIndex.clear();
+        for (auto& [listName, list] : config.conf["lists"].items()) {
+            // Database lists are mapped from their file instead of being loaded
+            if (list.contains("database")) {
+                DatabaseList& dbList = databases[listName];
+                dbList.visible = list["showOnWaterfall"];
+                if (!dbList.db.isOpen()) { dbList.db.open((std::string)list["database"]); }
+                continue;
+            }
+            bookmarkIndex.setList(listName, {}, list["showOnWaterfall"]);
+            for (auto& [bookmarkName, bm] : list["bookmarks"].items()) {
+                FrequencyBookmark fbm;
+                fbm.frequency = bm["frequency"];
+                fbm.bandwidth = bm["bandwidth"];
+                fbm.mode = bm["mode"];
+                fbm.selected = false;
+                bookmarkIndex.add(listName, bookmarkName, fbm);
             }
         }
         if (lockConfig) { config.release(); }
     }
 
+    // Find the bookmarks whose label can be seen in the given span of the waterfall
+    void queryVisibleBookmarks(double lowFreq, double highFreq, double freqToPixelRatio) {
+        bookmarkIndex.query(lowFreq, highFreq, freqToPixelRatio, visibleBookmarks);
+
+        // Read the visible part of the database lists straight from their mapping
+        dbBookmarks.clear();
+        for (auto& [listName, dbList] : databases) {
+            if (!dbList.visible) { continue; }
+            int count = dbList.db.getEntryCount();
+
+            // Measure the widest label the first time the database is shown
+            if (dbList.maxLabelHalfWidth < 0.0f) {
+                dbList.maxLabelHalfWidth = 0.0f;
+                for (int i = 0; i < count; i++) {
+                    float halfWidth = BookmarkIndex::getLabelHalfWidth(dbList.db.getString(dbList.db.getEntry(i).name));
+                    dbList.maxLabelHalfWidth = std::max<float>(dbList.maxLabelHalfWidth, halfWidth);
+                }
+            }
+
+            double maxReach = dbList.maxLabelHalfWidth / freqToPixelRatio;
+            for (int i = dbList.db.findFirst(lowFreq - maxReach); i < count; i++) {
+                const freqdb::Entry& e = dbList.db.getEntry(i);
+                if (e.start - maxReach > highFreq) { break; }
+                std::string name = dbList.db.getString(e.name);
+                double reach = BookmarkIndex::getLabelHalfWidth(name) / freqToPixelRatio;
+                if (e.start + reach < lowFreq || e.start - reach > highFreq) { continue; }
+                WaterfallBookmark wbm;
+                wbm.listName = listName;
+                wbm.bookmarkName = name;
+                wbm.bookmark = toBookmark(e);
+                dbBookmarks.push_back(wbm);
+            }
+        }
+        for (auto& wbm : dbBookmarks) { visibleBookmarks.push_back(&wbm); }
+    }
+
+    static FrequencyBookmark toBookmark(const freqdb::Entry& e) {
+        FrequencyBookmark bm;
+        bm.frequency = e.start;
+        bm.bandwidth = e.bandwidth;
+        bm.mode = std::clamp<int>(e.mode, 0, demodModeCount - 1);
+        bm.selected = false;
+        return bm;
+    }
+
+    void importDatabase(std::string path) {
+        // Read the bookmarks from a CSV, a JSON export or an existing database
+        std::vector<freqdb::Record> records;
+        std::filesystem::path src(path);
+        std::string ext = src.extension().string();
+        if (ext == ".csv") {
+            std::vector<std::string> modeNames(demodModeList, demodModeList + demodModeCount);
+            if (!freqdb::readCSV(path, records, modeNames)) { return; }
+        }
+        else if (ext == ".fdb") {
+            freqdb::Database db;
+            if (!db.open(path)) { return; }
+            for (int i = 0; i < db.getEntryCount(); i++) {
+                const freqdb::Entry& e = db.getEntry(i);
+                freqdb::Record r;
+                r.start = e.start;
+                r.end = e.end;
+                r.bandwidth = e.bandwidth;
+                r.mode = e.mode;
+                r.name = db.getString(e.name);
+                records.push_back(r);
+            }
+        }
+        else {
+            try {
+                std::ifstream fs(path);
+                json data;
+                fs >> data;
+                for (auto& [bmName, bm] : data["bookmarks"].items()) {
+                    freqdb::Record r;
+                    r.start = bm["frequency"];
+                    r.end = r.start;
+                    r.bandwidth = bm["bandwidth"];
+                    r.mode = bm["mode"];
+                    r.name = bmName;
+                    records.push_back(r);
+                }
+            }
+            catch (const std::exception& e) {
+                flog::error("Could not import bookmark database {0}: {1}", path, e.what());
+                return;
+            }
+        }
+
+        // Keep a copy of the database in the root directory so the list doesn't depend on the imported file
+        std::string dir = (std::string)core::args["root"] + "/frequency_manager";
+        if (!std::filesystem::is_directory(dir) && !std::filesystem::create_directories(dir)) {
+            flog::error("Could not create directory {0}", dir);
+            return;
+        }
+
+        // Find a unique list name. The file name must be unique too since renamed lists keep their file.
+        std::string listName = src.stem().string();
+        for (int i = 1; std::find(listNames.begin(), listNames.end(), listName) != listNames.end() || std::filesystem::exists(dir + "/" + listName + ".fdb"); i++) {
+            listName = src.stem().string() + " (" + std::to_string(i) + ")";
+        }
+        std::string dbPath = dir + "/" + listName + ".fdb";
+        if (!freqdb::write(dbPath, records, {})) { return; }
+        DatabaseList& dbList = databases[listName];
+        dbList.visible = true;
+        if (!dbList.db.open(dbPath)) {
+            databases.erase(listName);
+            return;
+        }
+        flog::info("Imported {0} bookmarks into database list '{1}'", records.size(), listName);
+
+        config.acquire();
+        config.conf["lists"][listName]["showOnWaterfall"] = true;
+        config.conf["lists"][listName]["bookmarks"] = json::object();
+        config.conf["lists"][listName]["database"] = dbPath;
+        config.releaseKey("lists");
+        refreshLists();
+        loadByName(listName);
+    }
+
     void loadFirst() {
         if (listNames.size() > 0) {
             loadByName(listNames[0]);
@@ -322,6 +449,7 @@ private:
         }
         selectedListId = std::distance(listNames.begin(), std::find(listNames.begin(), listNames.end(), listName));
         selectedListName = listName;
+        if (databases.find(listName) != databases.end()) { return; }
         config.acquire();
         for (auto [bmName, bm] : config.conf["lists"][listName]["bookmarks"].items()) {
             FrequencyBookmark fbm;
@@ -337,13 +465,19 @@ private:
     void saveByName(std::string listName) {
         config.acquire();
         config.conf["lists"][listName]["bookmarks"] = json::object();
-        for (auto [bmName, bm] : bookmarks) {
-            config.conf["lists"][listName]["bookmarks"][bmName]["frequency"] = bm.frequency;
-            config.conf["lists"][listName]["bookmarks"][bmName]["bandwidth"] = bm.bandwidth;
-            config.conf["lists"][listName]["bookmarks"][bmName]["mode"] = bm.mode;
+        for (auto& [bmName, bm] : bookmarks) {
+            storeBookmark(listName, bmName, bm);
         }
-        refreshWaterfallBookmarks(false);
-        config.release(true);
+        bookmarkIndex.setList(listName, bookmarks, config.conf["lists"][listName]["showOnWaterfall"]);
+        config.releaseKey("lists");
+    }
+
+    // Config must be acquired
+    void storeBookmark(const std::string& listName, const std::string& bmName, const FrequencyBookmark& bm) {
+        json& jbm = config.conf["lists"][listName]["bookmarks"][bmName];
+        jbm["frequency"] = bm.frequency;
+        jbm["bandwidth"] = bm.bandwidth;
+        jbm["mode"] = bm.mode;
     }
 
     static void menuHandler(void* ctx) {
@@ -364,7 +498,7 @@ private:
             _this->loadByName(_this->listNames[_this->selectedListId]);
             config.acquire();
             config.conf["selectedList"] = _this->selectedListName;
-            config.release(true);
+            config.releaseKey("selectedList");
         }
         ImGui::SameLine();
         if (_this->listNames.size() == 0) { style::beginDisabled(); }
@@ -402,9 +536,16 @@ private:
                 ImGui::Text("Deleting list named \"%s\". Are you sure?", _this->selectedListName.c_str());
             }) == GENERIC_DIALOG_BUTTON_YES) {
             config.acquire();
+            std::string dbPath = config.conf["lists"][_this->selectedListName].contains("database") ? config.conf["lists"][_this->selectedListName]["database"] : "";
             config.conf["lists"].erase(_this->selectedListName);
-            _this->refreshWaterfallBookmarks(false);
-            config.release(true);
+            config.releaseKey("lists");
+            _this->bookmarkIndex.removeList(_this->selectedListName);
+            if (!dbPath.empty()) {
+                // The database file is the copy made at import time
+                _this->databases.erase(_this->selectedListName);
+                std::error_code ec;
+                std::filesystem::remove(dbPath, ec);
+            }
             _this->refreshLists();
             _this->selectedListId = std::clamp<int>(_this->selectedListId, 0, _this->listNames.size());
             if (_this->listNames.size() > 0) {
@@ -420,7 +561,11 @@ private:
         ImGui::BeginTable(("freq_manager_btn_table" + _this->name).c_str(), 3);
         ImGui::TableNextRow();
 
+        // Database lists are read-only
+        bool isDatabase = (_this->databases.find(_this->selectedListName) != _this->databases.end());
+
         ImGui::TableSetColumnIndex(0);
+        if (isDatabase) { style::beginDisabled(); }
         if (ImGui::Button(("Add##_freq_mgr_add_" + _this->name).c_str(), ImVec2(ImGui::GetContentRegionAvail().x, 0))) {
             // If there's no VFO selected, just save the center freq
             if (gui::waterfall.selectedVFO == "") {
@@ -456,6 +601,7 @@ private:
                 _this->editedBookmarkName = buf;
             }
         }
+        if (isDatabase) { style::endDisabled(); }
 
         ImGui::TableSetColumnIndex(1);
         if (selectedNames.size() == 0 && _this->selectedListName != "") { style::beginDisabled(); }
@@ -480,8 +626,13 @@ private:
         if (ImGui::GenericDialog(("freq_manager_del_list_confirm" + _this->name).c_str(), _this->deleteBookmarksOpen, GENERIC_DIALOG_BUTTONS_YES_NO, [_this]() {
                 ImGui::TextUnformatted("Deleting selected bookmaks. Are you sure?");
             }) == GENERIC_DIALOG_BUTTON_YES) {
-            for (auto& _name : selectedNames) { _this->bookmarks.erase(_name); }
-            _this->saveByName(_this->selectedListName);
+            config.acquire();
+            for (auto& _name : selectedNames) {
+                _this->bookmarks.erase(_name);
+                config.conf["lists"][_this->selectedListName]["bookmarks"].erase(_name);
+                _this->bookmarkIndex.remove(_this->selectedListName, _name);
+            }
+            config.releaseKey("lists");
         }
 
         // Bookmark list
@@ -490,27 +641,59 @@ private:
             ImGui::TableSetupColumn("Bookmark");
             ImGui::TableSetupScrollFreeze(2, 1);
             ImGui::TableHeadersRow();
-            for (auto& [name, bm] : _this->bookmarks) {
-                ImGui::TableNextRow();
-                ImGui::TableSetColumnIndex(0);
-                ImVec2 min = ImGui::GetCursorPos();
-
-                if (ImGui::Selectable((name + "##_freq_mgr_bkm_name_" + _this->name).c_str(), &bm.selected, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_SelectOnClick)) {
-                    // if shift or control isn't pressed, deselect all others
-                    if (!ImGui::GetIO().KeyShift && !ImGui::GetIO().KeyCtrl) {
-                        for (auto& [_name, _bm] : _this->bookmarks) {
-                            if (name == _name) { continue; }
-                            _bm.selected = false;
+
+            // Only submit the rows that are scrolled into view, lists can hold thousands of bookmarks
+            ImGuiListClipper clipper;
+            if (isDatabase) {
+                freqdb::Database& db = _this->databases[_this->selectedListName].db;
+                clipper.Begin(db.getEntryCount());
+                while (clipper.Step()) {
+                    for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                        const freqdb::Entry& e = db.getEntry(i);
+                        FrequencyBookmark bm = toBookmark(e);
+                        ImGui::PushID(i);
+                        ImGui::TableNextRow();
+                        ImGui::TableSetColumnIndex(0);
+                        ImGui::Selectable((std::string(db.getString(e.name)) + "##_freq_mgr_db_name_" + _this->name).c_str(), false, ImGuiSelectableFlags_SpanAllColumns);
+                        if (ImGui::TableGetHoveredColumn() >= 0 && ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) {
+                            applyBookmark(bm, gui::waterfall.selectedVFO);
                         }
+                        ImGui::TableSetColumnIndex(1);
+                        ImGui::Text("%s %s", utils::formatFreq(bm.frequency).c_str(), demodModeList[bm.mode]);
+                        ImGui::PopID();
                     }
                 }
-                if (ImGui::TableGetHoveredColumn() >= 0 && ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) {
-                    applyBookmark(bm, gui::waterfall.selectedVFO);
-                }
+                clipper.End();
+            }
+            clipper.Begin(_this->bookmarks.size());
+            auto bmIt = _this->bookmarks.begin();
+            int bmItId = 0;
+            while (clipper.Step()) {
+                std::advance(bmIt, clipper.DisplayStart - bmItId);
+                bmItId = clipper.DisplayStart;
+                for (; bmItId < clipper.DisplayEnd; bmItId++, bmIt++) {
+                    auto& [name, bm] = *bmIt;
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImVec2 min = ImGui::GetCursorPos();
+
+                    if (ImGui::Selectable((name + "##_freq_mgr_bkm_name_" + _this->name).c_str(), &bm.selected, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_SelectOnClick)) {
+                        // if shift or control isn't pressed, deselect all others
+                        if (!ImGui::GetIO().KeyShift && !ImGui::GetIO().KeyCtrl) {
+                            for (auto& [_name, _bm] : _this->bookmarks) {
+                                if (name == _name) { continue; }
+                                _bm.selected = false;
+                            }
+                        }
+                    }
+                    if (ImGui::TableGetHoveredColumn() >= 0 && ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) {
+                        applyBookmark(bm, gui::waterfall.selectedVFO);
+                    }
 
-                ImGui::TableSetColumnIndex(1);
-                ImGui::Text("%s %s", utils::formatFreq(bm.frequency).c_str(), demodModeList[bm.mode]);
-                ImVec2 max = ImGui::GetCursorPos();
+                    ImGui::TableSetColumnIndex(1);
+                    ImGui::Text("%s %s", utils::formatFreq(bm.frequency).c_str(), demodModeList[bm.mode]);
+                    ImVec2 max = ImGui::GetCursorPos();
+                }
             }
             ImGui::EndTable();
         }
@@ -529,10 +712,12 @@ private:
         ImGui::TableNextRow();
 
         ImGui::TableSetColumnIndex(0);
+        if (isDatabase) { style::beginDisabled(); }
         if (ImGui::Button(("Import##_freq_mgr_imp_" + _this->name).c_str(), ImVec2(ImGui::GetContentRegionAvail().x, 0)) && !_this->importOpen) {
             _this->importOpen = true;
             _this->importDialog = new pfd::open_file("Import bookmarks", "", { "JSON Files (*.json)", "*.json", "All Files", "*" }, pfd::opt::multiselect);
         }
+        if (isDatabase) { style::endDisabled(); }
 
         ImGui::TableSetColumnIndex(1);
         if (selectedNames.size() == 0 && _this->selectedListName != "") { style::beginDisabled(); }
@@ -553,12 +738,19 @@ private:
             _this->selectListsOpen = true;
         }
 
+        if (_this->selectedListName == "") { style::endDisabled(); }
+        if (ImGui::Button(("Import database##_freq_mgr_imp_db_" + _this->name).c_str(), ImVec2(menuWidth, 0)) && !_this->importDbOpen) {
+            _this->importDbOpen = true;
+            _this->importDbDialog = new pfd::open_file("Import bookmark database", "", { "Bookmark Databases (*.csv *.json *.fdb)", "*.csv *.json *.fdb", "All Files", "*" });
+        }
+        if (_this->selectedListName == "") { style::beginDisabled(); }
+
         ImGui::LeftLabel("Bookmark display mode");
         ImGui::SetNextItemWidth(menuWidth - ImGui::GetCursorPosX());
         if (ImGui::Combo(("##_freq_mgr_dms_" + _this->name).c_str(), &_this->bookmarkDisplayMode, bookmarkDisplayModesTxt)) {
             config.acquire();
             config.conf["bookmarkDisplayMode"] = _this->bookmarkDisplayMode;
-            config.release(true);
+            config.releaseKey("bookmarkDisplayMode");
         }
 
         if (_this->selectedListName == "") { style::endDisabled(); }
@@ -592,6 +784,14 @@ private:
             }
             delete _this->importDialog;
         }
+        if (_this->importDbOpen && _this->importDbDialog->ready()) {
+            _this->importDbOpen = false;
+            std::vector<std::string> paths = _this->importDbDialog->result();
+            if (paths.size() > 0) {
+                _this->importDatabase(paths[0]);
+            }
+            delete _this->importDbDialog;
+        }
         if (_this->exportOpen && _this->exportDialog->ready()) {
             _this->exportOpen = false;
             std::string path = _this->exportDialog->result();
@@ -605,9 +805,11 @@ private:
     static void fftRedraw(ImGui::WaterFall::FFTRedrawArgs args, void* ctx) {
         FrequencyManagerModule* _this = (FrequencyManagerModule*)ctx;
         if (_this->bookmarkDisplayMode == BOOKMARK_DISP_MODE_OFF) { return; }
+        _this->queryVisibleBookmarks(args.lowFreq, args.highFreq, args.freqToPixelRatio);
 
         if (_this->bookmarkDisplayMode == BOOKMARK_DISP_MODE_TOP) {
-            for (auto const bm : _this->waterfallBookmarks) {
+            for (auto const* _bm : _this->visibleBookmarks) {
+                const WaterfallBookmark& bm = *_bm;
                 double centerXpos = args.min.x + std::round((bm.bookmark.frequency - args.lowFreq) * args.freqToPixelRatio);
 
                 if (bm.bookmark.frequency >= args.lowFreq && bm.bookmark.frequency <= args.highFreq) {
@@ -629,7 +831,8 @@ private:
             }
         }
         else if (_this->bookmarkDisplayMode == BOOKMARK_DISP_MODE_BOTTOM) {
-            for (auto const bm : _this->waterfallBookmarks) {
+            for (auto const* _bm : _this->visibleBookmarks) {
+                const WaterfallBookmark& bm = *_bm;
                 double centerXpos = args.min.x + std::round((bm.bookmark.frequency - args.lowFreq) * args.freqToPixelRatio);
 
                 if (bm.bookmark.frequency >= args.lowFreq && bm.bookmark.frequency <= args.highFreq) {
@@ -667,14 +870,15 @@ private:
         }
 
         // First check that the mouse clicked outside of any label. Also get the bookmark that's hovered
+        _this->queryVisibleBookmarks(args.lowFreq, args.highFreq, args.freqToPixelRatio);
         bool inALabel = false;
         WaterfallBookmark hoveredBookmark;
         std::string hoveredBookmarkName;
 
         if (_this->bookmarkDisplayMode == BOOKMARK_DISP_MODE_TOP) {
-            int count = _this->waterfallBookmarks.size();
+            int count = _this->visibleBookmarks.size();
             for (int i = count - 1; i >= 0; i--) {
-                auto& bm = _this->waterfallBookmarks[i];
+                auto& bm = *_this->visibleBookmarks[i];
                 double centerXpos = args.fftRectMin.x + std::round((bm.bookmark.frequency - args.lowFreq) * args.freqToPixelRatio);
                 ImVec2 nameSize = ImGui::CalcTextSize(bm.bookmarkName.c_str());
                 ImVec2 rectMin = ImVec2(centerXpos - (nameSize.x / 2) - 5, args.fftRectMin.y);
@@ -691,9 +895,9 @@ private:
             }
         }
         else if (_this->bookmarkDisplayMode == BOOKMARK_DISP_MODE_BOTTOM) {
-            int count = _this->waterfallBookmarks.size();
+            int count = _this->visibleBookmarks.size();
             for (int i = count - 1; i >= 0; i--) {
-                auto& bm = _this->waterfallBookmarks[i];
+                auto& bm = *_this->visibleBookmarks[i];
                 double centerXpos = args.fftRectMin.x + std::round((bm.bookmark.frequency - args.lowFreq) * args.freqToPixelRatio);
                 ImVec2 nameSize = ImGui::CalcTextSize(bm.bookmarkName.c_str());
                 ImVec2 rectMin = ImVec2(centerXpos - (nameSize.x / 2) - 5, args.fftRectMax.y - nameSize.y);
@@ -751,6 +955,8 @@ private:
     bool exportOpen = false;
     pfd::open_file* importDialog;
     pfd::save_file* exportDialog;
+    bool importDbOpen = false;
+    pfd::open_file* importDbDialog;
 
     void importBookmarks(std::string path) {
         std::ifstream fs(path);
@@ -819,7 +1025,16 @@ private:
     std::string editedListName;
     std::string firstEditedListName;
 
-    std::vector<WaterfallBookmark> waterfallBookmarks;
+    struct DatabaseList {
+        freqdb::Database db;
+        bool visible = true;
+        float maxLabelHalfWidth = -1.0f;    // Negative until measured
+    };
+
+    BookmarkIndex bookmarkIndex;
+    std::map<std::string, DatabaseList> databases;
+    std::vector<const WaterfallBookmark*> visibleBookmarks;
+    std::vector<WaterfallBookmark> dbBookmarks;
 
     int bookmarkDisplayMode = 0;
 };
@@ -1,10 +1,12 @@
 #include <utils/net.h>
+#include <utils/iq_packet.h>
 #include <imgui.h>
 #include <module.h>
 #include <gui/gui.h>
 #include <gui/style.h>
 #include <utils/optionlist.h>
 #include <algorithm>
+#include <atomic>
 #include <dsp/sink/handler_sink.h>
 #include <volk/volk.h>
 #include <signal_path/signal_path.h>
@@ -31,7 +33,8 @@ enum Mode {
 enum Protocol {
     PROTOCOL_TCP_SERVER,
     PROTOCOL_TCP_CLIENT,
-    PROTOCOL_UDP
+    PROTOCOL_UDP,
+    PROTOCOL_UDP_SEQ
 };
 
 enum SampleType {
@@ -68,6 +71,7 @@ public:
         protocols.define("TCP (Server)", PROTOCOL_TCP_SERVER);
         protocols.define("TCP (Client)", PROTOCOL_TCP_CLIENT);
         protocols.define("UDP", PROTOCOL_UDP);
+        protocols.define("UDP (Sequenced)", PROTOCOL_UDP_SEQ);
 
         // Define sample types
         sampleTypes.define("Int8", SAMPLE_TYPE_INT8);
@@ -126,8 +130,8 @@ public:
         sampTypeId = sampleTypes.valueId(sampType);
         packetSizeId = packetSizes.valueId(packetSize);
 
-        // Allocate buffer
-        buffer = dsp::buffer::alloc<uint8_t>(STREAM_BUFFER_SIZE * sizeof(dsp::complex_t));
+        // Allocate buffer, with room for a packet header
+        buffer = dsp::buffer::alloc<uint8_t>(sizeof(IQPacketHeader) + STREAM_BUFFER_SIZE * sizeof(dsp::complex_t));
 
         // Init DSP
         reshape.init(&iqStream, packetSize/sampleSize(), 0);
@@ -210,6 +214,10 @@ public:
             else {
                 // Open UDP socket
                 sock = net::openudp(hostname, port, "0.0.0.0", 0, true);
+
+                // Restart the packet sequence
+                seqNum = 0;
+                seqTimestamp = 0;
             }
         }
         catch (const std::exception& e) {
@@ -293,7 +301,7 @@ private:
             _this->setMode(_this->modes.value(_this->modeId));
             config.acquire();
             config.conf[_this->name]["mode"] = _this->modes.key(_this->modeId);
-            config.release(true);
+            config.releaseKey(_this->name);
         }
 
         // In VFO mode, show samplerate selector
@@ -308,7 +316,7 @@ private:
                 }
                 config.acquire();
                 config.conf[_this->name]["samplerate"] = _this->samplerates.key(_this->srId);
-                config.release(true);
+                config.releaseKey(_this->name);
             }
         }
 
@@ -319,7 +327,7 @@ private:
             _this->proto = _this->protocols.value(_this->protoId);
             config.acquire();
             config.conf[_this->name]["protocol"] = _this->protocols.key(_this->protoId);
-            config.release(true);
+            config.releaseKey(_this->name);
         }
 
         // Sample type selector
@@ -330,7 +338,7 @@ private:
             _this->reshape.setKeep(_this->packetSize/_this->sampleSize());
             config.acquire();
             config.conf[_this->name]["sampleType"] = _this->sampleTypes.key(_this->sampTypeId);
-            config.release(true);
+            config.releaseKey(_this->name);
         }
 
         // Packet size selector
@@ -341,14 +349,14 @@ private:
             _this->reshape.setKeep(_this->packetSize/_this->sampleSize());
             config.acquire();
             config.conf[_this->name]["packetSize"] = _this->packetSizes.key(_this->packetSizeId);
-            config.release(true);
+            config.releaseKey(_this->name);
         }
 
         // Hostname and port field
         if (ImGui::InputText(("##iq_exporter_host_" + _this->name).c_str(), _this->hostname, sizeof(_this->hostname))) {
             config.acquire();
             config.conf[_this->name]["host"] = _this->hostname;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
         ImGui::SameLine();
         ImGui::FillWidth();
@@ -356,7 +364,7 @@ private:
             _this->port = std::clamp<int>(_this->port, 1, 65535);
             config.acquire();
             config.conf[_this->name]["port"] = _this->port;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
 
         if (_this->running) { ImGui::EndDisabled(); }
@@ -367,7 +375,7 @@ private:
                 _this->stop();
                 config.acquire();
                 config.conf[_this->name]["running"] = false;
-                config.release(true);
+                config.releaseKey(_this->name);
             }
         }
         else {
@@ -375,7 +383,7 @@ private:
                 _this->start();
                 config.acquire();
                 config.conf[_this->name]["running"] = true;
-                config.release(true);
+                config.releaseKey(_this->name);
             }
         }
 
@@ -383,7 +391,7 @@ private:
         bool sockOpen;
         {
             uint8_t dummy;
-            sockOpen = !(!_this->sock || !_this->sock->isOpen() || (_this->proto != PROTOCOL_UDP && _this->sock->recv(&dummy, 1, false, net::NONBLOCKING) == 0));
+            sockOpen = !(!_this->sock || !_this->sock->isOpen() || (_this->proto != PROTOCOL_UDP && _this->proto != PROTOCOL_UDP_SEQ && _this->sock->recv(&dummy, 1, false, net::NONBLOCKING) == 0));
         }
 
         // Status text
@@ -487,6 +495,10 @@ private:
     static void dataHandler(dsp::complex_t* data, int count, void* ctx) {
         IQExporterModule* _this = (IQExporterModule*)ctx;
 
+        // Take the sequence number and timestamp first so that a block dropped below shows up as a gap at the receiver
+        uint32_t seq = _this->seqNum++;
+        uint64_t timestamp = _this->seqTimestamp.fetch_add(count);
+
         // Try to cquire lock on socket
         if (!_this->sockMtx.try_lock()) { return; }
 
@@ -497,22 +509,32 @@ private:
             return;
         }
         
+        // In sequenced mode, the samples follow a packet header
+        bool sequenced = (_this->proto == PROTOCOL_UDP_SEQ);
+        int hdrSize = sequenced ? sizeof(IQPacketHeader) : 0;
+        uint8_t* samples = &_this->buffer[hdrSize];
+
         // Convert the samples or send directory for float32
         int size;
         switch (_this->sampType) {
         case SAMPLE_TYPE_INT8:
-            volk_32f_s32f_convert_8i((int8_t*)_this->buffer, (float*)data, 128.0f, count*2);
+            volk_32f_s32f_convert_8i((int8_t*)samples, (float*)data, 128.0f, count*2);
             size = sizeof(int8_t)*2;
             break;
         case SAMPLE_TYPE_INT16:
-            volk_32f_s32f_convert_16i((int16_t*)_this->buffer, (float*)data, 32768.0f, count*2);
+            volk_32f_s32f_convert_16i((int16_t*)samples, (float*)data, 32768.0f, count*2);
             size = sizeof(int16_t)*2;
             break;
         case SAMPLE_TYPE_INT32:
-            volk_32f_s32f_convert_32i((int32_t*)_this->buffer, (float*)data, 2147483647.0f, count*2);
+            volk_32f_s32f_convert_32i((int32_t*)samples, (float*)data, 2147483647.0f, count*2);
             size = sizeof(int32_t)*2;
             break;
         case SAMPLE_TYPE_FLOAT32:
+            if (sequenced) {
+                memcpy(samples, data, count*sizeof(dsp::complex_t));
+                size = sizeof(dsp::complex_t);
+                break;
+            }
             _this->sock->send((uint8_t*)data, count*sizeof(dsp::complex_t));
         default:
             // Unlock socket mutex
@@ -520,8 +542,21 @@ private:
             return;
         }
 
+        // Fill in the packet header, the sample types are numbered the same way
+        if (sequenced) {
+            IQPacketHeader hdr;
+            hdr.magic = IQ_PACKET_MAGIC;
+            hdr.version = IQ_PACKET_VERSION;
+            hdr.sampleType = _this->sampType;
+            hdr.headerSize = sizeof(IQPacketHeader);
+            hdr.sequence = seq;
+            hdr.sampleCount = count;
+            hdr.timestamp = timestamp;
+            memcpy(_this->buffer, &hdr, sizeof(IQPacketHeader));
+        }
+
         // Send converted samples
-        _this->sock->send(_this->buffer, count*size);
+        _this->sock->send(_this->buffer, hdrSize + count*size);
 
         // Unlock socket mutex
         _this->sockMtx.unlock();
@@ -560,6 +595,8 @@ private:
     dsp::buffer::Reshaper<dsp::complex_t> reshape;
     dsp::sink::Handler<dsp::complex_t> handler;
     uint8_t* buffer = NULL;
+    std::atomic<uint32_t> seqNum = 0;
+    std::atomic<uint64_t> seqTimestamp = 0;
 
     std::thread listenWorkerThread;
 
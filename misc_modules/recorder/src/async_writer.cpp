@@ -0,0 +1,211 @@
+#include "async_writer.h"
+#include <dsp/buffer/buffer.h>
+#include <utils/flog.h>
+#include <algorithm>
+#include <filesystem>
+
+AsyncWriter::AsyncWriter(SampleWriter* writer) {
+    this->writer = writer;
+}
+
+AsyncWriter::~AsyncWriter() {
+    stop();
+}
+
+void AsyncWriter::setWriter(SampleWriter* writer) {
+    if (running) { return; }
+    this->writer = writer;
+}
+
+void AsyncWriter::setSegmentLimits(uint64_t maxBytes, uint64_t maxSamples) {
+    maxSegBytes = maxBytes;
+    maxSegSamples = maxSamples;
+}
+
+bool AsyncWriter::start(const std::string& basePath, const std::string& extension, int channels, uint64_t samplerate, size_t bufferSize) {
+    if (running) { return true; }
+    this->basePath = basePath;
+    this->extension = extension;
+    this->channels = channels;
+    this->samplerate = samplerate;
+
+    // Open the first file and work out the segment length now that the sample size is known
+    segment = 0;
+    startTime = std::chrono::system_clock::now();
+    if (!openSegment(0)) { return false; }
+    segSamples = maxSegSamples;
+    if (maxSegBytes) {
+        uint64_t byteLimit = std::max<uint64_t>(maxSegBytes / writer->getBytesPerSample(), 1);
+        segSamples = segSamples ? std::min<uint64_t>(segSamples, byteLimit) : byteLimit;
+    }
+
+    // Size the blocks to around 50ms of samples so that the disk sees large writes
+    blockFrames = ASYNC_WRITER_MIN_BLOCK_FRAMES;
+    while (blockFrames < samplerate / 20 && blockFrames < ASYNC_WRITER_MAX_BLOCK_FRAMES) { blockFrames <<= 1; }
+
+    // Allocate as many blocks as fit in the buffer, but no more than needed to hold a few seconds of samples
+    size_t blockBytes = blockFrames * channels * sizeof(float);
+    size_t maxBlocks = ((samplerate * ASYNC_WRITER_MAX_QUEUE_SECONDS) / blockFrames) + 1;
+    int blockCount = std::max<int>(std::min<size_t>(bufferSize / blockBytes, maxBlocks), ASYNC_WRITER_MIN_BLOCKS);
+    blocks.resize(blockCount);
+    for (auto& blk : blocks) {
+        blk.data = dsp::buffer::alloc<float>(blockFrames * channels);
+        blk.frames = 0;
+        blk.streamPos = 0;
+    }
+
+    // Reset the state
+    writeIdx = 0;
+    readIdx = 0;
+    streamPos = 0;
+    droppedSamples = 0;
+    overruns = 0;
+    samplesWritten = 0;
+    overflowing = false;
+    stopWorker = false;
+    failed = false;
+
+    workerThread = std::thread(&AsyncWriter::worker, this);
+    running = true;
+    return true;
+}
+
+void AsyncWriter::stop() {
+    if (!running) { return; }
+
+    // Hand over the partially filled block if the producer still owns it
+    uint64_t wr = writeIdx;
+    if (wr - readIdx < blocks.size() && blocks[wr % blocks.size()].frames) {
+        writeIdx = wr + 1;
+    }
+
+    // Let the worker drain the queue and exit
+    stopWorker = true;
+    workerCnd.notify_all();
+    if (workerThread.joinable()) { workerThread.join(); }
+
+    closeSegment();
+    if (index.is_open()) { index.close(); }
+    freeBlocks();
+    running = false;
+}
+
+void AsyncWriter::write(const float* samples, int count) {
+    if (!running || failed) { return; }
+    while (count > 0) {
+        // If the writer isn't keeping up, drop the samples instead of stalling the DSP
+        uint64_t wr = writeIdx.load(std::memory_order_relaxed);
+        if (wr - readIdx.load(std::memory_order_acquire) >= blocks.size()) {
+            if (!overflowing) { overruns++; }
+            overflowing = true;
+            droppedSamples += count;
+            streamPos += count;
+            return;
+        }
+        overflowing = false;
+
+        // Copy as much as fits in the current block, keeping track of where it sits in the stream
+        Block& blk = blocks[wr % blocks.size()];
+        if (!blk.frames) { blk.streamPos = streamPos; }
+        int toCopy = std::min<int>(count, blockFrames - blk.frames);
+        memcpy(&blk.data[blk.frames * channels], samples, toCopy * channels * sizeof(float));
+        blk.frames += toCopy;
+        samples += toCopy * channels;
+        count -= toCopy;
+        streamPos += toCopy;
+
+        // Hand the block over to the writer thread once full
+        if (blk.frames >= blockFrames) {
+            writeIdx.store(wr + 1, std::memory_order_release);
+            workerCnd.notify_one();
+        }
+    }
+}
+
+float AsyncWriter::getQueueUsage() {
+    if (!running) { return 0.0f; }
+    return (float)(writeIdx - readIdx) / (float)blocks.size();
+}
+
+void AsyncWriter::worker() {
+    while (true) {
+        // Wait for a block to be ready, exit only once the queue is empty
+        uint64_t rd = readIdx.load(std::memory_order_relaxed);
+        if (rd == writeIdx.load(std::memory_order_acquire)) {
+            if (stopWorker) { break; }
+            std::unique_lock<std::mutex> lck(workerMtx);
+            workerCnd.wait_for(lck, std::chrono::milliseconds(50));
+            continue;
+        }
+
+        // Write the block, rolling over to a new file exactly at the segment boundary
+        Block& blk = blocks[rd % blocks.size()];
+        int offset = 0;
+        while (offset < blk.frames) {
+            int count = blk.frames - offset;
+            if (segSamples) {
+                if (writer->getSamplesWritten() >= segSamples) {
+                    // The index sidecar is only created once the recording actually gets split
+                    if (!index.is_open()) {
+                        index = std::ofstream(basePath + "_index.csv", std::ios::out);
+                        index << "segment,file,first_sample,sample_count,start_time_us" << std::endl;
+                    }
+                    closeSegment();
+                    segment++;
+
+                    // Give up instead of silently discarding the rest of the recording
+                    if (!openSegment(blk.streamPos + offset)) {
+                        failed = true;
+                        return;
+                    }
+                }
+                count = std::min<uint64_t>(count, segSamples - writer->getSamplesWritten());
+            }
+            writer->write(&blk.data[offset * channels], count);
+            offset += count;
+        }
+        samplesWritten += blk.frames;
+
+        // Give the block back to the producer
+        blk.frames = 0;
+        readIdx.store(rd + 1, std::memory_order_release);
+    }
+}
+
+void AsyncWriter::freeBlocks() {
+    for (auto& blk : blocks) {
+        dsp::buffer::free(blk.data);
+    }
+    blocks.clear();
+}
+
+std::string AsyncWriter::segmentPath(int id) {
+    // The first segment keeps the plain name so that short recordings are unaffected
+    if (!id) { return basePath + extension; }
+    char buf[16];
+    sprintf(buf, "_%04d", id);
+    return basePath + buf + extension;
+}
+
+bool AsyncWriter::openSegment(uint64_t streamPos) {
+    segStart = streamPos;
+    std::string path = segmentPath(segment);
+    if (!writer->open(path)) {
+        flog::error("Failed to open file for recording: {0}", path);
+        return false;
+    }
+    return true;
+}
+
+void AsyncWriter::closeSegment() {
+    if (!writer->isOpen()) { return; }
+    uint64_t count = writer->getSamplesWritten();
+    writer->close();
+
+    // Record where the segment sits in time, derived from its position in the sample stream
+    if (!index.is_open()) { return; }
+    uint64_t startUs = std::chrono::duration_cast<std::chrono::microseconds>(startTime.time_since_epoch()).count();
+    startUs += (segStart / samplerate) * 1000000 + ((segStart % samplerate) * 1000000) / samplerate;
+    std::string filename = std::filesystem::path(segmentPath(segment)).filename().string();
+    index << segment << ',' << filename << ',' << segStart << ',' << count << ',' << startUs << std::endl;
+}
@@ -0,0 +1,144 @@
+#pragma once
+#include <utils/sample_writer.h>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <stdint.h>
+
+#define ASYNC_WRITER_MIN_BLOCK_FRAMES   4096
+#define ASYNC_WRITER_MAX_BLOCK_FRAMES   (1 << 19)
+#define ASYNC_WRITER_MIN_BLOCKS         4
+#define ASYNC_WRITER_MAX_QUEUE_SECONDS  10
+
+class AsyncWriter {
+public:
+    /**
+     * Create an asynchronous writer feeding a sample writer from a dedicated thread.
+     * @param writer Writer that the samples will be handed to. Must be configured before calling start().
+    */
+    AsyncWriter(SampleWriter* writer);
+
+    // Destructor
+    ~AsyncWriter();
+
+    /**
+     * Change the writer that the samples are handed to. Must be called before start().
+     * @param writer Writer that the samples will be handed to.
+    */
+    void setWriter(SampleWriter* writer);
+
+    /**
+     * Split the recording into segments of a maximum size. Must be called before start().
+     * @param maxBytes Maximum number of sample bytes per file, 0 for no limit.
+     * @param maxSamples Maximum number of frames per file, 0 for no limit.
+    */
+    void setSegmentLimits(uint64_t maxBytes, uint64_t maxSamples);
+
+    /**
+     * Open the first file, allocate the queue and start the writer thread.
+     * @param basePath Path of the recording without extension.
+     * @param extension Extension of the recording files.
+     * @param channels Number of interleaved channels per frame.
+     * @param samplerate Samplerate of the recording, used to size the write batches.
+     * @param bufferSize Maximum size of the queue in bytes. The queue never holds more than
+     *                   ASYNC_WRITER_MAX_QUEUE_SECONDS of samples, so low rate streams use much less.
+     * @return True on success, false if the file could not be opened.
+    */
+    bool start(const std::string& basePath, const std::string& extension, int channels, uint64_t samplerate, size_t bufferSize);
+
+    /**
+     * Flush all queued samples to the writer, stop the writer thread and close the file.
+     * The producer must not call write() anymore once this is called.
+    */
+    void stop();
+
+    /**
+     * Queue samples for writing. Never blocks, samples are dropped if the queue is full.
+     * @param samples Interleaved samples.
+     * @param count Number of frames.
+    */
+    void write(const float* samples, int count);
+
+    /**
+     * Get the number of frames dropped because the queue was full.
+    */
+    uint64_t getDroppedSamples() { return droppedSamples; }
+
+    /**
+     * Get the number of times the queue filled up.
+    */
+    uint64_t getOverruns() { return overruns; }
+
+    /**
+     * Get the fraction of the queue currently waiting to be written.
+    */
+    float getQueueUsage();
+
+    /**
+     * Get the total number of frames written across all segments.
+    */
+    uint64_t getSamplesWritten() { return samplesWritten; }
+
+    /**
+     * Get the index of the segment currently being written.
+    */
+    int getSegment() { return segment; }
+
+    /**
+     * Check if the recording had to be aborted because the next segment could not be opened.
+     * Samples passed to write() are discarded from then on, the recording should be stopped.
+    */
+    bool hasFailed() { return failed; }
+
+private:
+    struct Block {
+        float* data;
+        int frames;
+        uint64_t streamPos;
+    };
+
+    void worker();
+    void freeBlocks();
+    std::string segmentPath(int id);
+    bool openSegment(uint64_t streamPos);
+    void closeSegment();
+
+    SampleWriter* writer;
+    std::vector<Block> blocks;
+    int channels = 2;
+    int blockFrames = 0;
+    std::atomic<bool> running = false;
+    bool overflowing = false;
+    uint64_t streamPos = 0;
+
+    // Segmentation
+    uint64_t maxSegBytes = 0;
+    uint64_t maxSegSamples = 0;
+    uint64_t segSamples = 0;
+    uint64_t segStart = 0;
+    std::atomic<int> segment = 0;
+    std::string basePath;
+    std::string extension;
+    uint64_t samplerate;
+    std::chrono::system_clock::time_point startTime;
+    std::ofstream index;
+
+    // Single producer (DSP thread), single consumer (writer thread)
+    std::atomic<uint64_t> writeIdx = 0;
+    std::atomic<uint64_t> readIdx = 0;
+
+    std::atomic<uint64_t> droppedSamples = 0;
+    std::atomic<uint64_t> overruns = 0;
+    std::atomic<uint64_t> samplesWritten = 0;
+
+    std::mutex workerMtx;
+    std::condition_variable workerCnd;
+    std::atomic<bool> stopWorker = false;
+    std::atomic<bool> failed = false;
+    std::thread workerThread;
+};
@@ -21,12 +21,20 @@
 #include <core.h>
 #include <utils/optionlist.h>
 #include <utils/wav.h>
+#include <utils/iqz.h>
 #include <radio_interface.h>
+#include <inttypes.h>
+#include "async_writer.h"
 
 #define CONCAT(a, b) ((std::string(a) + b).c_str())
 
 #define SILENCE_LVL 10e-6
 
+#define PREALLOC_STEP (256ull * 1024ull * 1024ull)
+
+// Largest data chunk that still fits a plain WAV file, leaving room for the headers
+#define WAV_MAX_DATA_SIZE (0xFFFFFFFFull - 1024ull)
+
 SDRPP_MOD_INFO{
     /* Name:            */ "recorder",
     /* Description:     */ "Recorder module for SDR++",
@@ -42,9 +50,15 @@ enum TimeZone {
     TIME_ZONE_UTC
 };
 
+enum Container {
+    CONTAINER_WAV,
+    CONTAINER_RF64,
+    CONTAINER_IQZ
+};
+
 class RecorderModule : public ModuleManager::Instance {
 public:
-    RecorderModule(std::string name) : folderSelect("%ROOT%/recordings") {
+    RecorderModule(std::string name) : folderSelect("%ROOT%/recordings"), asyncWriter(&writer) {
         this->name = name;
         root = (std::string)core::args["root"];
         strcpy(nameTemplate, "$t_$f_$h-$m-$s_$d-$M-$y");
@@ -54,8 +68,9 @@ public:
         timezones.define("utc", "UTC", TIME_ZONE_UTC);
 
         // Define option lists
-        containers.define("WAV", wav::FORMAT_WAV);
-        // containers.define("RF64", wav::FORMAT_RF64); // Disabled for now
+        containers.define("WAV", CONTAINER_WAV);
+        containers.define("RF64", CONTAINER_RF64);
+        containers.define("IQZ", "IQZ (Compressed)", CONTAINER_IQZ);
         sampleTypes.define(wav::SAMP_TYPE_UINT8, "Uint8", wav::SAMP_TYPE_UINT8);
         sampleTypes.define(wav::SAMP_TYPE_INT16, "Int16", wav::SAMP_TYPE_INT16);
         sampleTypes.define(wav::SAMP_TYPE_INT32, "Int32", wav::SAMP_TYPE_INT32);
@@ -63,7 +78,7 @@ public:
 
         // Load default config for option lists
         timezoneId = timezones.valueId(TIME_ZONE_LOCAL);
-        containerId = containers.valueId(wav::FORMAT_WAV);
+        containerId = containers.valueId(CONTAINER_WAV);
         sampleTypeId = sampleTypes.valueId(wav::SAMP_TYPE_INT16);
 
         // Load config
@@ -95,6 +110,15 @@ public:
         if (config.conf[name].contains("ignoreSilence")) {
             ignoreSilence = config.conf[name]["ignoreSilence"];
         }
+        if (config.conf[name].contains("bufferSize")) {
+            bufferSize = std::clamp<int>(config.conf[name]["bufferSize"], 16, 4096);
+        }
+        if (config.conf[name].contains("splitSize")) {
+            splitSize = config.conf[name]["splitSize"];
+        }
+        if (config.conf[name].contains("splitTime")) {
+            splitTime = config.conf[name]["splitTime"];
+        }
         if (config.conf[name].contains("nameTemplate")) {
             std::string _nameTemplate = config.conf[name]["nameTemplate"];
             if (_nameTemplate.length() > sizeof(nameTemplate)-1) {
@@ -167,7 +191,7 @@ public:
         std::lock_guard<std::recursive_mutex> lck(recMtx);
         if (recording) { return; }
 
-        // Configure the wav writer
+        // Configure the writer for the selected container
         if (recMode == RECORDER_MODE_AUDIO) {
             if (selectedStreamName.empty()) { return; }
             samplerate = sigpath::sinkManager.getStreamSampleRate(selectedStreamName);
@@ -175,17 +199,36 @@ public:
         else {
             samplerate = sigpath::iqFrontEnd.getSampleRate();
         }
-        writer.setFormat(containers[containerId]);
-        writer.setChannels((recMode == RECORDER_MODE_AUDIO && !stereo) ? 1 : 2);
-        writer.setSampleType(sampleTypes[sampleTypeId]);
-        writer.setSamplerate(samplerate);
+        int channels = (recMode == RECORDER_MODE_AUDIO && !stereo) ? 1 : 2;
+        Container container = containers[containerId];
+        if (container == CONTAINER_IQZ) {
+            iqzWriter.setChannels(channels);
+            iqzWriter.setSamplerate(samplerate);
+            asyncWriter.setWriter(&iqzWriter);
+        }
+        else {
+            writer.setFormat((container == CONTAINER_RF64) ? wav::FORMAT_RF64 : wav::FORMAT_WAV);
+            writer.setChannels(channels);
+            writer.setSampleType(sampleTypes[sampleTypeId]);
+            writer.setSamplerate(samplerate);
+            writer.setPreallocation(PREALLOC_STEP);
+            asyncWriter.setWriter(&writer);
+        }
+
+        // Plain WAV files can't grow past 4GB, so always split them before that
+        uint64_t maxBytes = (uint64_t)splitSize * 1024 * 1024;
+        if (container == CONTAINER_WAV && (!maxBytes || maxBytes > WAV_MAX_DATA_SIZE)) {
+            maxBytes = WAV_MAX_DATA_SIZE;
+        }
+        asyncWriter.setSegmentLimits(maxBytes, (uint64_t)splitTime * 60 * samplerate);
 
-        // Open file
+        // Open file and start the writer thread
         std::string vfoName = (recMode == RECORDER_MODE_AUDIO) ? selectedStreamName : "";
-        std::string extension = ".wav";
-        std::string expandedPath = expandString(folderSelect.path + "/" + genFileName(nameTemplate, recMode, vfoName) + extension);
-        if (!writer.open(expandedPath)) {
-            flog::error("Failed to open file for recording: {0}", expandedPath);
+        std::string extension = (container == CONTAINER_IQZ) ? ".iqz" : ".wav";
+        std::string expandedPath = expandString(folderSelect.path + "/" + genFileName(nameTemplate, recMode, vfoName));
+        errorMsg.clear();
+        if (!asyncWriter.start(expandedPath, extension, channels, samplerate, (size_t)bufferSize * 1024 * 1024)) {
+            errorMsg = "Could not open the recording file";
             return;
         }
 
@@ -231,8 +274,8 @@ public:
             delete basebandStream;
         }
 
-        // Close file
-        writer.close();
+        // Flush the queued samples and close file
+        asyncWriter.stop();
         
         recording = false;
     }
@@ -242,6 +285,12 @@ private:
         RecorderModule* _this = (RecorderModule*)ctx;
         float menuWidth = ImGui::GetContentRegionAvail().x;
 
+        // Stop the recording if the writer gave up on it
+        if (_this->recording && _this->asyncWriter.hasFailed()) {
+            _this->stop();
+            _this->errorMsg = "Recording stopped, could not open the next file";
+        }
+
         // Recording mode
         if (_this->recording) { style::beginDisabled(); }
         ImGui::BeginGroup();
@@ -250,14 +299,14 @@ private:
             _this->recMode = RECORDER_MODE_BASEBAND;
             config.acquire();
             config.conf[_this->name]["mode"] = _this->recMode;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
         ImGui::NextColumn();
         if (ImGui::RadioButton(CONCAT("Audio##_recorder_mode_", _this->name), _this->recMode == RECORDER_MODE_AUDIO)) {
             _this->recMode = RECORDER_MODE_AUDIO;
             config.acquire();
             config.conf[_this->name]["mode"] = _this->recMode;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
         ImGui::Columns(1, CONCAT("EndRecorderModeColumns##_", _this->name), false);
         ImGui::EndGroup();
@@ -267,7 +316,7 @@ private:
             if (_this->folderSelect.pathIsValid()) {
                 config.acquire();
                 config.conf[_this->name]["recPath"] = _this->folderSelect.path;
-                config.release(true);
+                config.releaseKey(_this->name);
             }
         }
 
@@ -276,7 +325,7 @@ private:
         if (ImGui::InputText(CONCAT("##_recorder_name_template_", _this->name), _this->nameTemplate, 1023)) {
             config.acquire();
             config.conf[_this->name]["nameTemplate"] = _this->nameTemplate;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
 
         ImGui::LeftLabel("Time zone");
@@ -284,7 +333,7 @@ private:
         if (ImGui::Combo(CONCAT("##_recorder_timezone_", _this->name), &_this->timezoneId, _this->timezones.txt)) {
             config.acquire();
             config.conf[_this->name]["timezone"] = _this->timezones.key(_this->timezoneId);
-            config.release(true);
+            config.releaseKey(_this->name);
         }
 
         ImGui::LeftLabel("Container");
@@ -292,15 +341,48 @@ private:
         if (ImGui::Combo(CONCAT("##_recorder_container_", _this->name), &_this->containerId, _this->containers.txt)) {
             config.acquire();
             config.conf[_this->name]["container"] = _this->containers.key(_this->containerId);
-            config.release(true);
+            config.releaseKey(_this->name);
+        }
+        if (_this->recMode == RECORDER_MODE_AUDIO && _this->containers[_this->containerId] == CONTAINER_IQZ) {
+            ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "The file source only plays back IQZ baseband recordings");
+        }
+
+        // The compressed container always stores 16bit samples
+        if (_this->containers[_this->containerId] != CONTAINER_IQZ) {
+            ImGui::LeftLabel("Sample type");
+            ImGui::FillWidth();
+            if (ImGui::Combo(CONCAT("##_recorder_st_", _this->name), &_this->sampleTypeId, _this->sampleTypes.txt)) {
+                config.acquire();
+                config.conf[_this->name]["sampleType"] = _this->sampleTypes.key(_this->sampleTypeId);
+                config.releaseKey(_this->name);
+            }
+        }
+
+        ImGui::LeftLabel("Buffer (MB)");
+        ImGui::FillWidth();
+        if (ImGui::InputInt(CONCAT("##_recorder_buffer_", _this->name), &_this->bufferSize, 16, 128)) {
+            _this->bufferSize = std::clamp<int>(_this->bufferSize, 16, 4096);
+            config.acquire();
+            config.conf[_this->name]["bufferSize"] = _this->bufferSize;
+            config.releaseKey(_this->name);
         }
 
-        ImGui::LeftLabel("Sample type");
+        ImGui::LeftLabel("Split size (MB)");
         ImGui::FillWidth();
-        if (ImGui::Combo(CONCAT("##_recorder_st_", _this->name), &_this->sampleTypeId, _this->sampleTypes.txt)) {
+        if (ImGui::InputInt(CONCAT("##_recorder_split_size_", _this->name), &_this->splitSize, 100, 1000)) {
+            _this->splitSize = std::max<int>(_this->splitSize, 0);
             config.acquire();
-            config.conf[_this->name]["sampleType"] = _this->sampleTypes.key(_this->sampleTypeId);
-            config.release(true);
+            config.conf[_this->name]["splitSize"] = _this->splitSize;
+            config.releaseKey(_this->name);
+        }
+
+        ImGui::LeftLabel("Split time (min)");
+        ImGui::FillWidth();
+        if (ImGui::InputInt(CONCAT("##_recorder_split_time_", _this->name), &_this->splitTime, 1, 10)) {
+            _this->splitTime = std::max<int>(_this->splitTime, 0);
+            config.acquire();
+            config.conf[_this->name]["splitTime"] = _this->splitTime;
+            config.releaseKey(_this->name);
         }
 
         if (_this->recording) { style::endDisabled(); }
@@ -314,7 +396,7 @@ private:
                 _this->selectStream(_this->audioStreams.value(_this->streamId));
                 config.acquire();
                 config.conf[_this->name]["audioStream"] = _this->audioStreams.key(_this->streamId);
-                config.release(true);
+                config.releaseKey(_this->name);
             }
             if (_this->recording) { style::endDisabled(); }
 
@@ -329,21 +411,21 @@ private:
                 _this->volume.setVolume(_this->audioVolume);
                 config.acquire();
                 config.conf[_this->name]["audioVolume"] = _this->audioVolume;
-                config.release(true);
+                config.releaseKey(_this->name);
             }
 
             if (_this->recording) { style::beginDisabled(); }
             if (ImGui::Checkbox(CONCAT("Stereo##_recorder_stereo_", _this->name), &_this->stereo)) {
                 config.acquire();
                 config.conf[_this->name]["stereo"] = _this->stereo;
-                config.release(true);
+                config.releaseKey(_this->name);
             }
             if (_this->recording) { style::endDisabled(); }
 
             if (ImGui::Checkbox(CONCAT("Ignore silence##_recorder_ignore_silence_", _this->name), &_this->ignoreSilence)) {
                 config.acquire();
                 config.conf[_this->name]["ignoreSilence"] = _this->ignoreSilence;
-                config.release(true);
+                config.releaseKey(_this->name);
             }
         }
 
@@ -355,12 +437,15 @@ private:
                 _this->start();
             }
             ImGui::TextColored(ImGui::GetStyleColorVec4(ImGuiCol_Text), "Idle --:--:--");
+            if (!_this->errorMsg.empty()) {
+                ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "%s", _this->errorMsg.c_str());
+            }
         }
         else {
             if (ImGui::Button(CONCAT("Stop##_recorder_rec_", _this->name), ImVec2(menuWidth, 0))) {
                 _this->stop();
             }
-            uint64_t seconds = _this->writer.getSamplesWritten() / _this->samplerate;
+            uint64_t seconds = _this->asyncWriter.getSamplesWritten() / _this->samplerate;
             time_t diff = seconds;
             tm* dtm = gmtime(&diff);
 
@@ -370,6 +455,16 @@ private:
             else {
                 ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "Recording %02d:%02d:%02d", dtm->tm_hour, dtm->tm_min, dtm->tm_sec);
             }
+
+            // Show the state of the write queue
+            if (_this->asyncWriter.getSegment()) {
+                ImGui::Text("Segment %d", _this->asyncWriter.getSegment() + 1);
+            }
+            ImGui::ProgressBar(_this->asyncWriter.getQueueUsage(), ImVec2(menuWidth, 0), "Buffer");
+            uint64_t dropped = _this->asyncWriter.getDroppedSamples();
+            if (dropped) {
+                ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "Dropped %" PRIu64 " samples (%" PRIu64 " overruns)", dropped, _this->asyncWriter.getOverruns());
+            }
         }
     }
 
@@ -527,7 +622,7 @@ private:
 
     static void complexHandler(dsp::complex_t* data, int count, void* ctx) {
         RecorderModule* _this = (RecorderModule*)ctx;
-        _this->writer.write((float*)data, count);
+        _this->asyncWriter.write((float*)data, count);
     }
 
     static void stereoHandler(dsp::stereo_t* data, int count, void* ctx) {
@@ -543,7 +638,7 @@ private:
             _this->ignoringSilence = (absMax < SILENCE_LVL);
             if (_this->ignoringSilence) { return; }
         }
-        _this->writer.write((float*)data, count);
+        _this->asyncWriter.write((float*)data, count);
     }
 
     static void monoHandler(float* data, int count, void* ctx) {
@@ -557,7 +652,7 @@ private:
             _this->ignoringSilence = (absMax < SILENCE_LVL);
             if (_this->ignoringSilence) { return; }
         }
-        _this->writer.write(data, count);
+        _this->asyncWriter.write(data, count);
     }
 
     static void moduleInterfaceHandler(int code, void* in, void* out, void* ctx) {
@@ -586,7 +681,7 @@ private:
     char nameTemplate[1024];
 
     OptionList<std::string, TimeZone> timezones;
-    OptionList<std::string, wav::Format> containers;
+    OptionList<std::string, Container> containers;
     OptionList<int, wav::SampleType> sampleTypes;
     FolderSelect folderSelect;
 
@@ -603,6 +698,12 @@ private:
     bool recording = false;
     bool ignoringSilence = false;
     wav::Writer writer;
+    iqz::Writer iqzWriter;
+    AsyncWriter asyncWriter;
+    std::string errorMsg;
+    int bufferSize = 256;
+    int splitSize = 0;
+    int splitTime = 0;
     std::recursive_mutex recMtx;
     dsp::stream<dsp::complex_t>* basebandStream;
     dsp::stream<dsp::stereo_t> stereoStream;
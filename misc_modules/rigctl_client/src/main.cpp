@@ -116,14 +116,14 @@ private:
         if (ImGui::InputText(CONCAT("##_rigctl_cli_host_", _this->name), _this->host, 1023)) {
             config.acquire();
             config.conf[_this->name]["host"] = std::string(_this->host);
-            config.release(true);
+            config.releaseKey(_this->name);
         }
         ImGui::SameLine();
         ImGui::SetNextItemWidth(menuWidth - ImGui::GetCursorPosX());
         if (ImGui::InputInt(CONCAT("##_rigctl_cli_port_", _this->name), &_this->port, 0, 0)) {
             config.acquire();
             config.conf[_this->name]["port"] = _this->port;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
         if (_this->running) { style::endDisabled(); }
 
@@ -135,7 +135,7 @@ private:
             }
             config.acquire();
             config.conf[_this->name]["ifFreq"] = _this->ifFreq;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
 
         ImGui::FillWidth();
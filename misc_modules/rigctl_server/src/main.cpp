@@ -114,14 +114,14 @@ private:
         if (ImGui::InputText(CONCAT("##_rigctl_srv_host_", _this->name), _this->hostname, 1023)) {
             config.acquire();
             config.conf[_this->name]["host"] = std::string(_this->hostname);
-            config.release(true);
+            config.releaseKey(_this->name);
         }
         ImGui::SameLine();
         ImGui::SetNextItemWidth(menuWidth - ImGui::GetCursorPosX());
         if (ImGui::InputInt(CONCAT("##_rigctl_srv_port_", _this->name), &_this->port, 0, 0)) {
             config.acquire();
             config.conf[_this->name]["port"] = _this->port;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
         if (listening) { style::endDisabled(); }
 
@@ -134,7 +134,7 @@ private:
                 if (!_this->selectedVfo.empty()) {
                     config.acquire();
                     config.conf[_this->name]["vfo"] = _this->selectedVfo;
-                    config.release(true);
+                    config.releaseKey(_this->name);
                 }
             }
         }
@@ -148,7 +148,7 @@ private:
                 if (!_this->selectedRecorder.empty()) {
                     config.acquire();
                     config.conf[_this->name]["recorder"] = _this->selectedRecorder;
-                    config.release(true);
+                    config.releaseKey(_this->name);
                 }
             }
         }
@@ -159,20 +159,20 @@ private:
         if (ImGui::Checkbox(CONCAT("Tuning##_rigctl_srv_tune_ena_", _this->name), &_this->tuningEnabled)) {
             config.acquire();
             config.conf[_this->name]["tuning"] = _this->tuningEnabled;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
         ImGui::TableSetColumnIndex(1);
         if (ImGui::Checkbox(CONCAT("Recording##_rigctl_srv_tune_ena_", _this->name), &_this->recordingEnabled)) {
             config.acquire();
             config.conf[_this->name]["recording"] = _this->recordingEnabled;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
         ImGui::EndTable();
 
         if (ImGui::Checkbox(CONCAT("Listen on startup##_rigctl_srv_auto_lst_", _this->name), &_this->autoStart)) {
             config.acquire();
             config.conf[_this->name]["autoStart"] = _this->autoStart;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
 
         if (listening && ImGui::Button(CONCAT("Stop##_rigctl_srv_stop_", _this->name), ImVec2(menuWidth, 0))) {
@@ -0,0 +1,213 @@
+#include "activity_log.h"
+#include <signal_path/signal_path.h>
+#include <utils/flog.h>
+#include <algorithm>
+#include <filesystem>
+#include <chrono>
+#include <math.h>
+
+// Weight of each idle frame in the noise floor estimate of a channel
+#define ACTIVITY_NOISE_ALPHA    0.01f
+
+// Largest channel grid that can be logged, each channel has its own detection state
+#define ACTIVITY_MAX_CHANNELS   100000
+
+namespace scanner {
+    ActivityLogger::~ActivityLogger() {
+        stop();
+    }
+
+    void ActivityLogger::setRange(double start, double stop, double interval, double measureWidth) {
+        if (running) { return; }
+        startFreq = start;
+        stopFreq = stop;
+        this->interval = std::max<double>(interval, 1.0);
+        this->measureWidth = measureWidth;
+    }
+
+    void ActivityLogger::setDetection(float level, float hysteresis, int holdTime, int minDuration) {
+        std::lock_guard<std::mutex> lck(detectMtx);
+        this->level = level;
+        this->hysteresis = std::max<float>(hysteresis, 0.0f);
+        this->holdTime = (int64_t)holdTime * 1000;
+        this->minDuration = (int64_t)minDuration * 1000;
+    }
+
+    bool ActivityLogger::start(const std::string& path) {
+        if (running) { return true; }
+        this->path = path;
+
+        // Refuse grids too large to keep the state of every channel
+        int64_t channelCount = (stopFreq >= startFreq) ? (int64_t)floor((stopFreq - startFreq) / interval) + 1 : 0;
+        if (channelCount > ACTIVITY_MAX_CHANNELS) {
+            flog::error("Activity log range has too many channels ({0}, at most {1})", channelCount, ACTIVITY_MAX_CHANNELS);
+            return false;
+        }
+
+        // Pick up the hits of previous sessions, then append to the file
+        loadHits();
+        bool exists = std::filesystem::exists(path) && std::filesystem::file_size(path) > 0;
+        file = std::ofstream(path, std::ios::out | std::ios::app);
+        if (!file.is_open()) {
+            flog::error("Failed to open activity log: {0}", path);
+            return false;
+        }
+        if (!exists) {
+            file << "frequency_hz,start_time_us,duration_us,peak_db,mean_db,snr_db" << std::endl;
+        }
+
+        // Reset the state of all channels
+        engine.setRange(startFreq, stopFreq, interval);
+        channels.clear();
+        channels.resize(channelCount);
+        activeChannels.clear();
+        activeCount = 0;
+        frameId = 0;
+
+        fftHandlerId = sigpath::iqFrontEnd.onFFT.bind(&ActivityLogger::fftHandler, this);
+        running = true;
+        return true;
+    }
+
+    void ActivityLogger::stop() {
+        if (!running) { return; }
+        sigpath::iqFrontEnd.onFFT.unbind(fftHandlerId);
+        running = false;
+
+        // Close the hits still in progress at the time the signal was last seen
+        while (!activeChannels.empty()) {
+            endHit(activeChannels.back());
+        }
+        file.close();
+    }
+
+    std::vector<Hit> ActivityLogger::query(double minFreq, double maxFreq, int64_t from, int64_t to) {
+        std::lock_guard<std::mutex> lck(hitMtx);
+        std::vector<Hit> result;
+
+        // No hit starting before this one can reach into the time span
+        auto it = std::lower_bound(hits.begin(), hits.end(), from - maxDuration, [](const Hit& hit, int64_t time) {
+            return hit.start < time;
+        });
+        for (; it != hits.end() && it->start <= to; it++) {
+            if (it->start + it->duration < from || it->freq < minFreq || it->freq > maxFreq) { continue; }
+            result.push_back(*it);
+        }
+        return result;
+    }
+
+    size_t ActivityLogger::getHitCount() {
+        std::lock_guard<std::mutex> lck(hitMtx);
+        return hits.size();
+    }
+
+    void ActivityLogger::fftHandler(const float* data, int width) {
+        std::lock_guard<std::mutex> lck(detectMtx);
+        int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        frameId++;
+
+        // Measure all channels covered by the full band FFT
+        double bandwidth = sigpath::iqFrontEnd.getEffectiveSamplerate();
+        double wfStart = sigpath::sourceManager.getCenterFrequency() - (bandwidth / 2.0);
+        engine.evaluate(data, width, wfStart, bandwidth, measureWidth, measureWidth);
+
+        for (const auto& lvl : engine.getLevels()) {
+            int id = round((lvl.freq - startFreq) / interval);
+            if (id < 0 || id >= channels.size()) { continue; }
+            ChannelState& ch = channels[id];
+            ch.lastFrame = frameId;
+
+            if (!ch.active) {
+                // Only let the noise floor follow the channel while it's idle
+                if (!ch.noiseValid) {
+                    ch.noise = lvl.mean;
+                    ch.noiseValid = true;
+                }
+                ch.noise += ACTIVITY_NOISE_ALPHA * (lvl.mean - ch.noise);
+
+                if (lvl.max >= level) {
+                    ch.active = true;
+                    ch.start = now;
+                    ch.lastAbove = now;
+                    ch.peak = lvl.max;
+                    ch.powerSum = pow(10.0, lvl.max / 10.0);
+                    ch.frames = 1;
+                    activeChannels.push_back(id);
+                    activeCount = activeChannels.size();
+                }
+                continue;
+            }
+
+            ch.peak = std::max<float>(ch.peak, lvl.max);
+            ch.powerSum += pow(10.0, lvl.max / 10.0);
+            ch.frames++;
+
+            // End the hit only once the signal has been below the lower threshold for the hold time
+            if (lvl.max >= level - hysteresis) {
+                ch.lastAbove = now;
+            }
+            else if (now - ch.lastAbove > holdTime) {
+                endHit(id);
+            }
+        }
+
+        // Channels that left the visible band (eg. on retune) can't be followed anymore
+        for (int i = activeChannels.size() - 1; i >= 0; i--) {
+            if (channels[activeChannels[i]].lastFrame != frameId) {
+                endHit(activeChannels[i]);
+            }
+        }
+    }
+
+    void ActivityLogger::endHit(int id) {
+        ChannelState& ch = channels[id];
+        ch.active = false;
+        activeChannels.erase(std::remove(activeChannels.begin(), activeChannels.end(), id), activeChannels.end());
+        activeCount = activeChannels.size();
+
+        Hit hit;
+        hit.freq = startFreq + (double)id * interval;
+        hit.start = ch.start;
+        hit.duration = ch.lastAbove - ch.start;
+        if (hit.duration < minDuration) { return; }
+        hit.peak = ch.peak;
+        hit.mean = 10.0 * log10(ch.powerSum / (double)ch.frames);
+        hit.snr = ch.peak - ch.noise;
+
+        char line[256];
+        sprintf(line, "%.0lf,%lld,%lld,%.1f,%.1f,%.1f", hit.freq, (long long)hit.start, (long long)hit.duration, hit.peak, hit.mean, hit.snr);
+        file << line << std::endl;
+        addHit(hit);
+    }
+
+    void ActivityLogger::addHit(const Hit& hit) {
+        std::lock_guard<std::mutex> lck(hitMtx);
+        auto it = std::upper_bound(hits.begin(), hits.end(), hit.start, [](int64_t time, const Hit& h) {
+            return time < h.start;
+        });
+        hits.insert(it, hit);
+        maxDuration = std::max<int64_t>(maxDuration, hit.duration);
+        hitGeneration++;
+    }
+
+    void ActivityLogger::loadHits() {
+        {
+            std::lock_guard<std::mutex> lck(hitMtx);
+            hits.clear();
+            maxDuration = 0;
+            hitGeneration++;
+        }
+        std::ifstream in(path);
+        if (!in.is_open()) { return; }
+
+        std::string line;
+        while (std::getline(in, line)) {
+            Hit hit;
+            long long hitStart, hitDuration;
+            if (sscanf(line.c_str(), "%lf,%lld,%lld,%f,%f,%f", &hit.freq, &hitStart, &hitDuration, &hit.peak, &hit.mean, &hit.snr) != 6) { continue; }
+            hit.start = hitStart;
+            hit.duration = hitDuration;
+            addHit(hit);
+        }
+    }
+}
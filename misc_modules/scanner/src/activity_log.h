@@ -0,0 +1,122 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <atomic>
+#include <stdint.h>
+#include <utils/new_event.h>
+#include "scan_engine.h"
+
+namespace scanner {
+    struct Hit {
+        double freq;
+        int64_t start;      // Microseconds since the epoch
+        int64_t duration;   // Microseconds
+        float peak;
+        float mean;
+        float snr;
+    };
+
+    // Watches every channel of the scan grid in the full band FFT of the front end and logs each
+    // burst of activity as a hit. Doesn't depend on the waterfall or on a VFO being selected.
+    class ActivityLogger {
+    public:
+        ~ActivityLogger();
+
+        /**
+         * Set the channel grid. Ignored while logging.
+         * @param start Frequency of the first channel.
+         * @param stop Frequency above which there are no more channels.
+         * @param interval Spacing between channels.
+         * @param measureWidth Bandwidth around the channel frequency over which the level is measured.
+        */
+        void setRange(double start, double stop, double interval, double measureWidth);
+
+        /**
+         * Set the detection parameters.
+         * @param level Level above which a hit starts.
+         * @param hysteresis How far below the start level the signal must fall for the hit to end, in dB.
+         * @param holdTime Time the signal must stay below the end level for the hit to end, in ms.
+         * @param minDuration Hits shorter than this are discarded, in ms.
+        */
+        void setDetection(float level, float hysteresis, int holdTime, int minDuration);
+
+        /**
+         * Start logging hits, appending them to a CSV file. Hits already in the file are loaded into the index.
+         * @param path Path of the CSV file.
+         * @return True on success.
+        */
+        bool start(const std::string& path);
+
+        /**
+         * Stop logging, ending any hit in progress.
+        */
+        void stop();
+
+        bool isRunning() { return running; }
+
+        /**
+         * Find the logged hits within a band and overlapping a time span, by increasing start time.
+         * @param minFreq Lowest frequency.
+         * @param maxFreq Highest frequency.
+         * @param from Start of the time span in microseconds since the epoch.
+         * @param to End of the time span in microseconds since the epoch.
+        */
+        std::vector<Hit> query(double minFreq, double maxFreq, int64_t from, int64_t to);
+
+        size_t getHitCount();
+
+        /**
+         * Get a counter that changes every time hits are added or removed, to know when a query must be redone.
+        */
+        uint64_t getHitGeneration() { return hitGeneration; }
+
+        int getActiveCount() { return activeCount; }
+
+    private:
+        struct ChannelState {
+            bool active = false;
+            bool noiseValid = false;
+            int64_t lastFrame = -1;
+            float noise;
+            int64_t start;
+            int64_t lastAbove;
+            float peak;
+            double powerSum;
+            int frames;
+        };
+
+        void fftHandler(const float* data, int width);
+        void endHit(int id);
+        void addHit(const Hit& hit);
+        void loadHits();
+
+        double startFreq = 0.0;
+        double stopFreq = 0.0;
+        double interval = 1.0;
+        double measureWidth = 1.0;
+        float level = -50.0f;
+        float hysteresis = 6.0f;
+        int64_t holdTime = 1000000;
+        int64_t minDuration = 0;
+
+        bool running = false;
+        HandlerID fftHandlerId;
+        std::mutex detectMtx;
+        ScanEngine engine;
+        std::vector<ChannelState> channels;
+        std::vector<int> activeChannels;
+        int activeCount = 0;
+        int64_t frameId = 0;
+
+        std::string path;
+        std::ofstream file;
+
+        // Hits sorted by start time
+        std::mutex hitMtx;
+        std::vector<Hit> hits;
+        int64_t maxDuration = 0;
+        std::atomic<uint64_t> hitGeneration = 0;
+    };
+}
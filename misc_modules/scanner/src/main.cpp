@@ -3,7 +3,15 @@
 #include <gui/gui.h>
 #include <gui/style.h>
 #include <signal_path/signal_path.h>
+#include <gui/widgets/folder_select.h>
+#include <core.h>
+#include <config.h>
 #include <chrono>
+#include "scan_engine.h"
+#include "activity_log.h"
+#include "scanner_interface.h"
+
+#define SCANNER_RECENT_HITS     10
 
 SDRPP_MOD_INFO{
     /* Name:            */ "scanner",
@@ -13,16 +21,39 @@ SDRPP_MOD_INFO{
     /* Max instances    */ 1
 };
 
+ConfigManager config;
+
 class ScannerModule : public ModuleManager::Instance {
 public:
-    ScannerModule(std::string name) {
+    ScannerModule(std::string name) : logFolder("%ROOT%/recordings") {
         this->name = name;
+
+        // Load config
+        config.acquire();
+        if (config.conf.contains("startFreq")) { startFreq = config.conf["startFreq"]; }
+        if (config.conf.contains("stopFreq")) { stopFreq = config.conf["stopFreq"]; }
+        if (config.conf.contains("interval")) { interval = config.conf["interval"]; }
+        if (config.conf.contains("passbandRatio")) { passbandRatio = config.conf["passbandRatio"]; }
+        if (config.conf.contains("tuningTime")) { tuningTime = config.conf["tuningTime"]; }
+        if (config.conf.contains("lingerTime")) { lingerTime = config.conf["lingerTime"]; }
+        if (config.conf.contains("level")) { level = config.conf["level"]; }
+        if (config.conf.contains("logPath")) { logFolder.setPath(config.conf["logPath"]); }
+        if (config.conf.contains("hysteresis")) { hysteresis = config.conf["hysteresis"]; }
+        if (config.conf.contains("holdTime")) { holdTime = config.conf["holdTime"]; }
+        if (config.conf.contains("minDuration")) { minDuration = config.conf["minDuration"]; }
+        config.release();
+        current = startFreq;
+        updateDetection();
+
         gui::menu.registerEntry(name, menuHandler, this, NULL);
+        core::modComManager.registerInterface("scanner", name, moduleInterfaceHandler, this);
     }
 
     ~ScannerModule() {
+        core::modComManager.unregisterInterface(name);
         gui::menu.removeEntry(name);
         stop();
+        logger.stop();
     }
 
     void postInit() {}
@@ -49,37 +80,46 @@ private:
         ImGui::SetNextItemWidth(menuWidth - ImGui::GetCursorPosX());
         if (ImGui::InputDouble("##start_freq_scanner", &_this->startFreq, 100.0, 100000.0, "%0.0f")) {
             _this->startFreq = round(_this->startFreq);
+            _this->saveConfig();
         }
         ImGui::LeftLabel("Stop");
         ImGui::SetNextItemWidth(menuWidth - ImGui::GetCursorPosX());
         if (ImGui::InputDouble("##stop_freq_scanner", &_this->stopFreq, 100.0, 100000.0, "%0.0f")) {
             _this->stopFreq = round(_this->stopFreq);
+            _this->saveConfig();
         }
         ImGui::LeftLabel("Interval");
         ImGui::SetNextItemWidth(menuWidth - ImGui::GetCursorPosX());
         if (ImGui::InputDouble("##interval_scanner", &_this->interval, 100.0, 100000.0, "%0.0f")) {
             _this->interval = round(_this->interval);
+            _this->saveConfig();
         }
         ImGui::LeftLabel("Passband Ratio (%)");
         ImGui::SetNextItemWidth(menuWidth - ImGui::GetCursorPosX());
         if (ImGui::InputDouble("##pb_ratio_scanner", &_this->passbandRatio, 1.0, 10.0, "%0.0f")) {
             _this->passbandRatio = std::clamp<double>(round(_this->passbandRatio), 1.0, 100.0);
+            _this->saveConfig();
         }
         ImGui::LeftLabel("Tuning Time (ms)");
         ImGui::SetNextItemWidth(menuWidth - ImGui::GetCursorPosX());
         if (ImGui::InputInt("##tuning_time_scanner", &_this->tuningTime, 100, 1000)) {
             _this->tuningTime = std::clamp<int>(_this->tuningTime, 100, 10000.0);
+            _this->saveConfig();
         }
         ImGui::LeftLabel("Linger Time (ms)");
         ImGui::SetNextItemWidth(menuWidth - ImGui::GetCursorPosX());
         if (ImGui::InputInt("##linger_time_scanner", &_this->lingerTime, 100, 1000)) {
             _this->lingerTime = std::clamp<int>(_this->lingerTime, 100, 10000.0);
+            _this->saveConfig();
         }
         if (_this->running) { ImGui::EndDisabled(); }
 
         ImGui::LeftLabel("Level");
         ImGui::SetNextItemWidth(menuWidth - ImGui::GetCursorPosX());
-        ImGui::SliderFloat("##scanner_level", &_this->level, -150.0, 0.0);
+        if (ImGui::SliderFloat("##scanner_level", &_this->level, -150.0, 0.0)) {
+            _this->updateDetection();
+            _this->saveConfig();
+        }
 
         ImGui::BeginTable(("scanner_bottom_btn_table" + _this->name).c_str(), 2);
         ImGui::TableNextRow();
@@ -119,6 +159,122 @@ private:
                 ImGui::TextColored(ImVec4(1, 1, 0, 1), "Status: Scanning");
             }
         }
+
+        // Activity logging only needs the front end FFT, it runs with or without the scanner
+        ImGui::Separator();
+        ImGui::Text("Activity Log");
+        if (_this->logger.isRunning()) { ImGui::BeginDisabled(); }
+        if (_this->logFolder.render("##scanner_log_folder_" + _this->name) && _this->logFolder.pathIsValid()) {
+            _this->saveConfig();
+        }
+        if (_this->logger.isRunning()) { ImGui::EndDisabled(); }
+
+        ImGui::LeftLabel("Hysteresis (dB)");
+        ImGui::SetNextItemWidth(menuWidth - ImGui::GetCursorPosX());
+        if (ImGui::SliderFloat("##scanner_hysteresis", &_this->hysteresis, 0.0, 30.0, "%.1f")) {
+            _this->updateDetection();
+            _this->saveConfig();
+        }
+        ImGui::LeftLabel("Hold Time (ms)");
+        ImGui::SetNextItemWidth(menuWidth - ImGui::GetCursorPosX());
+        if (ImGui::InputInt("##hold_time_scanner", &_this->holdTime, 100, 1000)) {
+            _this->holdTime = std::clamp<int>(_this->holdTime, 0, 60000);
+            _this->updateDetection();
+            _this->saveConfig();
+        }
+        ImGui::LeftLabel("Min Duration (ms)");
+        ImGui::SetNextItemWidth(menuWidth - ImGui::GetCursorPosX());
+        if (ImGui::InputInt("##min_duration_scanner", &_this->minDuration, 100, 1000)) {
+            _this->minDuration = std::clamp<int>(_this->minDuration, 0, 60000);
+            _this->updateDetection();
+            _this->saveConfig();
+        }
+
+        if (!_this->logger.isRunning()) {
+            if (!_this->logFolder.pathIsValid()) { ImGui::BeginDisabled(); }
+            if (ImGui::Button("Start Logging##scanner_log", ImVec2(menuWidth, 0))) {
+                _this->startLogging();
+            }
+            if (!_this->logFolder.pathIsValid()) { ImGui::EndDisabled(); }
+            return;
+        }
+        if (ImGui::Button("Stop Logging##scanner_log", ImVec2(menuWidth, 0))) {
+            _this->logger.stop();
+        }
+        ImGui::Text("Hits: %d (%d active)", (int)_this->logger.getHitCount(), _this->logger.getActiveCount());
+
+        // Show the latest hits of the scan range, only querying again when the log or the range changed
+        // or once a second for old hits to leave the time window
+        int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        uint64_t gen = _this->logger.getHitGeneration();
+        if (gen != _this->recentGen || now - _this->recentTime > 1000000LL || _this->startFreq != _this->recentStart || _this->stopFreq != _this->recentStop) {
+            _this->recentHits = _this->logger.query(_this->startFreq, _this->stopFreq, now - 600000000LL, now);
+            _this->recentGen = gen;
+            _this->recentTime = now;
+            _this->recentStart = _this->startFreq;
+            _this->recentStop = _this->stopFreq;
+        }
+        const auto& recent = _this->recentHits;
+        if (recent.empty()) { return; }
+        if (ImGui::BeginTable(("scanner_hits_table" + _this->name).c_str(), 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Frequency");
+            ImGui::TableSetupColumn("Duration");
+            ImGui::TableSetupColumn("SNR");
+            ImGui::TableHeadersRow();
+            for (int i = recent.size() - 1; i >= std::max<int>((int)recent.size() - SCANNER_RECENT_HITS, 0); i--) {
+                const auto& hit = recent[i];
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::Text("%.3lf MHz", hit.freq / 1e6);
+                ImGui::TableSetColumnIndex(1);
+                ImGui::Text("%.1lf s", (double)hit.duration / 1e6);
+                ImGui::TableSetColumnIndex(2);
+                ImGui::Text("%.1f dB", hit.snr);
+            }
+            ImGui::EndTable();
+        }
+    }
+
+    void saveConfig() {
+        config.acquire();
+        config.conf["startFreq"] = startFreq;
+        config.conf["stopFreq"] = stopFreq;
+        config.conf["interval"] = interval;
+        config.conf["passbandRatio"] = passbandRatio;
+        config.conf["tuningTime"] = tuningTime;
+        config.conf["lingerTime"] = lingerTime;
+        config.conf["level"] = level;
+        config.conf["logPath"] = logFolder.path;
+        config.conf["hysteresis"] = hysteresis;
+        config.conf["holdTime"] = holdTime;
+        config.conf["minDuration"] = minDuration;
+        config.release(true);
+    }
+
+    void updateDetection() {
+        logger.setDetection(level, hysteresis, holdTime, minDuration);
+    }
+
+    bool startLogging() {
+        if (logger.isRunning()) { return true; }
+        logger.setRange(startFreq, stopFreq, interval, interval * (passbandRatio * 0.01));
+        updateDetection();
+        return logger.start(logFolder.expandString(logFolder.path + "/scanner_activity.csv"));
+    }
+
+    static void moduleInterfaceHandler(int code, void* in, void* out, void* ctx) {
+        ScannerModule* _this = (ScannerModule*)ctx;
+        if (code == SCANNER_IFACE_CMD_START_LOGGING) {
+            _this->startLogging();
+        }
+        else if (code == SCANNER_IFACE_CMD_STOP_LOGGING) {
+            _this->logger.stop();
+        }
+        else if (code == SCANNER_IFACE_CMD_QUERY_HITS && in && out) {
+            ScannerHitQuery* _in = (ScannerHitQuery*)in;
+            std::vector<scanner::Hit>* _out = (std::vector<scanner::Hit>*)out;
+            *_out = _this->logger.query(_in->minFreq, _in->maxFreq, _in->from, _in->to);
+        }
     }
 
     void start() {
@@ -177,7 +333,7 @@ private:
                 if (receiving) {
                     flog::warn("Receiving");
                 
-                    float maxLevel = getMaxLevel(data, current, vfoWidth, dataWidth, wfStart, wfWidth);
+                    float maxLevel = scanner::ScanEngine::getMaxLevel(data, current, vfoWidth, dataWidth, wfStart, wfWidth);
                     if (maxLevel >= level) {
                         lastSignalTime = now;
                     }
@@ -187,26 +343,27 @@ private:
                 }
                 else {
                     flog::warn("Seeking signal");
-                    double bottomLimit = current;
-                    double topLimit = current;
-                    
-                    // Search for a signal in scan direction
-                    if (findSignal(scanUp, bottomLimit, topLimit, wfStart, wfEnd, wfWidth, vfoWidth, data, dataWidth)) {
+
+                    // Evaluate every visible channel from this frame at once
+                    engine.setRange(startFreq, stopFreq, interval);
+                    engine.evaluate(data, dataWidth, wfStart, wfWidth, vfoWidth, vfoWidth * (passbandRatio * 0.01f));
+
+                    // Search for a signal in scan direction, then in the inverse direction if it isn't enforced
+                    double next;
+                    bool found = engine.nextActive(current, scanUp, level, next);
+                    if (!found && !reverseLock) { found = engine.nextActive(current, !scanUp, level, next); }
+                    reverseLock = false;
+                    if (found) {
+                        current = next;
+                        receiving = true;
                         gui::waterfall.releaseLatestFFT();
                         continue;
                     }
-                    
-                    // Search for signal in the inverse scan direction if direction isn't enforced
-                    if (!reverseLock) {
-                        if (findSignal(!scanUp, bottomLimit, topLimit, wfStart, wfEnd, wfWidth, vfoWidth, data, dataWidth)) {
-                            gui::waterfall.releaseLatestFFT();
-                            continue;
-                        }
-                    }
-                    else { reverseLock = false; }
-                    
 
-                    // There is no signal on the visible spectrum, tune in scan direction and retry
+                    // There is no signal on the visible spectrum, tune past it in scan direction and retry
+                    const auto& levels = engine.getLevels();
+                    double bottomLimit = levels.empty() ? current : std::min<double>(current, levels.front().freq);
+                    double topLimit = levels.empty() ? current : std::max<double>(current, levels.back().freq);
                     if (scanUp) {
                         current = topLimit + interval;
                         if (current > stopFreq) { current = startFreq; }
@@ -229,44 +386,6 @@ private:
         }
     }
 
-    bool findSignal(bool scanDir, double& bottomLimit, double& topLimit, double wfStart, double wfEnd, double wfWidth, double vfoWidth, float* data, int dataWidth) {
-        bool found = false;
-        double freq = current;
-        for (freq += scanDir ? interval : -interval;
-            scanDir ? (freq <= stopFreq) : (freq >= startFreq);
-            freq += scanDir ? interval : -interval) {
-
-            // Check if signal is within bounds
-            if (freq - (vfoWidth/2.0) < wfStart) { break; }
-            if (freq + (vfoWidth/2.0) > wfEnd) { break; }
-
-            if (freq < bottomLimit) { bottomLimit = freq; }
-            if (freq > topLimit) { topLimit = freq; }
-            
-            // Check signal level
-            float maxLevel = getMaxLevel(data, freq, vfoWidth * (passbandRatio * 0.01f), dataWidth, wfStart, wfWidth);
-            if (maxLevel >= level) {
-                found = true;
-                receiving = true;
-                current = freq;
-                break;
-            }
-        }
-        return found;
-    }
-
-    float getMaxLevel(float* data, double freq, double width, int dataWidth, double wfStart, double wfWidth) {
-        double low = freq - (width/2.0);
-        double high = freq + (width/2.0);
-        int lowId = std::clamp<int>((low - wfStart) * (double)dataWidth / wfWidth, 0, dataWidth - 1);
-        int highId = std::clamp<int>((high - wfStart) * (double)dataWidth / wfWidth, 0, dataWidth - 1);
-        float max = -INFINITY;
-        for (int i = lowId; i <= highId; i++) {
-            if (data[i] > max) { max = data[i]; }
-        }
-        return max;
-    }
-
     std::string name;
     bool enabled = true;
     
@@ -288,10 +407,28 @@ private:
     std::chrono::time_point<std::chrono::high_resolution_clock> lastTuneTime;
     std::thread workerThread;
     std::mutex scanMtx;
+    scanner::ScanEngine engine;
+
+    // Activity logging
+    scanner::ActivityLogger logger;
+
+    // Cached result of the recent hits query
+    std::vector<scanner::Hit> recentHits;
+    uint64_t recentGen = 0;
+    int64_t recentTime = 0;
+    double recentStart = 0.0;
+    double recentStop = 0.0;
+    FolderSelect logFolder;
+    float hysteresis = 6.0f;
+    int holdTime = 1000;
+    int minDuration = 0;
 };
 
 MOD_EXPORT void _INIT_() {
-    // Nothing here
+    json def = json({});
+    config.setPath(core::args["root"].s() + "/scanner_config.json");
+    config.load(def);
+    config.enableAutoSave();
 }
 
 MOD_EXPORT ModuleManager::Instance* _CREATE_INSTANCE_(std::string name) {
@@ -303,5 +440,6 @@ MOD_EXPORT void _DELETE_INSTANCE_(void* instance) {
 }
 
 MOD_EXPORT void _END_() {
-    // Nothing here
+    config.disableAutoSave();
+    config.save();
 }
\ No newline at end of file
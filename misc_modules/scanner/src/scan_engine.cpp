@@ -0,0 +1,87 @@
+#include "scan_engine.h"
+#include <volk/volk.h>
+#include <algorithm>
+#include <math.h>
+
+namespace scanner {
+    void ScanEngine::setRange(double start, double stop, double interval) {
+        if (start == this->start && stop == this->stop && interval == this->interval) { return; }
+        this->start = start;
+        this->stop = stop;
+        this->interval = std::max<double>(interval, 1.0);
+        rangesValid = false;
+    }
+
+    int ScanEngine::evaluate(const float* data, int dataWidth, double wfStart, double wfWidth, double vfoWidth, double measureWidth) {
+        // Only recompute the bin ranges when the view or grid changed
+        if (!rangesValid || dataWidth != lastDataWidth || wfStart != lastWfStart || wfWidth != lastWfWidth || vfoWidth != lastVfoWidth || measureWidth != lastMeasureWidth) {
+            updateRanges(dataWidth, wfStart, wfWidth, vfoWidth, measureWidth);
+        }
+
+        // Reduce every channel's bins to a max and mean level
+        levels.resize(ranges.size());
+        for (int i = 0; i < ranges.size(); i++) {
+            const BinRange& r = ranges[i];
+            uint32_t maxId;
+            float sum;
+            volk_32f_index_max_32u(&maxId, &data[r.first], r.count);
+            volk_32f_accumulator_s32f(&sum, &data[r.first], r.count);
+            levels[i].freq = r.freq;
+            levels[i].max = data[r.first + maxId];
+            levels[i].mean = sum / (float)r.count;
+        }
+
+        return levels.size();
+    }
+
+    bool ScanEngine::nextActive(double from, bool up, float threshold, double& freq) {
+        // Find the closest active channel in the scan direction
+        double bestDist = INFINITY;
+        for (const auto& lvl : levels) {
+            double dist = up ? (lvl.freq - from) : (from - lvl.freq);
+            if (dist < interval * 0.5 || dist >= bestDist || lvl.max < threshold) { continue; }
+            bestDist = dist;
+            freq = lvl.freq;
+        }
+        return bestDist != INFINITY;
+    }
+
+    float ScanEngine::getMaxLevel(const float* data, double freq, double width, int dataWidth, double wfStart, double wfWidth) {
+        double low = freq - (width/2.0);
+        double high = freq + (width/2.0);
+        int lowId = std::clamp<int>((low - wfStart) * (double)dataWidth / wfWidth, 0, dataWidth - 1);
+        int highId = std::clamp<int>((high - wfStart) * (double)dataWidth / wfWidth, 0, dataWidth - 1);
+        uint32_t maxId;
+        volk_32f_index_max_32u(&maxId, &data[lowId], highId - lowId + 1);
+        return data[lowId + maxId];
+    }
+
+    void ScanEngine::updateRanges(int dataWidth, double wfStart, double wfWidth, double vfoWidth, double measureWidth) {
+        lastDataWidth = dataWidth;
+        lastWfStart = wfStart;
+        lastWfWidth = wfWidth;
+        lastVfoWidth = vfoWidth;
+        lastMeasureWidth = measureWidth;
+        rangesValid = true;
+        ranges.clear();
+        if (dataWidth <= 0 || wfWidth <= 0.0 || stop < start) { return; }
+
+        // Find the grid channels whose whole VFO bandwidth is visible
+        double wfEnd = wfStart + wfWidth;
+        int64_t lastChannel = floor((stop - start) / interval);
+        int64_t first = std::max<int64_t>(ceil((wfStart + (vfoWidth / 2.0) - start) / interval), 0);
+        int64_t last = std::min<int64_t>(floor((wfEnd - (vfoWidth / 2.0) - start) / interval), lastChannel);
+
+        // Precompute the bins of each of them
+        double binsPerHz = (double)dataWidth / wfWidth;
+        for (int64_t i = first; i <= last; i++) {
+            BinRange r;
+            r.freq = start + (double)i * interval;
+            int lowId = std::clamp<int>((r.freq - (measureWidth / 2.0) - wfStart) * binsPerHz, 0, dataWidth - 1);
+            int highId = std::clamp<int>((r.freq + (measureWidth / 2.0) - wfStart) * binsPerHz, 0, dataWidth - 1);
+            r.first = lowId;
+            r.count = highId - lowId + 1;
+            ranges.push_back(r);
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+#include <stdint.h>
+
+namespace scanner {
+    struct ChannelLevel {
+        double freq;
+        float max;
+        float mean;
+    };
+
+    // Evaluates every channel of the scan grid visible in an FFT frame at once
+    class ScanEngine {
+    public:
+        /**
+         * Set the channel grid.
+         * @param start Frequency of the first channel.
+         * @param stop Frequency above which there are no more channels.
+         * @param interval Spacing between channels.
+        */
+        void setRange(double start, double stop, double interval);
+
+        /**
+         * Compute the level of all channels fully visible in the FFT frame.
+         * @param data FFT frame in dB.
+         * @param dataWidth Number of bins in the frame.
+         * @param wfStart Frequency of the first bin.
+         * @param wfWidth Bandwidth covered by the frame.
+         * @param vfoWidth Bandwidth a channel must have visible to be evaluated.
+         * @param measureWidth Bandwidth around the channel frequency over which the level is measured.
+         * @return Number of channels evaluated.
+        */
+        int evaluate(const float* data, int dataWidth, double wfStart, double wfWidth, double vfoWidth, double measureWidth);
+
+        /**
+         * Get the levels of the channels evaluated by the last call to evaluate(), by increasing frequency.
+        */
+        const std::vector<ChannelLevel>& getLevels() { return levels; }
+
+        /**
+         * Find the closest active channel in a given direction among the evaluated channels.
+         * @param from Frequency to search from, excluded from the search.
+         * @param up True to search upwards, false to search downwards.
+         * @param threshold Level above which a channel is active.
+         * @param freq Frequency of the active channel found.
+         * @return True if an active channel was found.
+        */
+        bool nextActive(double from, bool up, float threshold, double& freq);
+
+        /**
+         * Get the max level of a band of the FFT frame.
+        */
+        static float getMaxLevel(const float* data, double freq, double width, int dataWidth, double wfStart, double wfWidth);
+
+    private:
+        struct BinRange {
+            double freq;
+            int first;
+            int count;
+        };
+
+        void updateRanges(int dataWidth, double wfStart, double wfWidth, double vfoWidth, double measureWidth);
+
+        double start = 0.0;
+        double stop = 0.0;
+        double interval = 1.0;
+
+        // Geometry the bin ranges were computed for
+        int lastDataWidth = -1;
+        double lastWfStart = 0.0;
+        double lastWfWidth = 0.0;
+        double lastVfoWidth = 0.0;
+        double lastMeasureWidth = 0.0;
+        bool rangesValid = false;
+
+        std::vector<BinRange> ranges;
+        std::vector<ChannelLevel> levels;
+    };
+}
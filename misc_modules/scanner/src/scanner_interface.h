@@ -0,0 +1,16 @@
+#pragma once
+#include "activity_log.h"
+
+enum {
+    SCANNER_IFACE_CMD_START_LOGGING,
+    SCANNER_IFACE_CMD_STOP_LOGGING,
+    SCANNER_IFACE_CMD_QUERY_HITS
+};
+
+// Input of SCANNER_IFACE_CMD_QUERY_HITS, the output is a std::vector<scanner::Hit>
+struct ScannerHitQuery {
+    double minFreq;
+    double maxFreq;
+    int64_t from;   // Microseconds since the epoch
+    int64_t to;     // Microseconds since the epoch
+};
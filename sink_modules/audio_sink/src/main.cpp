@@ -5,13 +5,22 @@
 #include <signal_path/sink.h>
 #include <dsp/buffer/packer.h>
 #include <dsp/convert/stereo_to_mono.h>
+#include <dsp/sink/handler_sink.h>
+#include <dsp/buffer/spsc_ring.h>
 #include <utils/flog.h>
 #include <RtAudio.h>
 #include <config.h>
 #include <core.h>
+#include "mixer.h"
+#include <atomic>
+#include <algorithm>
 
 #define CONCAT(a, b) ((std::string(a) + b).c_str())
 
+// Maximum playback rate deviation used to absorb the drift between the stream and the device clocks
+#define LL_MAX_DRIFT    0.002
+#define LL_DRIFT_GAIN   0.002
+
 SDRPP_MOD_INFO{
     /* Name:            */ "audio_sink",
     /* Description:     */ "Audio sink module for SDR++",
@@ -30,6 +39,7 @@ public:
         s2m.init(_stream->sinkOut);
         monoPacker.init(&s2m.out, 512);
         stereoPacker.init(_stream->sinkOut, 512);
+        llSink.init(_stream->sinkOut, llHandler, this);
 
 #if RTAUDIO_VERSION_MAJOR >= 6
         audio.setErrorCallback(&errorCallback);
@@ -44,6 +54,9 @@ public:
             config.conf[_streamName]["devices"] = json({});
         }
         device = config.conf[_streamName]["device"];
+        if (config.conf[_streamName].contains("lowLatency")) {
+            lowLatency = config.conf[_streamName]["lowLatency"];
+        }
         config.release(created);
 
         RtAudio::DeviceInfo info;
@@ -74,6 +87,7 @@ public:
 
     ~AudioSink() {
         stop();
+        if (llTmp) { dsp::buffer::free(llTmp); }
     }
 
     void start() {
@@ -149,7 +163,7 @@ public:
             selectById(devId);
             config.acquire();
             config.conf[_streamName]["device"] = devList[devId].name;
-            config.release(true);
+            config.releaseKey(_streamName);
         }
 
         ImGui::SetNextItemWidth(menuWidth);
@@ -162,7 +176,34 @@ public:
             }
             config.acquire();
             config.conf[_streamName]["devices"][devList[devId].name] = sampleRate;
-            config.release(true);
+            config.releaseKey(_streamName);
+        }
+
+        if (ImGui::Checkbox(("Low latency##_audio_sink_ll_" + _streamName).c_str(), &lowLatency)) {
+            if (running) { doStop(); }
+            if (running) { running = doStart(); }
+            config.acquire();
+            config.conf[_streamName]["lowLatency"] = lowLatency;
+            config.releaseKey(_streamName);
+        }
+
+        // Latency from the source block to the speaker, filters inside the demodulators aren't counted
+        if (running) {
+            double upstream = _stream->getUpstreamLatency() * 1000.0;
+            double buffered = (double)(lowLatency ? llFill.load() : bufferFrames) * 1000.0 / (double)sampleRate;
+            double device = (double)(audio.getStreamLatency() + bufferFrames) * 1000.0 / (double)sampleRate;
+            ImGui::Text("Latency: %.1f ms", upstream + buffered + device);
+            if (ImGui::IsItemHovered()) {
+                ImGui::BeginTooltip();
+                ImGui::Text("Source and resamplers: %.1f ms", upstream);
+                ImGui::Text("Buffered: %.1f ms", buffered);
+                ImGui::Text("Device: %.1f ms", device);
+                if (lowLatency) {
+                    ImGui::Text("Underruns: %d", llUnderruns.load());
+                    ImGui::Text("Rate correction: %+.0f ppm", llDrift.load() * 1e6);
+                }
+                ImGui::EndTooltip();
+            }
         }
     }
 
@@ -187,11 +228,15 @@ private:
         RtAudio::StreamParameters parameters;
         parameters.deviceId = deviceIds[devId];
         parameters.nChannels = 2;
-        unsigned int bufferFrames = sampleRate / 60;
+        bufferFrames = lowLatency ? (sampleRate / 200) : (sampleRate / 60);
         RtAudio::StreamOptions opts;
         opts.flags = RTAUDIO_MINIMIZE_LATENCY;
         opts.streamName = _streamName;
 
+        if (lowLatency) {
+            return doStartLowLatency(parameters, opts);
+        }
+
         try {
             audio.openStream(&parameters, NULL, RTAUDIO_FLOAT32, sampleRate, &bufferFrames, &callback, this, &opts);
             stereoPacker.setSampleCount(bufferFrames);
@@ -207,10 +252,42 @@ private:
         return true;
     }
 
+    // The device pulls from a lock-free ring filled directly by the stream instead of going through the packer,
+    // and the amount of buffering follows the size of the blocks actually produced upstream.
+    bool doStartLowLatency(RtAudio::StreamParameters& parameters, RtAudio::StreamOptions& opts) {
+        opts.flags |= RTAUDIO_SCHEDULE_REALTIME;
+        opts.numberOfBuffers = 2;
+
+        llRing.init(sampleRate / 2);
+        llPrimed = false;
+        llPeakBlock = 0;
+        llFill = 0;
+        llUnderruns = 0;
+        llDrift = 0.0;
+
+        try {
+            audio.openStream(&parameters, NULL, RTAUDIO_FLOAT32, sampleRate, &bufferFrames, &llCallback, this, &opts);
+            if (llTmp) { dsp::buffer::free(llTmp); }
+            llTmpSize = (bufferFrames * 2) + 16;
+            llTmp = dsp::buffer::alloc<dsp::stereo_t>(llTmpSize);
+            llSink.start();
+            audio.startStream();
+        }
+        catch (const std::exception& e) {
+            llSink.stop();
+            flog::error("Could not open audio device {0}", e.what());
+            return false;
+        }
+
+        flog::info("RtAudio low latency stream open ({0} frames)", bufferFrames);
+        return true;
+    }
+
     void doStop() {
         s2m.stop();
         monoPacker.stop();
         stereoPacker.stop();
+        llSink.stop();
         monoPacker.out.stopReader();
         stereoPacker.out.stopReader();
         audio.stopStream();
@@ -229,11 +306,105 @@ private:
         return 0;
     }
 
+    static void llHandler(dsp::stereo_t* data, int count, void* ctx) {
+        AudioSink* _this = (AudioSink*)ctx;
+        _this->llRing.write(data, count);
+
+        // Track the largest recent block, slowly forgetting it
+        int peak = _this->llPeakBlock;
+        _this->llPeakBlock = std::max<int>(count, peak - (peak >> 8));
+    }
+
+    static int llCallback(void* outputBuffer, void* inputBuffer, unsigned int nBufferFrames, double streamTime, RtAudioStreamStatus status, void* userData) {
+        AudioSink* _this = (AudioSink*)userData;
+        dsp::stereo_t* out = (dsp::stereo_t*)outputBuffer;
+
+        // Enough buffering to ride out the gap between two blocks from the stream
+        int target = _this->bufferFrames + _this->llPeakBlock;
+        int fill = _this->llRing.readable();
+        _this->llFill = fill;
+
+        if (!_this->llPrimed) {
+            if (fill < target) {
+                memset(out, 0, nBufferFrames * sizeof(dsp::stereo_t));
+                return 0;
+            }
+            _this->llPrimed = true;
+            _this->llAvgFill = fill;
+            _this->llPhase = 0.0;
+            _this->llLast = { 0.0f, 0.0f };
+        }
+
+        // After a stall upstream, drop the backlog at once instead of slowly catching up
+        if (fill > target * 4) {
+            _this->llRing.skip(fill - target);
+            fill = target;
+            _this->llAvgFill = target;
+        }
+
+        // Steer the playback rate to keep the fill around the target
+        _this->llAvgFill += 0.01 * ((double)fill - _this->llAvgFill);
+        double drift = std::clamp<double>(LL_DRIFT_GAIN * (_this->llAvgFill - target) / (double)target, -LL_MAX_DRIFT, LL_MAX_DRIFT);
+        double ratio = 1.0 + drift;
+        _this->llDrift = drift;
+
+        // Linear interpolation between the last consumed sample and the next one
+        int done = 0;
+        while (done < nBufferFrames) {
+            int count = std::min<int>(nBufferFrames - done, _this->bufferFrames);
+            int avail = _this->llRing.peek(_this->llTmp, std::min<int>(ceil(count * ratio) + 2, _this->llTmpSize));
+            int used = 0;
+            int i = 0;
+            for (; i < count; i++) {
+                while (_this->llPhase >= 1.0 && used < avail) {
+                    _this->llLast = _this->llTmp[used++];
+                    _this->llPhase -= 1.0;
+                }
+                if (used >= avail) { break; }
+                float mu = _this->llPhase;
+                const dsp::stereo_t& next = _this->llTmp[used];
+                out[done + i].l = _this->llLast.l + (next.l - _this->llLast.l) * mu;
+                out[done + i].r = _this->llLast.r + (next.r - _this->llLast.r) * mu;
+                _this->llPhase += ratio;
+            }
+            _this->llRing.skip(used);
+            done += i;
+
+            // Ran dry, output silence and build the margin back up
+            if (i < count) {
+                memset(&out[done], 0, (nBufferFrames - done) * sizeof(dsp::stereo_t));
+                _this->llPrimed = false;
+                _this->llUnderruns++;
+                break;
+            }
+        }
+        return 0;
+    }
+
     SinkManager::Stream* _stream;
     dsp::convert::StereoToMono s2m;
     dsp::buffer::Packer<float> monoPacker;
     dsp::buffer::Packer<dsp::stereo_t> stereoPacker;
 
+    // Low latency path
+    dsp::sink::Handler<dsp::stereo_t> llSink;
+    dsp::buffer::SPSCRing<dsp::stereo_t> llRing;
+    std::atomic<int> llPeakBlock = 0;
+    bool lowLatency = false;
+
+    // Owned by the low latency callback
+    dsp::stereo_t* llTmp = NULL;
+    int llTmpSize = 0;
+    bool llPrimed = false;
+    double llAvgFill = 0.0;
+    double llPhase = 0.0;
+    dsp::stereo_t llLast = { 0.0f, 0.0f };
+
+    // Measurements shown in the menu
+    std::atomic<int> llFill = 0;
+    std::atomic<int> llUnderruns = 0;
+    std::atomic<double> llDrift = 0.0;
+
     std::string _streamName;
 
     int srId = 0;
@@ -250,6 +421,7 @@ private:
     std::vector<unsigned int> sampleRates;
     std::string sampleRatesTxt;
     unsigned int sampleRate = 48000;
+    unsigned int bufferFrames = 0;
 
     RtAudio audio;
 };
@@ -260,13 +432,17 @@ public:
         this->name = name;
         provider.create = create_sink;
         provider.ctx = this;
+        mixerProvider.create = create_mixer_sink;
+        mixerProvider.ctx = this;
 
         sigpath::sinkManager.registerSinkProvider("Audio", provider);
+        sigpath::sinkManager.registerSinkProvider("Audio Mixer", mixerProvider);
     }
 
     ~AudioSinkModule() {
         // Unregister sink, this will automatically stop and delete all instances of the audio sink
         sigpath::sinkManager.unregisterSinkProvider("Audio");
+        sigpath::sinkManager.unregisterSinkProvider("Audio Mixer");
     }
 
     void postInit() {}
@@ -288,9 +464,16 @@ private:
         return (SinkManager::Sink*)(new AudioSink(stream, streamName));
     }
 
+    static SinkManager::Sink* create_mixer_sink(SinkManager::Stream* stream, std::string streamName, void* ctx) {
+        AudioSinkModule* _this = (AudioSinkModule*)ctx;
+        return (SinkManager::Sink*)(new MixerSink(&_this->mixer, stream, streamName));
+    }
+
     std::string name;
     bool enabled = true;
     SinkManager::SinkProvider provider;
+    SinkManager::SinkProvider mixerProvider;
+    AudioMixer mixer;
 };
 
 MOD_EXPORT void _INIT_() {
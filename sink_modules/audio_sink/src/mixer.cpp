@@ -0,0 +1,318 @@
+#include "mixer.h"
+#include <imgui.h>
+#include <gui/style.h>
+#include <config.h>
+#include <utils/flog.h>
+#include <volk/volk.h>
+#include <algorithm>
+#include <thread>
+#include <string.h>
+
+#define MIXER_CONFIG_KEY    "_mixer_"
+
+extern ConfigManager config;
+
+MixerSink::MixerSink(AudioMixer* mixer, SinkManager::Stream* stream, std::string streamName) {
+    this->mixer = mixer;
+    this->stream = stream;
+    this->streamName = streamName;
+    sink.init(stream->sinkOut, handler, this);
+    ring.init(MIXER_RING_FRAMES);
+    gainPattern = dsp::buffer::alloc<float>(MIXER_CHUNK_FRAMES * 2);
+
+    config.acquire();
+    if (config.conf.contains(streamName) && config.conf[streamName].contains("mixerPan")) {
+        pan = config.conf[streamName]["mixerPan"];
+    }
+    config.release();
+    setPan(pan);
+
+    mixer->registerSink(this);
+}
+
+MixerSink::~MixerSink() {
+    stop();
+    mixer->unregisterSink(this);
+    dsp::buffer::free(gainPattern);
+}
+
+void MixerSink::start() {
+    if (running) { return; }
+    ring.clear();
+    primed = false;
+    sink.start();
+    mixer->addInput(this);
+    running = true;
+}
+
+void MixerSink::stop() {
+    if (!running) { return; }
+    mixer->removeInput(this);
+    sink.stop();
+    running = false;
+}
+
+void MixerSink::menuHandler() {
+    float menuWidth = ImGui::GetContentRegionAvail().x;
+    mixer->menuHandler(streamName);
+
+    ImGui::LeftLabel("Pan");
+    ImGui::SetNextItemWidth(menuWidth - ImGui::GetCursorPosX());
+    if (ImGui::SliderFloat(("##_audio_mixer_pan_" + streamName).c_str(), &pan, -1.0f, 1.0f, "%.2f")) {
+        setPan(pan);
+        config.acquire();
+        config.conf[streamName]["mixerPan"] = pan;
+        config.releaseKey(streamName);
+    }
+}
+
+void MixerSink::handler(dsp::stereo_t* data, int count, void* ctx) {
+    MixerSink* _this = (MixerSink*)ctx;
+    _this->ring.write(data, count);
+}
+
+void MixerSink::setPan(float pan) {
+    // Balance law, the center leaves both channels untouched
+    gainL = std::min<float>(1.0f, 1.0f - pan);
+    gainR = std::min<float>(1.0f, 1.0f + pan);
+    gainsChanged = true;
+}
+
+void MixerSink::mixInto(float* out, int frames, float* tmp, int primeFrames) {
+    // Build up some margin before playing, and again after running dry
+    int avail = ring.readable();
+    if (!primed) {
+        if (avail < primeFrames) { return; }
+        primed = true;
+    }
+
+    // Keep the latency bounded when the stream runs slightly faster than the device
+    if (avail > primeFrames * 4) {
+        ring.skip(avail - (primeFrames * 2));
+    }
+
+    if (gainsChanged.exchange(false)) {
+        float l = gainL;
+        float r = gainR;
+        for (int i = 0; i < MIXER_CHUNK_FRAMES; i++) {
+            gainPattern[2 * i] = l;
+            gainPattern[(2 * i) + 1] = r;
+        }
+    }
+
+    int count = ring.read((dsp::stereo_t*)tmp, frames);
+    volk_32f_x2_multiply_32f(tmp, tmp, gainPattern, count * 2);
+    volk_32f_x2_add_32f(out, out, tmp, count * 2);
+    if (count < frames) { primed = false; }
+}
+
+AudioMixer::AudioMixer() {
+    for (auto& in : inputs) { in = NULL; }
+    mixTmp = dsp::buffer::alloc<float>(MIXER_CHUNK_FRAMES * 2);
+
+    std::string device = "";
+    bool created = false;
+    config.acquire();
+    if (!config.conf.contains(MIXER_CONFIG_KEY)) {
+        created = true;
+        config.conf[MIXER_CONFIG_KEY]["device"] = "";
+        config.conf[MIXER_CONFIG_KEY]["devices"] = json({});
+    }
+    device = config.conf[MIXER_CONFIG_KEY]["device"];
+    config.release(created);
+
+    RtAudio::DeviceInfo info;
+#if RTAUDIO_VERSION_MAJOR >= 6
+    for (int i : audio.getDeviceIds()) {
+#else
+    int count = audio.getDeviceCount();
+    for (int i = 0; i < count; i++) {
+#endif
+        try {
+            info = audio.getDeviceInfo(i);
+#if !defined(RTAUDIO_VERSION_MAJOR) || RTAUDIO_VERSION_MAJOR < 6
+            if (!info.probed) { continue; }
+#endif
+            if (info.outputChannels == 0) { continue; }
+            if (info.isDefaultOutput) { defaultDevId = devList.size(); }
+            devList.push_back(info);
+            deviceIds.push_back(i);
+            txtDevList += info.name;
+            txtDevList += '\0';
+        }
+        catch (const std::exception& e) {
+            flog::error("AudioMixer Error getting audio device ({}) info: {}", i, e.what());
+        }
+    }
+    selectByName(device);
+}
+
+AudioMixer::~AudioMixer() {
+    close();
+    dsp::buffer::free(mixTmp);
+}
+
+void AudioMixer::registerSink(MixerSink* sink) {
+    {
+        std::lock_guard<std::mutex> lck(ctrlMtx);
+        sinks.push_back(sink);
+    }
+    sink->stream->setSampleRate(sampleRate);
+}
+
+void AudioMixer::unregisterSink(MixerSink* sink) {
+    std::lock_guard<std::mutex> lck(ctrlMtx);
+    sinks.erase(std::remove(sinks.begin(), sinks.end(), sink), sinks.end());
+}
+
+void AudioMixer::addInput(MixerSink* sink) {
+    std::lock_guard<std::mutex> lck(ctrlMtx);
+    for (auto& in : inputs) {
+        if (in.load()) { continue; }
+        in = sink;
+        if (!activeCount++ && !devList.empty()) { isOpen = open(); }
+        return;
+    }
+    flog::error("Audio mixer is full, '{0}' won't be heard", sink->streamName);
+}
+
+void AudioMixer::removeInput(MixerSink* sink) {
+    std::lock_guard<std::mutex> lck(ctrlMtx);
+    for (auto& in : inputs) {
+        if (in.load() != sink) { continue; }
+        in = NULL;
+
+        // The callback may still be reading from the sink it loaded before the slot was cleared
+        while (inCallback) { std::this_thread::yield(); }
+
+        if (!--activeCount) { close(); }
+        return;
+    }
+}
+
+void AudioMixer::menuHandler(const std::string& id) {
+    float menuWidth = ImGui::GetContentRegionAvail().x;
+
+    ImGui::SetNextItemWidth(menuWidth);
+    if (ImGui::Combo(("##_audio_mixer_dev_" + id).c_str(), &devId, txtDevList.c_str())) {
+        selectById(devId);
+        config.acquire();
+        config.conf[MIXER_CONFIG_KEY]["device"] = devList[devId].name;
+        config.releaseKey(MIXER_CONFIG_KEY);
+    }
+
+    ImGui::SetNextItemWidth(menuWidth);
+    if (ImGui::Combo(("##_audio_mixer_sr_" + id).c_str(), &srId, sampleRatesTxt.c_str())) {
+        config.acquire();
+        config.conf[MIXER_CONFIG_KEY]["devices"][devList[devId].name] = sampleRates[srId];
+        config.releaseKey(MIXER_CONFIG_KEY);
+        selectById(devId);
+    }
+}
+
+void AudioMixer::selectByName(std::string name) {
+    for (int i = 0; i < devList.size(); i++) {
+        if (devList[i].name == name) {
+            selectById(i);
+            return;
+        }
+    }
+    if (!devList.empty()) { selectById(defaultDevId); }
+}
+
+void AudioMixer::selectById(int id) {
+    devId = id;
+    bool created = false;
+    config.acquire();
+    if (!config.conf[MIXER_CONFIG_KEY]["devices"].contains(devList[id].name)) {
+        created = true;
+        config.conf[MIXER_CONFIG_KEY]["devices"][devList[id].name] = devList[id].preferredSampleRate;
+    }
+    unsigned int sr = config.conf[MIXER_CONFIG_KEY]["devices"][devList[id].name];
+    config.release(created);
+
+    sampleRates = devList[id].sampleRates;
+    sampleRatesTxt = "";
+    char buf[256];
+    bool found = false;
+    unsigned int defaultId = 0;
+    unsigned int defaultSr = devList[id].preferredSampleRate;
+    for (int i = 0; i < sampleRates.size(); i++) {
+        if (sampleRates[i] == sr) {
+            found = true;
+            srId = i;
+        }
+        if (sampleRates[i] == defaultSr) {
+            defaultId = i;
+        }
+        sprintf(buf, "%d", sampleRates[i]);
+        sampleRatesTxt += buf;
+        sampleRatesTxt += '\0';
+    }
+    if (!found) {
+        sr = defaultSr;
+        srId = defaultId;
+    }
+
+    // Reopen the device and have every stream switch to the new rate
+    std::vector<MixerSink*> toUpdate;
+    {
+        std::lock_guard<std::mutex> lck(ctrlMtx);
+        if (isOpen) { close(); }
+        sampleRate = sr;
+        if (activeCount) { isOpen = open(); }
+        toUpdate = sinks;
+    }
+    for (auto& sink : toUpdate) {
+        sink->stream->setSampleRate(sampleRate);
+    }
+}
+
+bool AudioMixer::open() {
+    RtAudio::StreamParameters parameters;
+    parameters.deviceId = deviceIds[devId];
+    parameters.nChannels = 2;
+    unsigned int bufferFrames = sampleRate / 60;
+    RtAudio::StreamOptions opts;
+    opts.flags = RTAUDIO_MINIMIZE_LATENCY;
+    opts.streamName = "SDR++ Mixer";
+
+    try {
+        audio.openStream(&parameters, NULL, RTAUDIO_FLOAT32, sampleRate, &bufferFrames, &callback, this, &opts);
+        primeFrames = bufferFrames * 2;
+        audio.startStream();
+    }
+    catch (const std::exception& e) {
+        flog::error("Could not open audio device {0}", e.what());
+        return false;
+    }
+
+    flog::info("RtAudio mixer stream open");
+    return true;
+}
+
+void AudioMixer::close() {
+    if (!isOpen) { return; }
+    audio.stopStream();
+    audio.closeStream();
+    isOpen = false;
+}
+
+int AudioMixer::callback(void* outputBuffer, void* inputBuffer, unsigned int nBufferFrames, double streamTime, RtAudioStreamStatus status, void* userData) {
+    AudioMixer* _this = (AudioMixer*)userData;
+    _this->inCallback = true;
+    float* out = (float*)outputBuffer;
+    memset(out, 0, nBufferFrames * sizeof(dsp::stereo_t));
+    int prime = _this->primeFrames;
+
+    for (int offset = 0; offset < nBufferFrames; offset += MIXER_CHUNK_FRAMES) {
+        int frames = std::min<int>(nBufferFrames - offset, MIXER_CHUNK_FRAMES);
+        for (auto& in : _this->inputs) {
+            MixerSink* sink = in.load();
+            if (sink) { sink->mixInto(&out[offset * 2], frames, _this->mixTmp, prime); }
+        }
+    }
+
+    _this->inCallback = false;
+    return 0;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <signal_path/sink.h>
+#include <dsp/sink/handler_sink.h>
+#include <dsp/buffer/spsc_ring.h>
+#include <RtAudio.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <string>
+
+#define MIXER_MAX_INPUTS    64
+#define MIXER_CHUNK_FRAMES  1024
+#define MIXER_RING_FRAMES   65536
+
+class AudioMixer;
+
+// Sink of a single stream, feeding the shared mixer through a lock-free ring
+class MixerSink : public SinkManager::Sink {
+public:
+    MixerSink(AudioMixer* mixer, SinkManager::Stream* stream, std::string streamName);
+    ~MixerSink();
+
+    void start();
+    void stop();
+    void menuHandler();
+
+private:
+    friend AudioMixer;
+
+    static void handler(dsp::stereo_t* data, int count, void* ctx);
+    void setPan(float pan);
+
+    // Audio callback thread only
+    void mixInto(float* out, int frames, float* tmp, int primeFrames);
+
+    AudioMixer* mixer;
+    SinkManager::Stream* stream;
+    std::string streamName;
+    dsp::sink::Handler<dsp::stereo_t> sink;
+    dsp::buffer::SPSCRing<dsp::stereo_t> ring;
+    bool running = false;
+    float pan = 0.0f;
+
+    // Channel gains set by the UI, picked up by the callback
+    std::atomic<float> gainL = 1.0f;
+    std::atomic<float> gainR = 1.0f;
+    std::atomic<bool> gainsChanged = true;
+
+    // Owned by the audio callback
+    float* gainPattern;
+    bool primed = false;
+};
+
+// Mixes any number of streams into a single device stream. Each stream is resampled to the device
+// rate by its producer, like with any other sink, and the audio callback sums the streams' rings
+// without taking a lock.
+class AudioMixer {
+public:
+    AudioMixer();
+    ~AudioMixer();
+
+    void registerSink(MixerSink* sink);
+    void unregisterSink(MixerSink* sink);
+
+    void addInput(MixerSink* sink);
+    void removeInput(MixerSink* sink);
+
+    unsigned int getSampleRate() { return sampleRate; }
+
+    void menuHandler(const std::string& id);
+
+private:
+    void selectByName(std::string name);
+    void selectById(int id);
+    bool open();
+    void close();
+
+    static int callback(void* outputBuffer, void* inputBuffer, unsigned int nBufferFrames, double streamTime, RtAudioStreamStatus status, void* userData);
+
+    RtAudio audio;
+    std::vector<RtAudio::DeviceInfo> devList;
+    std::vector<unsigned int> deviceIds;
+    std::string txtDevList;
+    int defaultDevId = 0;
+    int devId = 0;
+    std::vector<unsigned int> sampleRates;
+    std::string sampleRatesTxt;
+    int srId = 0;
+    unsigned int sampleRate = 48000;
+
+    std::mutex ctrlMtx;
+    std::vector<MixerSink*> sinks;
+    int activeCount = 0;
+    bool isOpen = false;
+    std::atomic<int> primeFrames = 0;
+
+    // Read by the callback
+    std::atomic<MixerSink*> inputs[MIXER_MAX_INPUTS];
+    std::atomic<bool> inCallback = false;
+    float* mixTmp;
+};
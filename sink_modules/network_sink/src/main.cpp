@@ -131,14 +131,14 @@ public:
         if (ImGui::InputText(CONCAT("##_network_sink_host_", _streamName), hostname, 1023)) {
             config.acquire();
             config.conf[_streamName]["hostname"] = hostname;
-            config.release(true);
+            config.releaseKey(_streamName);
         }
         ImGui::SameLine();
         ImGui::SetNextItemWidth(menuWidth - ImGui::GetCursorPosX());
         if (ImGui::InputInt(CONCAT("##_network_sink_port_", _streamName), &port, 0, 0)) {
             config.acquire();
             config.conf[_streamName]["port"] = port;
-            config.release(true);
+            config.releaseKey(_streamName);
         }
 
         ImGui::LeftLabel("Protocol");
@@ -146,7 +146,7 @@ public:
         if (ImGui::Combo(CONCAT("##_network_sink_mode_", _streamName), &modeId, sinkModesTxt)) {
             config.acquire();
             config.conf[_streamName]["protocol"] = modeId;
-            config.release(true);
+            config.releaseKey(_streamName);
         }
 
         if (listening) { style::endDisabled(); }
@@ -159,7 +159,7 @@ public:
             packer.setSampleCount(sampleRate / 60);
             config.acquire();
             config.conf[_streamName]["sampleRate"] = sampleRate;
-            config.release(true);
+            config.releaseKey(_streamName);
         }
 
         if (ImGui::Checkbox(CONCAT("Stereo##_network_sink_stereo_", _streamName), &stereo)) {
@@ -167,20 +167,20 @@ public:
             start();
             config.acquire();
             config.conf[_streamName]["stereo"] = stereo;
-            config.release(true);
+            config.releaseKey(_streamName);
         }
 
         if (listening && ImGui::Button(CONCAT("Stop##_network_sink_stop_", _streamName), ImVec2(menuWidth, 0))) {
             stopServer();
             config.acquire();
             config.conf[_streamName]["listening"] = false;
-            config.release(true);
+            config.releaseKey(_streamName);
         }
         else if (!listening && ImGui::Button(CONCAT("Start##_network_sink_stop_", _streamName), ImVec2(menuWidth, 0))) {
             startServer();
             config.acquire();
             config.conf[_streamName]["listening"] = true;
-            config.release(true);
+            config.releaseKey(_streamName);
         }
 
         ImGui::TextUnformatted("Status:");
@@ -148,7 +148,7 @@ public:
             if (selectedDevName != "") {
                 config.acquire();
                 config.conf[_streamName]["device"] = selectedDevName;
-                config.release(true);
+                config.releaseKey(_streamName);
             }
         }
 
@@ -160,7 +160,7 @@ public:
             if (selectedDevName != "") {
                 config.acquire();
                 config.conf[_streamName]["devices"][selectedDevName] = selectedDev.sampleRates[srId];
-                config.release(true);
+                config.releaseKey(_streamName);
             }
         }
     }
@@ -311,7 +311,7 @@ private:
         if (!config.conf[_streamName]["devices"].contains(name)) {
             config.conf[_streamName]["devices"][name] = selectedDev.sampleRates[selectedDev.defaultSrId];
         }
-        config.release(true);
+        config.releaseKey(_streamName);
 
         // Find the sample rate ID, if not use default
         bool found = false;
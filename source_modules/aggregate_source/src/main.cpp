@@ -0,0 +1,515 @@
+#include <utils/flog.h>
+#include <module.h>
+#include <gui/gui.h>
+#include <signal_path/signal_path.h>
+#include <core.h>
+#include <gui/style.h>
+#include <config.h>
+#include <gui/smgui.h>
+#include <utils/optionlist.h>
+#include <dsp/sink/handler_sink.h>
+#include <dsp/buffer/spsc_ring.h>
+#include <condition_variable>
+#include <memory>
+#include <atomic>
+#include "stitcher.h"
+
+#define CONCAT(a, b) ((std::string(a) + b).c_str())
+
+#define MAX_MEMBERS 16
+
+SDRPP_MOD_INFO{
+    /* Name:            */ "aggregate_source",
+    /* Description:     */ "Combines several sources into one wideband source",
+    /* Author:          */ "Ryzerth",
+    /* Version:         */ 0, 1, 0,
+    /* Max instances    */ 1
+};
+
+ConfigManager config;
+
+class AggregateSourceModule : public ModuleManager::Instance {
+public:
+    AggregateSourceModule(std::string name) {
+        this->name = name;
+
+        handler.ctx = this;
+        handler.selectHandler = menuSelected;
+        handler.deselectHandler = menuDeselected;
+        handler.menuHandler = menuHandler;
+        handler.startHandler = start;
+        handler.stopHandler = stop;
+        handler.tuneHandler = tune;
+        handler.stream = &stream;
+
+        // Define FFT sizes
+        for (int size = 1024; size <= 65536; size *= 2) {
+            fftSizes.define(size, std::to_string(size), size);
+        }
+
+        // Load config
+        config.acquire();
+        if (config.conf[name].contains("members")) {
+            for (auto const& mem : config.conf[name]["members"]) {
+                MemberConfig mc;
+                mc.name = mem["name"];
+                mc.delay = mem["delay"];
+                members.push_back(mc);
+            }
+        }
+        if (config.conf[name].contains("samplerate")) {
+            samplerate = config.conf[name]["samplerate"];
+            tempSamplerate = samplerate;
+        }
+        if (config.conf[name].contains("fftSize")) {
+            int size = config.conf[name]["fftSize"];
+            if (fftSizes.keyExists(size)) { fftSize = size; }
+        }
+        if (config.conf[name].contains("usable")) {
+            usable = std::clamp<int>(config.conf[name]["usable"], 50, 95);
+        }
+        config.release();
+        fftSizeId = fftSizes.keyId(fftSize);
+        clampDelays();
+
+        sourceUnregisterHandler.handler = onSourceUnregister;
+        sourceUnregisterHandler.ctx = this;
+        sigpath::sourceManager.onSourceUnregister.bindHandler(&sourceUnregisterHandler);
+
+        refreshSources();
+        sigpath::sourceManager.registerSource("Aggregate", &handler);
+    }
+
+    ~AggregateSourceModule() {
+        stop(this);
+        sigpath::sourceManager.unregisterSource("Aggregate");
+        sigpath::sourceManager.onSourceUnregister.unbindHandler(&sourceUnregisterHandler);
+    }
+
+    void postInit() {}
+
+    void enable() {
+        enabled = true;
+    }
+
+    void disable() {
+        enabled = false;
+    }
+
+    bool isEnabled() {
+        return enabled;
+    }
+
+private:
+    struct MemberConfig {
+        std::string name;
+        int delay = 0;
+    };
+
+    // Source being read while running
+    struct Member {
+        AggregateSourceModule* parent;
+        SourceManager::SourceHandler* handler;
+        dsp::sink::Handler<dsp::complex_t> sink;
+        dsp::buffer::SPSCRing<dsp::complex_t> ring;
+        dsp::complex_t* window;
+        std::atomic<bool> overflow = false;
+        int pendingSkip = 0;
+    };
+
+    std::string getSrScaled(double sr) {
+        char buf[1024];
+        if (sr >= 1000000.0) {
+            sprintf(buf, "%.3lf MS/s", sr / 1000000.0);
+        }
+        else if (sr >= 1000.0) {
+            sprintf(buf, "%.3lf KS/s", sr / 1000.0);
+        }
+        else {
+            sprintf(buf, "%.3lf S/s", sr);
+        }
+        return std::string(buf);
+    }
+
+    // Bins kept from each member, a multiple of 4 to keep the phase continuous (see Stitcher)
+    int getUsableBins() {
+        return std::max<int>(((fftSize * usable) / 100) & ~3, 4);
+    }
+
+    // Spacing between the center frequencies of the members
+    double getMemberStep() {
+        return (double)getUsableBins() * (double)samplerate / (double)fftSize;
+    }
+
+    double getOutputSamplerate() {
+        return (double)std::max<int>(members.size(), 1) * getMemberStep();
+    }
+
+    // Size of the ring of each member, in samples
+    int getRingSize() {
+        return std::max<int>(samplerate / 2, fftSize * 4);
+    }
+
+    // A delay is skipped from the ring along with a hop, so both have to fit in it
+    int getMaxDelay() {
+        return getRingSize() - (fftSize / 2);
+    }
+
+    void clampDelays() {
+        for (auto& mc : members) {
+            mc.delay = std::clamp<int>(mc.delay, 0, getMaxDelay());
+        }
+    }
+
+    void refreshSources() {
+        sourceNames.clear();
+        sourceNamesTxt.clear();
+        for (auto const& srcName : sigpath::sourceManager.getSourceNames()) {
+            if (srcName == "Aggregate") { continue; }
+            sourceNames.push_back(srcName);
+            sourceNamesTxt += srcName;
+            sourceNamesTxt += '\0';
+        }
+        sourceId = std::clamp<int>(sourceId, 0, std::max<int>(sourceNames.size() - 1, 0));
+    }
+
+    void saveMembers() {
+        config.acquire();
+        config.conf[name]["members"] = json::array();
+        for (auto const& mc : members) {
+            json mem;
+            mem["name"] = mc.name;
+            mem["delay"] = mc.delay;
+            config.conf[name]["members"].push_back(mem);
+        }
+        config.releaseKey(name);
+    }
+
+    static void onSourceUnregister(std::string name, void* ctx) {
+        AggregateSourceModule* _this = (AggregateSourceModule*)ctx;
+        if (name == "Aggregate") { return; }
+
+        // A member going away can't be read anymore
+        if (_this->running) {
+            for (auto const& mc : _this->members) {
+                if (mc.name != name) { continue; }
+                flog::warn("Member '{0}' of the aggregate source is going away, stopping", name);
+                stop(_this);
+                break;
+            }
+        }
+        _this->refreshSources();
+    }
+
+    static void menuSelected(void* ctx) {
+        AggregateSourceModule* _this = (AggregateSourceModule*)ctx;
+        _this->refreshSources();
+        core::setInputSampleRate(_this->getOutputSamplerate());
+        flog::info("AggregateSourceModule '{0}': Menu Select!", _this->name);
+    }
+
+    static void menuDeselected(void* ctx) {
+        AggregateSourceModule* _this = (AggregateSourceModule*)ctx;
+        flog::info("AggregateSourceModule '{0}': Menu Deselect!", _this->name);
+    }
+
+    static void start(void* ctx) {
+        AggregateSourceModule* _this = (AggregateSourceModule*)ctx;
+        if (_this->running) { return; }
+        if (_this->members.empty()) {
+            flog::error("The aggregate source has no members");
+            return;
+        }
+
+        // Find all members first, they're driven directly through their handlers
+        for (auto const& mc : _this->members) {
+            if (sigpath::sourceManager.getSourceHandler(mc.name)) { continue; }
+            flog::error("Member '{0}' of the aggregate source doesn't exist", mc.name);
+            return;
+        }
+
+        _this->stitcher.init(_this->members.size(), _this->fftSize, _this->getUsableBins());
+        int ringSize = _this->getRingSize();
+        for (auto const& mc : _this->members) {
+            auto mem = std::make_unique<Member>();
+            mem->parent = _this;
+            mem->handler = sigpath::sourceManager.getSourceHandler(mc.name);
+            mem->ring.init(ringSize);
+            mem->window = dsp::buffer::alloc<dsp::complex_t>(_this->fftSize);
+            dsp::buffer::clear(mem->window, _this->fftSize);
+            mem->sink.init(mem->handler->stream, memberHandler, mem.get());
+            _this->active.push_back(std::move(mem));
+        }
+
+        // Tune and start all members
+        _this->run = true;
+        _this->resync = true;
+        _this->tuneMembers();
+        for (auto& mem : _this->active) {
+            mem->sink.start();
+            mem->handler->startHandler(mem->handler->ctx);
+        }
+
+        _this->workerThread = std::thread(&AggregateSourceModule::worker, _this);
+
+        _this->running = true;
+        flog::info("AggregateSourceModule '{0}': Start!", _this->name);
+    }
+
+    static void stop(void* ctx) {
+        AggregateSourceModule* _this = (AggregateSourceModule*)ctx;
+        if (!_this->running) { return; }
+        _this->running = false;
+
+        // Stop worker thread
+        {
+            std::lock_guard<std::mutex> lck(_this->dataMtx);
+            _this->run = false;
+        }
+        _this->dataCnd.notify_all();
+        _this->stream.stopWriter();
+        if (_this->workerThread.joinable()) { _this->workerThread.join(); }
+        _this->stream.clearWriteStop();
+
+        // Stop all members
+        for (auto& mem : _this->active) {
+            mem->handler->stopHandler(mem->handler->ctx);
+            mem->sink.stop();
+            dsp::buffer::free(mem->window);
+        }
+        _this->active.clear();
+
+        flog::info("AggregateSourceModule '{0}': Stop!", _this->name);
+    }
+
+    static void tune(double freq, void* ctx) {
+        AggregateSourceModule* _this = (AggregateSourceModule*)ctx;
+        _this->freq = freq;
+        if (_this->running) { _this->tuneMembers(); }
+        flog::info("AggregateSourceModule '{0}': Tune: {1}!", _this->name, freq);
+    }
+
+    void tuneMembers() {
+        // Members are spread evenly around the center, in increasing frequency
+        double step = getMemberStep();
+        double first = freq - (step * (double)(active.size() - 1) / 2.0);
+        for (int i = 0; i < active.size(); i++) {
+            active[i]->handler->tuneHandler(first + (step * (double)i), active[i]->handler->ctx);
+        }
+    }
+
+    static void menuHandler(void* ctx) {
+        AggregateSourceModule* _this = (AggregateSourceModule*)ctx;
+
+        // Member list, the delays can be changed while running and apply on resync
+        for (int i = 0; i < _this->members.size(); i++) {
+            MemberConfig& mc = _this->members[i];
+            SmGui::LeftLabel(mc.name.c_str());
+            SmGui::FillWidth();
+            if (SmGui::InputInt(CONCAT("##aggregate_source_delay_" + std::to_string(i) + "_", _this->name), &mc.delay, 1, 100)) {
+                mc.delay = std::clamp<int>(mc.delay, 0, _this->getMaxDelay());
+                _this->saveMembers();
+            }
+        }
+
+        if (_this->running) { SmGui::BeginDisabled(); }
+
+        // Add or remove members, in increasing frequency order
+        bool canAdd = !_this->sourceNames.empty() && _this->members.size() < MAX_MEMBERS;
+        if (!canAdd) { SmGui::BeginDisabled(); }
+        SmGui::FillWidth();
+        SmGui::Combo(CONCAT("##aggregate_source_src_", _this->name), &_this->sourceId, _this->sourceNamesTxt.c_str());
+        SmGui::FillWidth();
+        if (SmGui::Button(CONCAT("Add member##aggregate_source_add_", _this->name))) {
+            MemberConfig mc;
+            mc.name = _this->sourceNames[_this->sourceId];
+            _this->members.push_back(mc);
+            _this->saveMembers();
+            core::setInputSampleRate(_this->getOutputSamplerate());
+        }
+        if (!canAdd) { SmGui::EndDisabled(); }
+
+        bool canRemove = !_this->members.empty();
+        if (!canRemove) { SmGui::BeginDisabled(); }
+        SmGui::FillWidth();
+        if (SmGui::Button(CONCAT("Remove last member##aggregate_source_rem_", _this->name))) {
+            _this->members.pop_back();
+            _this->saveMembers();
+            core::setInputSampleRate(_this->getOutputSamplerate());
+        }
+        if (!canRemove) { SmGui::EndDisabled(); }
+
+        // Samplerate the members are configured for
+        SmGui::LeftLabel("Member samplerate");
+        SmGui::FillWidth();
+        if (SmGui::InputInt(CONCAT("##aggregate_source_sr_", _this->name), &_this->tempSamplerate)) {
+            _this->tempSamplerate = std::max<int>(_this->tempSamplerate, 1000);
+        }
+        bool applyEn = (!_this->running && _this->tempSamplerate != _this->samplerate);
+        if (!applyEn) { SmGui::BeginDisabled(); }
+        SmGui::FillWidth();
+        if (SmGui::Button(CONCAT("Apply##aggregate_source_apply_", _this->name))) {
+            _this->samplerate = _this->tempSamplerate;
+            core::setInputSampleRate(_this->getOutputSamplerate());
+            _this->clampDelays();
+            _this->saveMembers();
+            config.acquire();
+            config.conf[_this->name]["samplerate"] = _this->samplerate;
+            config.releaseKey(_this->name);
+        }
+        if (!applyEn) { SmGui::EndDisabled(); }
+
+        SmGui::LeftLabel("FFT Size");
+        SmGui::FillWidth();
+        if (SmGui::Combo(CONCAT("##aggregate_source_fft_", _this->name), &_this->fftSizeId, _this->fftSizes.txt)) {
+            _this->fftSize = _this->fftSizes.value(_this->fftSizeId);
+            core::setInputSampleRate(_this->getOutputSamplerate());
+            _this->clampDelays();
+            _this->saveMembers();
+            config.acquire();
+            config.conf[_this->name]["fftSize"] = _this->fftSize;
+            config.releaseKey(_this->name);
+        }
+
+        SmGui::LeftLabel("Usable band (%)");
+        SmGui::FillWidth();
+        if (SmGui::SliderInt(CONCAT("##aggregate_source_usable_", _this->name), &_this->usable, 50, 95)) {
+            core::setInputSampleRate(_this->getOutputSamplerate());
+            config.acquire();
+            config.conf[_this->name]["usable"] = _this->usable;
+            config.releaseKey(_this->name);
+        }
+
+        if (_this->running) { SmGui::EndDisabled(); }
+
+        if (!_this->running) { SmGui::BeginDisabled(); }
+        SmGui::FillWidth();
+        if (SmGui::Button(CONCAT("Resync##aggregate_source_resync_", _this->name))) {
+            {
+                std::lock_guard<std::mutex> lck(_this->dataMtx);
+                _this->resync = true;
+            }
+            _this->dataCnd.notify_all();
+        }
+        if (!_this->running) { SmGui::EndDisabled(); }
+
+        SmGui::Text(("Span: " + _this->getSrScaled(_this->getOutputSamplerate())).c_str());
+        if (_this->tempSamplerate != _this->samplerate) {
+            SmGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "Warning: Samplerate not applied yet");
+        }
+    }
+
+    static void memberHandler(dsp::complex_t* data, int count, void* ctx) {
+        Member* mem = (Member*)ctx;
+        if (mem->ring.write(data, count) < count) { mem->overflow = true; }
+        {
+            std::lock_guard<std::mutex> lck(mem->parent->dataMtx);
+        }
+        mem->parent->dataCnd.notify_one();
+    }
+
+    bool membersOverflowed() {
+        for (auto& mem : active) {
+            if (mem->overflow) { return true; }
+        }
+        return false;
+    }
+
+    bool membersReady(int hop) {
+        for (auto& mem : active) {
+            if (mem->ring.readable() < hop + mem->pendingSkip) { return false; }
+        }
+        return true;
+    }
+
+    void worker() {
+        int hop = stitcher.getInputHop();
+        int outHop = stitcher.getOutputHop();
+        std::vector<const dsp::complex_t*> windows;
+        for (auto& mem : active) { windows.push_back(mem->window); }
+
+        while (true) {
+            // Realign when asked to and after losing samples. The buffered samples are dropped and each member
+            // then skips its own delay, which compensates for the members not starting at the same time.
+            bool overflow = false;
+            for (auto& mem : active) { overflow |= mem->overflow.exchange(false); }
+            if (overflow) { flog::warn("Aggregate source couldn't keep up, resyncing"); }
+            if (resync.exchange(false) || overflow) {
+                for (int i = 0; i < active.size(); i++) {
+                    active[i]->ring.skip(active[i]->ring.readable());
+                    active[i]->pendingSkip = members[i].delay;
+                    dsp::buffer::clear(active[i]->window, fftSize);
+                }
+            }
+
+            // Wait until all members have a new hop of samples. A member that lost samples or a resync request
+            // won't be fixed by waiting, so they're handled right away.
+            {
+                std::unique_lock<std::mutex> lck(dataMtx);
+                dataCnd.wait(lck, [&]() { return !run || resync || membersOverflowed() || membersReady(hop); });
+                if (!run) { break; }
+                if (!membersReady(hop)) { continue; }
+            }
+
+            for (auto& mem : active) {
+                mem->ring.skip(mem->pendingSkip);
+                mem->pendingSkip = 0;
+                memmove(mem->window, &mem->window[hop], hop * sizeof(dsp::complex_t));
+                mem->ring.read(&mem->window[hop], hop);
+            }
+
+            stitcher.process(windows.data(), stream.writeBuf);
+            if (!stream.swap(outHop)) { break; }
+        }
+    }
+
+    std::string name;
+    bool enabled = true;
+    dsp::stream<dsp::complex_t> stream;
+    SourceManager::SourceHandler handler;
+    bool running = false;
+    double freq = 0.0;
+
+    std::vector<MemberConfig> members;
+    std::vector<std::string> sourceNames;
+    std::string sourceNamesTxt;
+    int sourceId = 0;
+
+    OptionList<int, int> fftSizes;
+    int fftSizeId = 0;
+    int fftSize = 8192;
+    int usable = 80;
+    int samplerate = 2400000;
+    int tempSamplerate = 2400000;
+
+    EventHandler<std::string> sourceUnregisterHandler;
+
+    // Processing
+    Stitcher stitcher;
+    std::vector<std::unique_ptr<Member>> active;
+    std::thread workerThread;
+    std::mutex dataMtx;
+    std::condition_variable dataCnd;
+    bool run = false;
+    std::atomic<bool> resync = false;
+};
+
+MOD_EXPORT void _INIT_() {
+    json def = json({});
+    config.setPath(core::args["root"].s() + "/aggregate_source_config.json");
+    config.load(def);
+    config.enableAutoSave();
+}
+
+MOD_EXPORT ModuleManager::Instance* _CREATE_INSTANCE_(std::string name) {
+    return new AggregateSourceModule(name);
+}
+
+MOD_EXPORT void _DELETE_INSTANCE_(ModuleManager::Instance* instance) {
+    delete (AggregateSourceModule*)instance;
+}
+
+MOD_EXPORT void _END_() {
+    config.disableAutoSave();
+    config.save();
+}
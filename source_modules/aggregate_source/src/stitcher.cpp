@@ -0,0 +1,62 @@
+#include "stitcher.h"
+#include <string.h>
+
+Stitcher::~Stitcher() {
+    free();
+}
+
+void Stitcher::init(int memberCount, int fftSize, int usableBins) {
+    free();
+    _memberCount = memberCount;
+    _fftSize = fftSize;
+    _usableBins = usableBins;
+    outSize = memberCount * usableBins;
+
+    fftIn = (fftwf_complex*)fftwf_malloc(_fftSize * sizeof(fftwf_complex));
+    fftOut = (fftwf_complex*)fftwf_malloc(_fftSize * sizeof(fftwf_complex));
+    ifftIn = (fftwf_complex*)fftwf_malloc(outSize * sizeof(fftwf_complex));
+    ifftOut = (fftwf_complex*)fftwf_malloc(outSize * sizeof(fftwf_complex));
+    fwdPlan = fftwf_plan_dft_1d(_fftSize, fftIn, fftOut, FFTW_FORWARD, FFTW_ESTIMATE);
+    invPlan = fftwf_plan_dft_1d(outSize, ifftIn, ifftOut, FFTW_BACKWARD, FFTW_ESTIMATE);
+}
+
+void Stitcher::process(const dsp::complex_t* const* inputs, dsp::complex_t* out) {
+    float scale = 1.0f / (float)_fftSize;
+    int half = _usableBins / 2;
+    memset(ifftIn, 0, outSize * sizeof(fftwf_complex));
+
+    for (int i = 0; i < _memberCount; i++) {
+        memcpy(fftIn, inputs[i], _fftSize * sizeof(fftwf_complex));
+        fftwf_execute(fwdPlan);
+
+        // Place the central bins of the member at its position in the output spectrum. The shift is an even
+        // number of bins, so the phase of the shifted signal stays continuous from one window to the next.
+        int shift = ((2 * i) - (_memberCount - 1)) * half;
+        for (int b = -half; b < half; b++) {
+            int src = (b + _fftSize) % _fftSize;
+            int dst = (b + shift + outSize) % outSize;
+            ifftIn[dst][0] = fftOut[src][0] * scale;
+            ifftIn[dst][1] = fftOut[src][1] * scale;
+        }
+    }
+
+    fftwf_execute(invPlan);
+
+    // Keep the middle half, the rest is corrupted by the circular convolution
+    memcpy(out, &ifftOut[outSize / 4], (outSize / 2) * sizeof(dsp::complex_t));
+}
+
+void Stitcher::free() {
+    if (fwdPlan) { fftwf_destroy_plan(fwdPlan); }
+    if (invPlan) { fftwf_destroy_plan(invPlan); }
+    if (fftIn) { fftwf_free(fftIn); }
+    if (fftOut) { fftwf_free(fftOut); }
+    if (ifftIn) { fftwf_free(ifftIn); }
+    if (ifftOut) { fftwf_free(ifftOut); }
+    fwdPlan = NULL;
+    invPlan = NULL;
+    fftIn = NULL;
+    fftOut = NULL;
+    ifftIn = NULL;
+    ifftOut = NULL;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <dsp/types.h>
+#include <fftw3.h>
+
+// Stitches the spectra of several receivers tuned to adjacent frequencies into a single wider baseband using
+// overlap-and-discard. Every call takes a window of fftSize samples from each member, half of them new, and
+// produces half an output window. Only the central bins of each member are kept, the edges where the
+// members overlap and their anti-aliasing filters roll off are discarded. The DC spike of each member is
+// in its central bins, so it is kept and shows up in the middle of its part of the span.
+class Stitcher {
+public:
+    Stitcher() {}
+    ~Stitcher();
+
+    /**
+     * Configure the stitcher.
+     * @param memberCount Number of members, ordered by increasing frequency.
+     * @param fftSize Size of the member windows, must be even.
+     * @param usableBins Number of central bins kept from each member, must be a multiple of 4.
+    */
+    void init(int memberCount, int fftSize, int usableBins);
+
+    // Number of new samples needed from each member per call
+    int getInputHop() { return _fftSize / 2; }
+
+    // Number of samples produced per call
+    int getOutputHop() { return outSize / 2; }
+
+    /**
+     * Stitch one window.
+     * @param inputs Window of fftSize samples of each member, the previous hop followed by the new one.
+     * @param out Output buffer of at least getOutputHop() samples.
+    */
+    void process(const dsp::complex_t* const* inputs, dsp::complex_t* out);
+
+private:
+    void free();
+
+    int _memberCount = 0;
+    int _fftSize = 0;
+    int _usableBins = 0;
+    int outSize = 0;
+
+    fftwf_complex* fftIn = NULL;
+    fftwf_complex* fftOut = NULL;
+    fftwf_complex* ifftIn = NULL;
+    fftwf_complex* ifftOut = NULL;
+    fftwf_plan fwdPlan = NULL;
+    fftwf_plan invPlan = NULL;
+};
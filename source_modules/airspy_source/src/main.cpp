@@ -348,7 +348,7 @@ private:
             if (_this->selectedSerStr != "") {
                 config.acquire();
                 config.conf["device"] = _this->selectedSerStr;
-                config.release(true);
+                config.releaseKey("device");
             }
         }
 
@@ -358,7 +358,7 @@ private:
             if (_this->selectedSerStr != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerStr]["sampleRate"] = _this->sampleRate;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -389,7 +389,7 @@ private:
             if (_this->selectedSerStr != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerStr]["gainMode"] = 0;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
         SmGui::NextColumn();
@@ -404,7 +404,7 @@ private:
             if (_this->selectedSerStr != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerStr]["gainMode"] = 1;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
         SmGui::NextColumn();
@@ -431,7 +431,7 @@ private:
             if (_this->selectedSerStr != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerStr]["gainMode"] = 2;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
         SmGui::Columns(1, CONCAT("EndAirspyGainModeColumns##_", _this->name), false);
@@ -449,7 +449,7 @@ private:
                 if (_this->selectedSerStr != "") {
                     config.acquire();
                     config.conf["devices"][_this->selectedSerStr]["sensitiveGain"] = _this->sensitiveGain;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
         }
@@ -463,7 +463,7 @@ private:
                 if (_this->selectedSerStr != "") {
                     config.acquire();
                     config.conf["devices"][_this->selectedSerStr]["linearGain"] = _this->linearGain;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
         }
@@ -479,7 +479,7 @@ private:
                 if (_this->selectedSerStr != "") {
                     config.acquire();
                     config.conf["devices"][_this->selectedSerStr]["lnaGain"] = _this->lnaGain;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
             if (_this->lnaAgc) { SmGui::EndDisabled(); }
@@ -494,7 +494,7 @@ private:
                 if (_this->selectedSerStr != "") {
                     config.acquire();
                     config.conf["devices"][_this->selectedSerStr]["mixerGain"] = _this->mixerGain;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
             if (_this->mixerAgc) { SmGui::EndDisabled(); }
@@ -508,7 +508,7 @@ private:
                 if (_this->selectedSerStr != "") {
                     config.acquire();
                     config.conf["devices"][_this->selectedSerStr]["vgaGain"] = _this->vgaGain;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
 
@@ -527,7 +527,7 @@ private:
                 if (_this->selectedSerStr != "") {
                     config.acquire();
                     config.conf["devices"][_this->selectedSerStr]["lnaAgc"] = _this->lnaAgc;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
             SmGui::ForceSync();
@@ -544,7 +544,7 @@ private:
                 if (_this->selectedSerStr != "") {
                     config.acquire();
                     config.conf["devices"][_this->selectedSerStr]["mixerAgc"] = _this->mixerAgc;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
         }
@@ -557,7 +557,7 @@ private:
             if (_this->selectedSerStr != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerStr]["biasT"] = _this->biasT;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
     }
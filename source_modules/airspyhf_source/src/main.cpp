@@ -302,7 +302,7 @@ private:
             if (_this->selectedSerStr != "") {
                 config.acquire();
                 config.conf["device"] = _this->selectedSerStr;
-                config.release(true);
+                config.releaseKey("device");
             }
         }
 
@@ -312,7 +312,7 @@ private:
             if (_this->selectedSerStr != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerStr]["sampleRate"] = _this->sampleRate;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -342,7 +342,7 @@ private:
             if (_this->selectedSerStr != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerStr]["agcMode"] = _this->agcMode;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -355,7 +355,7 @@ private:
             if (_this->selectedSerStr != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerStr]["attenuation"] = _this->atten;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -366,7 +366,7 @@ private:
             if (_this->selectedSerStr != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerStr]["lna"] = _this->hfLNA;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
     }
@@ -237,7 +237,7 @@ private:
             core::setInputSampleRate(_this->sampleRate);
             config.acquire();
             config.conf["device"] = dev;
-            config.release(true);
+            config.releaseKey("device");
         }
 
         if (SmGui::Combo(CONCAT("##_audio_sr_sel_", _this->name), &_this->srId, _this->sampleRates.txt)) {
@@ -246,7 +246,7 @@ private:
             if (!_this->selectedDevice.empty()) {
                 config.acquire();
                 config.conf["devices"][_this->selectedDevice]["sampleRate"] = _this->sampleRate;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -9,6 +9,7 @@
 #include <gui/widgets/stepped_slider.h>
 #include <libbladeRF.h>
 #include <gui/smgui.h>
+#include <dsp/convert/sample_format.h>
 #include <algorithm>
 #include <utils/optionlist.h>
 
@@ -270,7 +271,7 @@ public:
         else {
             bwId = 0;
         }
-        config.release(true);
+        config.releaseKey("devices");
 
         // Load clock source
         clkId = clocks.keyId("onboard");
@@ -451,7 +452,7 @@ private:
             core::setInputSampleRate(_this->sampleRate);
             config.acquire();
             config.conf["device"] = _this->selectedSerial;
-            config.release(true);
+            config.releaseKey("device");
         }
 
         if (SmGui::Combo(CONCAT("##_balderf_sr_sel_", _this->name), &_this->srId, _this->sampleRatesTxt.c_str())) {
@@ -460,7 +461,7 @@ private:
             if (_this->selectedSerial != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerial]["sampleRate"] = _this->sampleRates[_this->srId];
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -482,7 +483,7 @@ private:
             if (_this->selectedSerial != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerial]["channelId"] = _this->chanId;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -497,7 +498,7 @@ private:
             if (_this->selectedSerial != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerial]["bandwidth"] = _this->bwId;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -510,7 +511,7 @@ private:
             if (_this->selectedSerial != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerial]["clock"] = _this->clocks.key(_this->clkId);
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -529,7 +530,7 @@ private:
             if (_this->selectedSerial != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerial]["gainMode"] = _this->gainModeNames[_this->gainMode];
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -546,7 +547,7 @@ private:
             if (_this->selectedSerial != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerial]["overallGain"] = _this->overallGain;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
         if (_this->selectedSerial != "") {
@@ -560,7 +561,7 @@ private:
                 }
                 config.acquire();
                 config.conf["devices"][_this->selectedSerial]["biasT"] = _this->biasT;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
     }
@@ -584,7 +585,7 @@ private:
             if (ret != 0) { break; }
 
             // Convert to complex float and swap buffers
-            volk_16i_s32f_convert_32f((float*)stream.writeBuf, buffer, 32768.0f, bufferSize * 2);
+            dsp::convert::s16ToComplex(buffer, stream.writeBuf, bufferSize);
             if (!stream.swap(bufferSize)) { break; }
         }
 
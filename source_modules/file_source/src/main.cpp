@@ -5,11 +5,14 @@
 #include <gui/gui.h>
 #include <signal_path/signal_path.h>
 #include <wavreader.h>
+#include <utils/iqz.h>
 #include <core.h>
 #include <gui/widgets/file_select.h>
 #include <filesystem>
 #include <regex>
 #include <gui/tuner.h>
+#include <gui/style.h>
+#include <dsp/convert/sample_format.h>
 #include <algorithm>
 #include <stdexcept>
 
@@ -27,7 +30,7 @@ ConfigManager config;
 
 class FileSourceModule : public ModuleManager::Instance {
 public:
-    FileSourceModule(std::string name) : fileSelect("", { "Wav IQ Files (*.wav)", "*.wav", "All Files", "*" }) {
+    FileSourceModule(std::string name) : fileSelect("", { "IQ Files (*.wav *.iqz)", "*.wav *.iqz", "All Files", "*" }) {
         this->name = name;
 
         if (core::args["server"].b()) { return; }
@@ -90,6 +93,12 @@ private:
     static void start(void* ctx) {
         FileSourceModule* _this = (FileSourceModule*)ctx;
         if (_this->running) { return; }
+        if (_this->iqzReader.isOpen()) {
+            _this->running = true;
+            _this->workerThread = std::thread(iqzWorker, _this);
+            flog::info("FileSourceModule '{0}': Start!", _this->name);
+            return;
+        }
         if (_this->reader == NULL) { return; }
         _this->running = true;
         _this->workerThread = _this->float32Mode ? std::thread(floatWorker, _this) : std::thread(worker, _this);
@@ -99,12 +108,13 @@ private:
     static void stop(void* ctx) {
         FileSourceModule* _this = (FileSourceModule*)ctx;
         if (!_this->running) { return; }
-        if (_this->reader == NULL) { return; }
+        if (_this->reader == NULL && !_this->iqzReader.isOpen()) { return; }
         _this->stream.stopWriter();
         _this->workerThread.join();
         _this->stream.clearWriteStop();
         _this->running = false;
-        _this->reader->rewind();
+        if (_this->reader) { _this->reader->rewind(); }
+        if (_this->iqzReader.isOpen()) { _this->iqzReader.seek(0); }
         flog::info("FileSourceModule '{0}': Stop!", _this->name);
     }
 
@@ -121,16 +131,35 @@ private:
                 if (_this->reader != NULL) {
                     _this->reader->close();
                     delete _this->reader;
+                    _this->reader = NULL;
                 }
+                _this->iqzReader.close();
                 try {
-                    _this->reader = new WavReader(_this->fileSelect.path);
-                    if (_this->reader->getSampleRate() == 0) {
-                        _this->reader->close();
-                        delete _this->reader;
-                        _this->reader = NULL;
-                        throw std::runtime_error("Sample rate may not be zero");
+                    if (std::filesystem::path(_this->fileSelect.path).extension() == ".iqz") {
+                        // Compressed recordings go through the iqz reader
+                        if (!_this->iqzReader.open(_this->fileSelect.path)) {
+                            throw std::runtime_error("Could not open compressed IQ file");
+                        }
+                        if (_this->iqzReader.getChannels() != 2) {
+                            _this->iqzReader.close();
+                            throw std::runtime_error("Compressed file is not an IQ recording");
+                        }
+                        if (!_this->iqzReader.getSampleCount()) {
+                            _this->iqzReader.close();
+                            throw std::runtime_error("Compressed file is empty");
+                        }
+                        _this->sampleRate = _this->iqzReader.getSamplerate();
+                    }
+                    else {
+                        _this->reader = new WavReader(_this->fileSelect.path);
+                        if (_this->reader->getSampleRate() == 0) {
+                            _this->reader->close();
+                            delete _this->reader;
+                            _this->reader = NULL;
+                            throw std::runtime_error("Sample rate may not be zero");
+                        }
+                        _this->sampleRate = _this->reader->getSampleRate();
                     }
-                    _this->sampleRate = _this->reader->getSampleRate();
                     core::setInputSampleRate(_this->sampleRate);
                     std::string filename = std::filesystem::path(_this->fileSelect.path).filename().string();
                     _this->centerFreq = _this->getFrequency(filename);
@@ -144,11 +173,23 @@ private:
                 }
                 config.acquire();
                 config.conf["path"] = _this->fileSelect.path;
-                config.release(true);
+                config.releaseKey("path");
             }
         }
 
-        ImGui::Checkbox("Float32 Mode##_file_source", &_this->float32Mode);
+        if (_this->iqzReader.isOpen()) {
+            // Compressed files are indexed, so they can be seeked
+            float duration = (double)_this->iqzReader.getSampleCount() / _this->sampleRate;
+            float pos = (double)_this->iqzReader.tell() / _this->sampleRate;
+            ImGui::LeftLabel("Position");
+            ImGui::FillWidth();
+            if (ImGui::SliderFloat("##_file_source_pos", &pos, 0.0f, duration, "%.1fs")) {
+                _this->iqzReader.seek(pos * _this->sampleRate);
+            }
+        }
+        else {
+            ImGui::Checkbox("Float32 Mode##_file_source", &_this->float32Mode);
+        }
     }
 
     static void worker(void* ctx) {
@@ -159,7 +200,7 @@ private:
 
         while (true) {
             _this->reader->readSamples(inBuf, blockSize * 2 * sizeof(int16_t));
-            volk_16i_s32f_convert_32f((float*)_this->stream.writeBuf, inBuf, 32768.0f, blockSize * 2);
+            dsp::convert::s16ToComplex(inBuf, _this->stream.writeBuf, blockSize);
             if (!_this->stream.swap(blockSize)) { break; };
         }
 
@@ -180,6 +221,29 @@ private:
         delete[] inBuf;
     }
 
+    static void iqzWorker(void* ctx) {
+        FileSourceModule* _this = (FileSourceModule*)ctx;
+        double sampleRate = std::max<double>(_this->iqzReader.getSamplerate(), 1.0);
+        int blockSize = std::min((int)(sampleRate / 200.0f), (int)STREAM_BUFFER_SIZE);
+
+        while (true) {
+            // Loop back to the start at the end of the file, like with wav files
+            float* buf = (float*)_this->stream.writeBuf;
+            int read = _this->iqzReader.read(buf, blockSize);
+            if (read < blockSize) {
+                _this->iqzReader.seek(0);
+                read += _this->iqzReader.read(&buf[read * 2], blockSize - read);
+            }
+
+            // Nothing could be read even from the start, give up instead of spinning
+            if (!read) {
+                flog::error("FileSourceModule '{0}': Could not read from the compressed file", _this->name);
+                break;
+            }
+            if (!_this->stream.swap(read)) { break; };
+        }
+    }
+
     double getFrequency(std::string filename) {
         std::regex expr("[0-9]+Hz");
         std::smatch matches;
@@ -194,6 +258,7 @@ private:
     dsp::stream<dsp::complex_t> stream;
     SourceManager::SourceHandler handler;
     WavReader* reader = NULL;
+    iqz::Reader iqzReader;
     bool running = false;
     bool enabled = true;
     float sampleRate = 1000000;
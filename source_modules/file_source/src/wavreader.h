@@ -4,22 +4,56 @@
 #include <stdint.h>
 #include <string.h>
 #include <fstream>
+#include <algorithm>
 
 #define WAV_SIGNATURE       "RIFF"
 #define WAV_TYPE            "WAVE"
 #define WAV_FORMAT_MARK     "fmt "
 #define WAV_DATA_MARK       "data"
+#define WAV_DS64_MARK       "ds64"
+#define WAV_RF64_SIGNATURE  "RF64"
 #define WAV_SAMPLE_TYPE_PCM 1
 
 class WavReader {
 public:
     WavReader(std::string path) {
         file = std::ifstream(path.c_str(), std::ios::binary);
-        file.read((char*)&hdr, sizeof(WavHeader_t));
         valid = false;
-        if (memcmp(hdr.signature, "RIFF", 4) != 0) { return; }
-        if (memcmp(hdr.fileType, "WAVE", 4) != 0) { return; }
-        valid = true;
+
+        // Check the RIFF header, RF64 files use the same layout with a ds64 chunk
+        RIFFHeader_t riff;
+        file.read((char*)&riff, sizeof(RIFFHeader_t));
+        if (!file) { return; }
+        bool rf64 = !memcmp(riff.signature, WAV_RF64_SIGNATURE, 4);
+        if (memcmp(riff.signature, WAV_SIGNATURE, 4) && !rf64) { return; }
+        if (memcmp(riff.fileType, WAV_TYPE, 4) != 0) { return; }
+
+        // Walk the chunks until the data chunk is found
+        uint64_t ds64DataSize = 0;
+        bool gotFormat = false;
+        while (true) {
+            ChunkHeader_t chunk;
+            file.read((char*)&chunk, sizeof(ChunkHeader_t));
+            if (!file) { return; }
+            uint64_t next = (uint64_t)file.tellg() + chunk.size + (chunk.size & 1);
+
+            if (!memcmp(chunk.id, WAV_DS64_MARK, 4)) {
+                uint64_t sizes[2];
+                file.read((char*)sizes, sizeof(sizes));
+                ds64DataSize = sizes[1];
+            }
+            else if (!memcmp(chunk.id, WAV_FORMAT_MARK, 4)) {
+                file.read((char*)&hdr, sizeof(FormatHeader_t));
+                gotFormat = true;
+            }
+            else if (!memcmp(chunk.id, WAV_DATA_MARK, 4)) {
+                dataStart = file.tellg();
+                dataSize = (rf64 && chunk.size == 0xFFFFFFFF) ? ds64DataSize : chunk.size;
+                break;
+            }
+            file.seekg(next);
+        }
+        valid = gotFormat;
     }
 
     uint16_t getBitDepth() {
@@ -40,18 +74,32 @@ public:
 
     void readSamples(void* data, size_t size) {
         char* _data = (char*)data;
-        file.read(_data, size);
-        int read = file.gcount();
-        if (read < size) {
-            file.clear();
-            file.seekg(sizeof(WavHeader_t));
-            file.read(&_data[read], size - read);
+        size_t done = 0;
+        while (done < size) {
+            // Nothing left to loop over
+            if (!dataSize) {
+                memset(&_data[done], 0, size - done);
+                break;
+            }
+
+            // Loop at the end of the data chunk, other chunks may follow it
+            if (dataPos >= dataSize) { rewind(); }
+            size_t toRead = std::min<uint64_t>(size - done, dataSize - dataPos);
+            file.read(&_data[done], toRead);
+            size_t read = file.gcount();
+            dataPos += read;
+            done += read;
+
+            // The file is shorter than its header says, loop at its actual end instead
+            if (read < toRead) { dataSize = dataPos; }
         }
         bytesRead += size;
     }
 
     void rewind() {
-        file.seekg(sizeof(WavHeader_t));
+        file.clear();
+        file.seekg(dataStart);
+        dataPos = 0;
     }
 
     void close() {
@@ -59,24 +107,31 @@ public:
     }
 
 private:
-    struct WavHeader_t {
-        char signature[4];           // "RIFF"
-        uint32_t fileSize;           // data bytes + sizeof(WavHeader_t) - 8
+    struct RIFFHeader_t {
+        char signature[4];           // "RIFF" or "RF64"
+        uint32_t fileSize;           // file size - 8
         char fileType[4];            // "WAVE"
-        char formatMarker[4];        // "fmt "
-        uint32_t formatHeaderLength; // Always 16
+    };
+
+    struct ChunkHeader_t {
+        char id[4];
+        uint32_t size;
+    };
+
+    struct FormatHeader_t {
         uint16_t sampleType;         // PCM (1)
         uint16_t channelCount;
         uint32_t sampleRate;
         uint32_t bytesPerSecond;
         uint16_t bytesPerSample;
         uint16_t bitDepth;
-        char dataMarker[4]; // "data"
-        uint32_t dataSize;
     };
 
     bool valid = false;
     std::ifstream file;
     size_t bytesRead = 0;
-    WavHeader_t hdr;
+    FormatHeader_t hdr = {};
+    uint64_t dataStart = 0;
+    uint64_t dataSize = 0;
+    uint64_t dataPos = 0;
 };
\ No newline at end of file
@@ -372,7 +372,7 @@ private:
             core::setInputSampleRate(_this->sampleRate);
             config.acquire();
             config.conf["device"] = _this->selectedSerial;
-            config.release(true);
+            config.releaseKey("device");
         }
 
         if (SmGui::Combo(CONCAT("##_fobossdr_sr_sel_", _this->name), &_this->srId, _this->samplerates.txt)) {
@@ -381,7 +381,7 @@ private:
             if (!_this->selectedSerial.empty()) {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerial]["samplerate"] = _this->samplerates.key(_this->srId);
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -400,7 +400,7 @@ private:
             if (!_this->selectedSerial.empty()) {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerial]["port"] = _this->ports.key(_this->portId);
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -415,7 +415,7 @@ private:
             if (!_this->selectedSerial.empty()) {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerial]["clkSrc"] = _this->clockSources.key(_this->clkSrcId);
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -429,7 +429,7 @@ private:
                 if (!_this->selectedSerial.empty()) {
                     config.acquire();
                     config.conf["devices"][_this->selectedSerial]["lnaGain"] = _this->lnaGain;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
 
@@ -442,7 +442,7 @@ private:
                 if (!_this->selectedSerial.empty()) {
                     config.acquire();
                     config.conf["devices"][_this->selectedSerial]["vgaGain"] = _this->vgaGain;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
         }
@@ -7,6 +7,7 @@
 #include <config.h>
 #include <gui/widgets/stepped_slider.h>
 #include <gui/smgui.h>
+#include <dsp/convert/sample_format.h>
 
 #ifndef __ANDROID__
 #include <libhackrf/hackrf.h>
@@ -307,7 +308,7 @@ private:
             core::setInputSampleRate(_this->sampleRate);
             config.acquire();
             config.conf["device"] = _this->selectedSerial;
-            config.release(true);
+            config.releaseKey("device");
         }
 
         if (SmGui::Combo(CONCAT("##_hackrf_sr_sel_", _this->name), &_this->srId, sampleRatesTxt)) {
@@ -315,7 +316,7 @@ private:
             core::setInputSampleRate(_this->sampleRate);
             config.acquire();
             config.conf["devices"][_this->selectedSerial]["sampleRate"] = _this->sampleRate;
-            config.release(true);
+            config.releaseKey("devices");
         }
 
         SmGui::SameLine();
@@ -337,7 +338,7 @@ private:
             }
             config.acquire();
             config.conf["devices"][_this->selectedSerial]["bandwidth"] = _this->bwId;
-            config.release(true);
+            config.releaseKey("devices");
         }
 
         SmGui::LeftLabel("LNA Gain");
@@ -348,7 +349,7 @@ private:
             }
             config.acquire();
             config.conf["devices"][_this->selectedSerial]["lnaGain"] = (int)_this->lna;
-            config.release(true);
+            config.releaseKey("devices");
         }
 
         SmGui::LeftLabel("VGA Gain");
@@ -359,7 +360,7 @@ private:
             }
             config.acquire();
             config.conf["devices"][_this->selectedSerial]["vgaGain"] = (int)_this->vga;
-            config.release(true);
+            config.releaseKey("devices");
         }
 
         if (SmGui::Checkbox(CONCAT("Bias-T##_hackrf_bt_", _this->name), &_this->biasT)) {
@@ -368,7 +369,7 @@ private:
             }
             config.acquire();
             config.conf["devices"][_this->selectedSerial]["biasT"] = _this->biasT;
-            config.release(true);
+            config.releaseKey("devices");
         }
 
         if (SmGui::Checkbox(CONCAT("Amp Enabled##_hackrf_amp_", _this->name), &_this->amp)) {
@@ -377,13 +378,13 @@ private:
             }
             config.acquire();
             config.conf["devices"][_this->selectedSerial]["amp"] = _this->amp;
-            config.release(true);
+            config.releaseKey("devices");
         }
     }
 
     static int callback(hackrf_transfer* transfer) {
         HackRFSourceModule* _this = (HackRFSourceModule*)transfer->rx_ctx;
-        volk_8i_s32f_convert_32f((float*)_this->stream.writeBuf, (int8_t*)transfer->buffer, 128.0f, transfer->valid_length);
+        dsp::convert::s8ToComplex((int8_t*)transfer->buffer, _this->stream.writeBuf, transfer->valid_length / 2);
         if (!_this->stream.swap(transfer->valid_length / 2)) { return -1; }
         return 0;
     }
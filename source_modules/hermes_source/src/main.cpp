@@ -202,7 +202,7 @@ private:
             if (!_this->selectedMac.empty()) {
                 config.acquire();
                 config.conf["device"] = _this->devices.key(_this->devId);
-                config.release(true);
+                config.releaseKey("device");
             }
         }
 
@@ -212,7 +212,7 @@ private:
             if (!_this->selectedMac.empty()) {
                 config.acquire();
                 config.conf["devices"][_this->selectedMac]["samplerate"] = _this->samplerates.key(_this->srId);
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -241,7 +241,7 @@ private:
             if (!_this->selectedMac.empty()) {
                 config.acquire();
                 config.conf["devices"][_this->selectedMac]["gain"] = _this->gain;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
     }
@@ -343,7 +343,7 @@ private:
             if (_this->selectedSerStr != "") {
                 config.acquire();
                 config.conf["device"] = _this->selectedSerStr;
-                config.release(true);
+                config.releaseKey("device");
             }
         }
 
@@ -353,7 +353,7 @@ private:
             if (_this->selectedSerStr != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerStr]["sampleRate"] = _this->samplerates.key(_this->srId);
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -380,7 +380,7 @@ private:
             if (_this->selectedSerStr != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerStr]["port"] = _this->ports.key(_this->portId);
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -397,7 +397,7 @@ private:
             if (_this->selectedSerStr != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerStr]["gainMode"] = 0;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
         SmGui::NextColumn();
@@ -412,7 +412,7 @@ private:
             if (_this->selectedSerStr != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerStr]["gainMode"] = 1;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
         SmGui::NextColumn();
@@ -439,7 +439,7 @@ private:
             if (_this->selectedSerStr != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerStr]["gainMode"] = 2;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
         SmGui::Columns(1, CONCAT("EndHydraSDRGainModeColumns##_", _this->name), false);
@@ -457,7 +457,7 @@ private:
                 if (_this->selectedSerStr != "") {
                     config.acquire();
                     config.conf["devices"][_this->selectedSerStr]["sensitiveGain"] = _this->sensitiveGain;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
         }
@@ -471,7 +471,7 @@ private:
                 if (_this->selectedSerStr != "") {
                     config.acquire();
                     config.conf["devices"][_this->selectedSerStr]["linearGain"] = _this->linearGain;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
         }
@@ -487,7 +487,7 @@ private:
                 if (_this->selectedSerStr != "") {
                     config.acquire();
                     config.conf["devices"][_this->selectedSerStr]["lnaGain"] = _this->lnaGain;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
             if (_this->lnaAgc) { SmGui::EndDisabled(); }
@@ -502,7 +502,7 @@ private:
                 if (_this->selectedSerStr != "") {
                     config.acquire();
                     config.conf["devices"][_this->selectedSerStr]["mixerGain"] = _this->mixerGain;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
             if (_this->mixerAgc) { SmGui::EndDisabled(); }
@@ -516,7 +516,7 @@ private:
                 if (_this->selectedSerStr != "") {
                     config.acquire();
                     config.conf["devices"][_this->selectedSerStr]["vgaGain"] = _this->vgaGain;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
 
@@ -535,7 +535,7 @@ private:
                 if (_this->selectedSerStr != "") {
                     config.acquire();
                     config.conf["devices"][_this->selectedSerStr]["lnaAgc"] = _this->lnaAgc;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
             SmGui::ForceSync();
@@ -552,7 +552,7 @@ private:
                 if (_this->selectedSerStr != "") {
                     config.acquire();
                     config.conf["devices"][_this->selectedSerStr]["mixerAgc"] = _this->mixerAgc;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
         }
@@ -565,7 +565,7 @@ private:
             if (_this->selectedSerStr != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerStr]["biasT"] = _this->biasT;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
     }
@@ -275,7 +275,7 @@ public:
             gain = 0;
         }
 
-        config.release(true);
+        config.releaseKey("devices");
 
         LMS_Close(dev);
     }
@@ -404,7 +404,7 @@ private:
             core::setInputSampleRate(_this->sampleRate);
             config.acquire();
             config.conf["device"] = _this->selectedDevName;
-            config.release(true);
+            config.releaseKey("device");
         }
 
         if (SmGui::Combo(CONCAT("##_limesdr_sr_sel_", _this->name), &_this->srId, _this->sampleRatesTxt.c_str())) {
@@ -413,7 +413,7 @@ private:
             if (_this->selectedDevName != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedDevName]["sampleRate"] = _this->sampleRates[_this->srId];
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -433,7 +433,7 @@ private:
             if (SmGui::Combo("##limesdr_ch_sel", &_this->chanId, _this->channelNamesTxt.c_str()) && _this->selectedDevName != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedDevName]["channel"] = _this->chanId;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -448,7 +448,7 @@ private:
             if (_this->selectedDevName != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedDevName]["antenna"] = _this->antennaNameList[_this->antennaId];
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -461,7 +461,7 @@ private:
             if (_this->selectedDevName != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedDevName]["bandwidth"] = _this->bwId;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -474,7 +474,7 @@ private:
             if (_this->selectedDevName != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedDevName]["gain"] = _this->gain;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
     }
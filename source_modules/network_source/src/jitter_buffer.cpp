@@ -0,0 +1,180 @@
+#include "jitter_buffer.h"
+#include <dsp/convert/sample_format.h>
+#include <string.h>
+
+void JitterBuffer::init(int slotCount, int latency, int maxGap) {
+    slots.clear();
+    slots.resize(slotCount);
+    _latency = latency;
+    _maxGap = maxGap;
+    reset();
+}
+
+void JitterBuffer::reset() {
+    for (auto& slot : slots) {
+        slot.valid = false;
+        slot.played = false;
+    }
+    started = false;
+    readOffset = 0;
+    pendingZeros = 0;
+    received = 0;
+    lost = 0;
+    late = 0;
+    duplicates = 0;
+    reordered = 0;
+    invalid = 0;
+    zeroFilled = 0;
+    discontinuities = 0;
+}
+
+bool JitterBuffer::push(const uint8_t* data, int len) {
+    // Check the header
+    IQPacketHeader hdr;
+    if (len < sizeof(IQPacketHeader)) {
+        invalid++;
+        return false;
+    }
+    memcpy(&hdr, data, sizeof(IQPacketHeader));
+    int sampSize = iqPacketSampleSize(hdr.sampleType);
+    if (hdr.magic != IQ_PACKET_MAGIC || hdr.version != IQ_PACKET_VERSION || !sampSize ||
+        hdr.headerSize < sizeof(IQPacketHeader) || hdr.headerSize > len ||
+        hdr.sampleCount > (len - hdr.headerSize) / sampSize) {
+        invalid++;
+        return false;
+    }
+
+    // Start on the first packet
+    if (!started) { restart(hdr); }
+
+    int slotCount = slots.size();
+    int32_t diff = (int32_t)(hdr.sequence - nextSeq);
+    if (diff < 0) {
+        // A packet that's slightly late was either already played or given up on, one from long ago means the
+        // sender restarted
+        if (diff >= -slotCount) {
+            const Slot& old = slots[hdr.sequence % slotCount];
+            if (old.played && old.sequence == hdr.sequence) { duplicates++; }
+            else { late++; }
+            return true;
+        }
+        restart(hdr);
+    }
+    else if (diff >= slotCount) {
+        // Too far ahead to be queued, most likely after an outage
+        lost += diff;
+        restart(hdr);
+    }
+
+    // Store the packet
+    Slot& slot = slots[hdr.sequence % slotCount];
+    if (slot.valid && slot.sequence == hdr.sequence) {
+        duplicates++;
+        return true;
+    }
+    slot.valid = true;
+    slot.played = false;
+    slot.sequence = hdr.sequence;
+    slot.timestamp = hdr.timestamp;
+    slot.sampleCount = hdr.sampleCount;
+    slot.sampleType = hdr.sampleType;
+    slot.data.assign(&data[hdr.headerSize], &data[hdr.headerSize + (hdr.sampleCount * sampSize)]);
+
+    // Keep track of the newest data
+    if ((int32_t)(hdr.sequence - highestSeq) > 0) {
+        highestSeq = hdr.sequence;
+    }
+    else if (hdr.sequence != highestSeq) {
+        reordered++;
+    }
+    uint64_t end = hdr.timestamp + hdr.sampleCount;
+    if ((int64_t)(end - newestEnd) > 0) { newestEnd = end; }
+
+    received++;
+    return true;
+}
+
+int JitterBuffer::pop(dsp::complex_t* out, int maxCount) {
+    int slotCount = slots.size();
+    int outCount = 0;
+    while (outCount < maxCount) {
+        // Zeros standing in for lost samples come first
+        if (pendingZeros) {
+            int count = std::min<int64_t>(pendingZeros, maxCount - outCount);
+            memset(&out[outCount], 0, count * sizeof(dsp::complex_t));
+            outCount += count;
+            pendingZeros -= count;
+            zeroFilled += count;
+            continue;
+        }
+        if (!started) { break; }
+
+        // If the next packet is missing, wait for it unless too much is queued behind it
+        Slot& slot = slots[nextSeq % slotCount];
+        if (!slot.valid || slot.sequence != nextSeq) {
+            bool slotsFull = ((int32_t)(highestSeq - nextSeq) >= slotCount - 1);
+            bool latencyExceeded = ((int64_t)(newestEnd - nextTs) > _latency);
+            if (!slotsFull && !latencyExceeded) { break; }
+            lost++;
+            nextSeq++;
+            continue;
+        }
+
+        // Fill the gap left by lost packets, the timestamps tell how many samples are missing
+        if (!readOffset && slot.timestamp != nextTs) {
+            int64_t gap = (int64_t)(slot.timestamp - nextTs);
+            if (gap <= 0 || gap > _maxGap) { discontinuities++; }
+            else { pendingZeros = gap; }
+            nextTs = slot.timestamp;
+            continue;
+        }
+
+        // Output as much of the packet as possible
+        int count = std::min<int>(slot.sampleCount - readOffset, maxCount - outCount);
+        convert(slot, readOffset, count, &out[outCount]);
+        outCount += count;
+        readOffset += count;
+        nextTs += count;
+        if (readOffset >= slot.sampleCount) {
+            slot.valid = false;
+            slot.played = true;
+            readOffset = 0;
+            nextSeq++;
+        }
+    }
+    return outCount;
+}
+
+void JitterBuffer::restart(const IQPacketHeader& hdr) {
+    if (started) { discontinuities++; }
+    for (auto& slot : slots) {
+        slot.valid = false;
+        slot.played = false;
+    }
+    nextSeq = hdr.sequence;
+    highestSeq = hdr.sequence;
+    nextTs = hdr.timestamp;
+    newestEnd = hdr.timestamp;
+    readOffset = 0;
+    started = true;
+}
+
+void JitterBuffer::convert(const Slot& slot, int offset, int count, dsp::complex_t* out) {
+    const uint8_t* in = &slot.data[offset * iqPacketSampleSize(slot.sampleType)];
+    switch (slot.sampleType) {
+    case IQ_PACKET_SAMPLE_TYPE_INT8:
+        dsp::convert::s8ToComplex((const int8_t*)in, out, count);
+        break;
+    case IQ_PACKET_SAMPLE_TYPE_INT16:
+        dsp::convert::s16ToComplex((const int16_t*)in, out, count);
+        break;
+    case IQ_PACKET_SAMPLE_TYPE_INT32:
+        dsp::convert::s32ToComplex((const int32_t*)in, out, count);
+        break;
+    case IQ_PACKET_SAMPLE_TYPE_FLOAT32:
+        memcpy(out, in, count * sizeof(dsp::complex_t));
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <dsp/types.h>
+#include <utils/iq_packet.h>
+#include <vector>
+#include <atomic>
+
+// Puts sequenced IQ packets back in order and fills the samples of lost packets with zeros so that the output
+// keeps its timing. A missing packet is waited for until the data queued behind it exceeds the latency.
+class JitterBuffer {
+public:
+    JitterBuffer() {}
+
+    /**
+     * Configure the buffer, this also resets it.
+     * @param slotCount Maximum number of packets held.
+     * @param latency Maximum number of samples queued behind a missing packet before it's given up on.
+     * @param maxGap Largest gap in samples that gets zero-filled, bigger jumps are treated as a restart of the stream.
+    */
+    void init(int slotCount, int latency, int maxGap);
+
+    // Drop all queued packets and clear the counters
+    void reset();
+
+    /**
+     * Queue a datagram.
+     * @param data Datagram, starting with an IQPacketHeader.
+     * @param len Length of the datagram in bytes.
+     * @return False if the datagram isn't a valid packet.
+    */
+    bool push(const uint8_t* data, int len);
+
+    /**
+     * Take the samples that are ready, in order.
+     * @param out Output buffer.
+     * @param maxCount Maximum number of samples to output.
+     * @return Number of samples written, 0 if nothing is ready.
+    */
+    int pop(dsp::complex_t* out, int maxCount);
+
+    std::atomic<uint64_t> received = 0;
+    std::atomic<uint64_t> lost = 0;
+    std::atomic<uint64_t> late = 0;
+    std::atomic<uint64_t> duplicates = 0;
+    std::atomic<uint64_t> reordered = 0;
+    std::atomic<uint64_t> invalid = 0;
+    std::atomic<uint64_t> zeroFilled = 0;
+    std::atomic<uint64_t> discontinuities = 0;
+
+private:
+    struct Slot {
+        bool valid = false;
+        bool played = false;    // The packet was output and its sequence number is kept to spot duplicates
+        uint32_t sequence;
+        uint64_t timestamp;
+        int sampleCount;
+        uint8_t sampleType;
+        std::vector<uint8_t> data;
+    };
+
+    void restart(const IQPacketHeader& hdr);
+    void convert(const Slot& slot, int offset, int count, dsp::complex_t* out);
+
+    std::vector<Slot> slots;
+    int _latency = 0;
+    int _maxGap = 0;
+
+    bool started = false;
+    uint32_t nextSeq = 0;
+    uint32_t highestSeq = 0;
+    uint64_t nextTs = 0;
+    uint64_t newestEnd = 0;
+    int readOffset = 0;
+    int64_t pendingZeros = 0;
+};
@@ -9,9 +9,15 @@
 #include <gui/smgui.h>
 #include <gui/widgets/stepped_slider.h>
 #include <utils/optionlist.h>
+#include <dsp/convert/sample_format.h>
+#include "jitter_buffer.h"
 
 #define CONCAT(a, b) ((std::string(a) + b).c_str())
 
+#define UDP_RECV_BUFFER_SIZE    (16 * 1024 * 1024)
+#define SEQ_MAX_DATAGRAM_SIZE   65536
+#define SEQ_SLOT_COUNT          1024
+
 SDRPP_MOD_INFO{
     /* Name:            */ "network_source",
     /* Description:     */ "UDP/TCP Source Module",
@@ -25,7 +31,8 @@ ConfigManager config;
 enum Protocol {
     PROTOCOL_TCP_SERVER,
     PROTOCOL_TCP_CLIENT,
-    PROTOCOL_UDP
+    PROTOCOL_UDP,
+    PROTOCOL_UDP_SEQ
 };
 
 enum SampleType {
@@ -62,6 +69,7 @@ public:
         // protocols.define("TCP (Server)", PROTOCOL_TCP_SERVER);
         protocols.define("TCP (Client)", PROTOCOL_TCP_CLIENT);
         protocols.define("UDP", PROTOCOL_UDP);
+        protocols.define("UDP (Sequenced)", PROTOCOL_UDP_SEQ);
 
         // Define sample types
         sampleTypes.define("Int8", SAMPLE_TYPE_INT8);
@@ -91,6 +99,10 @@ public:
             port = config.conf[name]["port"];
             port = std::clamp<int>(port, 1, 65535);
         }
+        if (config.conf[name].contains("jitterBuffer")) {
+            jitterMs = config.conf[name]["jitterBuffer"];
+            jitterMs = std::clamp<int>(jitterMs, 1, 1000);
+        }
         config.release();
 
         // Set menu IDs
@@ -162,9 +174,12 @@ private:
                 // Connect to TCP server
                 _this->sock = net::connect(_this->hostname, _this->port);
             }
-            else if (_this->proto == PROTOCOL_UDP) {
-                // Open UDP socket
+            else if (_this->proto == PROTOCOL_UDP || _this->proto == PROTOCOL_UDP_SEQ) {
+                // Open UDP socket with a large kernel buffer to absorb scheduling hiccups at high rates
                 _this->sock = net::openudp("0.0.0.0", _this->port, _this->hostname, _this->port, true);
+                if (!_this->sock->setRecvBufferSize(UDP_RECV_BUFFER_SIZE)) {
+                    flog::warn("Could not set the UDP receive buffer size");
+                }
             }
         }
         catch (const std::exception& e) {
@@ -173,7 +188,14 @@ private:
         }
 
         // Start receive worker
-        _this->workerThread = std::thread(&NetworkSourceModule::worker, _this);
+        if (_this->proto == PROTOCOL_UDP_SEQ) {
+            // Give up on lost packets after the jitter buffer time, and zero-fill gaps up to a second
+            _this->jbuf.init(SEQ_SLOT_COUNT, (_this->samplerate * _this->jitterMs) / 1000, _this->samplerate);
+            _this->workerThread = std::thread(&NetworkSourceModule::seqWorker, _this);
+        }
+        else {
+            _this->workerThread = std::thread(&NetworkSourceModule::worker, _this);
+        }
 
         _this->running = true;
         flog::info("NetworkSourceModule '{0}': Start!", _this->name);
@@ -216,7 +238,7 @@ private:
         if (SmGui::InputText(("##network_source_host_" + _this->name).c_str(), _this->hostname, sizeof(_this->hostname))) {
             config.acquire();
             config.conf[_this->name]["host"] = _this->hostname;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
         SmGui::SameLine();
         SmGui::FillWidth();
@@ -224,7 +246,7 @@ private:
             _this->port = std::clamp<int>(_this->port, 1, 65535);
             config.acquire();
             config.conf[_this->name]["port"] = _this->port;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
 
         // Mode protocol selector
@@ -234,17 +256,30 @@ private:
             _this->proto = _this->protocols.value(_this->protoId);
             config.acquire();
             config.conf[_this->name]["protocol"] = _this->protocols.key(_this->protoId);
-            config.release(true);
+            config.releaseKey(_this->name);
         }
 
-        // Sample type selector
-        SmGui::LeftLabel("Sample type");
-        SmGui::FillWidth();
-        if (SmGui::Combo(("##network_source_samp_" + _this->name).c_str(), &_this->sampTypeId, _this->sampleTypes.txt)) {
-            _this->sampType = _this->sampleTypes.value(_this->sampTypeId);
-            config.acquire();
-            config.conf[_this->name]["sampleType"] = _this->sampleTypes.key(_this->sampTypeId);
-            config.release(true);
+        if (_this->proto == PROTOCOL_UDP_SEQ) {
+            // The sample type is given by the packets, only the jitter buffer needs to be set
+            SmGui::LeftLabel("Jitter buffer (ms)");
+            SmGui::FillWidth();
+            if (SmGui::InputInt(("##network_source_jitter_" + _this->name).c_str(), &_this->jitterMs, 1, 10)) {
+                _this->jitterMs = std::clamp<int>(_this->jitterMs, 1, 1000);
+                config.acquire();
+                config.conf[_this->name]["jitterBuffer"] = _this->jitterMs;
+                config.releaseKey(_this->name);
+            }
+        }
+        else {
+            // Sample type selector
+            SmGui::LeftLabel("Sample type");
+            SmGui::FillWidth();
+            if (SmGui::Combo(("##network_source_samp_" + _this->name).c_str(), &_this->sampTypeId, _this->sampleTypes.txt)) {
+                _this->sampType = _this->sampleTypes.value(_this->sampTypeId);
+                config.acquire();
+                config.conf[_this->name]["sampleType"] = _this->sampleTypes.key(_this->sampTypeId);
+                config.releaseKey(_this->name);
+            }
         }
 
         // Samplerate selector
@@ -262,7 +297,7 @@ private:
             core::setInputSampleRate(_this->samplerate);
             config.acquire();
             config.conf[_this->name]["samplerate"] = _this->samplerate;
-            config.release(true);
+            config.releaseKey(_this->name);
         }
         if (!applyEn) { SmGui::EndDisabled(); }
 
@@ -271,6 +306,21 @@ private:
         }
 
         if (_this->running) { SmGui::EndDisabled(); }
+
+        // Packet statistics
+        if (_this->running && _this->proto == PROTOCOL_UDP_SEQ) {
+            char buf[128];
+            sprintf(buf, "Packets: %llu received, %llu lost", (unsigned long long)_this->jbuf.received, (unsigned long long)_this->jbuf.lost);
+            SmGui::Text(buf);
+            sprintf(buf, "Late: %llu, Duplicates: %llu, Reordered: %llu", (unsigned long long)_this->jbuf.late, (unsigned long long)_this->jbuf.duplicates, (unsigned long long)_this->jbuf.reordered);
+            SmGui::Text(buf);
+            sprintf(buf, "Zero-filled: %llu samples", (unsigned long long)_this->jbuf.zeroFilled);
+            SmGui::Text(buf);
+            if (_this->jbuf.invalid || _this->jbuf.discontinuities) {
+                sprintf(buf, "Invalid: %llu, Resyncs: %llu", (unsigned long long)_this->jbuf.invalid, (unsigned long long)_this->jbuf.discontinuities);
+                SmGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), buf);
+            }
+        }
     }
 
     void worker() {
@@ -294,13 +344,13 @@ private:
             int count = bytes / sampleSize;
             switch (sampType) {
             case SAMPLE_TYPE_INT8:
-                volk_8i_s32f_convert_32f((float*)stream.writeBuf, (int8_t*)buffer, 128.0f, count*2);
+                dsp::convert::s8ToComplex((int8_t*)buffer, stream.writeBuf, count);
                 break;
             case SAMPLE_TYPE_INT16:
-                volk_16i_s32f_convert_32f((float*)stream.writeBuf, (int16_t*)buffer, 32768.0f, count*2);
+                dsp::convert::s16ToComplex((int16_t*)buffer, stream.writeBuf, count);
                 break;
             case SAMPLE_TYPE_INT32:
-                volk_32i_s32f_convert_32f((float*)stream.writeBuf, (int32_t*)buffer, 2147483647.0f, count*2);
+                dsp::convert::s32ToComplex((int32_t*)buffer, stream.writeBuf, count);
                 break;
             case SAMPLE_TYPE_FLOAT32:
                 memcpy(stream.writeBuf, buffer, bytes);
@@ -317,6 +367,38 @@ private:
         dsp::buffer::free(buffer);
     }
 
+    void seqWorker() {
+        // Allocate a receive slot for every datagram of a batch
+        uint8_t* buffer = dsp::buffer::alloc<uint8_t>(SEQ_MAX_DATAGRAM_SIZE * NET_MAX_RECV_BATCH);
+        int lens[NET_MAX_RECV_BATCH];
+
+        bool run = true;
+        while (run) {
+            // Receive all datagrams waiting in the kernel buffer
+            int count = sock->recvmulti(buffer, SEQ_MAX_DATAGRAM_SIZE, NET_MAX_RECV_BATCH, lens);
+            if (count < 0 && sock->isOpen()) { continue; }
+            if (count <= 0) { break; }
+
+            // Put them back in order
+            for (int i = 0; i < count; i++) {
+                jbuf.push(&buffer[i * SEQ_MAX_DATAGRAM_SIZE], lens[i]);
+            }
+
+            // Send out all samples that are ready
+            while (true) {
+                int outCount = jbuf.pop(stream.writeBuf, STREAM_BUFFER_SIZE);
+                if (!outCount) { break; }
+                if (!stream.swap(outCount)) {
+                    run = false;
+                    break;
+                }
+            }
+        }
+
+        // Free receive buffer
+        dsp::buffer::free(buffer);
+    }
+
     std::string name;
     bool enabled = true;
     dsp::stream<dsp::complex_t> stream;
@@ -332,6 +414,7 @@ private:
     int sampTypeId;
     char hostname[1024] = "localhost";
     int port = 1234;
+    int jitterMs = 20;
 
     OptionList<std::string, Protocol> protocols;
     OptionList<std::string, SampleType> sampleTypes;
@@ -342,6 +425,8 @@ private:
     std::mutex sockMtx;
     std::shared_ptr<net::Socket> sock;
     std::shared_ptr<net::Listener> listener;
+
+    JitterBuffer jbuf;
 };
 
 MOD_EXPORT void _INIT_() {
@@ -331,7 +331,7 @@ private:
             core::setInputSampleRate(_this->sampleRate);
             config.acquire();
             config.conf["device"] = serial;
-            config.release(true);
+            config.releaseKey("device");
         }
 
         if (SmGui::Combo(CONCAT("##_airspyhf_sr_sel_", _this->name), &_this->srId, _this->srList.txt)) {
@@ -340,7 +340,7 @@ private:
             if (!_this->selectedSerial.empty()) {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerial]["samplerate"] = _this->sampleRate;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -364,7 +364,7 @@ private:
             if (!_this->selectedSerial.empty()) {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerial]["attenuation"] = _this->atten;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -375,7 +375,7 @@ private:
             if (!_this->selectedSerial.empty()) {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerial]["preamp"] = _this->preamp;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -386,7 +386,7 @@ private:
             if (!_this->selectedSerial.empty()) {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerial]["dithering"] = _this->dithering;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -397,7 +397,7 @@ private:
             if (!_this->selectedSerial.empty()) {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerial]["preselector"] = _this->preselector;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
     }
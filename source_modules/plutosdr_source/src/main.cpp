@@ -5,6 +5,7 @@
 #include <core.h>
 #include <gui/style.h>
 #include <gui/smgui.h>
+#include <dsp/convert/sample_format.h>
 #include <iio.h>
 #include <ad9361.h>
 #include <utils/optionlist.h>
@@ -367,7 +368,7 @@ private:
             core::setInputSampleRate(_this->samplerate);
             config.acquire();
             config.conf["device"] = _this->devices.key(_this->devId);
-            config.release(true);
+            config.releaseKey("device");
         }
 
         if (SmGui::Combo(CONCAT("##_pluto_sr_", _this->name), &_this->srId, _this->samplerates.txt)) {
@@ -376,7 +377,7 @@ private:
             if (!_this->devDesc.empty()) {
                 config.acquire();
                 config.conf["devices"][_this->devDesc]["samplerate"] = _this->samplerate;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -401,7 +402,7 @@ private:
             if (!_this->devDesc.empty()) {
                 config.acquire();
                 config.conf["devices"][_this->devDesc]["bandwidth"] = _this->bandwidth;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -415,7 +416,7 @@ private:
             if (!_this->devDesc.empty()) {
                 config.acquire();
                 config.conf["devices"][_this->devDesc]["gainMode"] = _this->gainModes.key(_this->gmId);
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -429,7 +430,7 @@ private:
             if (!_this->devDesc.empty()) {
                 config.acquire();
                 config.conf["devices"][_this->devDesc]["gain"] = _this->gain;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
         if (_this->gmId) { SmGui::EndDisabled(); }
@@ -477,7 +478,7 @@ private:
             if (!buf) { break; }
 
             // Convert samples to CF32
-            volk_16i_s32f_convert_32f((float*)_this->stream.writeBuf, buf, 32768.0f, blockSize * 2);
+            dsp::convert::s16ToComplex(buf, _this->stream.writeBuf, blockSize);
 
             // Send out the samples
             if (!_this->stream.swap(blockSize)) { break; };
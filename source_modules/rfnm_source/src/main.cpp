@@ -6,6 +6,7 @@
 #include <librfnm/librfnm.h>
 #include <core.h>
 #include <utils/optionlist.h>
+#include <dsp/convert/sample_format.h>
 #include <atomic>
 
 SDRPP_MOD_INFO{
@@ -446,7 +447,7 @@ private:
             else if (fail) { break; }
 
             // Convert buffer to CF32
-            volk_16i_s32f_convert_32f((float*)&stream.writeBuf[(count++)*sampCount], (int16_t*)lrxbuf->buf, 32768.0f, sampCount * 2);
+            dsp::convert::s16ToComplex((int16_t*)lrxbuf->buf, &stream.writeBuf[(count++)*sampCount], sampCount);
 
             // Reque buffer
             openDev->rx_qbuf(lrxbuf);
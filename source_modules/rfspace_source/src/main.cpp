@@ -134,14 +134,14 @@ private:
         if (SmGui::InputText(CONCAT("##_rfspace_srv_host_", _this->name), _this->hostname, 1023)) {
             config.acquire();
             config.conf["hostname"] = _this->hostname;
-            config.release(true);
+            config.releaseKey("hostname");
         }
         SmGui::SameLine();
         SmGui::FillWidth();
         if (SmGui::InputInt(CONCAT("##_rfspace_srv_port_", _this->name), &_this->port, 0, 0)) {
             config.acquire();
             config.conf["port"] = _this->port;
-            config.release(true);
+            config.releaseKey("port");
         }
         if (connected) { SmGui::EndDisabled(); }
 
@@ -176,7 +176,7 @@ private:
                 
                 config.acquire();
                 config.conf["devices"][_this->devConfName]["sampleRate"] = _this->sampleRates.key(_this->srId);
-                config.release(true);
+                config.releaseKey("devices");
             }
 
             if (_this->running) { SmGui::EndDisabled(); }
@@ -189,7 +189,7 @@ private:
 
                     config.acquire();
                     config.conf["devices"][_this->devConfName]["rfPort"] = _this->rfPorts.key(_this->rfPortId);
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
 
@@ -200,7 +200,7 @@ private:
 
                 config.acquire();
                 config.conf["devices"][_this->devConfName]["gain"] = _this->gain;
-                config.release(true);
+                config.releaseKey("devices");
             }
 
             SmGui::Text("Status:");
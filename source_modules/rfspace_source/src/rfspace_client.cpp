@@ -2,6 +2,7 @@
 #include <volk/volk.h>
 #include <cstring>
 #include <utils/flog.h>
+#include <dsp/convert/sample_format.h>
 
 using namespace std::chrono_literals;
 
@@ -238,7 +239,7 @@ namespace rfspace {
                 // Convert samples to complex float
                 int16_t* samples = (int16_t*)&buffer[4];
                 int sampCount = (size - 4) / (2 * sizeof(int16_t));
-                volk_16i_s32f_convert_32f((float*)&output->writeBuf[inBuffer], samples, 32768.0f, sampCount * 2);
+                dsp::convert::s16ToComplex(samples, &output->writeBuf[inBuffer], sampCount);
                 inBuffer += sampCount;
 
                 // Send out samples if enough are buffered
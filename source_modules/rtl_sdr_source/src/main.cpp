@@ -6,6 +6,7 @@
 #include <gui/style.h>
 #include <config.h>
 #include <gui/smgui.h>
+#include <dsp/convert/sample_format.h>
 #include <rtl-sdr.h>
 
 #ifdef __ANDROID__
@@ -89,7 +90,7 @@ public:
         else {
             selectedDevName = config.conf["device"];
         }
-        config.release(true);
+        config.releaseKey("device");
         selectByName(selectedDevName);
 
         sigpath::sourceManager.registerSource("RTL-SDR", &handler);
@@ -370,7 +371,7 @@ private:
             if (_this->selectedDevName != "") {
                 config.acquire();
                 config.conf["device"] = _this->selectedDevName;
-                config.release(true);
+                config.releaseKey("device");
             }
         }
 
@@ -380,7 +381,7 @@ private:
             if (_this->selectedDevName != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedDevName]["sampleRate"] = _this->sampleRate;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -417,7 +418,7 @@ private:
             if (_this->selectedDevName != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedDevName]["directSampling"] = _this->directSamplingMode;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -431,7 +432,7 @@ private:
             if (_this->selectedDevName != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedDevName]["ppm"] = _this->ppm;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -450,7 +451,7 @@ private:
                 if (_this->selectedDevName != "") {
                     config.acquire();
                     config.conf["devices"][_this->selectedDevName]["gain"] = _this->gainId;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
         }
@@ -463,7 +464,7 @@ private:
                 if (_this->selectedDevName != "") {
                     config.acquire();
                     config.conf["devices"][_this->selectedDevName]["gain"] = _this->gainId;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
         }
@@ -478,7 +479,7 @@ private:
             if (_this->selectedDevName != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedDevName]["biasT"] = _this->biasT;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -489,7 +490,7 @@ private:
             if (_this->selectedDevName != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedDevName]["offsetTuning"] = _this->offsetTuning;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -500,7 +501,7 @@ private:
             if (_this->selectedDevName != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedDevName]["rtlAgc"] = _this->rtlAgc;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -518,7 +519,7 @@ private:
             if (_this->selectedDevName != "") {
                 config.acquire();
                 config.conf["devices"][_this->selectedDevName]["tunerAgc"] = _this->tunerAgc;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
     }
@@ -531,10 +532,7 @@ private:
     static void asyncHandler(unsigned char* buf, uint32_t len, void* ctx) {
         RTLSDRSourceModule* _this = (RTLSDRSourceModule*)ctx;
         int sampCount = len / 2;
-        for (int i = 0; i < sampCount; i++) {
-            _this->stream.writeBuf[i].re = ((float)buf[i * 2] - 127.4) / 128.0f;
-            _this->stream.writeBuf[i].im = ((float)buf[(i * 2) + 1] - 127.4) / 128.0f;
-        }
+        _this->iqTable.convert(buf, _this->stream.writeBuf, sampCount);
         if (!_this->stream.swap(sampCount)) { return; }
     }
 
@@ -546,6 +544,7 @@ private:
     rtlsdr_dev_t* openDev;
     bool enabled = true;
     dsp::stream<dsp::complex_t> stream;
+    dsp::convert::IQTable8 iqTable{ false, 127.4f, 128.0f };
     double sampleRate;
     SourceManager::SourceHandler handler;
     bool running = false;
@@ -182,14 +182,14 @@ private:
         if (SmGui::InputText(CONCAT("##_ip_select_", _this->name), _this->ip, 1024)) {
             config.acquire();
             config.conf["host"] = std::string(_this->ip);
-            config.release(true);
+            config.releaseKey("host");
         }
         SmGui::SameLine();
         SmGui::FillWidth();
         if (SmGui::InputInt(CONCAT("##_port_select_", _this->name), &_this->port, 0)) {
             config.acquire();
             config.conf["port"] = _this->port;
-            config.release(true);
+            config.releaseKey("port");
         }
 
         SmGui::FillWidth();
@@ -198,7 +198,7 @@ private:
             core::setInputSampleRate(_this->sampleRate);
             config.acquire();
             config.conf["sampleRate"] = _this->sampleRate;
-            config.release(true);
+            config.releaseKey("sampleRate");
         }
 
         if (_this->running) { SmGui::EndDisabled(); }
@@ -212,7 +212,7 @@ private:
             }
             config.acquire();
             config.conf["directSamplingMode"] = _this->directSamplingId;
-            config.release(true);
+            config.releaseKey("directSamplingMode");
         }
 
         SmGui::LeftLabel("PPM Correction");
@@ -223,7 +223,7 @@ private:
             }
             config.acquire();
             config.conf["ppm"] = _this->ppm;
-            config.release(true);
+            config.releaseKey("ppm");
         }
 
         if (_this->tunerAGC) { SmGui::BeginDisabled(); }
@@ -235,7 +235,7 @@ private:
             }
             config.acquire();
             config.conf["gainIndex"] = _this->gain;
-            config.release(true);
+            config.releaseKey("gainIndex");
         }
         if (_this->tunerAGC) { SmGui::EndDisabled(); }
 
@@ -245,7 +245,7 @@ private:
             }
             config.acquire();
             config.conf["biasTee"] = _this->biasTee;
-            config.release(true);
+            config.releaseKey("biasTee");
         }
 
         if (SmGui::Checkbox(CONCAT("Offset Tuning##_biast_select_", _this->name), &_this->offsetTuning)) {
@@ -254,7 +254,7 @@ private:
             }
             config.acquire();
             config.conf["offsetTuning"] = _this->offsetTuning;
-            config.release(true);
+            config.releaseKey("offsetTuning");
         }
 
         if (SmGui::Checkbox("RTL AGC", &_this->rtlAGC)) {
@@ -266,7 +266,7 @@ private:
             }
             config.acquire();
             config.conf["rtlAGC"] = _this->rtlAGC;
-            config.release(true);
+            config.releaseKey("rtlAGC");
         }
 
         SmGui::ForceSync();
@@ -279,7 +279,7 @@ private:
             }
             config.acquire();
             config.conf["tunerAGC"] = _this->tunerAGC;
-            config.release(true);
+            config.releaseKey("tunerAGC");
         }
     }
 
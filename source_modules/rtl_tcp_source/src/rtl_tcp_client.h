@@ -2,6 +2,7 @@
 #include <utils/net.h>
 #include <dsp/stream.h>
 #include <dsp/types.h>
+#include <dsp/convert/sample_format.h>
 #include <thread>
 
 namespace rtltcp {
@@ -39,6 +40,7 @@ namespace rtltcp {
         std::thread workerThread;
         dsp::stream<dsp::complex_t>* stream;
         int bufferSize = 2400000 / 200;
+        dsp::convert::IQTable8 iqTable{ false, 128.0f, 128.0f };
     };
 
     std::shared_ptr<Client> connect(dsp::stream<dsp::complex_t>* stream, std::string host, int port = 1234);
@@ -5,6 +5,7 @@
 #include <signal_path/signal_path.h>
 #include <core.h>
 #include <utils/optionlist.h>
+#include <dsp/channel/real_ddc.h>
 #include <atomic>
 #include <sddc.h>
 
@@ -329,7 +330,7 @@ private:
             core::setInputSampleRate(_this->sampleRate);
             config.acquire();
             config.conf["device"] = _this->selectedSerial;
-            config.release(true);
+            config.releaseKey("device");
         }
 
         if (SmGui::Combo(CONCAT("##_sddc_sr_sel_", _this->name), &_this->srId, _this->samplerates.txt)) {
@@ -338,7 +339,7 @@ private:
             if (!_this->selectedSerial.empty()) {
                 config.acquire();
                 config.conf["devices"][_this->selectedSerial]["samplerate"] = _this->samplerates.key(_this->srId);
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -357,7 +358,7 @@ private:
         //     if (!_this->selectedSerial.empty()) {
         //         config.acquire();
         //         config.conf["devices"][_this->selectedSerial]["port"] = _this->ports.key(_this->portId);
-        //         config.release(true);
+        //         config.releaseKey("devices");
         //     }
         // }
 
@@ -373,7 +374,7 @@ private:
         //         if (!_this->selectedSerial.empty()) {
         //             config.acquire();
         //             config.conf["devices"][_this->selectedSerial]["lnaGain"] = _this->lnaGain;
-        //             config.release(true);
+        //             config.releaseKey("devices");
         //         }
         //     }
 
@@ -386,7 +387,7 @@ private:
         //         if (!_this->selectedSerial.empty()) {
         //             config.acquire();
         //             config.conf["devices"][_this->selectedSerial]["vgaGain"] = _this->vgaGain;
-        //             config.release(true);
+        //             config.releaseKey("devices");
         //         }
         //     }
         // }
@@ -435,23 +436,15 @@ private:
         // else if (port == PORT_HF2) {
             // Allocate the sample buffer
             int16_t* buffer = dsp::buffer::alloc<int16_t>(bufferSize);
-            float* fbuffer = dsp::buffer::alloc<float>(bufferSize);
-            float* nullBuffer = dsp::buffer::alloc<float>(bufferSize);
-
-            // Clear the null buffer
-            dsp::buffer::clear(nullBuffer, bufferSize);
 
             while (run) {
                 // Read samples
                 int err = sddc_rx(openDev, buffer, bufferSize);
                 if (err) { break; }
 
-                // Convert the samples to float
-                volk_16i_s32f_convert_32f(fbuffer, buffer, 32768.0f, bufferSize);
+                // Convert the samples to float, the DDC takes the real samples as-is
+                volk_16i_s32f_convert_32f(ddcIn.writeBuf, buffer, 32768.0f, bufferSize);
 
-                // Interleave into a complex value
-                volk_32f_x2_interleave_32fc((lv_32fc_t*)ddcIn.writeBuf, fbuffer, nullBuffer, bufferSize);
-                
                 // Send samples to the DDC
                 if (!ddcIn.swap(bufferSize)) { break; }
             }
@@ -485,8 +478,8 @@ private:
     std::thread workerThread;
     std::atomic<bool> run = false;
 
-    dsp::stream<dsp::complex_t> ddcIn;
-    dsp::channel::RxVFO ddc;
+    dsp::stream<float> ddcIn;
+    dsp::channel::RealDDC ddc;
 };
 
 MOD_EXPORT void _INIT_() {
@@ -652,7 +652,7 @@ private:
             core::setInputSampleRate(_this->sampleRate);
             config.acquire();
             config.conf["device"] = _this->devNameList[_this->devId];
-            config.release(true);
+            config.releaseKey("device");
         }
 
         if (_this->ifModeId == 0) {
@@ -664,7 +664,7 @@ private:
                 core::setInputSampleRate(_this->sampleRate);
                 config.acquire();
                 config.conf["devices"][_this->selectedName]["samplerate"] = _this->samplerates.key(_this->srId);
-                config.release(true);
+                config.releaseKey("devices");
             }
 
             SmGui::SameLine();
@@ -686,7 +686,7 @@ private:
                 }
                 config.acquire();
                 config.conf["devices"][_this->selectedName]["bwMode"] = _this->bandwidthId;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
         else {
@@ -734,7 +734,7 @@ private:
             core::setInputSampleRate(_this->sampleRate);
             config.acquire();
             config.conf["devices"][_this->selectedName]["ifModeId"] = _this->ifModeId;
-            config.release(true);
+            config.releaseKey("devices");
         }
 
         if (_this->running) { SmGui::EndDisabled(); }
@@ -749,7 +749,7 @@ private:
                 }
                 config.acquire();
                 config.conf["devices"][_this->selectedName]["lnaGain"] = _this->lnaGain;
-                config.release(true);
+                config.releaseKey("devices");
             }
 
             if (_this->agc > 0) { SmGui::BeginDisabled(); }
@@ -762,7 +762,7 @@ private:
                 }
                 config.acquire();
                 config.conf["devices"][_this->selectedName]["ifGain"] = _this->gain;
-                config.release(true);
+                config.releaseKey("devices");
             }
             if (_this->agc > 0) { SmGui::EndDisabled(); }
 
@@ -792,7 +792,7 @@ private:
                     config.conf["devices"][_this->selectedName]["agcDecayDelay"] = _this->agcDecayDelay;
                     config.conf["devices"][_this->selectedName]["agcDecayThreshold"] = _this->agcDecayThreshold;
                     config.conf["devices"][_this->selectedName]["agcSetPoint"] = _this->agcSetPoint;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
 
@@ -816,7 +816,7 @@ private:
                 }
                 config.acquire();
                 config.conf["devices"][_this->selectedName]["agc"] = _this->agc;
-                config.release(true);
+                config.releaseKey("devices");
             }
             SmGui::SameLine();
             SmGui::FillWidth();
@@ -935,7 +935,7 @@ private:
             }
             config.acquire();
             config.conf["devices"][selectedName]["fmmwNotch"] = rsp1a_fmmwNotch;
-            config.release(true);
+            config.releaseKey("devices");
         }
         if (SmGui::Checkbox(CONCAT("DAB Notch##sdrplay_rsp1a_dabnotch", name), &rsp1a_dabNotch)) {
             if (running) {
@@ -944,7 +944,7 @@ private:
             }
             config.acquire();
             config.conf["devices"][selectedName]["dabNotch"] = rsp1a_dabNotch;
-            config.release(true);
+            config.releaseKey("devices");
         }
         if (SmGui::Checkbox(CONCAT("Bias-T##sdrplay_rsp1a_biast", name), &rsp1a_biasT)) {
             if (running) {
@@ -953,7 +953,7 @@ private:
             }
             config.acquire();
             config.conf["devices"][selectedName]["biast"] = rsp1a_biasT;
-            config.release(true);
+            config.releaseKey("devices");
         }
     }
 
@@ -970,7 +970,7 @@ private:
             }
             config.acquire();
             config.conf["devices"][selectedName]["antenna"] = rsp2_antennaPort;
-            config.release(true);
+            config.releaseKey("devices");
         }
 
         // The notch is only available on the 50Ohm ports
@@ -982,7 +982,7 @@ private:
                 }
                 config.acquire();
                 config.conf["devices"][selectedName]["fmmwNotch"] = rsp2_fmmwNotch;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
         else {
@@ -999,7 +999,7 @@ private:
             }
             config.acquire();
             config.conf["devices"][selectedName]["biast"] = rsp2_biasT;
-            config.release(true);
+            config.releaseKey("devices");
         }
     }
 
@@ -1012,7 +1012,7 @@ private:
             }
             config.acquire();
             config.conf["devices"][selectedName]["antenna"] = rspduo_antennaPort;
-            config.release(true);
+            config.releaseKey("devices");
         }
         if (SmGui::Checkbox(CONCAT("FM/MW Notch##sdrplay_rspduo_fmmwnotch", name), &rspduo_fmmwNotch)) {
             if (running) {
@@ -1023,7 +1023,7 @@ private:
             }
             config.acquire();
             config.conf["devices"][selectedName]["fmmwnotch"] = rspduo_fmmwNotch;
-            config.release(true);
+            config.releaseKey("devices");
         }
         if (SmGui::Checkbox(CONCAT("DAB Notch##sdrplay_rspduo_dabnotch", name), &rspduo_dabNotch)) {
             if (running) {
@@ -1032,7 +1032,7 @@ private:
             }
             config.acquire();
             config.conf["devices"][selectedName]["dabNotch"] = rspduo_dabNotch;
-            config.release(true);
+            config.releaseKey("devices");
         }
         if (SmGui::Checkbox(CONCAT("Bias-T##sdrplay_rspduo_biast", name), &rspduo_biasT)) {
             if (running) {
@@ -1041,7 +1041,7 @@ private:
             }
             config.acquire();
             config.conf["devices"][selectedName]["biast"] = rspduo_biasT;
-            config.release(true);
+            config.releaseKey("devices");
         }
     }
 
@@ -1055,7 +1055,7 @@ private:
             }
             config.acquire();
             config.conf["devices"][selectedName]["antenna"] = rspdx_antennaPort;
-            config.release(true);
+            config.releaseKey("devices");
         }
 
         if (SmGui::Checkbox(CONCAT("FM/MW Notch##sdrplay_rspdx_fmmwnotch", name), &rspdx_fmmwNotch)) {
@@ -1065,7 +1065,7 @@ private:
             }
             config.acquire();
             config.conf["devices"][selectedName]["fmmwNotch"] = rspdx_fmmwNotch;
-            config.release(true);
+            config.releaseKey("devices");
         }
         if (SmGui::Checkbox(CONCAT("DAB Notch##sdrplay_rspdx_dabnotch", name), &rspdx_dabNotch)) {
             if (running) {
@@ -1074,7 +1074,7 @@ private:
             }
             config.acquire();
             config.conf["devices"][selectedName]["dabNotch"] = rspdx_dabNotch;
-            config.release(true);
+            config.releaseKey("devices");
         }
         if (SmGui::Checkbox(CONCAT("Bias-T##sdrplay_rspdx_biast", name), &rspdx_biasT)) {
             if (running) {
@@ -1083,7 +1083,7 @@ private:
             }
             config.acquire();
             config.conf["devices"][selectedName]["biast"] = rspdx_biasT;
-            config.release(true);
+            config.releaseKey("devices");
         }
     }
 
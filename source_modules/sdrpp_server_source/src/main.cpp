@@ -157,14 +157,14 @@ private:
         if (ImGui::InputText(CONCAT("##sdrpp_srv_srv_host_", _this->name), _this->hostname, 1023)) {
             config.acquire();
             config.conf["hostname"] = _this->hostname;
-            config.release(true);
+            config.releaseKey("hostname");
         }
         ImGui::SameLine();
         ImGui::SetNextItemWidth(menuWidth - ImGui::GetCursorPosX());
         if (ImGui::InputInt(CONCAT("##sdrpp_srv_srv_port_", _this->name), &_this->port, 0, 0)) {
             config.acquire();
             config.conf["port"] = _this->port;
-            config.release(true);
+            config.releaseKey("port");
         }
         if (connected) { style::endDisabled(); }
 
@@ -187,7 +187,7 @@ private:
                 // Save config
                 config.acquire();
                 config.conf["servers"][_this->devConfName]["sampleType"] = _this->sampleTypeList.key(_this->sampleTypeId);
-                config.release(true);
+                config.releaseKey("servers");
             }
             
             if (ImGui::Checkbox("Compression", &_this->compression)) {
@@ -196,7 +196,7 @@ private:
                 // Save config
                 config.acquire();
                 config.conf["servers"][_this->devConfName]["compression"] = _this->compression;
-                config.release(true);
+                config.releaseKey("servers");
             }
 
             bool dummy = true;
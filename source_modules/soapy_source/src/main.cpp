@@ -296,7 +296,7 @@ private:
         }
         config.acquire();
         config.conf["devices"][devArgs["label"]] = conf;
-        config.release(true);
+        config.releaseKey("devices");
     }
 
     static void menuSelected(void* ctx) {
@@ -404,7 +404,7 @@ private:
             _this->selectDevice(_this->devList[_this->devId]["label"]);
             config.acquire();
             config.conf["device"] = _this->devList[_this->devId]["label"];
-            config.release(true);
+            config.releaseKey("device");
         }
 
         if (SmGui::Combo(CONCAT("##_sr_select_", _this->name), &_this->srId, _this->txtSrList.c_str())) {
@@ -126,14 +126,14 @@ private:
         if (SmGui::InputText(CONCAT("##spectran_http_host_", _this->name), _this->hostname, 1023)) {
             config.acquire();
             config.conf["hostname"] = _this->hostname;
-            config.release(true);
+            config.releaseKey("hostname");
         }
         SmGui::SameLine();
         SmGui::FillWidth();
         if (SmGui::InputInt(CONCAT("##spectran_http_port_", _this->name), &_this->port, 0, 0)) {
             config.acquire();
             config.conf["port"] = _this->port;
-            config.release(true);
+            config.releaseKey("port");
         }
 
         if (connected) { SmGui::EndDisabled(); }
@@ -169,14 +169,14 @@ private:
         if (SmGui::InputText(CONCAT("##_spyserver_srv_host_", _this->name), _this->hostname, 1023)) {
             config.acquire();
             config.conf["hostname"] = _this->hostname;
-            config.release(true);
+            config.releaseKey("hostname");
         }
         SmGui::SameLine();
         SmGui::FillWidth();
         if (SmGui::InputInt(CONCAT("##_spyserver_srv_port_", _this->name), &_this->port, 0, 0)) {
             config.acquire();
             config.conf["port"] = _this->port;
-            config.release(true);
+            config.releaseKey("port");
         }
         if (connected) { SmGui::EndDisabled(); }
 
@@ -201,7 +201,7 @@ private:
                 core::setInputSampleRate(_this->sampleRate);
                 config.acquire();
                 config.conf["devices"][_this->devRef]["sampleRateId"] = _this->srId;
-                config.release(true);
+                config.releaseKey("devices");
             }
             if (_this->running) { style::endDisabled(); }
 
@@ -214,7 +214,7 @@ private:
 
                 config.acquire();
                 config.conf["devices"][_this->devRef]["sampleBitDepthId"] = _this->iqType;
-                config.release(true);
+                config.releaseKey("devices");
             }
 
             if (_this->client->devInfo.MaximumGainIndex) {
@@ -225,7 +225,7 @@ private:
                     _this->client->setSetting(SPYSERVER_SETTING_IQ_DIGITAL_GAIN, _this->client->computeDigitalGain(srvBits, _this->gain, _this->srId + _this->client->devInfo.MinimumIQDecimation));
                     config.acquire();
                     config.conf["devices"][_this->devRef]["gainId"] = _this->gain;
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
 
@@ -262,7 +262,7 @@ private:
                 srId = config.conf["devices"][devRef]["sampleRateId"];
                 iqType = config.conf["devices"][devRef]["sampleBitDepthId"];
                 gain = config.conf["devices"][devRef]["gainId"];
-                config.release(true);
+                config.releaseKey("devices");
 
                 gain = std::clamp<int>(gain, 0, client->devInfo.MaximumGainIndex);
 
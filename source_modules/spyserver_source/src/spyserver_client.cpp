@@ -136,22 +136,21 @@ namespace spyserver {
         else if (mtype == SPYSERVER_MSG_TYPE_UINT8_IQ) {
             int sampCount = _this->receivedHeader.BodySize / (sizeof(uint8_t) * 2);
             float gain = pow(10, (double)mflags / 20.0);
-            float scale = 1.0f / (gain * 128.0f);
-            for (int i = 0; i < sampCount; i++) {
-                _this->output->writeBuf[i].re = ((float)_this->readBuf[(2 * i)] - 128.0f) * scale;
-                _this->output->writeBuf[i].im = ((float)_this->readBuf[(2 * i) + 1] - 128.0f) * scale;
-            }
+            _this->iqTable.init(false, 128.0f, gain * 128.0f);
+            _this->iqTable.convert(_this->readBuf, _this->output->writeBuf, sampCount);
             _this->output->swap(sampCount);
         }
         else if (mtype == SPYSERVER_MSG_TYPE_INT16_IQ) {
             int sampCount = _this->receivedHeader.BodySize / (sizeof(int16_t) * 2);
             float gain = pow(10, (double)mflags / 20.0);
-            volk_16i_s32f_convert_32f((float*)_this->output->writeBuf, (int16_t*)_this->readBuf, 32768.0 * gain, sampCount * 2);
+            dsp::convert::s16ToComplex((int16_t*)_this->readBuf, _this->output->writeBuf, sampCount, 32768.0f * gain);
             _this->output->swap(sampCount);
         }
         else if (mtype == SPYSERVER_MSG_TYPE_INT24_IQ) {
-            printf("ERROR: IQ format not supported\n");
-            return;
+            int sampCount = _this->receivedHeader.BodySize / 6;
+            float gain = pow(10, (double)mflags / 20.0);
+            dsp::convert::s24ToComplex(_this->readBuf, _this->output->writeBuf, sampCount, 8388608.0f * gain);
+            _this->output->swap(sampCount);
         }
         else if (mtype == SPYSERVER_MSG_TYPE_FLOAT_IQ) {
             int sampCount = _this->receivedHeader.BodySize / sizeof(dsp::complex_t);
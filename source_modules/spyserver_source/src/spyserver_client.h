@@ -3,6 +3,7 @@
 #include <spyserver_protocol.h>
 #include <dsp/stream.h>
 #include <dsp/types.h>
+#include <dsp/convert/sample_format.h>
 
 namespace spyserver {
     class SpyServerClientClass {
@@ -42,6 +43,7 @@ namespace spyserver {
         std::condition_variable deviceInfoCnd;
 
         SpyServerMessageHeader receivedHeader;
+        dsp::convert::IQTable8 iqTable;
 
         dsp::stream<dsp::complex_t>* output;
     };
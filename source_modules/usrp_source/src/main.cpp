@@ -325,7 +325,7 @@ private:
             if (!_this->selectedSer.empty()) {
                 config.acquire();
                 config.conf["device"] = _this->devices.key(_this->devId);
-                config.release(true);
+                config.releaseKey("device");
             }
         }
 
@@ -335,7 +335,7 @@ private:
             if (!_this->selectedSer.empty()) {
                 config.acquire();
                 config.conf["devices"][_this->selectedSer]["channels"][_this->selectedChan]["samplerate"] = _this->samplerates.key(_this->srId);
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
 
@@ -356,7 +356,7 @@ private:
                 if (!_this->selectedSer.empty()) {
                     config.acquire();
                     config.conf["devices"][_this->selectedSer]["channel"] = _this->channels.key(_this->chanId);
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
                 _this->select(_this->devices.key(_this->devId));
             }
@@ -374,7 +374,7 @@ private:
                 if (!_this->selectedSer.empty() && !_this->selectedChan.empty()) {
                     config.acquire();
                     config.conf["devices"][_this->selectedSer]["channels"][_this->selectedChan]["antenna"] = _this->antennas.key(_this->antId);
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
         }
@@ -389,7 +389,7 @@ private:
                 if (!_this->selectedSer.empty() && !_this->selectedChan.empty()) {
                     config.acquire();
                     config.conf["devices"][_this->selectedSer]["channels"][_this->selectedChan]["bandwidth"] = _this->bandwidths.key(_this->bwId);
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
         }
@@ -404,7 +404,7 @@ private:
                 if (!_this->selectedSer.empty()) {
                     config.acquire();
                     config.conf["devices"][_this->selectedSer]["channels"][_this->selectedChan]["clock"] = _this->clockSources.key(_this->csId);
-                    config.release(true);
+                    config.releaseKey("devices");
                 }
             }
         }
@@ -418,7 +418,7 @@ private:
             if (!_this->selectedSer.empty() && !_this->selectedChan.empty()) {
                 config.acquire();
                 config.conf["devices"][_this->selectedSer]["channels"][_this->selectedChan]["gain"] = _this->gain;
-                config.release(true);
+                config.releaseKey("devices");
             }
         }
     }